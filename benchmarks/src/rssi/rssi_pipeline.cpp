@@ -0,0 +1,118 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "rssi/rssi_pipeline.h"
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+static constexpr size_t SAMPLES_COUNT = 16 * 1024;
+
+static std::vector<uint16_t> make_samples() {
+    std::vector<uint16_t> samples(SAMPLES_COUNT);
+    std::srand(1);
+    for (uint16_t& sample : samples) {
+        sample = static_cast<uint16_t>(std::rand());
+    }
+    return samples;
+}
+
+// Same stages called through a virtual interface, as a runtime configurable chain would do.
+class VirtualStage {
+public:
+    virtual ~VirtualStage() = default;
+    virtual bool process(uint16_t& sample, uint32_t& tick) = 0;
+};
+
+template<typename Stage>
+class VirtualStageAdapter : public VirtualStage {
+public:
+    bool process(uint16_t& sample, uint32_t& tick) override {
+        return stage.process(sample, tick);
+    }
+
+private:
+    Stage stage;
+};
+
+class VirtualPipeline {
+public:
+    template<typename Stage>
+    void add_stage() {
+        stages.push_back(std::make_unique<VirtualStageAdapter<Stage>>());
+    }
+
+    bool process(uint16_t& sample, uint32_t& tick) {
+        for (const std::unique_ptr<VirtualStage>& stage : stages) {
+            if (!stage->process(sample, tick)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<std::unique_ptr<VirtualStage>> stages;
+};
+
+template<typename Pipeline>
+static uint32_t run_pipeline(Pipeline& pipeline, const std::vector<uint16_t>& samples) {
+    uint32_t checksum = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+        uint16_t sample = samples[i];
+        uint32_t tick = i;
+        if (pipeline.process(sample, tick)) {
+            checksum += sample + tick;
+        }
+    }
+    return checksum;
+}
+
+TEST_CASE("RSSI pipeline", "[rssi_pipeline]") {
+    const std::vector<uint16_t> samples = make_samples();
+
+    BENCHMARK("virtual stages") {
+        VirtualPipeline pipeline;
+        pipeline.add_stage<RssiDecimate<2>>();
+        pipeline.add_stage<RssiMedian<9>>();
+        pipeline.add_stage<RssiIir<8192>>();
+        pipeline.add_stage<RssiHysteresis<64>>();
+        return run_pipeline(pipeline, samples);
+    };
+
+    BENCHMARK("inlined pipeline") {
+        RssiPipeline<RssiDecimate<2>, RssiMedian<9>, RssiIir<8192>, RssiHysteresis<64>> pipeline;
+        return run_pipeline(pipeline, samples);
+    };
+
+    BENCHMARK("block decimation") {
+        RssiPipeline<RssiBlockDecimate2, RssiMedian<9>, RssiIir<8192>, RssiHysteresis<64>> pipeline;
+        uint32_t checksum = 0;
+        pipeline.process_block(samples.data(), samples.size(), 0, 1, [&checksum](uint16_t sample, uint32_t tick) {
+            checksum += sample + tick;
+        });
+        return checksum;
+    };
+}
@@ -0,0 +1,47 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "rssi/rssi_signal_generator.h"
+
+static constexpr size_t SAMPLES_COUNT = 64 * 1024;
+
+TEST_CASE("RSSI signal generator", "[rssi_signal_generator]") {
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 1000;
+    drone.lap_time_ms = 3000;
+    drone.lap_time_jitter_ms = 300;
+
+    BENCHMARK("single channel") {
+        RssiSignalGenerator generator(400);
+        generator.add_drone(drone);
+        return generator.generate(SAMPLES_COUNT);
+    };
+
+    BENCHMARK("four channels") {
+        RssiSignalGenerator generator(400);
+        for (int i = 0; i < 4; i++) {
+            generator.add_drone(drone);
+        }
+        return generator.generate(SAMPLES_COUNT / 4);
+    };
+}
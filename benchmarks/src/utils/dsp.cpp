@@ -0,0 +1,89 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "utils/dsp.h"
+
+#include <cstdlib>
+#include <vector>
+
+static constexpr size_t SAMPLES_COUNT = 16 * 1024;
+
+// Length of a DMA block of a single channel.
+static constexpr size_t BLOCK_LENGTH = 64;
+
+static std::vector<uint16_t> make_samples() {
+    std::vector<uint16_t> samples(SAMPLES_COUNT);
+    std::srand(1);
+    for (uint16_t& sample : samples) {
+        sample = static_cast<uint16_t>(std::rand());
+    }
+    return samples;
+}
+
+template<typename Kernel>
+static uint32_t run_blocks(const std::vector<uint16_t>& samples, std::vector<uint16_t>& output, Kernel kernel) {
+    for (size_t offset = 0; offset < samples.size(); offset += BLOCK_LENGTH) {
+        kernel(samples.data() + offset, output.data() + offset);
+    }
+    return output[0] + output[output.size() / 2];
+}
+
+// Host numbers only show the overhead of the emulated lanes, gains are measured on the target.
+TEST_CASE("DSP kernels", "[dsp]") {
+    const std::vector<uint16_t> samples = make_samples();
+    std::vector<uint16_t> output(samples.size());
+
+    BENCHMARK("decimate by 2, scalar") {
+        return run_blocks(samples, output, [](const uint16_t* input, uint16_t* block_output) {
+            dsp_decimate2_scalar(input, BLOCK_LENGTH, block_output);
+        });
+    };
+
+    BENCHMARK("decimate by 2, packed") {
+        return run_blocks(samples, output, [](const uint16_t* input, uint16_t* block_output) {
+            dsp_decimate2(input, BLOCK_LENGTH, block_output);
+        });
+    };
+
+    DspFir<8> fir({4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096});
+
+    BENCHMARK("FIR 8 taps, scalar") {
+        return run_blocks(samples, output, [&fir](const uint16_t* input, uint16_t* block_output) {
+            fir.process_block_scalar(input, BLOCK_LENGTH, block_output);
+        });
+    };
+
+    BENCHMARK("FIR 8 taps, packed") {
+        return run_blocks(samples, output, [&fir](const uint16_t* input, uint16_t* block_output) {
+            fir.process_block(input, BLOCK_LENGTH, block_output);
+        });
+    };
+
+    BENCHMARK("find above, scalar") {
+        return dsp_find_above_scalar(samples.data(), samples.size(), UINT16_MAX - 1);
+    };
+
+    BENCHMARK("find above, packed") {
+        return dsp_find_above(samples.data(), samples.size(), UINT16_MAX - 1);
+    };
+}
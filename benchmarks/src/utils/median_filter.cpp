@@ -0,0 +1,97 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "utils/median_filter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+
+static constexpr size_t SAMPLES_COUNT = 16 * 1024;
+
+static std::vector<uint16_t> make_samples() {
+    std::vector<uint16_t> samples(SAMPLES_COUNT);
+    std::srand(1);
+    for (uint16_t& sample : samples) {
+        sample = static_cast<uint16_t>(std::rand());
+    }
+    return samples;
+}
+
+// Filter used by the lap detector before the median filter was introduced.
+template<uint8_t ORDER>
+class CopySortMedianFilter {
+public:
+    CopySortMedianFilter() : buffer{}, current_index(0) {}
+
+    uint16_t process(uint16_t sample) {
+        uint16_t sorted_buffer[ORDER];
+        buffer[current_index] = sample;
+        ++current_index %= ORDER;
+        std::copy(std::begin(buffer), std::end(buffer), std::begin(sorted_buffer));
+        std::sort(std::begin(sorted_buffer), std::end(sorted_buffer));
+        return sorted_buffer[ORDER / 2];
+    }
+
+private:
+    uint16_t buffer[ORDER];
+    size_t current_index;
+};
+
+template<typename Filter>
+static uint32_t run_filter(Filter& filter, const std::vector<uint16_t>& samples) {
+    uint32_t checksum = 0;
+    for (uint16_t sample : samples) {
+        checksum += filter.process(sample);
+    }
+    return checksum;
+}
+
+template<uint8_t ORDER>
+static void benchmark_median_filters() {
+    const std::vector<uint16_t> samples = make_samples();
+
+    BENCHMARK("copy and sort, order " + std::to_string(ORDER)) {
+        CopySortMedianFilter<ORDER> filter;
+        return run_filter(filter, samples);
+    };
+
+    BENCHMARK("median filter, order " + std::to_string(ORDER)) {
+        MedianFilter<uint16_t, ORDER> filter;
+        return run_filter(filter, samples);
+    };
+}
+
+TEST_CASE("Median filter of order 5", "[median_filter]") {
+    benchmark_median_filters<5>();
+}
+
+TEST_CASE("Median filter of order 31", "[median_filter]") {
+    benchmark_median_filters<31>();
+}
+
+TEST_CASE("Median filter of order 127", "[median_filter]") {
+    benchmark_median_filters<127>();
+}
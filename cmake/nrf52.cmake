@@ -487,7 +487,7 @@ target_sources(nRF5_PeriphDrivers PRIVATE
     "${NRF5_SDK_PATH}/modules/nrfx/drivers/src/nrfx_saadc.c"
     "${NRF5_SDK_PATH}/modules/nrfx/drivers/src/nrfx_timer.c"
     "${NRF5_SDK_PATH}/modules/nrfx/drivers/src/nrfx_ppi.c"
-    "${NRF5_SDK_PATH}/modules/nrfx/drivers/src/nrfx_uart.c"
+    "${NRF5_SDK_PATH}/modules/nrfx/drivers/src/nrfx_uarte.c"
     "${NRF5_SDK_PATH}/modules/nrfx/drivers/src/nrfx_rtc.c"
 )
 
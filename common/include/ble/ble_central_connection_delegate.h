@@ -24,16 +24,55 @@
 #define LAP_TIMER_BLE_CENTRAL_CONNECTION_DELEGATE_H
 
 #include "ble/ble_central_connection_interface.h"
+#include "events/event_dispatcher_interface.h"
+#include "events/events.h"
 #include "protocol/commands.h"
+#include "rssi/rssi_summary_stream.h"
+#include "storage/session_storage.h"
+#include "trace/latency_tracer.h"
 
-class BleCentralConnectionDelegate : public BleCentralConnectionInterface::Delegate {
+#include <atomic>
+
+class BleCentralConnectionDelegate : public BleCentralConnectionInterface::Delegate, public RssiSummaryStream::Client {
 public:
+    BleCentralConnectionDelegate() :
+        event_dispatcher(nullptr),
+        session_storage(nullptr),
+        latency_tracer(nullptr),
+        rssi_summary_stream(nullptr),
+        connection(nullptr),
+        calibration_requested(false) {}
+
+    void set_event_dispatcher(EventDispatcherInterface* event_dispatcher) {
+        this->event_dispatcher = event_dispatcher;
+    }
+
+    void set_session_storage(SessionStorage* session_storage) {
+        this->session_storage = session_storage;
+    }
+
+    void set_latency_tracer(LatencyTracer* latency_tracer) {
+        this->latency_tracer = latency_tracer;
+    }
+
+    void set_rssi_summary_stream(RssiSummaryStream* rssi_summary_stream) {
+        this->rssi_summary_stream = rssi_summary_stream;
+    }
+
     virtual void on_initialized(BleCentralConnectionInterface& ble_central_connection) override;
     virtual void on_cleanup() override;
     virtual void on_mtu_changed(uint16_t mtu) override;
     virtual void on_tx_write_request(const uint8_t* data, size_t length) override;
     virtual void on_rx_completed() override;
 
+    virtual size_t get_max_notification_length() const override;
+    virtual bool send_rssi_stream_notification(const uint8_t* data, size_t length) override;
+
+    ///
+    /// @brief Send the result to the central, if it asked for a calibration since it connected.
+    ///
+    void on_rssi_calibration_finished(const RssiCalibrationFinished& calibration_finished);
+
 private:
 
     void handle_start_command(const StartCommand& command);
@@ -44,8 +83,18 @@ private:
     void handle_last_session_id_command(const LastSessionIDCommand& command);
     void handle_list_sessions_ids_command(const ListSessionsIDsCommand& command);
     void handle_get_session_record_command(const GetSessionRecordCommand& command);
+    void handle_lap_signature_command(const LapSignatureCommand& command);
+    void handle_latency_stats_command(const LatencyStatsCommand& command);
+    void handle_rssi_stream_command(const RssiStreamCommand& command);
+    void handle_rssi_calibration_command(const RssiCalibrationCommand& command);
 
+    EventDispatcherInterface* event_dispatcher;
+    SessionStorage* session_storage;
+    LatencyTracer* latency_tracer;
+    RssiSummaryStream* rssi_summary_stream;
     BleCentralConnectionInterface* connection;
+    // Set from the BLE interrupt, read in the event loop.
+    std::atomic<bool> calibration_requested;
 };
 
 #endif // LAP_TIMER_BLE_CENTRAL_CONNECTION_DELEGATE_H
\ No newline at end of file
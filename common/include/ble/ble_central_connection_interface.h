@@ -117,6 +117,16 @@ public:
     ///
     virtual bool send_to_rx(const uint8_t* data, uint16_t length) = 0;
 
+    ///
+    /// @brief Send notification of the RSSI stream characteristic.
+    ///
+    /// @param data Pointer to the data.
+    /// @param length Length of the notification, at most MTU - 3 bytes.
+    /// @return true Notification was queued.
+    /// @return false Notification cannot be queued. Please retry later.
+    ///
+    virtual bool send_to_stream(const uint8_t* data, uint16_t length) = 0;
+
 public:
     virtual ~BleCentralConnectionInterface() {}
 };
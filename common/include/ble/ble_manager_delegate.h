@@ -25,12 +25,53 @@
 
 #include "ble/ble_manager_interface.h"
 #include "ble/ble_central_connection_delegate.h"
+#include "events/event_dispatcher_interface.h"
+#include "events/events.h"
+#include "events/event_observer.h"
 
 #include <array>
 
 template<uint8_t MAX_CENTRAL_CONNECTIONS>
-class BleManagerDelegate : public BleManagerInterface<MAX_CENTRAL_CONNECTIONS>::Delegate {
+class BleManagerDelegate : public BleManagerInterface<MAX_CENTRAL_CONNECTIONS>::Delegate, public EventObserver {
 public:
+    static constexpr EventMask EVENTS = event_mask<RssiCalibrationFinished>();
+
+    explicit BleManagerDelegate(EventDispatcherInterface& event_dispatcher) : manager(nullptr), connections() {
+        for (auto& connection : connections) {
+            connection.set_event_dispatcher(&event_dispatcher);
+        }
+        event_dispatcher.register_observer(this, EVENTS);
+    }
+
+    void set_session_storage(SessionStorage* session_storage) {
+        for (auto& connection : connections) {
+            connection.set_session_storage(session_storage);
+        }
+    }
+
+    void set_latency_tracer(LatencyTracer* latency_tracer) {
+        for (auto& connection : connections) {
+            connection.set_latency_tracer(latency_tracer);
+        }
+    }
+
+    void set_rssi_summary_stream(RssiSummaryStream* rssi_summary_stream) {
+        for (auto& connection : connections) {
+            connection.set_rssi_summary_stream(rssi_summary_stream);
+        }
+    }
+
+    void on_event(const Event& event) override {
+        std::visit(overloaded{
+            [this](const RssiCalibrationFinished& calibration_finished) {
+                for (auto& connection : connections) {
+                    connection.on_rssi_calibration_finished(calibration_finished);
+                }
+            },
+            [](auto other) {}
+        }, event);
+    }
+
     virtual void on_initialized(BleManagerInterface<MAX_CENTRAL_CONNECTIONS>& manager) override {
         this->manager = &manager;
     }
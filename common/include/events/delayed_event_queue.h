@@ -0,0 +1,188 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_DELAYED_EVENT_QUEUE_H
+#define LAP_TIMER_DELAYED_EVENT_QUEUE_H
+
+#include "events/events.h"
+#include "events/event_dispatcher_interface.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+///
+/// @brief Events waiting for their deadlines, kept in a binary min-heap.
+///
+/// Deadlines are milliseconds of a free running 32-bit clock. They are compared by their
+/// difference, so the clock may wrap as long as no deadline is more than 2^31 ms away. Events with
+/// the same deadline are popped in order they were pushed. Periodic events are pushed back with
+/// the next deadline when popped, which is a multiple of the period after the first one, so they
+/// don't drift.
+///
+/// @note Not thread safe, callers have to serialize access.
+///
+/// @tparam CAPACITY Maximum number of pending events.
+///
+template<size_t CAPACITY>
+class DelayedEventQueue {
+    static_assert(CAPACITY > 0, "Queue needs space for at least one event");
+
+public:
+    DelayedEventQueue() : entries(), size(0), next_sequence(0), next_handle(1), overflows(0), high_water_mark(0) {}
+
+    ///
+    /// @brief Add event due at the deadline.
+    ///
+    /// @param event Event to queue.
+    /// @param deadline Time the event is due.
+    /// @param period Period of a periodic event, 0 for a single event.
+    /// @return EventHandle Handle of the queued event or INVALID_EVENT_HANDLE if the queue is full.
+    ///
+    EventHandle push(const Event& event, uint32_t deadline, uint32_t period = 0) {
+        if (size == CAPACITY) {
+            overflows++;
+            return INVALID_EVENT_HANDLE;
+        }
+        Entry& entry = entries[size];
+        entry.deadline = deadline;
+        entry.period = period;
+        entry.sequence = next_sequence++;
+        entry.handle = next_handle++;
+        if (next_handle == INVALID_EVENT_HANDLE) {
+            next_handle++;
+        }
+        entry.event = event;
+        size++;
+        std::push_heap(entries.begin(), entries.begin() + size, is_later);
+        high_water_mark = std::max(high_water_mark, size);
+        return entry.handle;
+    }
+
+    ///
+    /// @brief Take the earliest event, if it's due.
+    ///
+    /// Periodic event stays queued for the next period after now, missed periods are skipped.
+    ///
+    /// @param now Current time.
+    /// @param event Due event.
+    /// @return true Event was taken.
+    /// @return false Queue is empty or the earliest event isn't due yet.
+    ///
+    bool pop_due(uint32_t now, Event& event) {
+        if (size == 0 || static_cast<int32_t>(entries[0].deadline - now) > 0) {
+            return false;
+        }
+        std::pop_heap(entries.begin(), entries.begin() + size, is_later);
+        Entry& entry = entries[size - 1];
+        event = entry.event;
+        if (entry.period == 0) {
+            size--;
+            return true;
+        }
+        uint32_t missed_periods = (now - entry.deadline) / entry.period;
+        entry.deadline += (missed_periods + 1) * entry.period;
+        entry.sequence = next_sequence++;
+        std::push_heap(entries.begin(), entries.begin() + size, is_later);
+        return true;
+    }
+
+    ///
+    /// @brief Remove a pending event.
+    ///
+    /// @return true Event was removed.
+    /// @return false Event was already popped or canceled.
+    ///
+    bool cancel(EventHandle handle) {
+        for (size_t i = 0; i < size; i++) {
+            if (entries[i].handle == handle) {
+                entries[i] = entries[size - 1];
+                size--;
+                std::make_heap(entries.begin(), entries.begin() + size, is_later);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ///
+    /// @brief Get deadline of the earliest event.
+    ///
+    /// @note Queue must not be empty.
+    ///
+    uint32_t get_next_deadline() const {
+        return entries[0].deadline;
+    }
+
+    size_t get_size() const {
+        return size;
+    }
+
+    bool is_empty() const {
+        return size == 0;
+    }
+
+    static constexpr size_t get_capacity() {
+        return CAPACITY;
+    }
+
+    ///
+    /// @brief Get number of events dropped because the queue was full.
+    ///
+    uint32_t get_overflows() const {
+        return overflows;
+    }
+
+    ///
+    /// @brief Get the largest number of events pending at once.
+    ///
+    size_t get_high_water_mark() const {
+        return high_water_mark;
+    }
+
+private:
+    struct Entry {
+        uint32_t deadline;
+        uint32_t period;
+        uint32_t sequence;
+        EventHandle handle;
+        Event event;
+    };
+
+    // Heap ordering, the earliest entry ends up on top.
+    static bool is_later(const Entry& a, const Entry& b) {
+        int32_t difference = static_cast<int32_t>(a.deadline - b.deadline);
+        if (difference != 0) {
+            return difference > 0;
+        }
+        return static_cast<int32_t>(a.sequence - b.sequence) > 0;
+    }
+
+    std::array<Entry, CAPACITY> entries;
+    size_t size;
+    uint32_t next_sequence;
+    EventHandle next_handle;
+    uint32_t overflows;
+    size_t high_water_mark;
+};
+
+#endif // LAP_TIMER_DELAYED_EVENT_QUEUE_H
@@ -26,13 +26,68 @@
 #include "events/events.h"
 #include "events/event_observer.h"
 
+///
+/// @brief Handle of a scheduled event, used to cancel it.
+///
+typedef uint32_t EventHandle;
+
+static constexpr EventHandle INVALID_EVENT_HANDLE = 0;
+
 class EventDispatcherInterface {
 public:
     virtual void emit_event(const Event& event) = 0;
-    virtual void emit_event_delayed(const Event& event, uint32_t ms_delay) = 0;
 
-    virtual bool register_observer(EventObserver* observer) = 0;
+    ///
+    /// @brief Emit the event after the delay.
+    ///
+    /// @return EventHandle Handle of the scheduled event.
+    /// @return INVALID_EVENT_HANDLE There is no space for another scheduled event, event was dropped.
+    ///
+    virtual EventHandle emit_event_delayed(const Event& event, uint32_t ms_delay) = 0;
+
+    ///
+    /// @brief Emit the event when the RealTimeClock reaches the timestamp.
+    ///
+    /// Timestamp in the past emits the event as soon as possible.
+    ///
+    /// @return EventHandle Handle of the scheduled event.
+    /// @return INVALID_EVENT_HANDLE There is no space for another scheduled event, event was dropped.
+    ///
+    virtual EventHandle emit_event_at(const Event& event, uint32_t timestamp_ms) = 0;
+
+    ///
+    /// @brief Emit the event every period, first time one period from now.
+    ///
+    /// Emission times are multiples of the period from the first one, so the event doesn't drift
+    /// with dispatch latency. Periods missed while the dispatcher was busy are skipped.
+    ///
+    /// @return EventHandle Handle of the scheduled event, keep it to cancel the event.
+    /// @return INVALID_EVENT_HANDLE Period is 0 or there is no space for another scheduled event.
+    ///
+    virtual EventHandle emit_event_periodic(const Event& event, uint32_t ms_period) = 0;
+
+    ///
+    /// @brief Cancel a scheduled event.
+    ///
+    /// @return true Event won't be emitted again.
+    /// @return false Event was already emitted or canceled.
+    ///
+    virtual bool cancel(EventHandle handle) = 0;
+
+    ///
+    /// @brief Register observer for the events in the mask, see event_mask().
+    ///
+    /// Registering the observer again replaces its events.
+    ///
+    /// @return true Observer was registered.
+    /// @return false There is no space for another observer.
+    ///
+    virtual bool register_observer(EventObserver* observer, EventMask events) = 0;
     virtual bool unregister_observer(EventObserver* observer) = 0;
+
+    bool register_observer(EventObserver* observer) {
+        return register_observer(observer, EVENT_MASK_ALL);
+    }
 };
 
 #endif // LAP_TIMER_EVENT_DISPATCHER_INTERFACE_H
\ No newline at end of file
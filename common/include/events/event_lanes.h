@@ -0,0 +1,108 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_EVENT_LANES_H
+#define LAP_TIMER_EVENT_LANES_H
+
+#include "events/events.h"
+#include "utils/queue.h"
+
+#include <cstdint>
+
+///
+/// @brief Pending events split into an urgent and a background lane.
+///
+/// Urgent events, see EVENT_MASK_URGENT, are always popped before background ones, so a burst of
+/// storage work doesn't delay a lap. Each lane keeps order of its events.
+///
+/// @note Not thread safe, callers have to serialize access.
+///
+/// @tparam URGENT_CAPACITY Maximum number of pending urgent events.
+/// @tparam BACKGROUND_CAPACITY Maximum number of pending background events.
+///
+template<uint8_t URGENT_CAPACITY, uint8_t BACKGROUND_CAPACITY>
+class EventLanes {
+public:
+    EventLanes() : urgent_events(), background_events(), overflows(0) {}
+
+    ///
+    /// @brief Queue the event in its lane.
+    ///
+    /// @return true Event was queued.
+    /// @return false The lane is full, event was dropped.
+    ///
+    bool push(const Event& event) {
+        bool pushed = is_urgent_event(event) ? urgent_events.push(event) : background_events.push(event);
+        if (!pushed) {
+            overflows++;
+        }
+        return pushed;
+    }
+
+    ///
+    /// @brief Take the next event, urgent events go first.
+    ///
+    /// @param event Taken event.
+    /// @param include_background Take background event if there is no urgent one.
+    /// @return true Event was taken.
+    /// @return false There is no event to take.
+    ///
+    bool pop(Event& event, bool include_background = true) {
+        if (!urgent_events.is_empty()) {
+            event = urgent_events.get_first();
+            urgent_events.pop();
+            return true;
+        }
+        if (include_background && !background_events.is_empty()) {
+            event = background_events.get_first();
+            background_events.pop();
+            return true;
+        }
+        return false;
+    }
+
+    bool is_empty() const {
+        return urgent_events.is_empty() && background_events.is_empty();
+    }
+
+    uint8_t get_urgent_size() const {
+        return urgent_events.size();
+    }
+
+    uint8_t get_background_size() const {
+        return background_events.size();
+    }
+
+    ///
+    /// @brief Get number of events dropped because their lane was full.
+    ///
+    uint32_t get_overflows() const {
+        return overflows;
+    }
+
+private:
+    Queue<Event, URGENT_CAPACITY> urgent_events;
+    Queue<Event, BACKGROUND_CAPACITY> background_events;
+    uint32_t overflows;
+};
+
+#endif // LAP_TIMER_EVENT_LANES_H
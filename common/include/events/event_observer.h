@@ -25,6 +25,12 @@
 
 #include "events/events.h"
 
+///
+/// @brief Receives events passed by the event dispatcher.
+///
+/// Observers declare the events handled by on_event() as EVENTS, a mask made with event_mask().
+/// They register with it, and StaticDispatcher uses it to call them only with these events.
+///
 class EventObserver {
 public:
     virtual void on_event(const Event& event) = 0;
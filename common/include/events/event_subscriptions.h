@@ -0,0 +1,127 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_EVENT_SUBSCRIPTIONS_H
+#define LAP_TIMER_EVENT_SUBSCRIPTIONS_H
+
+#include "events/events.h"
+#include "events/event_observer.h"
+
+#include <array>
+
+///
+/// @brief Observers of event dispatcher, indexed by the events they subscribed to.
+///
+/// For every Event alternative there is a bitmask of observer slots, so dispatching an event
+/// touches only the observers interested in it. Observers are called in order of their slots.
+///
+/// @tparam MAX_OBSERVERS Maximum number of observers, at most 32.
+///
+template<size_t MAX_OBSERVERS>
+class EventSubscriptions {
+    static_assert(MAX_OBSERVERS > 0 && MAX_OBSERVERS <= 32, "Observer slots have to fit in 32 bits");
+
+public:
+    EventSubscriptions() : observers(), subscribers() {
+        observers.fill(nullptr);
+        subscribers.fill(0);
+    }
+
+    ///
+    /// @brief Subscribe observer to events, registering it again replaces its events.
+    ///
+    /// @return true Observer was subscribed.
+    /// @return false All slots are used.
+    ///
+    bool subscribe(EventObserver* observer, EventMask events) {
+        size_t slot = find(observer);
+        if (slot == MAX_OBSERVERS) {
+            slot = find(nullptr);
+            if (slot == MAX_OBSERVERS) {
+                return false;
+            }
+            observers[slot] = observer;
+        }
+        uint32_t slot_bit = uint32_t(1) << slot;
+        for (size_t type = 0; type < EVENT_TYPES_COUNT; type++) {
+            if (events & (EventMask(1) << type)) {
+                subscribers[type] |= slot_bit;
+            } else {
+                subscribers[type] &= ~slot_bit;
+            }
+        }
+        return true;
+    }
+
+    ///
+    /// @brief Remove observer from all events.
+    ///
+    /// @return true Observer was removed.
+    /// @return false Observer wasn't subscribed.
+    ///
+    bool unsubscribe(EventObserver* observer) {
+        size_t slot = find(observer);
+        if (slot == MAX_OBSERVERS) {
+            return false;
+        }
+        uint32_t slot_bit = uint32_t(1) << slot;
+        for (uint32_t& type_subscribers : subscribers) {
+            type_subscribers &= ~slot_bit;
+        }
+        observers[slot] = nullptr;
+        return true;
+    }
+
+    ///
+    /// @brief Pass the event to its subscribers.
+    ///
+    /// @return size_t Number of notified observers.
+    ///
+    size_t dispatch(const Event& event) const {
+        size_t notified = 0;
+        uint32_t pending = subscribers[event.index()];
+        while (pending) {
+            size_t slot = __builtin_ctz(pending);
+            pending &= pending - 1;
+            // Observer could unsubscribe while handling the event.
+            if (observers[slot] && (subscribers[event.index()] & (uint32_t(1) << slot))) {
+                observers[slot]->on_event(event);
+                notified++;
+            }
+        }
+        return notified;
+    }
+
+private:
+    size_t find(const EventObserver* observer) const {
+        size_t slot = 0;
+        while (slot < MAX_OBSERVERS && observers[slot] != observer) {
+            slot++;
+        }
+        return slot;
+    }
+
+    std::array<EventObserver*, MAX_OBSERVERS> observers;
+    std::array<uint32_t, EVENT_TYPES_COUNT> subscribers;
+};
+
+#endif // LAP_TIMER_EVENT_SUBSCRIPTIONS_H
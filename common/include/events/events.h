@@ -23,9 +23,13 @@
 #ifndef LAP_TIMER_EVENTS_H
 #define LAP_TIMER_EVENTS_H
 
+#include <cstddef>
+#include <cstdint>
 #include <variant>
 
 #include "storage/session_storage_events.h"
+#include "rssi/rssi_events.h"
+#include "rssi/pass_signature.h"
 
 class StartSession {
 public:
@@ -43,18 +47,33 @@ public:
 
 class AddLapTime {
 public:
-    AddLapTime(uint32_t lap_time) : lap_time(lap_time) {}
+    AddLapTime(uint32_t lap_time, const PassSignature& pass_signature = PassSignature(), uint8_t channel = 0) :
+        lap_time(lap_time),
+        pass_signature(pass_signature),
+        channel(channel) {}
 
     uint32_t get_lap_time() const {
         return lap_time;
     }
 
+    // RSSI channel, which identifies the pilot.
+    uint8_t get_channel() const {
+        return channel;
+    }
+
+    // Signature of the pass which finished the lap, stored next to the lap time.
+    const PassSignature& get_pass_signature() const {
+        return pass_signature;
+    }
+
     bool operator==(const AddLapTime& event) const {
-        return lap_time == event.lap_time;
+        return lap_time == event.lap_time && pass_signature == event.pass_signature && channel == event.channel;
     }
 
 private:
     uint32_t lap_time;
+    PassSignature pass_signature;
+    uint8_t channel;
 };
 
 class FlashLED {
@@ -76,13 +95,46 @@ private:
 
 class NewLap {
 public:
-    NewLap(uint32_t timestamp) : timestamp(timestamp) {}
+    NewLap(uint32_t timestamp, uint16_t timestamp_fraction_us = 0, uint8_t channel = 0, const PassSignature& pass_signature = PassSignature()) :
+        timestamp(timestamp),
+        timestamp_fraction_us(timestamp_fraction_us),
+        channel(channel),
+        pass_signature(pass_signature) {}
 
     uint32_t get_timestamp() const {
         return timestamp;
     }
+
+    // Sub-millisecond part of the timestamp in range 0 - 999 us.
+    uint16_t get_timestamp_fraction_us() const {
+        return timestamp_fraction_us;
+    }
+
+    uint64_t get_timestamp_us() const {
+        return static_cast<uint64_t>(timestamp) * 1000 + timestamp_fraction_us;
+    }
+
+    // RSSI channel, which identifies the pilot.
+    uint8_t get_channel() const {
+        return channel;
+    }
+
+    const PassSignature& get_pass_signature() const {
+        return pass_signature;
+    }
+
+    bool operator==(const NewLap& other) const {
+        return timestamp == other.timestamp &&
+               timestamp_fraction_us == other.timestamp_fraction_us &&
+               channel == other.channel &&
+               pass_signature == other.pass_signature;
+    }
+
 private:
     uint32_t timestamp;
+    uint16_t timestamp_fraction_us;
+    uint8_t channel;
+    PassSignature pass_signature;
 };
 
 template<class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
@@ -103,6 +155,13 @@ typedef std::variant<
     LoadSessionRecordEvent,
     StorageResponse<LoadSessionRecordEvent>,
 
+    StartRssiCalibration,
+    RssiCalibrationFinished,
+    RssiProfileLoaded,
+    RssiSamplesAvailable,
+    RssiSummariesAvailable,
+    SetLapLockout,
+
     FlashLED,
     NewLap
 
@@ -111,4 +170,56 @@ typedef std::variant<
 // Increase if there is a need. Added here to monitor if event sizes are sane.
 static_assert(sizeof(Event) < 64);
 
+// Set of Event alternatives, bit n stands for the alternative with index n.
+typedef uint32_t EventMask;
+
+static constexpr size_t EVENT_TYPES_COUNT = std::variant_size_v<Event>;
+static_assert(EVENT_TYPES_COUNT <= sizeof(EventMask) * 8, "EventMask is too small for all events");
+
+template<typename T, typename V>
+struct EventIndex;
+
+template<typename T, typename... Ts>
+struct EventIndex<T, std::variant<T, Ts...>> {
+    static constexpr size_t value = 0;
+};
+
+template<typename T, typename U, typename... Ts>
+struct EventIndex<T, std::variant<U, Ts...>> {
+    static constexpr size_t value = 1 + EventIndex<T, std::variant<Ts...>>::value;
+};
+
+///
+/// @brief Get mask of the given Event alternatives, e.g. event_mask<StartSession, StopSession>().
+///
+template<typename... Ts>
+constexpr EventMask event_mask() {
+    return (EventMask(0) | ... | (EventMask(1) << EventIndex<Ts, Event>::value));
+}
+
+static constexpr EventMask EVENT_MASK_ALL = EVENT_TYPES_COUNT == sizeof(EventMask) * 8 ?
+    ~EventMask(0) : (EventMask(1) << EVENT_TYPES_COUNT) - 1;
+
+///
+/// @brief Latency critical events, dispatched before any background event.
+///
+/// Lap detection runs on RssiSamplesAvailable and RSSI summaries end up in BLE notifications, so
+/// they wait neither for storage nor for the LEDs. All the other events run in the background.
+///
+static constexpr EventMask EVENT_MASK_URGENT = event_mask<
+    StartSession,
+    StopSession,
+    SetLapLockout,
+    RssiSamplesAvailable,
+    RssiSummariesAvailable,
+    NewLap
+>();
+
+///
+/// @brief Check if the event is latency critical, see EVENT_MASK_URGENT.
+///
+inline bool is_urgent_event(const Event& event) {
+    return (EVENT_MASK_URGENT & (EventMask(1) << event.index())) != 0;
+}
+
 #endif // LAP_TIMER_EVENTS_H
\ No newline at end of file
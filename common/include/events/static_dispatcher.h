@@ -0,0 +1,131 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_STATIC_DISPATCHER_H
+#define LAP_TIMER_STATIC_DISPATCHER_H
+
+#include "events/event_dispatcher_interface.h"
+#include "events/events.h"
+#include "events/event_observer.h"
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+///
+/// @brief Dispatcher with observers wired at compile time.
+///
+/// Events are queued by the wrapped dispatcher, which calls this dispatcher once per event. Each
+/// event is passed to the observers, whose EVENTS contain it, with direct calls to their
+/// on_event(), so the compiler can inline the whole dispatch of every event type.
+///
+/// Observers are constructed with this dispatcher. Their register_observer() calls are accepted
+/// without changing anything, and attach() binds them once all of them exist.
+///
+/// @tparam Observers Types of the observers, called in this order.
+///
+template<typename... Observers>
+class StaticDispatcher : public EventDispatcherInterface, public EventObserver {
+public:
+    static constexpr EventMask EVENTS = (EventMask(0) | ... | Observers::EVENTS);
+
+    explicit StaticDispatcher(EventDispatcherInterface& event_dispatcher) :
+        event_dispatcher(event_dispatcher),
+        observers() {
+        event_dispatcher.register_observer(this, EVENTS);
+    }
+
+    StaticDispatcher(const StaticDispatcher&) = delete;
+    StaticDispatcher(StaticDispatcher&&) = delete;
+    StaticDispatcher& operator=(const StaticDispatcher&) = delete;
+    StaticDispatcher& operator=(StaticDispatcher&&) = delete;
+
+    ///
+    /// @brief Bind the observers, events are dropped until this is done.
+    ///
+    void attach(Observers&... observers) {
+        this->observers = std::make_tuple(&observers...);
+    }
+
+    using EventDispatcherInterface::register_observer;
+
+    ///
+    /// @brief Observers are bound by attach().
+    ///
+    /// @return true Events match one of the observer types.
+    /// @return false Observer isn't wired to this dispatcher.
+    ///
+    bool register_observer(EventObserver* observer, EventMask events) override {
+        return (false || ... || (events == Observers::EVENTS));
+    }
+
+    bool unregister_observer(EventObserver* observer) override {
+        return false;
+    }
+
+    void emit_event(const Event& event) override {
+        event_dispatcher.emit_event(event);
+    }
+
+    EventHandle emit_event_delayed(const Event& event, uint32_t ms_delay) override {
+        return event_dispatcher.emit_event_delayed(event, ms_delay);
+    }
+
+    EventHandle emit_event_at(const Event& event, uint32_t timestamp_ms) override {
+        return event_dispatcher.emit_event_at(event, timestamp_ms);
+    }
+
+    EventHandle emit_event_periodic(const Event& event, uint32_t ms_period) override {
+        return event_dispatcher.emit_event_periodic(event, ms_period);
+    }
+
+    bool cancel(EventHandle handle) override {
+        return event_dispatcher.cancel(handle);
+    }
+
+    void on_event(const Event& event) override {
+        std::visit([this, &event](const auto& alternative) {
+            dispatch<std::decay_t<decltype(alternative)>>(event, std::index_sequence_for<Observers...>());
+        }, event);
+    }
+
+private:
+    template<typename T, size_t... Indices>
+    void dispatch(const Event& event, std::index_sequence<Indices...>) {
+        (dispatch_to<T>(std::get<Indices>(observers), event), ...);
+    }
+
+    template<typename T, typename Observer>
+    static void dispatch_to(Observer* observer, const Event& event) {
+        if constexpr ((Observer::EVENTS & event_mask<T>()) != 0) {
+            if (observer) {
+                // Qualified call isn't virtual.
+                observer->Observer::on_event(event);
+            }
+        }
+    }
+
+    EventDispatcherInterface& event_dispatcher;
+    std::tuple<Observers*...> observers;
+};
+
+#endif // LAP_TIMER_STATIC_DISPATCHER_H
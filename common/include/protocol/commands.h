@@ -45,6 +45,10 @@ enum CommandRequestCode : command_id_t {
     LAST_SESSION_ID_CODE    = 0x05,
     LIST_SESSIONS_IDS_CODE  = 0x06,
     GET_SESSION_RECORD_CODE = 0x07,
+    LAP_SIGNATURE_CODE      = 0x08,
+    LATENCY_STATS_CODE      = 0x09,
+    RSSI_STREAM_CODE        = 0x0A,
+    RSSI_CALIBRATION_CODE   = 0x0B,
     COMMAND_CODE_MAX
 };
 
@@ -1079,5 +1083,570 @@ private:
     uint8_t phase;
 };
 
+// LAP SIGNATURE --------------------------------------------------------------
+
+class LapSignatureCommand : public Command<LapSignatureCommand, 4> {
+public:
+    LapSignatureCommand(session_id_t session_id, lap_id_t lap_id) :
+        id(LAP_SIGNATURE_CODE),
+        session_id(session_id),
+        lap_id(lap_id) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    session_id_t get_session_id() const {
+        return session_id;
+    }
+    lap_id_t get_lap_id() const {
+        return lap_id;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < max_length) return false;
+        buffer[0] = id;
+        write_uint16_le(session_id, buffer + 1);
+        buffer[3] = lap_id;
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < max_length) return false;
+        if (buffer[0] != id) return false;
+        session_id = read_uint16_le(buffer + 1);
+        lap_id = buffer[3];
+        return true;
+    }
+
+private:
+    command_id_t id;
+    session_id_t session_id;
+    lap_id_t lap_id;
+};
+
+class LapSignatureCommandResponse : public Command<LapSignatureCommandResponse, 18> {
+public:
+    // Lap not found.
+    LapSignatureCommandResponse() :
+        id(LAP_SIGNATURE_CODE | COMMAND_RESPONSE_BIT),
+        found(0),
+        session_id(0),
+        lap_id(0),
+        lap_time(0),
+        peak(0),
+        duration_ms(0),
+        rise_slope(0),
+        fall_slope(0),
+        confidence(0) {}
+
+    LapSignatureCommandResponse(session_id_t session_id,
+                                lap_id_t lap_id,
+                                lap_time_t lap_time,
+                                uint16_t peak,
+                                uint16_t duration_ms,
+                                uint16_t rise_slope,
+                                uint16_t fall_slope,
+                                uint8_t confidence) :
+        id(LAP_SIGNATURE_CODE | COMMAND_RESPONSE_BIT),
+        found(1),
+        session_id(session_id),
+        lap_id(lap_id),
+        lap_time(lap_time),
+        peak(peak),
+        duration_ms(duration_ms),
+        rise_slope(rise_slope),
+        fall_slope(fall_slope),
+        confidence(confidence) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    bool is_found() const {
+        return found != 0;
+    }
+    session_id_t get_session_id() const {
+        return session_id;
+    }
+    lap_id_t get_lap_id() const {
+        return lap_id;
+    }
+    lap_time_t get_lap_time() const {
+        return lap_time;
+    }
+    uint16_t get_peak() const {
+        return peak;
+    }
+    uint16_t get_duration_ms() const {
+        return duration_ms;
+    }
+    uint16_t get_rise_slope() const {
+        return rise_slope;
+    }
+    uint16_t get_fall_slope() const {
+        return fall_slope;
+    }
+    uint8_t get_confidence() const {
+        return confidence;
+    }
+
+    virtual size_t length() const override {
+        return found ? max_length : 2;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < this->length()) return false;
+        buffer[0] = id;
+        buffer[1] = found;
+        if (!found) return true;
+        write_uint16_le(session_id, buffer + 2);
+        buffer[4] = lap_id;
+        write_uint32_le(lap_time, buffer + 5);
+        write_uint16_le(peak, buffer + 9);
+        write_uint16_le(duration_ms, buffer + 11);
+        write_uint16_le(rise_slope, buffer + 13);
+        write_uint16_le(fall_slope, buffer + 15);
+        buffer[17] = confidence;
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < 2) return false;
+        if (buffer[0] != id) return false;
+        found = buffer[1];
+        if (!found) return true;
+        if (length < max_length) return false;
+        session_id = read_uint16_le(buffer + 2);
+        lap_id = buffer[4];
+        lap_time = read_uint32_le(buffer + 5);
+        peak = read_uint16_le(buffer + 9);
+        duration_ms = read_uint16_le(buffer + 11);
+        rise_slope = read_uint16_le(buffer + 13);
+        fall_slope = read_uint16_le(buffer + 15);
+        confidence = buffer[17];
+        return true;
+    }
+
+private:
+    command_id_t id;
+    uint8_t found;
+    session_id_t session_id;
+    lap_id_t lap_id;
+    lap_time_t lap_time;
+    uint16_t peak;
+    uint16_t duration_ms;
+    uint16_t rise_slope;
+    uint16_t fall_slope;
+    uint8_t confidence;
+};
+// LATENCY STATS --------------------------------------------------------------
+
+class LatencyStatsCommand : public Command<LatencyStatsCommand, 2> {
+public:
+    LatencyStatsCommand(uint8_t stage) :
+        id(LATENCY_STATS_CODE),
+        stage(stage) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    uint8_t get_stage() const {
+        return stage;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < max_length) return false;
+        buffer[0] = id;
+        buffer[1] = stage;
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < max_length) return false;
+        if (buffer[0] != id) return false;
+        stage = buffer[1];
+        return true;
+    }
+
+private:
+    command_id_t id;
+    uint8_t stage;
+};
+
+class LatencyStatsCommandResponse : public Command<LatencyStatsCommandResponse, 23> {
+public:
+    LatencyStatsCommandResponse(uint8_t stage,
+                                uint8_t priority,
+                                uint32_t count,
+                                uint32_t min_us,
+                                uint32_t p50_us,
+                                uint32_t p99_us,
+                                uint32_t max_us) :
+        id(LATENCY_STATS_CODE | COMMAND_RESPONSE_BIT),
+        stage(stage),
+        priority(priority),
+        count(count),
+        min_us(min_us),
+        p50_us(p50_us),
+        p99_us(p99_us),
+        max_us(max_us) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    uint8_t get_stage() const {
+        return stage;
+    }
+    uint8_t get_priority() const {
+        return priority;
+    }
+    uint32_t get_count() const {
+        return count;
+    }
+    uint32_t get_min_us() const {
+        return min_us;
+    }
+    uint32_t get_p50_us() const {
+        return p50_us;
+    }
+    uint32_t get_p99_us() const {
+        return p99_us;
+    }
+    uint32_t get_max_us() const {
+        return max_us;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < max_length) return false;
+        buffer[0] = id;
+        buffer[1] = stage;
+        buffer[2] = priority;
+        write_uint32_le(count, buffer + 3);
+        write_uint32_le(min_us, buffer + 7);
+        write_uint32_le(p50_us, buffer + 11);
+        write_uint32_le(p99_us, buffer + 15);
+        write_uint32_le(max_us, buffer + 19);
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < max_length) return false;
+        if (buffer[0] != id) return false;
+        stage = buffer[1];
+        priority = buffer[2];
+        count = read_uint32_le(buffer + 3);
+        min_us = read_uint32_le(buffer + 7);
+        p50_us = read_uint32_le(buffer + 11);
+        p99_us = read_uint32_le(buffer + 15);
+        max_us = read_uint32_le(buffer + 19);
+        return true;
+    }
+
+private:
+    command_id_t id;
+    uint8_t stage;
+    uint8_t priority;
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+};
+
+// RSSI STREAM ----------------------------------------------------------------
+
+// Summary rates accepted by RssiStreamCommand, 0 stops the stream.
+#define RSSI_STREAM_MIN_RATE_HZ 10
+#define RSSI_STREAM_MAX_RATE_HZ 200
+
+class RssiStreamCommand : public Command<RssiStreamCommand, 3> {
+public:
+    RssiStreamCommand(uint8_t channel, uint8_t rate_hz) :
+        id(RSSI_STREAM_CODE),
+        channel(channel),
+        rate_hz(rate_hz) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    uint8_t get_channel() const {
+        return channel;
+    }
+    uint8_t get_rate_hz() const {
+        return rate_hz;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < max_length) return false;
+        buffer[0] = id;
+        buffer[1] = channel;
+        buffer[2] = rate_hz;
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < max_length) return false;
+        if (buffer[0] != id) return false;
+        channel = buffer[1];
+        rate_hz = buffer[2];
+        return true;
+    }
+
+private:
+    command_id_t id;
+    uint8_t channel;
+    uint8_t rate_hz;
+};
+
+// Rate 0 means the stream is stopped or the request was rejected.
+class RssiStreamCommandResponse : public Command<RssiStreamCommandResponse, 3> {
+public:
+    RssiStreamCommandResponse(uint8_t channel, uint8_t rate_hz) :
+        id(RSSI_STREAM_CODE | COMMAND_RESPONSE_BIT),
+        channel(channel),
+        rate_hz(rate_hz) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    uint8_t get_channel() const {
+        return channel;
+    }
+    uint8_t get_rate_hz() const {
+        return rate_hz;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < max_length) return false;
+        buffer[0] = id;
+        buffer[1] = channel;
+        buffer[2] = rate_hz;
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < max_length) return false;
+        if (buffer[0] != id) return false;
+        channel = buffer[1];
+        rate_hz = buffer[2];
+        return true;
+    }
+
+private:
+    command_id_t id;
+    uint8_t channel;
+    uint8_t rate_hz;
+};
+
+struct RssiStreamSummary {
+    uint16_t min;
+    uint16_t max;
+    uint16_t mean;
+
+    bool operator==(const RssiStreamSummary& other) const {
+        return min == other.min && max == other.max && mean == other.mean;
+    }
+};
+
+///
+/// @brief Consecutive RSSI summaries sent as a notification of the stream characteristic.
+///
+/// Summary i covers period_us starting at first_time_ms + i * period_us / 1000. Sequence
+/// increments with every notification, so the client can tell when notifications were lost.
+///
+template<uint8_t MAX_SUMMARIES>
+class RssiStreamNotification : public Command<RssiStreamNotification<MAX_SUMMARIES>, 13 + MAX_SUMMARIES * 6> {
+public:
+    static constexpr size_t header_length = 13;
+    static constexpr size_t summary_length = 6;
+
+    RssiStreamNotification() :
+        id(RSSI_STREAM_CODE | COMMAND_INDICATION_BIT),
+        channel(0),
+        sequence(0),
+        first_time_ms(0),
+        period_us(0),
+        summaries(),
+        summary_count(0) {}
+
+    RssiStreamNotification(uint8_t channel, uint16_t sequence, uint32_t first_time_ms, uint32_t period_us) :
+        id(RSSI_STREAM_CODE | COMMAND_INDICATION_BIT),
+        channel(channel),
+        sequence(sequence),
+        first_time_ms(first_time_ms),
+        period_us(period_us),
+        summaries(),
+        summary_count(0) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    uint8_t get_channel() const {
+        return channel;
+    }
+    uint16_t get_sequence() const {
+        return sequence;
+    }
+    uint32_t get_first_time_ms() const {
+        return first_time_ms;
+    }
+    uint32_t get_period_us() const {
+        return period_us;
+    }
+    const RssiStreamSummary* get_summaries() const {
+        return summaries;
+    }
+    uint8_t get_summary_count() const {
+        return summary_count;
+    }
+
+    ///
+    /// @brief Append a summary.
+    ///
+    /// @return true Summary was added.
+    /// @return false Notification already has MAX_SUMMARIES summaries.
+    ///
+    bool add_summary(const RssiStreamSummary& summary) {
+        if (summary_count == MAX_SUMMARIES) return false;
+        summaries[summary_count++] = summary;
+        return true;
+    }
+
+    virtual size_t length() const override {
+        return header_length + summary_count * summary_length;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < this->length()) return false;
+        buffer[0] = id;
+        buffer[1] = channel;
+        write_uint16_le(sequence, buffer + 2);
+        write_uint32_le(first_time_ms, buffer + 4);
+        write_uint32_le(period_us, buffer + 8);
+        buffer[12] = summary_count;
+        for (size_t i = 0; i < summary_count; i++) {
+            uint8_t* summary = buffer + header_length + i * summary_length;
+            write_uint16_le(summaries[i].min, summary);
+            write_uint16_le(summaries[i].max, summary + 2);
+            write_uint16_le(summaries[i].mean, summary + 4);
+        }
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < header_length) return false;
+        if (buffer[0] != id) return false;
+        if (buffer[12] > MAX_SUMMARIES) return false;
+        if (length < header_length + buffer[12] * summary_length) return false;
+        channel = buffer[1];
+        sequence = read_uint16_le(buffer + 2);
+        first_time_ms = read_uint32_le(buffer + 4);
+        period_us = read_uint32_le(buffer + 8);
+        summary_count = buffer[12];
+        for (size_t i = 0; i < summary_count; i++) {
+            const uint8_t* summary = buffer + header_length + i * summary_length;
+            summaries[i].min = read_uint16_le(summary);
+            summaries[i].max = read_uint16_le(summary + 2);
+            summaries[i].mean = read_uint16_le(summary + 4);
+        }
+        return true;
+    }
+
+private:
+    command_id_t id;
+    uint8_t channel;
+    uint16_t sequence;
+    uint32_t first_time_ms;
+    uint32_t period_us;
+    RssiStreamSummary summaries[MAX_SUMMARIES];
+    uint8_t summary_count;
+};
+
+// RSSI CALIBRATION -----------------------------------------------------------
+
+class RssiCalibrationCommand : public Command<RssiCalibrationCommand, 5> {
+public:
+    RssiCalibrationCommand(uint32_t duration_ms) :
+        id(RSSI_CALIBRATION_CODE),
+        duration_ms(duration_ms) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    uint32_t get_duration_ms() const {
+        return duration_ms;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < max_length) return false;
+        buffer[0] = id;
+        write_uint32_le(duration_ms, buffer + 1);
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < max_length) return false;
+        if (buffer[0] != id) return false;
+        duration_ms = read_uint32_le(buffer + 1);
+        return true;
+    }
+
+private:
+    command_id_t id;
+    uint32_t duration_ms;
+};
+
+// Sent for every channel once its calibration finished.
+class RssiCalibrationCommandResponse : public Command<RssiCalibrationCommandResponse, 7> {
+public:
+    RssiCalibrationCommandResponse(uint8_t channel, bool successful, uint16_t noise_floor, uint16_t peak) :
+        id(RSSI_CALIBRATION_CODE | COMMAND_RESPONSE_BIT),
+        channel(channel),
+        successful(successful),
+        noise_floor(noise_floor),
+        peak(peak) {}
+
+    command_id_t get_id() const {
+        return id;
+    }
+    uint8_t get_channel() const {
+        return channel;
+    }
+    bool is_successful() const {
+        return successful;
+    }
+    uint16_t get_noise_floor() const {
+        return noise_floor;
+    }
+    uint16_t get_peak() const {
+        return peak;
+    }
+
+    virtual bool serialize(uint8_t* buffer, size_t length) const override {
+        if (length < max_length) return false;
+        buffer[0] = id;
+        buffer[1] = channel;
+        buffer[2] = successful ? 0x01 : 0x00;
+        write_uint16_le(noise_floor, buffer + 3);
+        write_uint16_le(peak, buffer + 5);
+        return true;
+    }
+
+    virtual bool deserialize(const uint8_t* buffer, size_t length) override {
+        if (length < max_length) return false;
+        if (buffer[0] != id) return false;
+        channel = buffer[1];
+        successful = buffer[2] != 0x00;
+        noise_floor = read_uint16_le(buffer + 3);
+        peak = read_uint16_le(buffer + 5);
+        return true;
+    }
+
+private:
+    command_id_t id;
+    uint8_t channel;
+    bool successful;
+    uint16_t noise_floor;
+    uint16_t peak;
+};
 
 #endif // LAP_TIMER_COMMANDS_H
\ No newline at end of file
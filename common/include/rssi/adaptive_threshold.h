@@ -0,0 +1,152 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_ADAPTIVE_THRESHOLD_H
+#define LAP_TIMER_ADAPTIVE_THRESHOLD_H
+
+#include <cstdint>
+
+#include "rssi/rssi_profile.h"
+
+///
+/// @brief Derives gate pass thresholds from a running estimate of the noise floor and the pass peak.
+///
+/// Pass starts when RSSI rises above the enter threshold and lasts until it falls below
+/// the lower exit threshold. Both thresholds are placed between the noise floor and the peak:
+///
+///     enter = floor + span * enter_level_percent / 100
+///     exit  = floor + span * exit_level_percent / 100
+///
+/// Levels default to ENTER_LEVEL_PERCENT and EXIT_LEVEL_PERCENT.
+///
+/// Lower approach threshold (APPROACH_LEVEL_PERCENT) is only a hint that a drone is getting close.
+///
+/// Noise floor follows samples outside of passes with a time constant expressed in milliseconds,
+/// so it behaves the same for every sampling rate. Peak is updated after each detected pass.
+///
+/// In calibration mode the profile is measured from scratch over a given period, during which
+/// a drone should fly through the gate at least once.
+///
+class AdaptiveThreshold {
+public:
+    static constexpr uint8_t ENTER_LEVEL_PERCENT = 50;
+    static constexpr uint8_t EXIT_LEVEL_PERCENT = 35;
+    static constexpr uint8_t APPROACH_LEVEL_PERCENT = 15;
+    // Smallest distance between the floor and the peak which is considered a gate pass.
+    static constexpr uint16_t MIN_SPAN = 4000;
+    static constexpr uint32_t NOISE_FLOOR_TIME_CONSTANT_MS = 2000;
+    // Each pass moves the peak estimate by 1 / 2^PEAK_UPDATE_SHIFT towards the pass peak.
+    static constexpr uint8_t PEAK_UPDATE_SHIFT = 2;
+
+    // Profile used until a calibrated one is loaded.
+    static constexpr uint16_t DEFAULT_NOISE_FLOOR = 23000;
+    static constexpr uint16_t DEFAULT_PEAK = 49200;
+
+    AdaptiveThreshold();
+
+    ///
+    /// @brief Set interval between consecutive samples. Required to convert milliseconds to samples.
+    ///
+    /// Interval may change while tracking, calibration keeps its remaining duration.
+    ///
+    void set_sample_interval_us(uint32_t sample_interval_us);
+
+    ///
+    /// @brief Convert duration to the number of samples at the current sampling rate.
+    ///
+    uint32_t ms_to_samples(uint32_t duration_ms) const;
+
+    void set_profile(const RssiProfile& profile);
+    RssiProfile get_profile() const;
+
+    ///
+    /// @brief Set position of the thresholds between the noise floor and the peak.
+    ///
+    /// @param enter_level_percent Level of the enter threshold.
+    /// @param exit_level_percent Level of the exit threshold, at most enter_level_percent.
+    ///
+    void set_levels(uint8_t enter_level_percent, uint8_t exit_level_percent);
+
+    uint16_t get_enter_threshold() const {
+        return enter_threshold;
+    }
+
+    uint16_t get_exit_threshold() const {
+        return exit_threshold;
+    }
+
+    uint16_t get_approach_threshold() const {
+        return approach_threshold;
+    }
+
+    ///
+    /// @brief Track a sample which is not a part of a gate pass.
+    ///
+    /// @param sample Filtered sample value.
+    /// @return true Calibration has finished with this sample.
+    ///
+    bool track(uint16_t sample);
+
+    ///
+    /// @brief Update peak estimate with the highest sample of a detected pass.
+    ///
+    void add_pass_peak(uint16_t peak_value);
+
+    ///
+    /// @brief Start measuring the profile. Thresholds are not valid until calibration finishes.
+    ///
+    void start_calibration(uint32_t duration_ms);
+
+    bool is_calibrating() const {
+        return calibration_samples_left > 0;
+    }
+
+    ///
+    /// @brief Check result of the last calibration. Profile is left intact if calibration failed.
+    ///
+    bool is_calibration_successful() const {
+        return calibration_successful;
+    }
+
+private:
+    void update_thresholds();
+
+    uint32_t sample_interval_us;
+    // Noise floor with 16 fractional bits.
+    uint32_t noise_floor;
+    // Filter coefficient with 24 fractional bits.
+    uint32_t noise_floor_alpha;
+    uint16_t peak;
+    uint8_t enter_level_percent;
+    uint8_t exit_level_percent;
+    uint16_t enter_threshold;
+    uint16_t exit_threshold;
+    uint16_t approach_threshold;
+
+    uint32_t calibration_samples_left;
+    uint16_t calibration_min;
+    uint16_t calibration_max;
+    bool calibration_successful;
+};
+
+#endif // LAP_TIMER_ADAPTIVE_THRESHOLD_H
@@ -0,0 +1,108 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_BUFFERED_RSSI_READER_DELEGATE_H
+#define LAP_TIMER_BUFFERED_RSSI_READER_DELEGATE_H
+
+#include "rssi/rssi_reader_interface.h"
+#include "events/event_dispatcher_interface.h"
+#include "events/events.h"
+#include "events/event_observer.h"
+#include "utils/spsc_ring.h"
+#include "trace/latency_tracer.h"
+
+#include <atomic>
+
+///
+/// @brief Moves processing of captured samples from the interrupt to the event loop.
+///
+/// Blocks passed by RssiReader are only copied into a lock-free ring and a single
+/// RssiSamplesAvailable event is emitted until the ring is drained. Queued blocks are passed
+/// to the wrapped delegate in bulk, when the event is handled by the event loop.
+///
+class BufferedRssiReaderDelegate : public RssiReaderInterface::Delegate, public EventObserver {
+public:
+    static constexpr EventMask EVENTS = event_mask<RssiSamplesAvailable>();
+
+    // Longer blocks are queued in parts.
+    static constexpr size_t MAX_BLOCK_LENGTH = 32;
+    // Number of queued blocks of all channels, 64 blocks keep 0.8s of a single channel sampled at 400us.
+    static constexpr size_t BLOCKS_COUNT = 64;
+
+    explicit BufferedRssiReaderDelegate(EventDispatcherInterface& event_dispatcher, RssiReaderInterface::Delegate& delegate);
+
+    void on_initialized(RssiReaderInterface& rssi_reader) override;
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override;
+
+    void on_event(const Event& event) override;
+
+    ///
+    /// @brief Pass all queued blocks to the wrapped delegate.
+    ///
+    /// @return size_t Number of passed blocks.
+    ///
+    size_t process_queued_blocks();
+
+    ///
+    /// @brief Timestamp queued blocks for the tracer, nullptr disables tracing.
+    ///
+    /// @note Has to be set before the reader is initialized.
+    ///
+    void set_latency_tracer(LatencyTracer* latency_tracer) {
+        this->latency_tracer = latency_tracer;
+    }
+
+    ///
+    /// @brief Get number of blocks dropped because the event loop didn't keep up.
+    ///
+    uint32_t get_overflows() const {
+        return blocks.get_overflows();
+    }
+
+    ///
+    /// @brief Get the largest number of blocks waiting for processing at once.
+    ///
+    size_t get_high_water_mark() const {
+        return blocks.get_high_water_mark();
+    }
+
+private:
+    struct Block {
+        uint8_t channel;
+        uint8_t count;
+        uint8_t tick_stride;
+        uint8_t captured_priority;
+        uint32_t first_sample_tick;
+        uint32_t captured_cycles;
+        uint16_t samples[MAX_BLOCK_LENGTH];
+    };
+
+    EventDispatcherInterface& event_dispatcher;
+    RssiReaderInterface::Delegate& delegate;
+    SpscRing<Block, BLOCKS_COUNT> blocks;
+    std::atomic<bool> processing_scheduled;
+    uint32_t reported_overflows;
+    LatencyTracer* latency_tracer;
+};
+
+#endif // LAP_TIMER_BUFFERED_RSSI_READER_DELEGATE_H
@@ -0,0 +1,138 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_GATE_PASS_ESTIMATOR_H
+#define LAP_TIMER_GATE_PASS_ESTIMATOR_H
+
+#include <cstdint>
+
+///
+/// @brief Estimates the moment of a gate pass from samples of a single excursion above
+///        the threshold.
+///
+/// Excursion is accumulated incrementally, so the estimator doesn't need to store samples.
+/// Estimate is expressed in sample ticks with 16 fractional bits, which makes it independent
+/// of the sampling rate and gives sub-sample resolution.
+///
+class GatePassEstimator {
+public:
+    enum Method : uint8_t {
+        // Tick of the maximum RSSI, refined by a parabola fitted to its neighbours.
+        GATE_PASS_METHOD_PEAK     = 0x00,
+        // Tick of the centroid of the energy above the threshold.
+        GATE_PASS_METHOD_CENTROID = 0x01,
+    };
+
+    static constexpr uint8_t TICK_FRACTION_BITS = 16;
+
+    explicit GatePassEstimator(Method method = GATE_PASS_METHOD_CENTROID);
+
+    ///
+    /// @brief Start a new excursion.
+    ///
+    /// @param threshold Threshold above which samples are accumulated.
+    ///
+    void reset(uint16_t threshold);
+
+    ///
+    /// @brief Add a sample of the current excursion. Ticks must be increasing.
+    ///
+    /// @param sample Filtered sample value.
+    /// @param tick Tick of the sample.
+    /// @param tick_span Ticks between this and the next sample. Centroid weights samples by it,
+    ///        so passes sampled at changing rates are not biased towards the denser part.
+    ///
+    void add_sample(uint16_t sample, uint32_t tick, uint32_t tick_span = 1);
+
+    ///
+    /// @brief Check if any sample was added since the last reset.
+    ///
+    bool is_empty() const {
+        return samples_count == 0;
+    }
+
+    ///
+    /// @brief Get the highest sample value of the current excursion.
+    ///
+    uint16_t get_peak_value() const {
+        return peak_value;
+    }
+
+    uint16_t get_threshold() const {
+        return threshold;
+    }
+
+    uint32_t get_first_tick() const {
+        return first_tick;
+    }
+
+    ///
+    /// @brief Get tick following the span of the last sample.
+    ///
+    uint32_t get_end_tick() const {
+        return end_tick;
+    }
+
+    ///
+    /// @brief Get first tick of the peak, which may be a plateau.
+    ///
+    uint32_t get_peak_first_tick() const {
+        return peak_first_tick;
+    }
+
+    uint32_t get_peak_last_tick() const {
+        return peak_last_tick;
+    }
+
+    ///
+    /// @brief Get estimated tick of the gate pass.
+    ///
+    /// @return uint64_t Tick with TICK_FRACTION_BITS fractional bits.
+    ///
+    uint64_t get_pass_tick() const;
+
+private:
+    uint64_t get_peak_tick() const;
+    uint64_t get_centroid_tick() const;
+
+    Method method;
+    uint16_t threshold;
+    uint32_t samples_count;
+    uint32_t first_tick;
+    uint32_t end_tick;
+
+    // Centroid accumulators, ticks are relative to the first tick and counted in halves.
+    uint64_t weight_sum;
+    uint64_t weighted_tick_sum;
+
+    // Peak tracking. Peak may be a plateau of equal samples.
+    uint16_t last_sample;
+    uint16_t peak_value;
+    uint16_t before_peak_value;
+    uint16_t after_peak_value;
+    uint32_t peak_first_tick;
+    uint32_t peak_last_tick;
+    bool after_peak_pending;
+};
+
+#endif // LAP_TIMER_GATE_PASS_ESTIMATOR_H
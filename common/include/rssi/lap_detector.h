@@ -0,0 +1,194 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_LAP_DETECTOR_H
+#define LAP_TIMER_LAP_DETECTOR_H
+
+#include <cstdint>
+
+#include "rssi/adaptive_threshold.h"
+#include "rssi/gate_pass_estimator.h"
+#include "rssi/pass_signature.h"
+
+///
+/// @brief Detects gate passes in the RSSI of a single video receiver.
+///
+/// Detector works on filtered samples and their ticks only, filtering, conversion to timestamps
+/// and reporting is left to the user.
+///
+class LapDetector {
+public:
+    enum Result : uint8_t {
+        LAP_DETECTOR_RESULT_NONE                 = 0x00,
+        // Gate pass was detected, see get_lap_tick().
+        LAP_DETECTOR_RESULT_LAP                  = 0x01,
+        // Calibration has finished, see is_calibration_successful() and get_profile().
+        LAP_DETECTOR_RESULT_CALIBRATION_FINISHED = 0x02,
+    };
+
+    // Minimum time above the threshold for the excursion to be considered a gate pass.
+    static constexpr uint32_t PASS_MIN_TIME_MS = 80;
+    // Passes are closed after this time, even if the drone stays in the gate.
+    static constexpr uint32_t PASS_MAX_TIME_MS = 2000;
+    // Time below the exit threshold after a lap, before a next lap can be detected.
+    static constexpr uint32_t REARM_TIME_MS = 8000;
+    // With lockout, time below the exit threshold after the lockout is the same as of a shortest pass.
+    static constexpr uint32_t LOCKOUT_REARM_TIME_MS = PASS_MIN_TIME_MS;
+    // Passes shorter than this have lower confidence.
+    static constexpr uint32_t CONFIDENT_PASS_TIME_MS = 2 * PASS_MIN_TIME_MS;
+
+    ///
+    /// @brief Detection tuning, defaults are the constants above.
+    ///
+    struct Parameters {
+        uint8_t enter_level_percent = AdaptiveThreshold::ENTER_LEVEL_PERCENT;
+        uint8_t exit_level_percent = AdaptiveThreshold::EXIT_LEVEL_PERCENT;
+        uint32_t pass_min_time_ms = PASS_MIN_TIME_MS;
+        uint32_t rearm_time_ms = REARM_TIME_MS;
+    };
+
+    LapDetector();
+
+    ///
+    /// @brief Set interval between consecutive processed samples, it has to be called before processing samples.
+    ///
+    /// Interval may change between samples, e.g. with a different sample stride. Pass in progress
+    /// keeps its duration measured so far.
+    ///
+    void set_sample_interval_us(uint32_t sample_interval_us);
+
+    ///
+    /// @brief Replace detection tuning, e.g. with one found by rssi_sweep.
+    ///
+    void set_parameters(const Parameters& parameters);
+
+    const Parameters& get_parameters() const {
+        return parameters;
+    }
+
+    ///
+    /// @brief Set minimum lap time, no lap is detected until this many ticks after the previous one.
+    ///
+    /// Samples during the lockout may be skipped, e.g. if sampling is suspended. Without lockout,
+    /// a next lap requires REARM_TIME_MS below the exit threshold instead.
+    ///
+    /// @param lockout_ticks Lockout length in ticks, 0 disables the lockout.
+    ///
+    void set_lockout_ticks(uint32_t lockout_ticks);
+
+    ///
+    /// @brief Check if the detector waits for the lockout after a lap to end.
+    ///
+    bool is_locked_out() const {
+        return in_checkpoint && lockout_ticks > 0;
+    }
+
+    ///
+    /// @brief Check if the detector waits for a pass, so samples below get_wakeup_level() may be skipped.
+    ///
+    bool is_idle() const {
+        return !in_checkpoint && checkpoint_threshold_counter == 0 && !adaptive_threshold.is_calibrating();
+    }
+
+    ///
+    /// @brief Get level above which samples have to be processed to catch the whole pass.
+    ///
+    uint16_t get_wakeup_level() const {
+        return adaptive_threshold.get_exit_threshold();
+    }
+
+    ///
+    /// @brief Get level above which a drone is likely approaching the gate, below any pass.
+    ///
+    uint16_t get_approach_level() const {
+        return adaptive_threshold.get_approach_threshold();
+    }
+
+    ///
+    /// @brief Get tick at which the lockout after the last lap ends.
+    ///
+    uint32_t get_lockout_end_tick() const {
+        return lockout_end_tick;
+    }
+
+    void set_profile(const RssiProfile& profile);
+    RssiProfile get_profile() const;
+
+    void start_calibration(uint32_t duration_ms);
+    bool is_calibration_successful() const;
+
+    ///
+    /// @brief Process a filtered sample.
+    ///
+    /// @param filtered_sample Sample normalized to 16 bits precision.
+    /// @param tick Tick of the sample.
+    /// @param tick_span Ticks between this and the next sample, see GatePassEstimator::add_sample().
+    /// @return Result Event detected with this sample.
+    ///
+    Result process_sample(uint16_t filtered_sample, uint32_t tick, uint32_t tick_span = 1);
+
+    ///
+    /// @brief Get tick of the last detected lap.
+    ///
+    /// @return uint64_t Tick with GatePassEstimator::TICK_FRACTION_BITS fractional bits.
+    ///
+    uint64_t get_lap_tick() const {
+        return lap_tick;
+    }
+
+    ///
+    /// @brief Get signature of the pass of the last detected lap.
+    ///
+    /// Confidence starts from the peak height relative to the expected one, it's scaled down
+    /// for passes shorter than CONFIDENT_PASS_TIME_MS and halved for passes closed after
+    /// PASS_MAX_TIME_MS, when the drone likely stayed near the gate.
+    ///
+    /// @param tick_interval_us Interval between ticks, to express times in milliseconds.
+    ///
+    PassSignature get_pass_signature(uint32_t tick_interval_us) const;
+
+private:
+    Result finish_pass(bool closed_by_timeout);
+    uint32_t rescale_samples(uint32_t samples, uint32_t new_sample_interval_us) const;
+    void update_sample_counts();
+    void reset_state();
+
+    GatePassEstimator gate_pass_estimator;
+    AdaptiveThreshold adaptive_threshold;
+    Parameters parameters;
+    uint32_t sample_interval_us;
+    uint32_t pass_min_samples;
+    uint32_t pass_max_samples;
+    uint32_t rearm_samples;
+    uint32_t lockout_rearm_samples;
+    uint32_t lockout_ticks;
+    uint32_t lockout_end_tick;
+
+    bool in_checkpoint;
+    uint32_t checkpoint_threshold_counter;
+    uint32_t track_threshold_counter;
+    uint64_t lap_tick;
+    uint8_t pass_confidence;
+};
+
+#endif // LAP_TIMER_LAP_DETECTOR_H
@@ -0,0 +1,100 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_MATCHED_FILTER_RSSI_READER_DELEGATE_H
+#define LAP_TIMER_MATCHED_FILTER_RSSI_READER_DELEGATE_H
+
+#include "time/real_time_clock_interface.h"
+#include "events/event_dispatcher_interface.h"
+#include "events/events.h"
+#include "events/event_observer.h"
+#include "rssi/pass_correlator.h"
+#include "rssi/rssi_reader_delegate.h"
+#include "trace/latency_tracer.h"
+
+#include <array>
+#include <atomic>
+
+class CalibrationStorage;
+
+///
+/// @brief Alternative to RssiReaderDelegate, detects laps at peaks of correlation with a pass template.
+///
+/// Samples of each channel are filtered with RssiReaderPipeline and passed to a PassCorrelator.
+/// RSSI calibration learns the template from the first pass instead of measuring the profile.
+/// Learned templates are saved through CalibrationStorage and loaded from it once Session Storage is
+/// initialized, loaded profiles are not used. Sampling is never suspended nor slowed down.
+///
+class MatchedFilterRssiReaderDelegate : public RssiReaderInterface::Delegate, public EventObserver {
+public:
+    static constexpr EventMask EVENTS = event_mask<SessionStorageInitialized, StartRssiCalibration, RssiCalibrationFinished, SetLapLockout>();
+
+    explicit MatchedFilterRssiReaderDelegate(RealTimeClockInterface& clock, EventDispatcherInterface& event_dispatcher);
+    void on_initialized(RssiReaderInterface& rssi_reader) override;
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override;
+
+    void on_event(const Event& event) override;
+
+    ///
+    /// @brief Mark detected laps in the tracer, nullptr disables tracing.
+    ///
+    void set_latency_tracer(LatencyTracer* latency_tracer);
+
+    ///
+    /// @brief Keep learned pass templates across reboots, nullptr disables it.
+    ///
+    /// @note Has to be set before the event loop starts.
+    ///
+    void set_calibration_storage(CalibrationStorage* calibration_storage);
+
+private:
+    void apply_pending_requests();
+    void emit_new_lap(uint8_t channel);
+    void finish_learning(uint8_t channel);
+    void load_pass_templates();
+    uint32_t ms_to_ticks(uint32_t ms) const;
+
+    RealTimeClockInterface& clock;
+    EventDispatcherInterface& event_dispatcher;
+    uint32_t first_sample_timestamp_ms;
+    uint32_t sample_interval_us;
+    uint8_t channels_count;
+    std::array<RssiReaderPipeline, RssiReaderInterface::MAX_CHANNELS_COUNT> pipelines;
+    std::array<PassCorrelator, RssiReaderInterface::MAX_CHANNELS_COUNT> correlators;
+    // Tick expected in the next block of each channel, a different one means that samples were skipped.
+    std::array<uint32_t, RssiReaderInterface::MAX_CHANNELS_COUNT> next_ticks;
+    LatencyTracer* latency_tracer;
+    CalibrationStorage* calibration_storage;
+    // Copied by the sampling context when learning finishes, saved by the event loop.
+    std::array<PassTemplate, RssiReaderInterface::MAX_CHANNELS_COUNT> learned_templates;
+
+    // Requests come from the event loop and are applied by the sampling context between blocks.
+    uint32_t pending_calibration_ms;
+    std::atomic<bool> pending_calibration_ready;
+    uint32_t pending_lockout_ms;
+    std::atomic<bool> pending_lockout_ready;
+    std::array<PassTemplate, RssiReaderInterface::MAX_CHANNELS_COUNT> pending_templates;
+    // Bit per channel with a template ready in pending_templates.
+    std::atomic<uint8_t> pending_templates_ready;
+};
+
+#endif // LAP_TIMER_MATCHED_FILTER_RSSI_READER_DELEGATE_H
@@ -0,0 +1,195 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_PASS_CORRELATOR_H
+#define LAP_TIMER_PASS_CORRELATOR_H
+
+#include <array>
+#include <cstdint>
+
+#include "rssi/gate_pass_estimator.h"
+#include "rssi/pass_signature.h"
+#include "rssi/pass_template.h"
+#include "rssi/rssi_profile.h"
+
+///
+/// @brief Detects gate passes in the RSSI of a single video receiver by matching them with a pass template.
+///
+/// Filtered samples are averaged into bins of BIN_TIME_MS, and the last TEMPLATE_LENGTH bins are
+/// correlated with the template using normalized cross-correlation:
+///
+///     correlation = sum((x - mean(x)) * t) / sqrt(sum((x - mean(x))^2))
+///
+/// where the template t is kept with zero mean and unit norm. Correlation doesn't depend on the
+/// level or the height of the pass, so it keeps working when the noise floor rises. To ignore noise
+/// which happens to have the shape of a pass, the window has to deviate at least MIN_DEVIATION.
+/// Bins average out receiver noise and prop ripple well below it.
+///
+/// Lap is reported at the correlation peak, interpolated between bins. Template starts as the path
+/// loss of a drone passing close to the antenna and follows the shape of detected passes.
+///
+class PassCorrelator {
+public:
+    enum Result : uint8_t {
+        PASS_CORRELATOR_RESULT_NONE              = 0x00,
+        // Gate pass was detected, see get_lap_tick().
+        PASS_CORRELATOR_RESULT_LAP               = 0x01,
+        // Template learning has finished, see is_learning_successful() and get_profile().
+        PASS_CORRELATOR_RESULT_LEARNING_FINISHED = 0x02,
+    };
+
+    // Samples averaged into one correlated value.
+    static constexpr uint32_t BIN_TIME_MS = 8;
+    // Bins of the template and the correlated window.
+    static constexpr uint8_t TEMPLATE_LENGTH = PassTemplate::LENGTH;
+    // Correlation required for a lap.
+    static constexpr float DETECTION_CORRELATION = 0.8f;
+    // Correlation required for a pass to replace the template while learning.
+    static constexpr float LEARNING_CORRELATION = 0.6f;
+    // Weight of a detected pass in the template.
+    static constexpr float TEMPLATE_ADAPTATION_RATE = 0.125f;
+    // Standard deviation of a window with a pass, in RSSI normalized to 16 bits.
+    static constexpr float MIN_DEVIATION = 400.0f;
+    // Time for the drone to get from the closest point as far again, shapes the default template.
+    static constexpr uint32_t DEFAULT_PASS_TIME_CONSTANT_MS = 75;
+
+    PassCorrelator();
+
+    ///
+    /// @brief Set interval of ticks, bins keep their length in time.
+    ///
+    void set_sample_interval_us(uint32_t sample_interval_us);
+
+    ///
+    /// @brief Forget the window, e.g. after samples were skipped.
+    ///
+    void reset();
+
+    ///
+    /// @brief Set minimum lap time, no lap is detected until this many ticks after the previous one.
+    ///
+    /// @param lockout_ticks Lockout length in ticks, 0 disables the lockout.
+    ///
+    void set_lockout_ticks(uint32_t lockout_ticks);
+
+    ///
+    /// @brief Learn the template from the first pass in the given time, no laps are reported meanwhile.
+    ///
+    void start_learning(uint32_t duration_ms);
+    bool is_learning_successful() const;
+
+    ///
+    /// @brief Get the lowest and the highest bin of the learned pass.
+    ///
+    RssiProfile get_profile() const;
+
+    ///
+    /// @brief Process a filtered sample.
+    ///
+    /// @param filtered_sample Sample normalized to 16 bits precision.
+    /// @param tick Tick of the sample.
+    /// @return Result Event detected with this sample.
+    ///
+    Result process_sample(uint16_t filtered_sample, uint32_t tick);
+
+    ///
+    /// @brief Get tick of the last detected lap.
+    ///
+    /// @return uint64_t Tick with GatePassEstimator::TICK_FRACTION_BITS fractional bits.
+    ///
+    uint64_t get_lap_tick() const {
+        return lap_tick;
+    }
+
+    ///
+    /// @brief Get signature of the pass of the last detected lap.
+    ///
+    /// Duration is the time above the middle between the lowest and the highest bin of the window,
+    /// slopes are measured from there to the peak. Confidence is the correlation.
+    ///
+    PassSignature get_pass_signature() const;
+
+    ///
+    /// @brief Get correlation of the last complete window.
+    ///
+    float get_correlation() const {
+        return correlation;
+    }
+
+    const std::array<float, TEMPLATE_LENGTH>& get_template() const {
+        return pass_template;
+    }
+
+    ///
+    /// @brief Get the template quantized for storage.
+    ///
+    PassTemplate get_pass_template() const;
+
+    ///
+    /// @brief Replace the template, e.g. with the one learned before reboot.
+    ///
+    void set_pass_template(const PassTemplate& stored_template);
+
+private:
+    using Window = std::array<float, TEMPLATE_LENGTH>;
+
+    static void normalize(Window& window);
+    Result process_bin(float bin, uint32_t bin_start_tick);
+    Result finish_peak();
+    Window get_window() const;
+
+    uint32_t bin_ticks;
+    uint32_t bin_start_tick;
+    uint32_t bin_sum;
+    uint16_t bin_samples;
+    bool bin_started;
+    Window bins;
+    uint8_t oldest_bin;
+    uint8_t bins_count;
+    Window pass_template;
+    float correlation;
+    float previous_correlation;
+
+    bool in_peak;
+    float best_correlation;
+    float before_best_correlation;
+    float after_best_correlation;
+    uint8_t bins_since_best;
+    // Tick in the middle of the window with the best correlation.
+    uint32_t best_center_tick;
+    Window best_window;
+
+    uint32_t lockout_ticks;
+    // Ticks of windows overlapping the last pass are ignored, as well as those during the lockout.
+    bool lap_detected;
+    uint32_t next_lap_tick;
+    uint64_t lap_tick;
+    float lap_correlation;
+    Window lap_window;
+
+    bool learning;
+    uint32_t learning_end_tick;
+    uint32_t learning_ticks;
+    bool learning_successful;
+};
+
+#endif // LAP_TIMER_PASS_CORRELATOR_H
@@ -0,0 +1,88 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_PASS_SIGNATURE_H
+#define LAP_TIMER_PASS_SIGNATURE_H
+
+#include <cstdint>
+
+///
+/// @brief Compact description of the RSSI excursion of a gate pass, to audit lap quality.
+///
+/// Slopes are measured from the exit threshold to the peak and back, in RSSI units normalized
+/// to 16 bits per millisecond. Confidence is 0 - 100 %, see LapDetector::get_pass_signature().
+///
+class PassSignature {
+public:
+    PassSignature() :
+        peak(0),
+        duration_ms(0),
+        rise_slope(0),
+        fall_slope(0),
+        confidence(0) {}
+
+    PassSignature(uint16_t peak, uint16_t duration_ms, uint16_t rise_slope, uint16_t fall_slope, uint8_t confidence) :
+        peak(peak),
+        duration_ms(duration_ms),
+        rise_slope(rise_slope),
+        fall_slope(fall_slope),
+        confidence(confidence) {}
+
+    uint16_t get_peak() const {
+        return peak;
+    }
+
+    // Time above the exit threshold.
+    uint16_t get_duration_ms() const {
+        return duration_ms;
+    }
+
+    uint16_t get_rise_slope() const {
+        return rise_slope;
+    }
+
+    uint16_t get_fall_slope() const {
+        return fall_slope;
+    }
+
+    uint8_t get_confidence() const {
+        return confidence;
+    }
+
+    bool operator==(const PassSignature& other) const {
+        return peak == other.peak &&
+               duration_ms == other.duration_ms &&
+               rise_slope == other.rise_slope &&
+               fall_slope == other.fall_slope &&
+               confidence == other.confidence;
+    }
+
+private:
+    uint16_t peak;
+    uint16_t duration_ms;
+    uint16_t rise_slope;
+    uint16_t fall_slope;
+    uint8_t confidence;
+};
+
+#endif // LAP_TIMER_PASS_SIGNATURE_H
@@ -0,0 +1,55 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_PASS_TEMPLATE_H
+#define LAP_TIMER_PASS_TEMPLATE_H
+
+#include <array>
+#include <cstdint>
+
+///
+/// @brief Pass template of PassCorrelator quantized to 8 bits, small enough for a flash record.
+///
+/// Template has zero mean and unit norm, so none of its values exceeds 1 and they are stored
+/// multiplied by SCALE.
+///
+class PassTemplate {
+public:
+    static constexpr uint8_t LENGTH = 48;
+    static constexpr float SCALE = 127.0f;
+
+    PassTemplate() : values() {}
+    explicit PassTemplate(const std::array<int8_t, LENGTH>& values) : values(values) {}
+
+    const std::array<int8_t, LENGTH>& get_values() const {
+        return values;
+    }
+
+    bool operator==(const PassTemplate& other) const {
+        return values == other.values;
+    }
+
+private:
+    std::array<int8_t, LENGTH> values;
+};
+
+#endif // LAP_TIMER_PASS_TEMPLATE_H
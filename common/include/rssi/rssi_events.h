@@ -0,0 +1,127 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_RSSI_EVENTS_H
+#define LAP_TIMER_RSSI_EVENTS_H
+
+#include <cstdint>
+
+#include "rssi/rssi_profile.h"
+
+class StartRssiCalibration {
+public:
+    StartRssiCalibration(uint32_t duration_ms) : duration_ms(duration_ms) {}
+
+    uint32_t get_duration_ms() const {
+        return duration_ms;
+    }
+
+    bool operator==(const StartRssiCalibration& event) const {
+        return duration_ms == event.duration_ms;
+    }
+
+private:
+    uint32_t duration_ms;
+};
+
+class RssiCalibrationFinished {
+public:
+    RssiCalibrationFinished(RssiProfile profile, bool successful, uint8_t channel = 0) :
+        profile(profile),
+        successful(successful),
+        channel(channel) {}
+
+    RssiProfile get_profile() const {
+        return profile;
+    }
+
+    bool is_successful() const {
+        return successful;
+    }
+
+    uint8_t get_channel() const {
+        return channel;
+    }
+
+    bool operator==(const RssiCalibrationFinished& event) const {
+        return profile == event.profile && successful == event.successful && channel == event.channel;
+    }
+
+private:
+    RssiProfile profile;
+    bool successful;
+    uint8_t channel;
+};
+
+class RssiProfileLoaded {
+public:
+    RssiProfileLoaded(RssiProfile profile, uint8_t channel = 0) : profile(profile), channel(channel) {}
+
+    RssiProfile get_profile() const {
+        return profile;
+    }
+
+    uint8_t get_channel() const {
+        return channel;
+    }
+
+    bool operator==(const RssiProfileLoaded& event) const {
+        return profile == event.profile && channel == event.channel;
+    }
+
+private:
+    RssiProfile profile;
+    uint8_t channel;
+};
+
+class SetLapLockout {
+public:
+    SetLapLockout(uint32_t duration_ms) : duration_ms(duration_ms) {}
+
+    uint32_t get_duration_ms() const {
+        return duration_ms;
+    }
+
+    bool operator==(const SetLapLockout& event) const {
+        return duration_ms == event.duration_ms;
+    }
+
+private:
+    uint32_t duration_ms;
+};
+
+class RssiSamplesAvailable {
+public:
+    bool operator==(const RssiSamplesAvailable& event) const {
+        return true;
+    }
+};
+
+class RssiSummariesAvailable {
+public:
+    bool operator==(const RssiSummariesAvailable& event) const {
+        return true;
+    }
+};
+
+#endif // LAP_TIMER_RSSI_EVENTS_H
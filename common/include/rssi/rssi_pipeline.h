@@ -0,0 +1,386 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_RSSI_PIPELINE_H
+#define LAP_TIMER_RSSI_PIPELINE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "utils/dsp.h"
+#include "utils/median_filter.h"
+
+///
+/// @brief Averages FACTOR consecutive samples into one.
+///
+/// Output sample gets the tick of the middle sample of the averaged window, rounded down.
+///
+/// @tparam FACTOR Number of samples averaged into one.
+///
+template<uint8_t FACTOR>
+class RssiDecimate {
+    static_assert(FACTOR > 0, "Decimation factor must be positive");
+
+public:
+    static constexpr uint32_t DECIMATION = FACTOR;
+
+    RssiDecimate() : sum(0), count(0), middle_tick(0) {}
+
+    void prime(uint16_t sample) {
+        sum = 0;
+        count = 0;
+    }
+
+    bool process(uint16_t& sample, uint32_t& tick) {
+        if (count == (FACTOR - 1) / 2) {
+            middle_tick = tick;
+        }
+        sum += sample;
+        if (++count < FACTOR) {
+            return false;
+        }
+        sample = static_cast<uint16_t>((sum + FACTOR / 2) / FACTOR);
+        tick = middle_tick;
+        sum = 0;
+        count = 0;
+        return true;
+    }
+
+private:
+    uint32_t sum;
+    uint8_t count;
+    uint32_t middle_tick;
+};
+
+///
+/// @brief Sliding window median, removes spikes shorter than half of the window.
+///
+/// @tparam ORDER Window length. Must be odd.
+///
+template<uint8_t ORDER>
+class RssiMedian {
+public:
+    static constexpr uint32_t DECIMATION = 1;
+
+    RssiMedian() : filter() {}
+
+    void prime(uint16_t sample) {
+        filter.reset(sample);
+    }
+
+    bool process(uint16_t& sample, uint32_t& tick) {
+        sample = filter.process(sample);
+        return true;
+    }
+
+private:
+    MedianFilter<uint16_t, ORDER> filter;
+};
+
+///
+/// @brief Single pole low pass filter: y += alpha * (x - y).
+///
+/// State is kept with 16 fractional bits, so small alphas don't get stuck below the input.
+///
+/// @tparam ALPHA_Q15 Filter coefficient in Q15, 32768 passes samples unchanged.
+///
+template<uint16_t ALPHA_Q15>
+class RssiIir {
+    static_assert(ALPHA_Q15 > 0 && ALPHA_Q15 <= (1 << 15), "IIR coefficient must be in (0, 1]");
+
+public:
+    static constexpr uint32_t DECIMATION = 1;
+
+    RssiIir() : state(0) {}
+
+    void prime(uint16_t sample) {
+        state = static_cast<uint32_t>(sample) << 16;
+    }
+
+    bool process(uint16_t& sample, uint32_t& tick) {
+        int64_t error = (static_cast<int64_t>(sample) << 16) - state;
+        state = static_cast<uint32_t>(state + ((error * ALPHA_Q15) >> 15));
+        sample = static_cast<uint16_t>((state + (1 << 15)) >> 16);
+        return true;
+    }
+
+private:
+    uint32_t state;
+};
+
+///
+/// @brief Dead band, output follows the input only when it moves more than BAND away.
+///
+/// @tparam BAND Half width of the dead band.
+///
+template<uint16_t BAND>
+class RssiHysteresis {
+public:
+    static constexpr uint32_t DECIMATION = 1;
+
+    RssiHysteresis() : output(0) {}
+
+    void prime(uint16_t sample) {
+        output = sample;
+    }
+
+    bool process(uint16_t& sample, uint32_t& tick) {
+        // Unsigned arithmetic, firmware builds with -Wall -Werror.
+        uint32_t input = sample;
+        if (input > output + BAND) {
+            output = input - BAND;
+        } else if (input + BAND < output) {
+            output = input + BAND;
+        }
+        sample = static_cast<uint16_t>(output);
+        return true;
+    }
+
+private:
+    uint32_t output;
+};
+
+///
+/// @brief Block version of RssiDecimate<2>, averages pairs of samples with dsp_decimate2.
+///
+/// Odd sample at the end of a block is paired with the first sample of the next block,
+/// when the blocks are continuous. Output is bit-exact with RssiDecimate<2>.
+///
+class RssiBlockDecimate2 {
+public:
+    static constexpr uint32_t DECIMATION = 2;
+
+    RssiBlockDecimate2() : pending(false), pending_sample(0), pending_tick(0) {}
+
+    void prime(uint16_t sample) {
+        pending = false;
+    }
+
+    size_t process_block(uint16_t* samples, size_t count, uint32_t& first_tick, uint32_t& tick_stride) {
+        if (count == 0) {
+            return 0;
+        }
+        uint32_t last_tick = first_tick + (count - 1) * tick_stride;
+        uint16_t last_sample = samples[count - 1];
+        size_t start = 0;
+        if (pending && pending_tick + tick_stride == first_tick) {
+            samples[0] = static_cast<uint16_t>((pending_sample + samples[0] + 1) / 2);
+            first_tick = pending_tick;
+            start = 1;
+        }
+        size_t output_count = start + dsp_decimate2(&samples[start], count - start, &samples[start]);
+        pending = (count - start) % 2 != 0;
+        pending_sample = last_sample;
+        pending_tick = last_tick;
+        tick_stride *= DECIMATION;
+        return output_count;
+    }
+
+private:
+    bool pending;
+    uint16_t pending_sample;
+    uint32_t pending_tick;
+};
+
+///
+/// @brief FIR filter stage running DspFir over whole blocks.
+///
+/// Output samples get the tick of the middle of the filter window, which matches the group delay
+/// of symmetric coefficients.
+///
+/// @tparam COEFFICIENTS Q15 coefficients, newest sample first. Sum of 32768 keeps the DC gain.
+///
+template<int16_t... COEFFICIENTS>
+class RssiFir {
+public:
+    static constexpr uint32_t DECIMATION = 1;
+
+    RssiFir() : fir(std::array<int16_t, TAPS>{COEFFICIENTS...}), last_tick_stride(0) {}
+
+    void prime(uint16_t sample) {
+        fir.prime(sample);
+    }
+
+    size_t process_block(uint16_t* samples, size_t count, uint32_t& first_tick, uint32_t& tick_stride) {
+        if (count == 0) {
+            return 0;
+        }
+        // History taken at another sampling rate would smear the output.
+        if (tick_stride != last_tick_stride) {
+            fir.prime(samples[0]);
+            last_tick_stride = tick_stride;
+        }
+        fir.process_block(samples, count, samples);
+        first_tick -= DELAY * tick_stride;
+        return count;
+    }
+
+private:
+    static constexpr uint8_t TAPS = sizeof...(COEFFICIENTS);
+    static constexpr uint32_t DELAY = (TAPS - 1) / 2;
+
+    DspFir<TAPS> fir;
+    uint32_t last_tick_stride;
+};
+
+template<typename Stage, typename = void>
+struct is_rssi_block_stage : std::false_type {};
+
+template<typename Stage>
+struct is_rssi_block_stage<Stage, std::void_t<decltype(std::declval<Stage&>().process_block(
+    std::declval<uint16_t*>(), size_t(), std::declval<uint32_t&>(), std::declval<uint32_t&>()))>> : std::true_type {};
+
+///
+/// @brief Chain of RSSI filter stages resolved at compile time.
+///
+/// Each stage provides:
+/// - DECIMATION - number of input samples per output sample,
+/// - prime(sample) - initialize the state as if the signal had this value forever,
+/// - process(sample, tick) - filter the sample in place, return false if the sample is consumed
+///   without output (e.g. by decimation). Stages may move the tick to match the output sample.
+///
+/// Block stages provide process_block(samples, count, first_tick, tick_stride) instead, filter the
+/// block in place, return the number of output samples and update the ticks to match them. They
+/// have to precede the sample stages and run on up to BLOCK_LENGTH samples at once.
+///
+/// Stages are stored by value and called directly, so the whole chain is inlined into the caller.
+///
+/// @tparam Stages Filter stages in processing order.
+///
+template<typename... Stages>
+class RssiPipeline {
+public:
+    // Number of input samples per output sample.
+    static constexpr uint32_t DECIMATION = (Stages::DECIMATION * ... * 1);
+    static constexpr bool HAS_BLOCK_STAGES = (is_rssi_block_stage<Stages>::value || ...);
+    // Samples passed to block stages at once, bounds the working buffer.
+    static constexpr size_t BLOCK_LENGTH = 32;
+
+    RssiPipeline() : stages() {
+        static_assert(block_stages_first(), "Block stages have to precede sample stages");
+    }
+
+    ///
+    /// @brief Initialize all stages as if the signal had the given value forever.
+    ///
+    void prime(uint16_t sample) {
+        std::apply([sample](Stages&... stage) { (stage.prime(sample), ...); }, stages);
+    }
+
+    ///
+    /// @brief Pass a sample through all stages.
+    ///
+    /// @note Pipelines with block stages filter samples with process_block only.
+    ///
+    /// @param sample Input sample, replaced with the output sample.
+    /// @param tick Tick of the input sample, replaced with the tick of the output sample.
+    /// @return true If the output sample is available.
+    ///
+    bool process(uint16_t& sample, uint32_t& tick) {
+        static_assert(!HAS_BLOCK_STAGES, "Pipelines with block stages filter samples with process_block");
+        return process_sample_stages(sample, tick);
+    }
+
+    ///
+    /// @brief Pass a block of continuous samples through all stages.
+    ///
+    /// @param samples Input samples.
+    /// @param count Number of input samples.
+    /// @param first_tick Tick of the first input sample.
+    /// @param tick_stride Ticks between input samples.
+    /// @param on_output Called with each output sample and its tick.
+    ///
+    template<typename Callback>
+    void process_block(const uint16_t* samples, size_t count, uint32_t first_tick, uint32_t tick_stride, Callback&& on_output) {
+        if constexpr (!HAS_BLOCK_STAGES) {
+            for (size_t i = 0; i < count; i++) {
+                uint16_t sample = samples[i];
+                uint32_t tick = first_tick + i * tick_stride;
+                if (process_sample_stages(sample, tick)) {
+                    on_output(sample, tick);
+                }
+            }
+        } else {
+            std::array<uint16_t, BLOCK_LENGTH> buffer;
+            for (size_t offset = 0; offset < count; offset += BLOCK_LENGTH) {
+                size_t length = std::min(BLOCK_LENGTH, count - offset);
+                std::copy(&samples[offset], &samples[offset + length], buffer.begin());
+                uint32_t block_tick = first_tick + offset * tick_stride;
+                uint32_t block_stride = tick_stride;
+                length = std::apply([&](Stages&... stage) {
+                    ((length = process_block_stage(stage, buffer.data(), length, block_tick, block_stride)), ...);
+                    return length;
+                }, stages);
+                for (size_t i = 0; i < length; i++) {
+                    uint16_t sample = buffer[i];
+                    uint32_t tick = block_tick + i * block_stride;
+                    if (process_sample_stages(sample, tick)) {
+                        on_output(sample, tick);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr bool block_stages_first() {
+        constexpr bool is_block_stage[] = {is_rssi_block_stage<Stages>::value..., false};
+        for (size_t i = 1; i < sizeof...(Stages); i++) {
+            if (is_block_stage[i] && !is_block_stage[i - 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename Stage>
+    static size_t process_block_stage(Stage& stage, uint16_t* samples, size_t count, uint32_t& first_tick, uint32_t& tick_stride) {
+        if constexpr (is_rssi_block_stage<Stage>::value) {
+            return stage.process_block(samples, count, first_tick, tick_stride);
+        } else {
+            return count;
+        }
+    }
+
+    template<typename Stage>
+    static bool process_sample_stage(Stage& stage, uint16_t& sample, uint32_t& tick) {
+        if constexpr (is_rssi_block_stage<Stage>::value) {
+            return true;
+        } else {
+            return stage.process(sample, tick);
+        }
+    }
+
+    bool process_sample_stages(uint16_t& sample, uint32_t& tick) {
+        return std::apply([&sample, &tick](Stages&... stage) { return (process_sample_stage(stage, sample, tick) && ...); }, stages);
+    }
+
+    std::tuple<Stages...> stages;
+};
+
+#endif // LAP_TIMER_RSSI_PIPELINE_H
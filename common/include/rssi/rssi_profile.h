@@ -0,0 +1,59 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_RSSI_PROFILE_H
+#define LAP_TIMER_RSSI_PROFILE_H
+
+#include <cstdint>
+
+///
+/// @brief RSSI levels observed at a track: noise floor far from the gate and peak during a gate pass.
+///        Detection thresholds are derived from these two levels.
+///
+class RssiProfile {
+public:
+    RssiProfile() : noise_floor(0), peak(0) {}
+    RssiProfile(uint16_t noise_floor, uint16_t peak) : noise_floor(noise_floor), peak(peak) {}
+
+    uint16_t get_noise_floor() const {
+        return noise_floor;
+    }
+
+    uint16_t get_peak() const {
+        return peak;
+    }
+
+    uint16_t get_span() const {
+        return peak > noise_floor ? peak - noise_floor : 0;
+    }
+
+    bool operator==(const RssiProfile& other) const {
+        return noise_floor == other.noise_floor && peak == other.peak;
+    }
+
+private:
+    uint16_t noise_floor;
+    uint16_t peak;
+};
+
+#endif // LAP_TIMER_RSSI_PROFILE_H
@@ -21,29 +21,117 @@
 #ifndef LAP_TIMER_RSSI_READER_DELEGATE_H
 #define LAP_TIMER_RSSI_READER_DELEGATE_H
 
-#include <nrf_log.h>
-
 #include "rssi/rssi_reader_interface.h"
 #include "time/real_time_clock_interface.h"
 #include "events/event_dispatcher_interface.h"
 #include "events/events.h"
+#include "events/event_observer.h"
+#include "rssi/lap_detector.h"
+#include "rssi/rssi_pipeline.h"
+#include "rssi/sampling_scheduler.h"
+#include "trace/latency_tracer.h"
+
+#include <array>
+#include <atomic>
 
-class RssiReaderDelegate : public RssiReaderInterface::Delegate {
+///
+/// @brief Filters samples of each channel with the Pipeline and detects laps in the output.
+///
+/// Definitions are compiled only for RssiReaderPipeline, other pipelines have to be
+/// instantiated explicitly with rssi/rssi_reader_delegate_impl.h.
+///
+/// @tparam Pipeline RssiPipeline applied to raw samples.
+///
+template<typename Pipeline>
+class BasicRssiReaderDelegate : public RssiReaderInterface::Delegate, public EventObserver {
 public:
-    explicit RssiReaderDelegate(RealTimeClockInterface& clock, EventDispatcherInterface& event_dispatcher);
+    static constexpr EventMask EVENTS = event_mask<RssiProfileLoaded, StartRssiCalibration, SetLapLockout, StartSession>();
+
+    // Sampling is resumed before the lockout ends, so filters settle before the next lap is possible.
+    static constexpr uint32_t LOCKOUT_RESUME_MARGIN_MS = 500;
+    // Shorter pauses are not worth suspending the reader.
+    static constexpr uint32_t MIN_SUSPEND_TIME_MS = 200;
+    // Time all channels have to stay below their wake-up levels before the reader is left idle.
+    static constexpr uint32_t IDLE_QUIET_TIME_MS = 1000;
+
+    explicit BasicRssiReaderDelegate(RealTimeClockInterface& clock, EventDispatcherInterface& event_dispatcher);
     void on_initialized(RssiReaderInterface& rssi_reader) override;
-    void on_sample_captured(uint16_t sample) override;
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override;
+
+    void on_event(const Event& event) override;
+
+    ///
+    /// @brief Let the reader wait for a pass in hardware, when no drone is near the gate.
+    ///
+    /// @note Has to be set before the reader is initialized.
+    ///
+    void set_idle_wakeup_enabled(bool enabled);
+
+    ///
+    /// @brief Let the SamplingScheduler lower the sampling rate while no pass is expected.
+    ///
+    /// @note Has to be set before the reader is initialized.
+    ///
+    void set_sampling_profiles_enabled(bool enabled);
+
+    ///
+    /// @brief Tune lap detection of all channels.
+    ///
+    /// @note Has to be set before the reader is initialized.
+    ///
+    void set_detection_parameters(const LapDetector::Parameters& parameters);
+
+    ///
+    /// @brief Mark detected laps in the tracer, nullptr disables tracing.
+    ///
+    void set_latency_tracer(LatencyTracer* latency_tracer);
 
 private:
-    static constexpr size_t MEDIAN_FILTER_ORDER = 5;
+    void apply_pending_requests();
+    void emit_new_lap(uint8_t channel);
+    void suspend_during_lockout(uint32_t tick);
+    void arm_wakeup_when_quiet();
+    void update_sampling_profile(uint32_t tick);
+    uint32_t ms_to_ticks(uint32_t ms) const;
+    void finish_calibration(uint8_t channel);
+
     RssiReaderInterface* reader;
     RealTimeClockInterface& clock;
     EventDispatcherInterface& event_dispatcher;
-    uint16_t buffer[MEDIAN_FILTER_ORDER];
-    size_t current_index;
-    bool in_checkpoint;
-    uint32_t checkpoint_threshold_counter;
-    uint32_t track_threshold_counter;
+    uint32_t first_sample_timestamp_ms;
+    uint32_t sample_interval_us;
+    uint8_t channels_count;
+    std::array<Pipeline, RssiReaderInterface::MAX_CHANNELS_COUNT> pipelines;
+    std::array<LapDetector, RssiReaderInterface::MAX_CHANNELS_COUNT> lap_detectors;
+    // Tick expected in the next block of each channel, a different one means that samples were skipped.
+    std::array<uint32_t, RssiReaderInterface::MAX_CHANNELS_COUNT> next_ticks;
+    // Ticks between samples of the last block of each channel.
+    std::array<uint8_t, RssiReaderInterface::MAX_CHANNELS_COUNT> tick_strides;
+    // Ticks of consecutive samples below the wake-up level, while the detector was idle.
+    std::array<uint32_t, RssiReaderInterface::MAX_CHANNELS_COUNT> quiet_ticks;
+    bool idle_wakeup_enabled;
+    SamplingScheduler sampling_scheduler;
+    SamplingScheduler::Profile sampling_profile;
+    bool sampling_profiles_enabled;
+    LatencyTracer* latency_tracer;
+
+    // Requests come from the event loop and are applied by the sampling context between blocks.
+    std::array<RssiProfile, RssiReaderInterface::MAX_CHANNELS_COUNT> pending_profiles;
+    std::array<std::atomic<bool>, RssiReaderInterface::MAX_CHANNELS_COUNT> pending_profiles_ready;
+    uint32_t pending_calibration_ms;
+    std::atomic<bool> pending_calibration_ready;
+    uint32_t pending_lockout_ms;
+    std::atomic<bool> pending_lockout_ready;
+    std::atomic<bool> pending_session_start;
 };
 
+// Filtering of the firmware, per venue tuning goes here.
+using RssiReaderPipeline = RssiPipeline<RssiMedian<5>>;
+
+using RssiReaderDelegate = BasicRssiReaderDelegate<RssiReaderPipeline>;
+
+// Median lengths compared by rssi_sweep, instantiated in tools/src/rssi_median_pipelines.cpp.
+template<uint8_t ORDER>
+using RssiMedianPipeline = RssiPipeline<RssiMedian<ORDER>>;
+
 #endif // LAP_TIMER_RSSI_READER_DELEGATE_H
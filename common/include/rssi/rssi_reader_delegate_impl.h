@@ -0,0 +1,312 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_RSSI_READER_DELEGATE_IMPL_H
+#define LAP_TIMER_RSSI_READER_DELEGATE_IMPL_H
+
+// Definitions of BasicRssiReaderDelegate, included only where a pipeline is instantiated.
+
+#include "rssi/rssi_reader_delegate.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+template<typename Pipeline>
+BasicRssiReaderDelegate<Pipeline>::BasicRssiReaderDelegate(RealTimeClockInterface& clock, EventDispatcherInterface& event_dispatcher):
+    reader(nullptr),
+    clock(clock),
+    event_dispatcher(event_dispatcher),
+    first_sample_timestamp_ms(0),
+    sample_interval_us(0),
+    channels_count(0),
+    pipelines(),
+    lap_detectors(),
+    next_ticks(),
+    tick_strides(),
+    quiet_ticks(),
+    idle_wakeup_enabled(false),
+    sampling_scheduler(),
+    sampling_profile(SamplingScheduler::SAMPLING_PROFILE_PASS),
+    sampling_profiles_enabled(false),
+    latency_tracer(nullptr),
+    pending_profiles(),
+    pending_profiles_ready(),
+    pending_calibration_ms(0),
+    pending_calibration_ready(false),
+    pending_lockout_ms(0),
+    pending_lockout_ready(false),
+    pending_session_start(false) {
+    for (std::atomic<bool>& profile_ready : pending_profiles_ready) {
+        profile_ready.store(false);
+    }
+    // Filters are primed with the first sample.
+    next_ticks.fill(UINT32_MAX);
+    tick_strides.fill(1);
+    event_dispatcher.register_observer(this, EVENTS);
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::on_initialized(RssiReaderInterface &rssi_reader) {
+    this->reader = &rssi_reader;
+    // Sampling starts right after initialization, all sample timestamps are derived from this point.
+    first_sample_timestamp_ms = clock.get_current_timestamp_ms();
+    sample_interval_us = rssi_reader.get_sample_interval_us();
+    channels_count = std::min(rssi_reader.get_channels_count(), RssiReaderInterface::MAX_CHANNELS_COUNT);
+
+    // Detectors see only the output of the pipeline, ticks stay in input samples.
+    for (LapDetector& lap_detector : lap_detectors) {
+        lap_detector.set_sample_interval_us(sample_interval_us * Pipeline::DECIMATION);
+    }
+    sampling_scheduler.set_tick_interval_us(sample_interval_us);
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+    if (channel >= channels_count) {
+        return;
+    }
+
+    // Requests are applied to all channels at the same block.
+    if (channel == 0) {
+        apply_pending_requests();
+    }
+
+    Pipeline& pipeline = pipelines[channel];
+    LapDetector& lap_detector = lap_detectors[channel];
+    if (first_sample_tick != next_ticks[channel] && count > 0) {
+        pipeline.prime(samples[0]);
+        quiet_ticks[channel] = 0;
+    }
+    tick_stride = std::max<uint8_t>(tick_stride, 1);
+    if (tick_stride != tick_strides[channel]) {
+        // Durations in the detector are counted in samples, they keep their length in time.
+        tick_strides[channel] = tick_stride;
+        lap_detector.set_sample_interval_us(sample_interval_us * tick_stride * Pipeline::DECIMATION);
+    }
+    next_ticks[channel] = first_sample_tick + count * tick_stride;
+
+    pipeline.process_block(samples, count, first_sample_tick, tick_stride, [&](uint16_t sample, uint32_t tick) {
+        switch (lap_detector.process_sample(sample, tick, tick_stride * Pipeline::DECIMATION)) {
+            case LapDetector::LAP_DETECTOR_RESULT_LAP:
+                emit_new_lap(channel);
+                sampling_scheduler.add_lap(channel, lap_detector.get_lap_tick() >> GatePassEstimator::TICK_FRACTION_BITS);
+                suspend_during_lockout(tick + tick_stride);
+                break;
+            case LapDetector::LAP_DETECTOR_RESULT_CALIBRATION_FINISHED:
+                finish_calibration(channel);
+                break;
+            default:
+                break;
+        }
+
+        bool idle = lap_detector.is_idle();
+        if (idle && sample < lap_detector.get_wakeup_level()) {
+            quiet_ticks[channel] += tick_stride * Pipeline::DECIMATION;
+        } else {
+            quiet_ticks[channel] = 0;
+        }
+        sampling_scheduler.add_sample(channel, sample, tick, idle && sample < lap_detector.get_approach_level());
+    });
+
+    if (channel == channels_count - 1) {
+        if (idle_wakeup_enabled) {
+            arm_wakeup_when_quiet();
+        }
+        if (sampling_profiles_enabled) {
+            update_sampling_profile(next_ticks[channel]);
+        }
+    }
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::on_event(const Event& event) {
+    std::visit(overloaded{
+        [this](const RssiProfileLoaded& profile_loaded) {
+            uint8_t channel = profile_loaded.get_channel();
+            if (channel < RssiReaderInterface::MAX_CHANNELS_COUNT) {
+                pending_profiles[channel] = profile_loaded.get_profile();
+                pending_profiles_ready[channel].store(true, std::memory_order_release);
+            }
+        },
+        [this](const StartRssiCalibration& start_calibration) {
+            pending_calibration_ms = start_calibration.get_duration_ms();
+            pending_calibration_ready.store(true, std::memory_order_release);
+        },
+        [this](const SetLapLockout& set_lap_lockout) {
+            pending_lockout_ms = set_lap_lockout.get_duration_ms();
+            pending_lockout_ready.store(true, std::memory_order_release);
+        },
+        [this](const StartSession& start_session) {
+            pending_session_start.store(true, std::memory_order_release);
+        },
+        [](auto other) {}
+    }, event);
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::apply_pending_requests() {
+    for (uint8_t channel = 0; channel < channels_count; channel++) {
+        if (pending_profiles_ready[channel].exchange(false, std::memory_order_acquire)) {
+            const RssiProfile& profile = pending_profiles[channel];
+            lap_detectors[channel].set_profile(profile);
+            LOG_INFO("RSSI profile loaded for channel %u: floor %u, peak %u",
+                channel,
+                profile.get_noise_floor(),
+                profile.get_peak()
+            );
+        }
+    }
+    if (pending_lockout_ready.exchange(false, std::memory_order_acquire)) {
+        LOG_INFO("Lap lockout set to %u ms", pending_lockout_ms);
+        for (LapDetector& lap_detector : lap_detectors) {
+            lap_detector.set_lockout_ticks(ms_to_ticks(pending_lockout_ms));
+        }
+    }
+    if (pending_session_start.exchange(false, std::memory_order_acquire)) {
+        // Laps of a previous session don't predict passes of this one.
+        sampling_scheduler.reset_laps();
+    }
+    if (pending_calibration_ready.exchange(false, std::memory_order_acquire)) {
+        LOG_INFO("RSSI calibration started for %u ms", pending_calibration_ms);
+        for (uint8_t channel = 0; channel < channels_count; channel++) {
+            lap_detectors[channel].start_calibration(pending_calibration_ms);
+        }
+    }
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::emit_new_lap(uint8_t channel) {
+    uint64_t lap_tick = lap_detectors[channel].get_lap_tick();
+    uint64_t lap_offset_us = (lap_tick * sample_interval_us) >> GatePassEstimator::TICK_FRACTION_BITS;
+    uint64_t timestamp_us = static_cast<uint64_t>(first_sample_timestamp_ms) * 1000 + lap_offset_us;
+
+    uint32_t timestamp = static_cast<uint32_t>(timestamp_us / 1000);
+    uint16_t timestamp_fraction_us = static_cast<uint16_t>(timestamp_us % 1000);
+    PassSignature signature = lap_detectors[channel].get_pass_signature(sample_interval_us);
+    if (latency_tracer) {
+        latency_tracer->on_lap_detected();
+    }
+    event_dispatcher.emit_event(NewLap(timestamp, timestamp_fraction_us, channel, signature));
+    LOG_INFO("NEW LAP EVENT on channel %u: %u.%03u, peak %u, %u ms, confidence %u%%",
+        channel,
+        timestamp,
+        timestamp_fraction_us,
+        signature.get_peak(),
+        signature.get_duration_ms(),
+        signature.get_confidence()
+    );
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::finish_calibration(uint8_t channel) {
+    const LapDetector& lap_detector = lap_detectors[channel];
+    RssiProfile profile = lap_detector.get_profile();
+    bool successful = lap_detector.is_calibration_successful();
+    if (successful) {
+        LOG_INFO("RSSI calibration of channel %u finished: floor %u, peak %u", channel, profile.get_noise_floor(), profile.get_peak());
+    } else {
+        LOG_WARNING("RSSI calibration of channel %u failed, no gate pass detected.", channel);
+    }
+    event_dispatcher.emit_event(RssiCalibrationFinished(profile, successful, channel));
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::suspend_during_lockout(uint32_t tick) {
+    // Other channels still need samples until all of them are locked out.
+    uint32_t lockout_end_tick = 0;
+    for (uint8_t channel = 0; channel < channels_count; channel++) {
+        const LapDetector& lap_detector = lap_detectors[channel];
+        if (!lap_detector.is_locked_out()) {
+            return;
+        }
+        uint32_t channel_end_tick = lap_detector.get_lockout_end_tick();
+        if (channel == 0 || static_cast<int32_t>(channel_end_tick - lockout_end_tick) < 0) {
+            lockout_end_tick = channel_end_tick;
+        }
+    }
+
+    uint32_t resume_tick = lockout_end_tick - ms_to_ticks(LOCKOUT_RESUME_MARGIN_MS);
+    if (static_cast<int32_t>(resume_tick - tick) < static_cast<int32_t>(ms_to_ticks(MIN_SUSPEND_TIME_MS))) {
+        return;
+    }
+    LOG_INFO("Sampling suspended until tick %u", resume_tick);
+    reader->suspend_sampling(resume_tick);
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::set_idle_wakeup_enabled(bool enabled) {
+    idle_wakeup_enabled = enabled;
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::arm_wakeup_when_quiet() {
+    uint32_t required_ticks = ms_to_ticks(IDLE_QUIET_TIME_MS);
+    std::array<uint16_t, RssiReaderInterface::MAX_CHANNELS_COUNT> levels;
+    levels.fill(UINT16_MAX);
+    for (uint8_t channel = 0; channel < channels_count; channel++) {
+        if (quiet_ticks[channel] < required_ticks) {
+            return;
+        }
+        levels[channel] = lap_detectors[channel].get_wakeup_level();
+    }
+
+    // Counting starts again, in case the reader ignores the request.
+    quiet_ticks.fill(0);
+    LOG_INFO("RSSI reader waits for a pass, wake-up level of channel 0: %u", levels[0]);
+    reader->arm_wakeup(levels);
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::set_sampling_profiles_enabled(bool enabled) {
+    sampling_profiles_enabled = enabled;
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::set_detection_parameters(const LapDetector::Parameters& parameters) {
+    for (LapDetector& lap_detector : lap_detectors) {
+        lap_detector.set_parameters(parameters);
+    }
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::set_latency_tracer(LatencyTracer* latency_tracer) {
+    this->latency_tracer = latency_tracer;
+}
+
+template<typename Pipeline>
+void BasicRssiReaderDelegate<Pipeline>::update_sampling_profile(uint32_t tick) {
+    SamplingScheduler::Profile profile = sampling_scheduler.get_profile(tick);
+    if (profile == sampling_profile) {
+        return;
+    }
+    sampling_profile = profile;
+    uint8_t stride = sampling_scheduler.get_stride(profile);
+    LOG_INFO("Sampling profile %u from tick %u, stride %u", profile, tick, stride);
+    reader->set_sample_stride(stride);
+}
+
+template<typename Pipeline>
+uint32_t BasicRssiReaderDelegate<Pipeline>::ms_to_ticks(uint32_t ms) const {
+    return static_cast<uint32_t>(static_cast<uint64_t>(ms) * 1000 / sample_interval_us);
+}
+
+#endif // LAP_TIMER_RSSI_READER_DELEGATE_IMPL_H
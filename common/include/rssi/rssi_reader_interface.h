@@ -23,17 +23,79 @@
 #define LAP_TIMER_RSSI_READER_INTERFACE_H
 
 
+#include <array>
 #include <cstdint>
 #include <cstddef>
 
 class RssiReaderInterface {
 public:
+    // Number of SAADC inputs, each one may be connected to a separate video receiver.
+    static constexpr uint8_t MAX_CHANNELS_COUNT = 8;
+
     class Delegate {
     public:
         virtual void on_initialized(RssiReaderInterface& rssi_reader) = 0;
-        virtual void on_sample_captured(uint16_t sample) = 0;
+
+        ///
+        /// @brief Callback called when a block of samples was captured. In case of multiple channels
+        ///        it's called for every channel in turn, with the same ticks.
+        /// @note Called from interrupt context.
+        ///
+        /// @param channel Channel of the samples in range from 0 to get_channels_count() - 1.
+        /// @param samples Samples normalized to 16 bits precision.
+        /// @param count Number of samples in the block.
+        /// @param first_sample_tick Index of the first sample in the block counted from the start
+        ///        of sampling, in intervals of get_sample_interval_us().
+        /// @param tick_stride Ticks between consecutive samples in the block, see set_sample_stride().
+        ///
+        virtual void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) = 0;
     };
 
     virtual void initialize(Delegate &delegate) = 0;
+
+    ///
+    /// @brief Get time between two consecutive ticks, the shortest sample interval.
+    ///
+    /// @return uint32_t Tick interval in microseconds.
+    ///
+    virtual uint32_t get_sample_interval_us() const = 0;
+
+    ///
+    /// @brief Get number of channels sampled simultaneously.
+    ///
+    /// @return uint8_t Number of channels, at most MAX_CHANNELS_COUNT.
+    ///
+    virtual uint8_t get_channels_count() const = 0;
+
+    ///
+    /// @brief Stop sampling of all channels until the given tick.
+    ///
+    /// Ticks of skipped samples are not passed to the delegate, the first sample after the pause
+    /// has the resume tick. Reader may ignore the request, e.g. if the tick is too close.
+    ///
+    /// @param resume_tick Tick of the first sample captured after the pause.
+    ///
+    virtual void suspend_sampling(uint32_t resume_tick) = 0;
+
+    ///
+    /// @brief Stop passing samples until a sample of any channel rises above its level.
+    ///
+    /// Samples are compared by hardware, so the CPU isn't woken up while the signal stays low.
+    /// After the wake-up blocks are passed again, starting a few samples after the one above
+    /// the level at most. Reader may ignore the request, e.g. if sampling is being suspended.
+    ///
+    /// @param levels Wake-up level of each channel, normalized to 16 bits precision.
+    ///
+    virtual void arm_wakeup(const std::array<uint16_t, MAX_CHANNELS_COUNT>& levels) = 0;
+
+    ///
+    /// @brief Capture a sample every stride ticks, starting at a block boundary.
+    ///
+    /// Longer sample intervals are used to oversample more, when no pass is expected. Reader may
+    /// use a shorter stride if the requested one isn't supported, each block reports its own.
+    ///
+    /// @param stride Ticks between consecutive samples, 1 samples every tick.
+    ///
+    virtual void set_sample_stride(uint8_t stride) = 0;
 };
 #endif //LAP_TIMER_RSSI_READER_INTERFACE_H
@@ -0,0 +1,81 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_RSSI_SAMPLE_BUS_H
+#define LAP_TIMER_RSSI_SAMPLE_BUS_H
+
+#include "rssi/rssi_reader_interface.h"
+#include "rssi/buffered_rssi_reader_delegate.h"
+
+#include <array>
+
+///
+/// @brief Passes samples captured by the reader to several delegates, each at its own rate.
+///
+/// Sinks are BufferedRssiReaderDelegates, so in the context of the reader each of them only copies
+/// samples into its own ring. A sink which doesn't keep up drops its own blocks when the ring is
+/// full, instead of delaying the other sinks or the reader.
+///
+/// Decimated sinks get every n-th sample of each channel, with the tick stride multiplied by n.
+/// Every sink is initialized with the reader, but only the lap detection should control it,
+/// pauses and wake-ups apply to all sinks.
+///
+class RssiSampleBus : public RssiReaderInterface::Delegate {
+public:
+    static constexpr uint8_t MAX_SINKS_COUNT = 4;
+    // Decimated blocks are passed in parts of this length.
+    static constexpr size_t MAX_BLOCK_LENGTH = 32;
+
+    RssiSampleBus();
+
+    ///
+    /// @brief Register a sink, sinks are called in order of registration.
+    ///
+    /// @note Has to be called before the reader is initialized.
+    ///
+    /// @param sink Ring of the delegate to receive samples.
+    /// @param decimation Sink gets every decimation-th sample, 1 passes all samples.
+    /// @return true Sink was added.
+    /// @return false MAX_SINKS_COUNT sinks are already registered or decimation is 0.
+    ///
+    bool add_sink(BufferedRssiReaderDelegate& sink, uint8_t decimation = 1);
+
+    void on_initialized(RssiReaderInterface& rssi_reader) override;
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override;
+
+private:
+    struct Sink {
+        BufferedRssiReaderDelegate* delegate;
+        uint8_t decimation;
+        // Samples of each channel to skip before the next one is passed.
+        std::array<uint8_t, RssiReaderInterface::MAX_CHANNELS_COUNT> skipped_samples;
+    };
+
+    void pass_decimated(Sink& sink, uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride);
+
+    std::array<Sink, MAX_SINKS_COUNT> sinks;
+    uint8_t sinks_count;
+    // Tick expected in the next block of each channel, decimation starts again after a gap.
+    std::array<uint32_t, RssiReaderInterface::MAX_CHANNELS_COUNT> next_ticks;
+};
+
+#endif // LAP_TIMER_RSSI_SAMPLE_BUS_H
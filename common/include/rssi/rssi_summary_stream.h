@@ -0,0 +1,154 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_RSSI_SUMMARY_STREAM_H
+#define LAP_TIMER_RSSI_SUMMARY_STREAM_H
+
+#include "rssi/rssi_reader_interface.h"
+#include "events/event_dispatcher_interface.h"
+#include "events/events.h"
+#include "events/event_observer.h"
+#include "protocol/commands.h"
+#include "utils/spsc_ring.h"
+
+#include <atomic>
+
+///
+/// @brief Streams min/max/mean summaries of a single RSSI channel to a client.
+///
+/// Samples come from the ring of a BufferedRssiReaderDelegate, they are summarized and queued in a
+/// lock-free ring. Summaries are packed into notifications in the event loop, as many as the client
+/// can send at once. A notification is sent when it's full, when the next summary doesn't follow the
+/// previous one or when its first summary waits for MAX_LATENCY_MS.
+///
+class RssiSummaryStream : public RssiReaderInterface::Delegate, public EventObserver {
+public:
+    static constexpr EventMask EVENTS = event_mask<RssiSummariesAvailable>();
+
+    // Fills ATT_MTU of 247 bytes.
+    static constexpr uint8_t MAX_SUMMARIES_PER_NOTIFICATION = 38;
+    // Number of queued summaries, 64 summaries keep 320ms at the highest rate.
+    static constexpr size_t SUMMARIES_COUNT = 64;
+    static constexpr uint32_t MAX_LATENCY_MS = 100;
+
+    typedef RssiStreamNotification<MAX_SUMMARIES_PER_NOTIFICATION> Notification;
+
+    class Client {
+    public:
+        ///
+        /// @brief Get the longest notification which can be sent.
+        ///
+        virtual size_t get_max_notification_length() const = 0;
+
+        ///
+        /// @brief Send the notification.
+        ///
+        /// @return true Notification was queued for sending.
+        /// @return false Notification cannot be sent now, it's retried with the next summary.
+        ///
+        virtual bool send_rssi_stream_notification(const uint8_t* data, size_t length) = 0;
+
+    public:
+        virtual ~Client() {}
+    };
+
+    explicit RssiSummaryStream(EventDispatcherInterface& event_dispatcher);
+
+    ///
+    /// @brief Start streaming to the client, replaces the previous client.
+    ///
+    /// @param client Client receiving notifications.
+    /// @param channel RSSI channel to summarize.
+    /// @param rate_hz Summaries per second, RSSI_STREAM_MIN_RATE_HZ - RSSI_STREAM_MAX_RATE_HZ.
+    /// @return true Stream was started.
+    /// @return false Channel or rate is out of range, or the reader isn't initialized yet.
+    ///
+    bool start(Client& client, uint8_t channel, uint8_t rate_hz);
+
+    ///
+    /// @brief Stop streaming, if the client is the current one.
+    ///
+    void stop(Client& client);
+
+    void on_initialized(RssiReaderInterface& rssi_reader) override;
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override;
+
+    void on_event(const Event& event) override;
+
+    ///
+    /// @brief Pack queued summaries and send notifications to the client.
+    ///
+    /// @return size_t Number of sent notifications.
+    ///
+    size_t send_queued_summaries();
+
+    ///
+    /// @brief Get number of summaries dropped because the event loop didn't keep up.
+    ///
+    uint32_t get_overflows() const {
+        return summaries.get_overflows();
+    }
+
+private:
+    struct Summary {
+        uint32_t first_tick;
+        uint32_t period_ticks;
+        uint8_t channel;
+        RssiStreamSummary summary;
+    };
+
+    void finish_period();
+    bool is_continuation(const Summary& summary) const;
+    bool send_notification();
+
+    EventDispatcherInterface& event_dispatcher;
+    uint32_t sample_interval_us;
+    uint8_t channels_count;
+
+    // Requested by start() and stop(), applied in the reader context.
+    std::atomic<uint8_t> requested_channel;
+    std::atomic<uint8_t> requested_rate_hz;
+    std::atomic<bool> configuration_requested;
+    std::atomic<Client*> client;
+
+    // Reader context.
+    uint8_t channel;
+    uint32_t period_ticks;
+    bool period_started;
+    uint32_t period_first_tick;
+    uint16_t period_min;
+    uint16_t period_max;
+    uint32_t period_sum;
+    uint32_t period_count;
+
+    SpscRing<Summary, SUMMARIES_COUNT> summaries;
+    std::atomic<bool> sending_scheduled;
+
+    // Event loop context.
+    Notification notification;
+    Client* notification_client;
+    uint32_t notification_first_tick;
+    uint32_t notification_period_ticks;
+    uint16_t sequence;
+};
+
+#endif // LAP_TIMER_RSSI_SUMMARY_STREAM_H
@@ -0,0 +1,118 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_SAMPLING_SCHEDULER_H
+#define LAP_TIMER_SAMPLING_SCHEDULER_H
+
+#include <array>
+#include <cstdint>
+
+#include "rssi/rssi_reader_interface.h"
+
+///
+/// @brief Chooses the sampling profile from the RSSI trend and the expected time of the next pass.
+///
+/// Idle profile samples less often, with more oversampling, while no drone is near the gate.
+/// Pass profile samples every tick. Full rate is restored when RSSI of any channel rises or
+/// shortly before the next pass predicted from recent lap times.
+///
+/// All times are in milliseconds and converted with the tick interval, so the scheduler
+/// behaves the same for every sampling rate.
+///
+class SamplingScheduler {
+public:
+    enum Profile : uint8_t {
+        SAMPLING_PROFILE_PASS = 0x00,
+        SAMPLING_PROFILE_IDLE = 0x01,
+    };
+
+    // Sample interval of the idle profile, rounded down to a multiple of the tick interval.
+    static constexpr uint32_t IDLE_SAMPLE_INTERVAL_US = 1600;
+    // All channels have to be calm this long before the rate is lowered.
+    static constexpr uint32_t IDLE_ENTER_TIME_MS = 500;
+    // RSSI rising by TREND_MIN_RISE within this window means that a drone is approaching.
+    static constexpr uint32_t TREND_WINDOW_MS = 100;
+    static constexpr uint16_t TREND_MIN_RISE = 1500;
+    // Full rate is kept this long around the predicted pass.
+    static constexpr uint32_t PREDICTION_MARGIN_MS = 1000;
+    // Next pass is predicted from the shortest of this many recent laps.
+    static constexpr uint8_t LAP_HISTORY_LENGTH = 4;
+
+    SamplingScheduler();
+
+    ///
+    /// @brief Set interval between ticks, it has to be called before adding samples.
+    ///
+    void set_tick_interval_us(uint32_t tick_interval_us);
+
+    ///
+    /// @brief Get ticks between samples of a profile.
+    ///
+    uint8_t get_stride(Profile profile) const;
+
+    ///
+    /// @brief Track a filtered sample of a channel.
+    ///
+    /// @param channel Channel of the sample.
+    /// @param sample Filtered sample normalized to 16 bits precision.
+    /// @param tick Tick of the sample.
+    /// @param calm Lap detector waits for a pass and the sample is below its approach level.
+    ///
+    void add_sample(uint8_t channel, uint16_t sample, uint32_t tick, bool calm);
+
+    ///
+    /// @brief Add a detected lap to the history used for prediction.
+    ///
+    void add_lap(uint8_t channel, uint32_t lap_tick);
+
+    ///
+    /// @brief Forget lap history, e.g. when a new session starts.
+    ///
+    void reset_laps();
+
+    ///
+    /// @brief Choose the profile for samples following the given tick.
+    ///
+    Profile get_profile(uint32_t tick) const;
+
+private:
+    struct ChannelState {
+        uint32_t last_active_tick;
+        uint32_t trend_tick;
+        uint16_t trend_sample;
+        bool has_trend;
+        uint32_t last_lap_tick;
+        // Circular buffer of recent lap lengths in ticks, 0 for none.
+        std::array<uint32_t, LAP_HISTORY_LENGTH> lap_ticks;
+        uint8_t next_lap_index;
+        bool has_lap;
+    };
+
+    bool is_pass_predicted(const ChannelState& state, uint32_t tick) const;
+    uint32_t ms_to_ticks(uint32_t ms) const;
+
+    uint32_t tick_interval_us;
+    std::array<ChannelState, RssiReaderInterface::MAX_CHANNELS_COUNT> channels;
+};
+
+#endif // LAP_TIMER_SAMPLING_SCHEDULER_H
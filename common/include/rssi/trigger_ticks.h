@@ -0,0 +1,44 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_TRIGGER_TICKS_H
+#define LAP_TIMER_TRIGGER_TICKS_H
+
+#include <cstdint>
+
+///
+/// @brief Find the tick of a value of the 32-bit counter of sampling timer triggers.
+///
+/// Counter holds ticks * triggers_per_tick modulo 2^32, so it wraps long before ticks do, after
+/// about 7.5 hours at 64 triggers per tick. The tick is found from the distance to a known one,
+/// which is correct across the wrap-around while they are less than 2^32 triggers apart.
+///
+/// @param reference_tick Tick known to be at or before the counter value.
+/// @param triggers Counter value.
+/// @param triggers_per_tick Counter increments per tick.
+/// @return uint32_t Tick the counter value belongs to.
+///
+inline uint32_t get_trigger_tick(uint32_t reference_tick, uint32_t triggers, uint32_t triggers_per_tick) {
+    return reference_tick + (triggers - reference_tick * triggers_per_tick) / triggers_per_tick;
+}
+
+#endif // LAP_TIMER_TRIGGER_TICKS_H
@@ -0,0 +1,105 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_CALIBRATION_STORAGE_H
+#define LAP_TIMER_CALIBRATION_STORAGE_H
+
+#include "storage/flash_storage_interface.h"
+#include "events/event_observer.h"
+#include "events/event_dispatcher_interface.h"
+#include "rssi/rssi_reader_interface.h"
+#include "rssi/pass_template.h"
+
+#include <array>
+
+///
+/// @brief Persists RSSI profile of the last calibration, so the device warm-starts with it.
+///
+/// Profiles are loaded once Session Storage is initialized and stored after every successful
+/// calibration. They're kept in a file reserved for the configuration, outside of session files,
+/// one record per RSSI channel. Pass templates learned by the matched filter are kept the same
+/// way, in their own records, but they're too big for events, so the matched filter saves and loads
+/// them itself.
+///
+class CalibrationStorage : public EventObserver {
+public:
+    static constexpr EventMask EVENTS = event_mask<SessionStorageInitialized, RssiCalibrationFinished>();
+
+    CalibrationStorage(EventDispatcherInterface &event_dispatcher, FlashStorageInterface &flash_storage);
+
+    void on_event(const Event& event) override;
+
+    void on_session_storage_initialized(const SessionStorageInitialized& initialized);
+    void on_calibration_finished(const RssiCalibrationFinished& calibration_finished);
+
+    ///
+    /// @brief Read the pass template of a channel, once Session Storage is initialized.
+    ///
+    /// @param channel RSSI channel of the template.
+    /// @param pass_template Set to the stored template.
+    /// @return true Template was read.
+    /// @return false No compatible template is stored.
+    ///
+    bool load_pass_template(uint8_t channel, PassTemplate& pass_template);
+
+    ///
+    /// @brief Store the pass template of a channel, the write finishes asynchronously.
+    ///
+    /// @param channel RSSI channel of the template.
+    /// @param pass_template Template learned by the matched filter.
+    /// @return true Write was requested.
+    /// @return false Channel is out of range or the write couldn't be requested.
+    ///
+    bool save_pass_template(uint8_t channel, const PassTemplate& pass_template);
+
+    constexpr static uint16_t CALIBRATION_FILE_ID = 0xFFF1;
+    // Record of the first channel, following channels use consecutive records.
+    constexpr static uint16_t RSSI_PROFILE_RECORD_ID = 0x0001;
+    constexpr static uint16_t PASS_TEMPLATE_RECORD_ID = 0x0101;
+
+private:
+    EventDispatcherInterface& event_dispatcher;
+    FlashStorageInterface &flash_storage;
+
+    constexpr static uint32_t RSSI_PROFILE_VERSION = 1;
+    constexpr static uint32_t PASS_TEMPLATE_VERSION = 1;
+
+    struct RssiProfileRecordData {
+        uint32_t version;
+        uint16_t noise_floor;
+        uint16_t peak;
+    } __attribute__ ((aligned (4)));
+    static_assert(sizeof(RssiProfileRecordData) % 4 == 0);
+
+    struct PassTemplateRecordData {
+        uint32_t version;
+        std::array<int8_t, PassTemplate::LENGTH> values;
+    } __attribute__ ((aligned (4)));
+    static_assert(sizeof(PassTemplateRecordData) % 4 == 0);
+
+    // Write is asynchronous, data has to outlive the request.
+    std::array<RssiProfileRecordData, RssiReaderInterface::MAX_CHANNELS_COUNT> profile_records_data;
+    std::array<PassTemplateRecordData, RssiReaderInterface::MAX_CHANNELS_COUNT> template_records_data;
+};
+
+#endif // LAP_TIMER_CALIBRATION_STORAGE_H
@@ -27,9 +27,15 @@
 #include "storage/session_storage_events.h"
 #include "events/event_observer.h"
 #include "events/event_dispatcher_interface.h"
+#include "rssi/pass_signature.h"
+#include "rssi/rssi_reader_interface.h"
+
+#include <array>
 
 class SessionStorage : public EventObserver, public FlashStorageInterface::Delegate {
 public:
+    static constexpr EventMask EVENTS = event_mask<ResetStorage, StartSession, StopSession, AddLapTime, NewLap>();
+
     SessionStorage(EventDispatcherInterface &event_dispatcher, FlashStorageInterface &flash_storage);
 
     void on_event(const Event& event) override;
@@ -40,6 +46,19 @@ public:
     void on_start_session(const StartSession& start_session);
     void on_stop_session(const StopSession& stop_session);
     void on_add_lap_time(const AddLapTime& add_lap_time);
+    void on_new_lap(const NewLap& new_lap);
+
+    ///
+    /// @brief Read a lap stored in a session.
+    ///
+    /// @param session_id Session of the lap.
+    /// @param lap_id Lap number in the session, starting from 1.
+    /// @param lap_time Lap time in milliseconds.
+    /// @param pass_signature Signature of the pass which finished the lap, empty for laps stored without it.
+    /// @param channel RSSI channel of the lap.
+    /// @return true Lap was found.
+    ///
+    bool load_lap(uint16_t session_id, uint8_t lap_id, uint32_t& lap_time, PassSignature& pass_signature, uint8_t& channel);
 
     void on_initialized(bool successful, FlashStorageInterface& interface) override;
     void on_garbage_collected(bool successful) override;
@@ -54,6 +73,12 @@ private:
 
     struct LapRecordData {
         uint32_t lap_time;
+        uint16_t peak;
+        uint16_t duration_ms;
+        uint16_t rise_slope;
+        uint16_t fall_slope;
+        uint8_t confidence;
+        uint8_t channel;
     } __attribute__ ((aligned (32)));
     static_assert(sizeof(LapRecordData) % 4 == 0);
 
@@ -64,6 +89,14 @@ private:
     uint16_t last_session_id;
     uint16_t last_lap_id;
     bool last_session_completed;
+
+    // Write is asynchronous, data has to outlive the request. Laps are seconds apart.
+    constexpr static size_t LAP_RECORDS_IN_FLIGHT = 4;
+    std::array<LapRecordData, LAP_RECORDS_IN_FLIGHT> lap_records_data;
+
+    // Lap times are measured between consecutive gate passes of each channel.
+    std::array<uint64_t, RssiReaderInterface::MAX_CHANNELS_COUNT> last_pass_timestamps_us;
+    std::array<bool, RssiReaderInterface::MAX_CHANNELS_COUNT> last_pass_valid;
 };
 
 #endif // LAP_TIMER_SESSION_STORAGE_H
\ No newline at end of file
@@ -0,0 +1,131 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_TELEMETRY_FRAME_H
+#define LAP_TIMER_TELEMETRY_FRAME_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/cobs.h"
+
+///
+/// @brief Block of RSSI samples sent over the telemetry stream.
+///
+/// Frame before COBS encoding:
+///
+///     [0]      version
+///     [1]      channel
+///     [2..3]   sequence number of the frame, incremented for dropped frames as well
+///     [4..7]   tick of the first sample
+///     [8..9]   total number of frames dropped by the device, saturated
+///     [10]     number of samples
+///     [11]     ticks between consecutive samples, each sample spans this many ticks
+///     [12..]   first sample followed by differences between consecutive samples,
+///              zigzag and varint encoded
+///     [n..n+1] CRC-16/CCITT of all preceding bytes
+///
+/// Integers are little endian. Encoded frame is terminated with a zero byte. Frames of version 1
+/// have no tick stride byte, their samples are one tick apart.
+///
+class TelemetryFrame {
+public:
+    static constexpr uint8_t VERSION = 0x02;
+    static constexpr uint8_t UNSTRIDED_VERSION = 0x01;
+    static constexpr size_t MAX_SAMPLES = 64;
+    static constexpr size_t HEADER_LENGTH = 12;
+    static constexpr size_t CRC_LENGTH = 2;
+    // Zigzag encoded 16 bits difference takes up to 17 bits, which is 3 bytes of varint.
+    static constexpr size_t MAX_SAMPLE_LENGTH = 3;
+    static constexpr size_t MAX_LENGTH = HEADER_LENGTH + MAX_SAMPLES * MAX_SAMPLE_LENGTH + CRC_LENGTH;
+    static constexpr size_t MAX_ENCODED_LENGTH = cobs_max_encoded_length(MAX_LENGTH) + 1;
+    static constexpr uint8_t DELIMITER = 0x00;
+
+    TelemetryFrame();
+    TelemetryFrame(uint8_t channel, uint16_t sequence, uint32_t first_sample_tick, uint16_t dropped_frames, uint8_t tick_stride = 1);
+
+    uint8_t get_channel() const {
+        return channel;
+    }
+
+    uint16_t get_sequence() const {
+        return sequence;
+    }
+
+    uint32_t get_first_sample_tick() const {
+        return first_sample_tick;
+    }
+
+    uint16_t get_dropped_frames() const {
+        return dropped_frames;
+    }
+
+    uint8_t get_tick_stride() const {
+        return tick_stride;
+    }
+
+    const uint16_t* get_samples() const {
+        return samples;
+    }
+
+    size_t get_samples_count() const {
+        return samples_count;
+    }
+
+    ///
+    /// @brief Set samples of the frame, at most MAX_SAMPLES are used.
+    ///
+    /// @return size_t Number of samples used.
+    ///
+    size_t set_samples(const uint16_t* samples, size_t count);
+
+    ///
+    /// @brief Encode the frame with COBS and append the delimiter.
+    ///
+    /// @param buffer Output buffer, MAX_ENCODED_LENGTH is always enough.
+    /// @param length Length of the buffer.
+    /// @return size_t Length of the encoded frame or 0 if the buffer is too small.
+    ///
+    size_t encode(uint8_t* buffer, size_t length) const;
+
+    ///
+    /// @brief Decode a frame.
+    ///
+    /// @param buffer Encoded frame without the delimiter.
+    /// @param length Length of the encoded frame.
+    /// @return true Frame is valid.
+    /// @return false Frame is malformed, has invalid CRC, zero tick stride or unsupported version.
+    ///
+    bool decode(const uint8_t* buffer, size_t length);
+
+private:
+    uint8_t channel;
+    uint16_t sequence;
+    uint32_t first_sample_tick;
+    uint16_t dropped_frames;
+    uint8_t tick_stride;
+    uint16_t samples[MAX_SAMPLES];
+    size_t samples_count;
+};
+
+#endif // LAP_TIMER_TELEMETRY_FRAME_H
@@ -0,0 +1,144 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_TELEMETRY_STREAM_H
+#define LAP_TIMER_TELEMETRY_STREAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "telemetry/telemetry_frame.h"
+
+///
+/// @brief Stream of encoded telemetry frames waiting for transmission.
+///
+/// Frames are encoded by the producer and queued in a ring buffer, from which the consumer
+/// (e.g. DMA transfer) takes contiguous chunks of bytes. Frame which doesn't fit into the buffer
+/// is dropped as a whole and counted, its sequence number is skipped, so the receiver can
+/// tell which frames are missing.
+///
+/// @note One producer and one consumer may work in different contexts without locking.
+///
+/// @tparam BUFFER_SIZE Size of the ring buffer in bytes.
+///
+template<size_t BUFFER_SIZE>
+class TelemetryStream {
+public:
+    static_assert(BUFFER_SIZE > TelemetryFrame::MAX_ENCODED_LENGTH);
+
+    TelemetryStream() : head(0), tail(0), sequence(0), dropped_frames(0), pushed_frames(0) {}
+
+    ///
+    /// @brief Encode samples into frames and queue them. Called by the producer.
+    ///
+    /// @param channel Channel of the samples.
+    /// @param samples Samples to be sent.
+    /// @param count Number of samples, split into multiple frames if needed.
+    /// @param first_sample_tick Tick of the first sample.
+    /// @param tick_stride Ticks between consecutive samples.
+    /// @return true All frames were queued.
+    /// @return false At least one frame was dropped.
+    ///
+    bool push_samples(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+        bool pushed_all = true;
+        for (size_t offset = 0; offset < count; offset += TelemetryFrame::MAX_SAMPLES) {
+            uint16_t dropped = static_cast<uint16_t>(std::min<uint32_t>(dropped_frames, UINT16_MAX));
+            TelemetryFrame frame(channel, sequence++, first_sample_tick + offset * tick_stride, dropped, tick_stride);
+            frame.set_samples(samples + offset, count - offset);
+
+            size_t length = frame.encode(encoded_frame, sizeof(encoded_frame));
+            if (!push_bytes(encoded_frame, length)) {
+                dropped_frames++;
+                pushed_all = false;
+            } else {
+                pushed_frames++;
+            }
+        }
+        return pushed_all;
+    }
+
+    ///
+    /// @brief Get contiguous chunk of queued bytes. Called by the consumer.
+    ///
+    /// @param data Set to the first queued byte.
+    /// @return size_t Number of bytes, which can be read from data. Zero if stream is empty.
+    ///
+    size_t get_pending(const uint8_t** data) const {
+        size_t current_head = head.load(std::memory_order_acquire);
+        size_t current_tail = tail.load(std::memory_order_relaxed);
+        *data = buffer + current_tail;
+        return current_head >= current_tail ? current_head - current_tail : BUFFER_SIZE - current_tail;
+    }
+
+    ///
+    /// @brief Remove bytes returned by get_pending() once they are sent. Called by the consumer.
+    ///
+    void consume(size_t length) {
+        size_t current_tail = tail.load(std::memory_order_relaxed);
+        tail.store((current_tail + length) % BUFFER_SIZE, std::memory_order_release);
+    }
+
+    bool is_empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    uint32_t get_dropped_frames() const {
+        return dropped_frames;
+    }
+
+    uint32_t get_pushed_frames() const {
+        return pushed_frames;
+    }
+
+private:
+    bool push_bytes(const uint8_t* data, size_t length) {
+        size_t current_head = head.load(std::memory_order_relaxed);
+        size_t current_tail = tail.load(std::memory_order_acquire);
+        // One byte is always left empty to distinguish full buffer from empty one.
+        size_t free_space = (current_tail + BUFFER_SIZE - current_head - 1) % BUFFER_SIZE;
+        if (length == 0 || length > free_space) {
+            return false;
+        }
+
+        size_t first_part = std::min(length, BUFFER_SIZE - current_head);
+        std::memcpy(buffer + current_head, data, first_part);
+        std::memcpy(buffer, data + first_part, length - first_part);
+        head.store((current_head + length) % BUFFER_SIZE, std::memory_order_release);
+        return true;
+    }
+
+    uint8_t buffer[BUFFER_SIZE];
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+
+    // Producer state.
+    uint8_t encoded_frame[TelemetryFrame::MAX_ENCODED_LENGTH];
+    uint16_t sequence;
+    uint32_t dropped_frames;
+    uint32_t pushed_frames;
+};
+
+#endif // LAP_TIMER_TELEMETRY_STREAM_H
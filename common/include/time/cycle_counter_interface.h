@@ -0,0 +1,49 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_CYCLE_COUNTER_INTERFACE_H
+#define LAP_TIMER_CYCLE_COUNTER_INTERFACE_H
+
+#include <cstdint>
+
+class CycleCounterInterface {
+public:
+    // Priority reported for code running outside of any interrupt.
+    static constexpr uint8_t THREAD_PRIORITY = 0xFF;
+
+    ///
+    /// @brief Get free running cycle counter. Counter wraps around, only differences are meaningful.
+    ///
+    virtual uint32_t get_cycles() const = 0;
+
+    ///
+    /// @brief Get number of counter cycles in a microsecond.
+    ///
+    virtual uint32_t get_cycles_per_us() const = 0;
+
+    ///
+    /// @brief Get priority of the interrupt which is currently executed, THREAD_PRIORITY outside of interrupts.
+    ///
+    virtual uint8_t get_execution_priority() const = 0;
+};
+
+#endif // LAP_TIMER_CYCLE_COUNTER_INTERFACE_H
@@ -0,0 +1,126 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_LATENCY_HISTOGRAM_H
+#define LAP_TIMER_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+///
+/// @brief Statically allocated histogram of latencies in microseconds.
+///
+/// Buckets are spaced logarithmically with four buckets per power of two, so percentiles are
+/// reported with at most 25% error over the whole uint32_t range using 124 counters. Minimum
+/// and maximum are exact.
+///
+class LatencyHistogram {
+public:
+    static constexpr uint8_t SUB_BUCKETS_BITS = 2;
+    static constexpr uint8_t SUB_BUCKETS_COUNT = 1 << SUB_BUCKETS_BITS;
+    static constexpr size_t BUCKETS_COUNT = (32 - SUB_BUCKETS_BITS + 1) * SUB_BUCKETS_COUNT;
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    void reset() {
+        buckets.fill(0);
+        count = 0;
+        min_us = UINT32_MAX;
+        max_us = 0;
+    }
+
+    void add(uint32_t latency_us) {
+        buckets[get_bucket(latency_us)]++;
+        count++;
+        if (latency_us < min_us) min_us = latency_us;
+        if (latency_us > max_us) max_us = latency_us;
+    }
+
+    uint32_t get_count() const {
+        return count;
+    }
+
+    uint32_t get_min_us() const {
+        return count ? min_us : 0;
+    }
+
+    uint32_t get_max_us() const {
+        return max_us;
+    }
+
+    ///
+    /// @brief Get latency which is not exceeded by the given percent of samples.
+    ///
+    /// @param percent Percentile in range 1 - 100.
+    /// @return uint32_t Upper bound of the bucket with the percentile, 0 if nothing was added.
+    ///
+    uint32_t get_percentile_us(uint8_t percent) const {
+        if (count == 0) {
+            return 0;
+        }
+        // Rank of the sample, rounded up.
+        uint64_t rank = (static_cast<uint64_t>(count) * percent + 99) / 100;
+        if (rank == 0) {
+            rank = 1;
+        }
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < BUCKETS_COUNT; bucket++) {
+            seen += buckets[bucket];
+            if (seen >= rank) {
+                uint32_t upper_us = bucket + 1 < BUCKETS_COUNT ? get_bucket_start(bucket + 1) - 1 : UINT32_MAX;
+                if (upper_us > max_us) upper_us = max_us;
+                if (upper_us < min_us) upper_us = min_us;
+                return upper_us;
+            }
+        }
+        return max_us;
+    }
+
+    static size_t get_bucket(uint32_t latency_us) {
+        if (latency_us < SUB_BUCKETS_COUNT) {
+            return latency_us;
+        }
+        uint8_t msb = 31 - __builtin_clz(latency_us);
+        uint8_t sub_bucket = (latency_us >> (msb - SUB_BUCKETS_BITS)) & (SUB_BUCKETS_COUNT - 1);
+        return (msb - SUB_BUCKETS_BITS + 1) * SUB_BUCKETS_COUNT + sub_bucket;
+    }
+
+    static uint32_t get_bucket_start(size_t bucket) {
+        if (bucket < SUB_BUCKETS_COUNT) {
+            return bucket;
+        }
+        uint8_t msb = bucket / SUB_BUCKETS_COUNT + SUB_BUCKETS_BITS - 1;
+        uint32_t sub_bucket = bucket % SUB_BUCKETS_COUNT;
+        return (SUB_BUCKETS_COUNT + sub_bucket) << (msb - SUB_BUCKETS_BITS);
+    }
+
+private:
+    std::array<uint32_t, BUCKETS_COUNT> buckets;
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+};
+
+#endif // LAP_TIMER_LATENCY_HISTOGRAM_H
@@ -0,0 +1,130 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_LATENCY_TRACER_H
+#define LAP_TIMER_LATENCY_TRACER_H
+
+#include "events/event_dispatcher_interface.h"
+#include "events/event_observer.h"
+#include "time/cycle_counter_interface.h"
+#include "trace/latency_histogram.h"
+
+#include <array>
+
+///
+/// @brief Measures how long a gate pass takes to get from SAADC to the observers of NewLap.
+///
+/// A trace starts when the block of samples which finished a lap was captured and is marked at
+/// each stage of the pipeline. Time spent in every stage is collected in a histogram together
+/// with the interrupt priority the stage ended at. Only the most recent lap is traced, laps
+/// are seconds apart.
+///
+/// Cycle counter stops while the CPU sleeps and wraps within a minute, so traces end before the
+/// event loop may sleep again. The firmware has no lap indication, centrals poll for laps.
+///
+class LatencyTracer : public EventObserver {
+public:
+    static constexpr EventMask EVENTS = event_mask<NewLap>();
+
+    enum Stage : uint8_t {
+        // From SAADC interrupt until the event loop picked the block up.
+        LATENCY_STAGE_QUEUE         = 0x00,
+        // Lap detection on the block.
+        LATENCY_STAGE_DETECTION     = 0x01,
+        // From emitting NewLap until observers received it.
+        LATENCY_STAGE_DISPATCH      = 0x02,
+        // Whole pipeline, from SAADC interrupt until observers received the lap.
+        LATENCY_STAGE_TOTAL         = 0x03,
+        LATENCY_STAGES_COUNT
+    };
+
+    // Summary is logged after this many complete traces.
+    static constexpr uint32_t LOG_INTERVAL_TRACES = 10;
+
+    LatencyTracer(EventDispatcherInterface& event_dispatcher, CycleCounterInterface& cycle_counter);
+
+    void on_event(const Event& event) override;
+
+    ///
+    /// @brief Get current cycle counter value, safe to call from interrupts.
+    ///
+    uint32_t get_cycles() const {
+        return cycle_counter.get_cycles();
+    }
+
+    ///
+    /// @brief Get priority of the current context, safe to call from interrupts.
+    ///
+    uint8_t get_execution_priority() const {
+        return cycle_counter.get_execution_priority();
+    }
+
+    ///
+    /// @brief Mark start of processing of a block of samples.
+    ///
+    /// @param captured_cycles Cycle counter value when the block was captured.
+    /// @param captured_priority Priority at which the block was captured.
+    ///
+    void on_block_processing(uint32_t captured_cycles, uint8_t captured_priority);
+
+    ///
+    /// @brief Start a trace of the lap found in the block passed to on_block_processing.
+    ///
+    void on_lap_detected();
+
+    const LatencyHistogram& get_histogram(Stage stage) const {
+        return histograms[stage];
+    }
+
+    ///
+    /// @brief Get priority at which the stage was last finished.
+    ///
+    uint8_t get_priority(Stage stage) const {
+        return priorities[stage];
+    }
+
+    void reset();
+    void log_summary() const;
+
+private:
+    enum TraceState : uint8_t {
+        TRACE_STATE_IDLE,
+        TRACE_STATE_DETECTED
+    };
+
+    void add_stage(Stage stage, uint32_t start_cycles, uint32_t end_cycles, uint8_t priority);
+
+    CycleCounterInterface& cycle_counter;
+    std::array<LatencyHistogram, LATENCY_STAGES_COUNT> histograms;
+    std::array<uint8_t, LATENCY_STAGES_COUNT> priorities;
+
+    uint32_t block_captured_cycles;
+    uint8_t block_captured_priority;
+    uint32_t block_processing_cycles;
+
+    TraceState trace_state;
+    uint32_t trace_start_cycles;
+    uint32_t trace_mark_cycles;
+    uint32_t completed_traces;
+};
+
+#endif // LAP_TIMER_LATENCY_TRACER_H
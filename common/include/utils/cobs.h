@@ -0,0 +1,65 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_COBS_H
+#define LAP_TIMER_COBS_H
+
+#include <cstddef>
+#include <cstdint>
+
+///
+/// @brief Consistent Overhead Byte Stuffing. Encoded data doesn't contain zero bytes,
+///        so zero can be used as an unambiguous frame delimiter.
+///
+
+///
+/// @brief Get the worst case length of encoded data.
+///
+constexpr size_t cobs_max_encoded_length(size_t length) {
+    return length + length / 254 + 1;
+}
+
+///
+/// @brief Encode data. Delimiter is not appended.
+///
+/// @param data Data to be encoded.
+/// @param length Length of the data.
+/// @param output Buffer for encoded data.
+/// @param output_length Length of the buffer.
+/// @return size_t Length of encoded data or 0 if the buffer is too small.
+///
+size_t cobs_encode(const uint8_t* data, size_t length, uint8_t* output, size_t output_length);
+
+///
+/// @brief Decode data without the delimiter.
+///
+/// @param data Encoded data.
+/// @param length Length of encoded data.
+/// @param output Buffer for decoded data.
+/// @param output_length Length of the buffer.
+/// @return size_t Length of decoded data or 0 if data is malformed or the buffer is too small.
+///         Empty data is decoded to 0 bytes as well.
+///
+size_t cobs_decode(const uint8_t* data, size_t length, uint8_t* output, size_t output_length);
+
+#endif // LAP_TIMER_COBS_H
@@ -0,0 +1,152 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_DSP_H
+#define LAP_TIMER_DSP_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/simd.h"
+
+///
+/// Block kernels for RSSI samples, processing two samples per instruction where the target allows.
+///
+/// Every packed kernel has a scalar reference with bit-exact results, used by the host tests.
+///
+
+///
+/// @brief Average pairs of samples, rounding half up like RssiDecimate<2>.
+///
+/// @param input Samples to be decimated.
+/// @param count Number of input samples, the last one is dropped if the count is odd.
+/// @param output Decimated samples, may be the same buffer as the input.
+/// @return size_t Number of output samples.
+///
+size_t dsp_decimate2(const uint16_t* input, size_t count, uint16_t* output);
+size_t dsp_decimate2_scalar(const uint16_t* input, size_t count, uint16_t* output);
+
+///
+/// @brief Find the first sample above the level.
+///
+/// @return size_t Index of the sample or count if all samples are at or below the level.
+///
+size_t dsp_find_above(const uint16_t* samples, size_t count, uint16_t level);
+size_t dsp_find_above_scalar(const uint16_t* samples, size_t count, uint16_t level);
+
+///
+/// @brief FIR filter of unsigned samples with Q15 coefficients, state is kept between blocks.
+///
+/// Samples are biased to signed 16-bit values, so pairs of taps are accumulated with dual
+/// multiply-accumulate, and the bias is added back to the sum. Output is rounded and saturated.
+///
+/// @tparam TAPS Number of coefficients.
+///
+template<uint8_t TAPS>
+class DspFir {
+    static_assert(TAPS > 0, "FIR needs at least one tap");
+
+public:
+    // Samples filtered at once, bounds the working buffer.
+    static constexpr size_t CHUNK_LENGTH = 32;
+
+    ///
+    /// @param coefficients Q15 coefficients, newest sample first. Sum of 32768 keeps the DC gain.
+    ///
+    explicit DspFir(const std::array<int16_t, TAPS>& coefficients) : reversed_coefficients(), bias_sum(0), window() {
+        for (uint8_t i = 0; i < TAPS; i++) {
+            reversed_coefficients[i] = coefficients[TAPS - 1 - i];
+            bias_sum += static_cast<int64_t>(coefficients[i]) * BIAS;
+        }
+        prime(0);
+    }
+
+    ///
+    /// @brief Initialize the state as if the signal had this value forever.
+    ///
+    void prime(uint16_t sample) {
+        window.fill(bias(sample));
+    }
+
+    ///
+    /// @brief Filter a block of samples, output may be the same buffer as the input.
+    ///
+    void process_block(const uint16_t* input, size_t count, uint16_t* output) {
+        process_chunks(input, count, output, [this](size_t n) {
+            int64_t sum = bias_sum;
+            uint8_t tap = 0;
+            for (; tap + 1 < TAPS; tap += 2) {
+                sum = simd_multiply_accumulate(simd_load_pair(&window[n + tap]), simd_load_pair(&reversed_coefficients[tap]), sum);
+            }
+            if (tap < TAPS) {
+                sum += static_cast<int32_t>(window[n + tap]) * reversed_coefficients[tap];
+            }
+            return sum;
+        });
+    }
+
+    ///
+    /// @brief Same as process_block, one tap at a time.
+    ///
+    void process_block_scalar(const uint16_t* input, size_t count, uint16_t* output) {
+        process_chunks(input, count, output, [this](size_t n) {
+            int64_t sum = 0;
+            for (uint8_t tap = 0; tap < TAPS; tap++) {
+                sum += static_cast<int64_t>(window[n + tap] + BIAS) * reversed_coefficients[tap];
+            }
+            return sum;
+        });
+    }
+
+private:
+    static constexpr int32_t BIAS = 1 << 15;
+    static constexpr size_t HISTORY_LENGTH = TAPS - 1;
+
+    static int16_t bias(uint16_t sample) {
+        return static_cast<int16_t>(static_cast<int32_t>(sample) - BIAS);
+    }
+
+    // Window holds the history followed by the chunk, oldest sample first.
+    template<typename Sum>
+    void process_chunks(const uint16_t* input, size_t count, uint16_t* output, Sum sum) {
+        for (size_t offset = 0; offset < count; offset += CHUNK_LENGTH) {
+            size_t length = std::min(CHUNK_LENGTH, count - offset);
+            for (size_t i = 0; i < length; i++) {
+                window[HISTORY_LENGTH + i] = bias(input[offset + i]);
+            }
+            for (size_t n = 0; n < length; n++) {
+                output[offset + n] = simd_saturate_u16(static_cast<int32_t>((sum(n) + (1 << 14)) >> 15));
+            }
+            for (size_t i = 0; i < HISTORY_LENGTH; i++) {
+                window[i] = window[length + i];
+            }
+        }
+    }
+
+    std::array<int16_t, TAPS> reversed_coefficients;
+    int64_t bias_sum;
+    std::array<int16_t, HISTORY_LENGTH + CHUNK_LENGTH> window;
+};
+
+#endif // LAP_TIMER_DSP_H
@@ -0,0 +1,194 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_MEDIAN_FILTER_H
+#define LAP_TIMER_MEDIAN_FILTER_H
+
+#include <cstdint>
+
+///
+/// @brief Statically allocated sliding window median filter.
+///
+/// Window is kept in a "mediator" heap: a max heap with all values below the median and
+/// a min heap with all values above it, both sharing a single array with the median in
+/// the middle. Each new sample replaces the oldest one in place, so a single update costs
+/// O(log ORDER) comparisons and doesn't allocate or copy the window.
+///
+/// @tparam T Sample type.
+/// @tparam ORDER Window length. Must be odd.
+///
+template<typename T, uint8_t ORDER>
+class MedianFilter {
+    static_assert(ORDER % 2 == 1, "Median filter order must be odd");
+
+public:
+    explicit MedianFilter(T initial_value = T()) {
+        reset(initial_value);
+    }
+
+    ///
+    /// @brief Fill the whole window with a single value.
+    ///
+    /// @param value Value to fill the window with.
+    ///
+    void reset(T value) {
+        // Initial fill pattern: median, max heap, min heap, max heap, ...
+        for (int i = 0; i < ORDER; i++) {
+            values[i] = value;
+            positions[i] = static_cast<int8_t>(((i + 1) / 2) * ((i & 1) ? -1 : 1));
+            heap(positions[i]) = static_cast<uint8_t>(i);
+        }
+        oldest = 0;
+    }
+
+    ///
+    /// @brief Replace the oldest sample in the window.
+    ///
+    /// @param sample New sample.
+    /// @return T Median of the updated window.
+    ///
+    T process(T sample) {
+        int position = positions[oldest];
+        T old_value = values[oldest];
+        values[oldest] = sample;
+        oldest = oldest + 1 == ORDER ? 0 : oldest + 1;
+
+        if (position > 0) {
+            // Sample is in the min heap.
+            if (old_value < sample) {
+                min_sort_down(position * 2);
+            } else if (min_sort_up(position)) {
+                max_sort_down(-1);
+            }
+        } else if (position < 0) {
+            // Sample is in the max heap.
+            if (sample < old_value) {
+                max_sort_down(position * 2);
+            } else if (max_sort_up(position)) {
+                min_sort_down(1);
+            }
+        } else {
+            // Sample replaced the median.
+            if (HEAP_SIZE > 0) {
+                max_sort_down(-1);
+                min_sort_down(1);
+            }
+        }
+
+        return median();
+    }
+
+    ///
+    /// @brief Get median of the current window.
+    ///
+    /// @return T Median value.
+    ///
+    T median() const {
+        return values[heap(0)];
+    }
+
+    ///
+    /// @brief Returns window length.
+    ///
+    /// @return uint8_t Window length.
+    ///
+    uint8_t order() const {
+        return ORDER;
+    }
+
+private:
+    // Number of elements in each of the heaps.
+    static constexpr int HEAP_SIZE = ORDER / 2;
+
+    uint8_t& heap(int position) {
+        return heap_storage[position + HEAP_SIZE];
+    }
+
+    uint8_t heap(int position) const {
+        return heap_storage[position + HEAP_SIZE];
+    }
+
+    bool less(int i, int j) const {
+        return values[heap(i)] < values[heap(j)];
+    }
+
+    // Swaps heap elements if element at i is smaller than element at j.
+    bool exchange_if_less(int i, int j) {
+        if (!less(i, j)) {
+            return false;
+        }
+        uint8_t value_index = heap(i);
+        heap(i) = heap(j);
+        heap(j) = value_index;
+        positions[heap(i)] = static_cast<int8_t>(i);
+        positions[heap(j)] = static_cast<int8_t>(j);
+        return true;
+    }
+
+    // Restores min heap property for all elements below i / 2.
+    void min_sort_down(int i) {
+        for (; i <= HEAP_SIZE; i *= 2) {
+            if (i > 1 && i < HEAP_SIZE && less(i + 1, i)) {
+                ++i;
+            }
+            if (!exchange_if_less(i, i / 2)) {
+                break;
+            }
+        }
+    }
+
+    // Restores max heap property for all elements below i / 2.
+    void max_sort_down(int i) {
+        for (; i >= -HEAP_SIZE; i *= 2) {
+            if (i < -1 && i > -HEAP_SIZE && less(i, i - 1)) {
+                --i;
+            }
+            if (!exchange_if_less(i / 2, i)) {
+                break;
+            }
+        }
+    }
+
+    // Restores min heap property above i. Returns true if median changed.
+    bool min_sort_up(int i) {
+        while (i > 0 && exchange_if_less(i, i / 2)) {
+            i /= 2;
+        }
+        return i == 0;
+    }
+
+    // Restores max heap property above i. Returns true if median changed.
+    bool max_sort_up(int i) {
+        while (i < 0 && exchange_if_less(i / 2, i)) {
+            i /= 2;
+        }
+        return i == 0;
+    }
+
+    T values[ORDER];
+    int8_t positions[ORDER];
+    uint8_t heap_storage[ORDER];
+    uint8_t oldest;
+};
+
+#endif // LAP_TIMER_MEDIAN_FILTER_H
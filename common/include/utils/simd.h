@@ -0,0 +1,119 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_SIMD_H
+#define LAP_TIMER_SIMD_H
+
+#include <cstdint>
+#include <cstring>
+
+///
+/// Two 16-bit lanes packed in a 32-bit word, lane 0 in the low half.
+///
+/// Cortex-M4 executes these with single DSP instructions through CMSIS intrinsics, other targets
+/// use portable emulation with the same results, so packed kernels can be verified on the host.
+///
+
+#if defined(__ARM_FEATURE_DSP)
+#include "cmsis_compiler.h"
+#endif
+
+///
+/// @brief Load two consecutive 16-bit values, the address doesn't have to be word aligned.
+///
+template<typename T>
+inline uint32_t simd_load_pair(const T* values) {
+    static_assert(sizeof(T) == 2, "Only 16-bit lanes are supported");
+    uint32_t word;
+    std::memcpy(&word, values, sizeof(word));
+    return word;
+}
+
+///
+/// @brief Store two consecutive 16-bit values, the address doesn't have to be word aligned.
+///
+template<typename T>
+inline void simd_store_pair(T* values, uint32_t word) {
+    static_assert(sizeof(T) == 2, "Only 16-bit lanes are supported");
+    std::memcpy(values, &word, sizeof(word));
+}
+
+///
+/// @brief Pack low lanes: (a[0], b[0]).
+///
+inline uint32_t simd_pack_low(uint32_t a, uint32_t b) {
+#if defined(__ARM_FEATURE_DSP)
+    return __PKHBT(a, b, 16);
+#else
+    return (a & 0xFFFF) | (b << 16);
+#endif
+}
+
+///
+/// @brief Pack high lanes: (a[1], b[1]).
+///
+inline uint32_t simd_pack_high(uint32_t a, uint32_t b) {
+#if defined(__ARM_FEATURE_DSP)
+    return __PKHTB(b, a, 16);
+#else
+    return (a >> 16) | (b & 0xFFFF0000);
+#endif
+}
+
+///
+/// @brief Mask of lanes where unsigned a >= b, 0xFFFF in matching lanes.
+///
+inline uint32_t simd_mask_ge_u16(uint32_t a, uint32_t b) {
+#if defined(__ARM_FEATURE_DSP)
+    // USUB16 sets GE flags of lanes without borrow, SEL reads them right away.
+    __USUB16(a, b);
+    return __SEL(0xFFFFFFFF, 0);
+#else
+    uint32_t mask = (a & 0xFFFF) >= (b & 0xFFFF) ? 0x0000FFFF : 0;
+    return mask | ((a >> 16) >= (b >> 16) ? 0xFFFF0000 : 0);
+#endif
+}
+
+///
+/// @brief Dual signed 16-bit multiply with 64-bit accumulate: acc + a[0] * b[0] + a[1] * b[1].
+///
+inline int64_t simd_multiply_accumulate(uint32_t a, uint32_t b, int64_t acc) {
+#if defined(__ARM_FEATURE_DSP)
+    return static_cast<int64_t>(__SMLALD(a, b, static_cast<uint64_t>(acc)));
+#else
+    return acc + static_cast<int16_t>(a) * static_cast<int16_t>(b) +
+        static_cast<int16_t>(a >> 16) * static_cast<int16_t>(b >> 16);
+#endif
+}
+
+///
+/// @brief Saturate a signed value to the unsigned 16-bit range.
+///
+inline uint16_t simd_saturate_u16(int32_t value) {
+#if defined(__ARM_FEATURE_DSP)
+    return static_cast<uint16_t>(__USAT(value, 16));
+#else
+    return static_cast<uint16_t>(value < 0 ? 0 : (value > UINT16_MAX ? UINT16_MAX : value));
+#endif
+}
+
+#endif // LAP_TIMER_SIMD_H
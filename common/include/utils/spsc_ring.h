@@ -0,0 +1,149 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_SPSC_RING_H
+#define LAP_TIMER_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+///
+/// @brief Lock-free ring of fixed size items for a single producer and a single consumer.
+///
+/// Producer and consumer may work in different contexts (e.g. interrupt and main loop) without
+/// locking. Items which don't fit are dropped and counted, the largest number of queued items
+/// is tracked to help sizing the ring.
+///
+/// @tparam T Item type.
+/// @tparam CAPACITY Maximum number of queued items. Must be a power of two.
+///
+template<typename T, size_t CAPACITY>
+class SpscRing {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "Ring capacity must be a power of two");
+
+public:
+    SpscRing() : head(0), tail(0), overflows(0), high_water_mark(0) {}
+
+    ///
+    /// @brief Get slot for the next item without queueing it. Called by the producer.
+    ///
+    /// Allows filling the item in place, it's queued by commit().
+    ///
+    /// @return T* Free slot or nullptr if the ring is full, which is counted as overflow.
+    ///
+    T* reserve() {
+        size_t current_head = head.load(std::memory_order_relaxed);
+        size_t current_tail = tail.load(std::memory_order_acquire);
+        if (current_head - current_tail == CAPACITY) {
+            overflows.store(overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &items[current_head & (CAPACITY - 1)];
+    }
+
+    ///
+    /// @brief Queue item filled in the slot returned by reserve(). Called by the producer.
+    ///
+    void commit() {
+        size_t current_head = head.load(std::memory_order_relaxed) + 1;
+        head.store(current_head, std::memory_order_release);
+
+        size_t size = current_head - tail.load(std::memory_order_relaxed);
+        if (size > high_water_mark.load(std::memory_order_relaxed)) {
+            high_water_mark.store(size, std::memory_order_relaxed);
+        }
+    }
+
+    ///
+    /// @brief Queue a copy of the item. Called by the producer.
+    ///
+    /// @return true Item was queued.
+    /// @return false Ring is full, item was dropped.
+    ///
+    bool push(const T& item) {
+        T* slot = reserve();
+        if (!slot) {
+            return false;
+        }
+        *slot = item;
+        commit();
+        return true;
+    }
+
+    ///
+    /// @brief Get the oldest queued item without removing it. Called by the consumer.
+    ///
+    /// @return const T* Oldest item or nullptr if the ring is empty.
+    ///
+    const T* front() const {
+        size_t current_tail = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == current_tail) {
+            return nullptr;
+        }
+        return &items[current_tail & (CAPACITY - 1)];
+    }
+
+    ///
+    /// @brief Remove the oldest item returned by front(). Called by the consumer.
+    ///
+    void pop() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    size_t get_size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    bool is_empty() const {
+        return get_size() == 0;
+    }
+
+    static constexpr size_t get_capacity() {
+        return CAPACITY;
+    }
+
+    ///
+    /// @brief Get number of items dropped because the ring was full.
+    ///
+    uint32_t get_overflows() const {
+        return overflows.load(std::memory_order_relaxed);
+    }
+
+    ///
+    /// @brief Get the largest number of items queued at once.
+    ///
+    size_t get_high_water_mark() const {
+        return high_water_mark.load(std::memory_order_relaxed);
+    }
+
+private:
+    T items[CAPACITY];
+    // Free running counters, wrapped to the capacity on access.
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+    std::atomic<uint32_t> overflows;
+    std::atomic<size_t> high_water_mark;
+};
+
+#endif // LAP_TIMER_SPSC_RING_H
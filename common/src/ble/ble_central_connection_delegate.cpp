@@ -30,6 +30,10 @@ void BleCentralConnectionDelegate::on_initialized(BleCentralConnectionInterface&
 
 void BleCentralConnectionDelegate::on_cleanup() {
     LOG_INFO("[%s] on_cleanup", connection->get_mac_address());
+    if (rssi_summary_stream) {
+        rssi_summary_stream->stop(*this);
+    }
+    calibration_requested.store(false, std::memory_order_relaxed);
     connection = nullptr;
 }
 
@@ -114,6 +118,42 @@ void BleCentralConnectionDelegate::on_tx_write_request(const uint8_t* data, size
             handle_get_session_record_command(command);
             break;
         }
+        case LATENCY_STATS_CODE: {
+            LatencyStatsCommand command(0);
+            if (!command.deserialize(data, length)) {
+                LOG_WARNING("[%s] Invalid latency stats command", connection->get_mac_address());
+                return;
+            }
+            handle_latency_stats_command(command);
+            break;
+        }
+        case LAP_SIGNATURE_CODE: {
+            LapSignatureCommand command(0, 0);
+            if (!command.deserialize(data, length)) {
+                LOG_WARNING("[%s] Invalid lap signature command", connection->get_mac_address());
+                return;
+            }
+            handle_lap_signature_command(command);
+            break;
+        }
+        case RSSI_STREAM_CODE: {
+            RssiStreamCommand command(0, 0);
+            if (!command.deserialize(data, length)) {
+                LOG_WARNING("[%s] Invalid RSSI stream command", connection->get_mac_address());
+                return;
+            }
+            handle_rssi_stream_command(command);
+            break;
+        }
+        case RSSI_CALIBRATION_CODE: {
+            RssiCalibrationCommand command(0);
+            if (!command.deserialize(data, length)) {
+                LOG_WARNING("[%s] Invalid RSSI calibration command", connection->get_mac_address());
+                return;
+            }
+            handle_rssi_calibration_command(command);
+            break;
+        }
         default: {
             LOG_WARNING("[%s] Command is not supported: id=%u", connection->get_mac_address(), data[0]);
         }
@@ -215,3 +255,124 @@ void BleCentralConnectionDelegate::handle_list_sessions_ids_command(const ListSe
 void BleCentralConnectionDelegate::handle_get_session_record_command(const GetSessionRecordCommand& command) {
     LOG_WARNING("[%s] Get Session record command not implemented.")
 }
+
+void BleCentralConnectionDelegate::handle_lap_signature_command(const LapSignatureCommand& command) {
+    uint32_t lap_time = 0;
+    PassSignature signature;
+    uint8_t channel = 0;
+    LapSignatureCommandResponse response;
+    if (session_storage && session_storage->load_lap(command.get_session_id(), command.get_lap_id(), lap_time, signature, channel)) {
+        response = LapSignatureCommandResponse(
+            command.get_session_id(),
+            command.get_lap_id(),
+            lap_time,
+            signature.get_peak(),
+            signature.get_duration_ms(),
+            signature.get_rise_slope(),
+            signature.get_fall_slope(),
+            signature.get_confidence()
+        );
+    }
+    const size_t data_length = LapSignatureCommandResponse::max_length;
+    uint8_t data[data_length];
+    if (!response.serialize(data, data_length)) {
+        LOG_WARNING("[%s] Cannot construct lap signature response", connection->get_mac_address());
+        return;
+    }
+    if (!connection->send_to_rx(data, response.length())) {
+        LOG_WARNING("[%s] Cannot send lap signature response", connection->get_mac_address());
+        return;
+    }
+}
+
+void BleCentralConnectionDelegate::handle_latency_stats_command(const LatencyStatsCommand& command) {
+    if (!latency_tracer || command.get_stage() >= LatencyTracer::LATENCY_STAGES_COUNT) {
+        LOG_WARNING("[%s] Latency stage %u is not traced", connection->get_mac_address(), command.get_stage());
+        return;
+    }
+    LatencyTracer::Stage stage = static_cast<LatencyTracer::Stage>(command.get_stage());
+    const LatencyHistogram& histogram = latency_tracer->get_histogram(stage);
+    LatencyStatsCommandResponse response(
+        command.get_stage(),
+        latency_tracer->get_priority(stage),
+        histogram.get_count(),
+        histogram.get_min_us(),
+        histogram.get_percentile_us(50),
+        histogram.get_percentile_us(99),
+        histogram.get_max_us()
+    );
+    const size_t data_length = LatencyStatsCommandResponse::max_length;
+    uint8_t data[data_length];
+    if (!response.serialize(data, data_length)) {
+        LOG_WARNING("[%s] Cannot construct latency stats response", connection->get_mac_address());
+        return;
+    }
+    if (!connection->send_to_rx(data, data_length)) {
+        LOG_WARNING("[%s] Cannot send latency stats response", connection->get_mac_address());
+        return;
+    }
+}
+
+void BleCentralConnectionDelegate::handle_rssi_stream_command(const RssiStreamCommand& command) {
+    uint8_t rate_hz = 0;
+    if (rssi_summary_stream) {
+        if (command.get_rate_hz() == 0) {
+            rssi_summary_stream->stop(*this);
+        } else if (rssi_summary_stream->start(*this, command.get_channel(), command.get_rate_hz())) {
+            rate_hz = command.get_rate_hz();
+        } else {
+            LOG_WARNING("[%s] Cannot stream channel %u at %u Hz", connection->get_mac_address(), command.get_channel(), command.get_rate_hz());
+        }
+    }
+    RssiStreamCommandResponse response(command.get_channel(), rate_hz);
+    const size_t data_length = RssiStreamCommandResponse::max_length;
+    uint8_t data[data_length];
+    if (!response.serialize(data, data_length)) {
+        LOG_WARNING("[%s] Cannot construct RSSI stream response", connection->get_mac_address());
+        return;
+    }
+    if (!connection->send_to_rx(data, data_length)) {
+        LOG_WARNING("[%s] Cannot send RSSI stream response", connection->get_mac_address());
+        return;
+    }
+}
+
+void BleCentralConnectionDelegate::handle_rssi_calibration_command(const RssiCalibrationCommand& command) {
+    if (!event_dispatcher || command.get_duration_ms() == 0) {
+        LOG_WARNING("[%s] Cannot calibrate RSSI for %u ms", connection->get_mac_address(), static_cast<unsigned>(command.get_duration_ms()));
+        return;
+    }
+    calibration_requested.store(true, std::memory_order_release);
+    event_dispatcher->emit_event(StartRssiCalibration(command.get_duration_ms()));
+}
+
+void BleCentralConnectionDelegate::on_rssi_calibration_finished(const RssiCalibrationFinished& calibration_finished) {
+    if (!connection || !calibration_requested.load(std::memory_order_acquire)) {
+        return;
+    }
+    RssiCalibrationCommandResponse response(
+        calibration_finished.get_channel(),
+        calibration_finished.is_successful(),
+        calibration_finished.get_profile().get_noise_floor(),
+        calibration_finished.get_profile().get_peak()
+    );
+    const size_t data_length = RssiCalibrationCommandResponse::max_length;
+    uint8_t data[data_length];
+    if (!response.serialize(data, data_length)) {
+        LOG_WARNING("[%s] Cannot construct RSSI calibration response", connection->get_mac_address());
+        return;
+    }
+    if (!connection->send_to_rx(data, data_length)) {
+        LOG_WARNING("[%s] Cannot send RSSI calibration response", connection->get_mac_address());
+        return;
+    }
+}
+
+size_t BleCentralConnectionDelegate::get_max_notification_length() const {
+    // ATT header takes 3 bytes of the MTU.
+    return connection ? connection->get_mtu() - 3 : 0;
+}
+
+bool BleCentralConnectionDelegate::send_rssi_stream_notification(const uint8_t* data, size_t length) {
+    return connection && connection->send_to_stream(data, length);
+}
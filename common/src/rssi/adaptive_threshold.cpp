@@ -0,0 +1,127 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rssi/adaptive_threshold.h"
+
+#include <algorithm>
+
+static constexpr uint8_t NOISE_FLOOR_FRACTION_BITS = 16;
+static constexpr uint8_t NOISE_FLOOR_ALPHA_FRACTION_BITS = 24;
+
+AdaptiveThreshold::AdaptiveThreshold() :
+    sample_interval_us(0),
+    noise_floor(0),
+    noise_floor_alpha(0),
+    peak(0),
+    enter_level_percent(ENTER_LEVEL_PERCENT),
+    exit_level_percent(EXIT_LEVEL_PERCENT),
+    enter_threshold(0),
+    exit_threshold(0),
+    approach_threshold(0),
+    calibration_samples_left(0),
+    calibration_min(0),
+    calibration_max(0),
+    calibration_successful(false) {
+    set_profile(RssiProfile(DEFAULT_NOISE_FLOOR, DEFAULT_PEAK));
+}
+
+void AdaptiveThreshold::set_sample_interval_us(uint32_t sample_interval_us) {
+    if (is_calibrating() && this->sample_interval_us != 0) {
+        uint64_t calibration_us = static_cast<uint64_t>(calibration_samples_left) * this->sample_interval_us;
+        calibration_samples_left = std::max<uint32_t>(static_cast<uint32_t>(calibration_us / sample_interval_us), 1);
+    }
+    this->sample_interval_us = sample_interval_us;
+    // First order low pass filter: alpha = interval / time constant.
+    uint64_t alpha = (static_cast<uint64_t>(sample_interval_us) << NOISE_FLOOR_ALPHA_FRACTION_BITS) / (NOISE_FLOOR_TIME_CONSTANT_MS * 1000);
+    noise_floor_alpha = static_cast<uint32_t>(std::clamp<uint64_t>(alpha, 1, 1 << NOISE_FLOOR_ALPHA_FRACTION_BITS));
+}
+
+uint32_t AdaptiveThreshold::ms_to_samples(uint32_t duration_ms) const {
+    if (sample_interval_us == 0) {
+        return 0;
+    }
+    return static_cast<uint32_t>(static_cast<uint64_t>(duration_ms) * 1000 / sample_interval_us);
+}
+
+void AdaptiveThreshold::set_profile(const RssiProfile& profile) {
+    noise_floor = static_cast<uint32_t>(profile.get_noise_floor()) << NOISE_FLOOR_FRACTION_BITS;
+    peak = profile.get_peak();
+    update_thresholds();
+}
+
+RssiProfile AdaptiveThreshold::get_profile() const {
+    return RssiProfile(noise_floor >> NOISE_FLOOR_FRACTION_BITS, peak);
+}
+
+void AdaptiveThreshold::set_levels(uint8_t enter_level_percent, uint8_t exit_level_percent) {
+    this->enter_level_percent = enter_level_percent;
+    this->exit_level_percent = std::min(exit_level_percent, enter_level_percent);
+    update_thresholds();
+}
+
+bool AdaptiveThreshold::track(uint16_t sample) {
+    if (is_calibrating()) {
+        calibration_min = std::min(calibration_min, sample);
+        calibration_max = std::max(calibration_max, sample);
+        if (--calibration_samples_left > 0) {
+            return false;
+        }
+
+        RssiProfile profile(calibration_min, calibration_max);
+        calibration_successful = profile.get_span() >= MIN_SPAN;
+        if (calibration_successful) {
+            set_profile(profile);
+        }
+        return true;
+    }
+
+    // Samples above the exit threshold are most likely a drone approaching the gate.
+    if (sample < exit_threshold) {
+        int64_t error = (static_cast<int64_t>(sample) << NOISE_FLOOR_FRACTION_BITS) - noise_floor;
+        noise_floor += static_cast<int32_t>(error * noise_floor_alpha / (INT64_C(1) << NOISE_FLOOR_ALPHA_FRACTION_BITS));
+        update_thresholds();
+    }
+    return false;
+}
+
+void AdaptiveThreshold::add_pass_peak(uint16_t peak_value) {
+    int32_t error = static_cast<int32_t>(peak_value) - peak;
+    peak += error / (1 << PEAK_UPDATE_SHIFT);
+    update_thresholds();
+}
+
+void AdaptiveThreshold::start_calibration(uint32_t duration_ms) {
+    calibration_samples_left = std::max<uint32_t>(ms_to_samples(duration_ms), 1);
+    calibration_min = UINT16_MAX;
+    calibration_max = 0;
+    calibration_successful = false;
+}
+
+void AdaptiveThreshold::update_thresholds() {
+    uint32_t floor = noise_floor >> NOISE_FLOOR_FRACTION_BITS;
+    // Keep thresholds away from the noise even if the peak estimate collapsed.
+    uint32_t span = std::max<uint32_t>(peak > floor ? peak - floor : 0, MIN_SPAN);
+    enter_threshold = std::min<uint32_t>(floor + span * enter_level_percent / 100, UINT16_MAX);
+    exit_threshold = std::min<uint32_t>(floor + span * exit_level_percent / 100, UINT16_MAX);
+    approach_threshold = std::min<uint32_t>(floor + span * APPROACH_LEVEL_PERCENT / 100, UINT16_MAX);
+}
@@ -0,0 +1,105 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rssi/buffered_rssi_reader_delegate.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+BufferedRssiReaderDelegate::BufferedRssiReaderDelegate(EventDispatcherInterface& event_dispatcher, RssiReaderInterface::Delegate& delegate) :
+    event_dispatcher(event_dispatcher),
+    delegate(delegate),
+    blocks(),
+    processing_scheduled(false),
+    reported_overflows(0),
+    latency_tracer(nullptr) {
+    event_dispatcher.register_observer(this, EVENTS);
+}
+
+void BufferedRssiReaderDelegate::on_initialized(RssiReaderInterface& rssi_reader) {
+    delegate.on_initialized(rssi_reader);
+}
+
+void BufferedRssiReaderDelegate::on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+    uint32_t captured_cycles = 0;
+    uint8_t captured_priority = CycleCounterInterface::THREAD_PRIORITY;
+    if (latency_tracer) {
+        captured_cycles = latency_tracer->get_cycles();
+        captured_priority = latency_tracer->get_execution_priority();
+    }
+    for (size_t offset = 0; offset < count; offset += MAX_BLOCK_LENGTH) {
+        Block* block = blocks.reserve();
+        if (!block) {
+            break;
+        }
+        size_t length = std::min(count - offset, MAX_BLOCK_LENGTH);
+        block->channel = channel;
+        block->count = static_cast<uint8_t>(length);
+        block->tick_stride = tick_stride;
+        block->first_sample_tick = first_sample_tick + offset * tick_stride;
+        block->captured_cycles = captured_cycles;
+        block->captured_priority = captured_priority;
+        std::memcpy(block->samples, samples + offset, length * sizeof(uint16_t));
+        blocks.commit();
+    }
+
+    if (!processing_scheduled.exchange(true, std::memory_order_acq_rel)) {
+        event_dispatcher.emit_event(RssiSamplesAvailable());
+    }
+}
+
+void BufferedRssiReaderDelegate::on_event(const Event& event) {
+    std::visit(overloaded{
+        [this](const RssiSamplesAvailable& samples_available) {
+            process_queued_blocks();
+        },
+        [](auto other) {}
+    }, event);
+}
+
+size_t BufferedRssiReaderDelegate::process_queued_blocks() {
+    // Blocks captured from now on need another event.
+    processing_scheduled.store(false, std::memory_order_release);
+
+    size_t processed = 0;
+    while (const Block* block = blocks.front()) {
+        if (latency_tracer) {
+            latency_tracer->on_block_processing(block->captured_cycles, block->captured_priority);
+        }
+        delegate.on_samples_captured(block->channel, block->samples, block->count, block->first_sample_tick, block->tick_stride);
+        blocks.pop();
+        processed++;
+    }
+
+    uint32_t overflows = blocks.get_overflows();
+    if (overflows != reported_overflows) {
+        LOG_WARNING("%u RSSI blocks dropped, %u of %u blocks used at most",
+            static_cast<unsigned>(overflows - reported_overflows),
+            static_cast<unsigned>(blocks.get_high_water_mark()),
+            static_cast<unsigned>(BLOCKS_COUNT)
+        );
+        reported_overflows = overflows;
+    }
+    return processed;
+}
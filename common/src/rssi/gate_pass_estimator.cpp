@@ -0,0 +1,110 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rssi/gate_pass_estimator.h"
+
+GatePassEstimator::GatePassEstimator(Method method) : method(method) {
+    reset(0);
+}
+
+void GatePassEstimator::reset(uint16_t threshold) {
+    this->threshold = threshold;
+    samples_count = 0;
+    first_tick = 0;
+    end_tick = 0;
+    weight_sum = 0;
+    weighted_tick_sum = 0;
+    last_sample = threshold;
+    peak_value = 0;
+    before_peak_value = threshold;
+    after_peak_value = threshold;
+    peak_first_tick = 0;
+    peak_last_tick = 0;
+    after_peak_pending = false;
+}
+
+void GatePassEstimator::add_sample(uint16_t sample, uint32_t tick, uint32_t tick_span) {
+    if (samples_count == 0) {
+        first_tick = tick;
+    }
+    samples_count++;
+    end_tick = tick + tick_span;
+
+    if (sample > threshold) {
+        uint64_t weight = static_cast<uint64_t>(sample - threshold) * tick_span;
+        weight_sum += weight;
+        // Sample stands for the middle of the ticks it spans, counted in half ticks.
+        weighted_tick_sum += weight * (2 * static_cast<uint64_t>(tick - first_tick) + tick_span - 1);
+    }
+
+    if (sample > peak_value) {
+        peak_value = sample;
+        peak_first_tick = tick;
+        peak_last_tick = tick;
+        before_peak_value = last_sample;
+        after_peak_pending = true;
+    } else if (sample == peak_value && tick == peak_last_tick + tick_span) {
+        peak_last_tick = tick;
+    } else if (after_peak_pending) {
+        after_peak_value = sample;
+        after_peak_pending = false;
+    }
+
+    last_sample = sample;
+}
+
+uint64_t GatePassEstimator::get_pass_tick() const {
+    switch (method) {
+        case GATE_PASS_METHOD_PEAK:
+            return get_peak_tick();
+        case GATE_PASS_METHOD_CENTROID:
+        default:
+            return get_centroid_tick();
+    }
+}
+
+uint64_t GatePassEstimator::get_peak_tick() const {
+    // Middle of the plateau.
+    int64_t tick = (static_cast<int64_t>(peak_first_tick) + peak_last_tick) << (TICK_FRACTION_BITS - 1);
+
+    // Vertex of a parabola passing through single peak sample and its neighbours.
+    if (peak_first_tick == peak_last_tick && !after_peak_pending) {
+        int64_t before = before_peak_value;
+        int64_t peak = peak_value;
+        int64_t after = after_peak_value;
+        int64_t denominator = before - 2 * peak + after;
+        if (denominator < 0) {
+            tick += (before - after) * (INT64_C(1) << (TICK_FRACTION_BITS - 1)) / denominator;
+        }
+    }
+
+    return static_cast<uint64_t>(tick);
+}
+
+uint64_t GatePassEstimator::get_centroid_tick() const {
+    uint64_t tick = static_cast<uint64_t>(first_tick) << TICK_FRACTION_BITS;
+    if (weight_sum > 0) {
+        tick += (weighted_tick_sum << (TICK_FRACTION_BITS - 1)) / weight_sum;
+    }
+    return tick;
+}
@@ -0,0 +1,193 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rssi/lap_detector.h"
+
+#include <algorithm>
+
+LapDetector::LapDetector() :
+    gate_pass_estimator(GatePassEstimator::GATE_PASS_METHOD_CENTROID),
+    adaptive_threshold(),
+    parameters(),
+    sample_interval_us(0),
+    pass_min_samples(0),
+    pass_max_samples(0),
+    rearm_samples(0),
+    lockout_rearm_samples(0),
+    lockout_ticks(0),
+    lockout_end_tick(0),
+    in_checkpoint(false),
+    checkpoint_threshold_counter(0),
+    track_threshold_counter(0),
+    lap_tick(0),
+    pass_confidence(0) {}
+
+void LapDetector::set_sample_interval_us(uint32_t sample_interval_us) {
+    if (this->sample_interval_us != 0) {
+        checkpoint_threshold_counter = rescale_samples(checkpoint_threshold_counter, sample_interval_us);
+        track_threshold_counter = rescale_samples(track_threshold_counter, sample_interval_us);
+    }
+    this->sample_interval_us = sample_interval_us;
+    adaptive_threshold.set_sample_interval_us(sample_interval_us);
+    update_sample_counts();
+}
+
+void LapDetector::set_parameters(const Parameters& parameters) {
+    this->parameters = parameters;
+    adaptive_threshold.set_levels(parameters.enter_level_percent, parameters.exit_level_percent);
+    update_sample_counts();
+}
+
+void LapDetector::update_sample_counts() {
+    pass_min_samples = adaptive_threshold.ms_to_samples(parameters.pass_min_time_ms);
+    pass_max_samples = adaptive_threshold.ms_to_samples(PASS_MAX_TIME_MS);
+    rearm_samples = adaptive_threshold.ms_to_samples(parameters.rearm_time_ms);
+    lockout_rearm_samples = adaptive_threshold.ms_to_samples(LOCKOUT_REARM_TIME_MS);
+}
+
+uint32_t LapDetector::rescale_samples(uint32_t samples, uint32_t new_sample_interval_us) const {
+    // A started pass stays started, even if it lasted less than a new sample.
+    uint64_t duration_us = static_cast<uint64_t>(samples) * sample_interval_us;
+    uint32_t rescaled = static_cast<uint32_t>(duration_us / new_sample_interval_us);
+    return samples > 0 ? std::max<uint32_t>(rescaled, 1) : 0;
+}
+
+void LapDetector::set_lockout_ticks(uint32_t lockout_ticks) {
+    this->lockout_ticks = lockout_ticks;
+}
+
+void LapDetector::set_profile(const RssiProfile& profile) {
+    adaptive_threshold.set_profile(profile);
+}
+
+RssiProfile LapDetector::get_profile() const {
+    return adaptive_threshold.get_profile();
+}
+
+void LapDetector::start_calibration(uint32_t duration_ms) {
+    adaptive_threshold.start_calibration(duration_ms);
+    reset_state();
+}
+
+bool LapDetector::is_calibration_successful() const {
+    return adaptive_threshold.is_calibration_successful();
+}
+
+LapDetector::Result LapDetector::process_sample(uint16_t filtered_sample, uint32_t tick, uint32_t tick_span) {
+    if (adaptive_threshold.is_calibrating()) {
+        if (adaptive_threshold.track(filtered_sample)) {
+            return LAP_DETECTOR_RESULT_CALIBRATION_FINISHED;
+        }
+        return LAP_DETECTOR_RESULT_NONE;
+    }
+
+    if (in_checkpoint) {
+        adaptive_threshold.track(filtered_sample);
+        if (lockout_ticks > 0) {
+            // Drone has to stay out of the gate for a while after the lockout, ticks may be skipped before.
+            bool lockout_passed = static_cast<int32_t>(tick - lockout_end_tick) >= 0;
+            if (!lockout_passed || filtered_sample >= adaptive_threshold.get_exit_threshold()) {
+                track_threshold_counter = 0;
+            } else if (++track_threshold_counter > lockout_rearm_samples) {
+                reset_state();
+            }
+        } else if (filtered_sample >= adaptive_threshold.get_exit_threshold()) {
+            track_threshold_counter = 0;
+        } else if (++track_threshold_counter > rearm_samples) {
+            reset_state();
+        }
+        return LAP_DETECTOR_RESULT_NONE;
+    }
+
+    // Pass starts above the enter threshold and lasts until the signal drops below the exit threshold.
+    bool in_pass = checkpoint_threshold_counter > 0;
+    uint16_t threshold = in_pass ? adaptive_threshold.get_exit_threshold() : adaptive_threshold.get_enter_threshold();
+    if (filtered_sample <= threshold) {
+        // Lap is reported once the drone leaves the gate, when the whole excursion is known.
+        if (checkpoint_threshold_counter > pass_min_samples) {
+            return finish_pass(false);
+        }
+        adaptive_threshold.track(filtered_sample);
+        checkpoint_threshold_counter = 0;
+        return LAP_DETECTOR_RESULT_NONE;
+    }
+
+    if (!in_pass) {
+        gate_pass_estimator.reset(adaptive_threshold.get_exit_threshold());
+    }
+    gate_pass_estimator.add_sample(filtered_sample, tick, tick_span);
+
+    // Don't wait forever if the drone stays in the gate.
+    if (++checkpoint_threshold_counter > pass_max_samples) {
+        return finish_pass(true);
+    }
+    return LAP_DETECTOR_RESULT_NONE;
+}
+
+LapDetector::Result LapDetector::finish_pass(bool closed_by_timeout) {
+    lap_tick = gate_pass_estimator.get_pass_tick();
+
+    // Profile before this pass updates the peak.
+    RssiProfile profile = adaptive_threshold.get_profile();
+    uint16_t peak_value = gate_pass_estimator.get_peak_value();
+    uint32_t height = peak_value > profile.get_noise_floor() ? peak_value - profile.get_noise_floor() : 0;
+    uint32_t confidence = std::min<uint32_t>(height * 100 / std::max<uint32_t>(profile.get_span(), 1), 100);
+    uint32_t confident_samples = adaptive_threshold.ms_to_samples(CONFIDENT_PASS_TIME_MS);
+    if (checkpoint_threshold_counter < confident_samples) {
+        confidence = confidence * checkpoint_threshold_counter / confident_samples;
+    }
+    if (closed_by_timeout) {
+        confidence /= 2;
+    }
+    pass_confidence = static_cast<uint8_t>(confidence);
+
+    lockout_end_tick = static_cast<uint32_t>(lap_tick >> GatePassEstimator::TICK_FRACTION_BITS) + lockout_ticks;
+    adaptive_threshold.add_pass_peak(gate_pass_estimator.get_peak_value());
+
+    in_checkpoint = true;
+    checkpoint_threshold_counter = 0;
+    track_threshold_counter = 0;
+    return LAP_DETECTOR_RESULT_LAP;
+}
+
+PassSignature LapDetector::get_pass_signature(uint32_t tick_interval_us) const {
+    const GatePassEstimator& pass = gate_pass_estimator;
+    uint32_t height = pass.get_peak_value() > pass.get_threshold() ? pass.get_peak_value() - pass.get_threshold() : 0;
+    uint64_t duration_us = static_cast<uint64_t>(pass.get_end_tick() - pass.get_first_tick()) * tick_interval_us;
+    // Peak sample itself belongs to both edges, so neither of them is shorter than a tick.
+    uint64_t rise_us = static_cast<uint64_t>(pass.get_peak_first_tick() - pass.get_first_tick() + 1) * tick_interval_us;
+    uint64_t fall_us = static_cast<uint64_t>(pass.get_end_tick() - pass.get_peak_last_tick()) * tick_interval_us;
+    return PassSignature(
+        pass.get_peak_value(),
+        static_cast<uint16_t>(std::min<uint64_t>(duration_us / 1000, UINT16_MAX)),
+        static_cast<uint16_t>(std::min<uint64_t>(height * UINT64_C(1000) / std::max<uint64_t>(rise_us, 1), UINT16_MAX)),
+        static_cast<uint16_t>(std::min<uint64_t>(height * UINT64_C(1000) / std::max<uint64_t>(fall_us, 1), UINT16_MAX)),
+        pass_confidence
+    );
+}
+
+void LapDetector::reset_state() {
+    in_checkpoint = false;
+    checkpoint_threshold_counter = 0;
+    track_threshold_counter = 0;
+}
@@ -0,0 +1,199 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "rssi/matched_filter_rssi_reader_delegate.h"
+#include "storage/calibration_storage.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+MatchedFilterRssiReaderDelegate::MatchedFilterRssiReaderDelegate(RealTimeClockInterface& clock, EventDispatcherInterface& event_dispatcher) :
+    clock(clock),
+    event_dispatcher(event_dispatcher),
+    first_sample_timestamp_ms(0),
+    sample_interval_us(0),
+    channels_count(0),
+    pipelines(),
+    correlators(),
+    next_ticks(),
+    latency_tracer(nullptr),
+    calibration_storage(nullptr),
+    learned_templates(),
+    pending_calibration_ms(0),
+    pending_calibration_ready(false),
+    pending_lockout_ms(0),
+    pending_lockout_ready(false),
+    pending_templates(),
+    pending_templates_ready(0) {
+    // Filters are primed with the first sample.
+    next_ticks.fill(UINT32_MAX);
+    event_dispatcher.register_observer(this, EVENTS);
+}
+
+void MatchedFilterRssiReaderDelegate::on_initialized(RssiReaderInterface &rssi_reader) {
+    // Sampling starts right after initialization, all sample timestamps are derived from this point.
+    first_sample_timestamp_ms = clock.get_current_timestamp_ms();
+    sample_interval_us = rssi_reader.get_sample_interval_us();
+    channels_count = std::min(rssi_reader.get_channels_count(), RssiReaderInterface::MAX_CHANNELS_COUNT);
+
+    // Correlator bins samples by ticks, so it doesn't depend on decimation nor strides.
+    for (PassCorrelator& correlator : correlators) {
+        correlator.set_sample_interval_us(sample_interval_us);
+    }
+}
+
+void MatchedFilterRssiReaderDelegate::on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+    if (channel >= channels_count) {
+        return;
+    }
+
+    // Requests are applied to all channels at the same block.
+    if (channel == 0) {
+        apply_pending_requests();
+    }
+
+    RssiReaderPipeline& pipeline = pipelines[channel];
+    PassCorrelator& correlator = correlators[channel];
+    if (first_sample_tick != next_ticks[channel] && count > 0) {
+        pipeline.prime(samples[0]);
+        correlator.reset();
+    }
+    tick_stride = std::max<uint8_t>(tick_stride, 1);
+    next_ticks[channel] = first_sample_tick + count * tick_stride;
+
+    pipeline.process_block(samples, count, first_sample_tick, tick_stride, [&](uint16_t sample, uint32_t tick) {
+        switch (correlator.process_sample(sample, tick)) {
+            case PassCorrelator::PASS_CORRELATOR_RESULT_LAP:
+                emit_new_lap(channel);
+                break;
+            case PassCorrelator::PASS_CORRELATOR_RESULT_LEARNING_FINISHED:
+                finish_learning(channel);
+                break;
+            default:
+                break;
+        }
+    });
+}
+
+void MatchedFilterRssiReaderDelegate::on_event(const Event& event) {
+    std::visit(overloaded{
+        [this](const StartRssiCalibration& start_calibration) {
+            pending_calibration_ms = start_calibration.get_duration_ms();
+            pending_calibration_ready.store(true, std::memory_order_release);
+        },
+        [this](const SetLapLockout& set_lap_lockout) {
+            pending_lockout_ms = set_lap_lockout.get_duration_ms();
+            pending_lockout_ready.store(true, std::memory_order_release);
+        },
+        [this](const SessionStorageInitialized& initialized) {
+            load_pass_templates();
+        },
+        [this](const RssiCalibrationFinished& calibration_finished) {
+            uint8_t channel = calibration_finished.get_channel();
+            if (calibration_storage && calibration_finished.is_successful() && channel < RssiReaderInterface::MAX_CHANNELS_COUNT) {
+                calibration_storage->save_pass_template(channel, learned_templates[channel]);
+            }
+        },
+        [](auto other) {}
+    }, event);
+}
+
+void MatchedFilterRssiReaderDelegate::set_latency_tracer(LatencyTracer* latency_tracer) {
+    this->latency_tracer = latency_tracer;
+}
+
+void MatchedFilterRssiReaderDelegate::set_calibration_storage(CalibrationStorage* calibration_storage) {
+    this->calibration_storage = calibration_storage;
+}
+
+void MatchedFilterRssiReaderDelegate::load_pass_templates() {
+    if (!calibration_storage) {
+        return;
+    }
+    uint8_t templates_loaded = 0;
+    for (uint8_t channel = 0; channel < RssiReaderInterface::MAX_CHANNELS_COUNT; channel++) {
+        if (calibration_storage->load_pass_template(channel, pending_templates[channel])) {
+            templates_loaded |= 1 << channel;
+        }
+    }
+    pending_templates_ready.fetch_or(templates_loaded, std::memory_order_release);
+}
+
+void MatchedFilterRssiReaderDelegate::apply_pending_requests() {
+    if (pending_lockout_ready.exchange(false, std::memory_order_acquire)) {
+        LOG_INFO("Lap lockout set to %u ms", pending_lockout_ms);
+        for (PassCorrelator& correlator : correlators) {
+            correlator.set_lockout_ticks(ms_to_ticks(pending_lockout_ms));
+        }
+    }
+    uint8_t templates_ready = pending_templates_ready.exchange(0, std::memory_order_acquire);
+    for (uint8_t channel = 0; channel < channels_count; channel++) {
+        if (templates_ready & (1 << channel)) {
+            LOG_INFO("Pass template of channel %u restored", channel);
+            correlators[channel].set_pass_template(pending_templates[channel]);
+        }
+    }
+    if (pending_calibration_ready.exchange(false, std::memory_order_acquire)) {
+        LOG_INFO("Pass template learning started for %u ms", pending_calibration_ms);
+        for (uint8_t channel = 0; channel < channels_count; channel++) {
+            correlators[channel].start_learning(pending_calibration_ms);
+        }
+    }
+}
+
+void MatchedFilterRssiReaderDelegate::emit_new_lap(uint8_t channel) {
+    uint64_t lap_tick = correlators[channel].get_lap_tick();
+    uint64_t lap_offset_us = (lap_tick * sample_interval_us) >> GatePassEstimator::TICK_FRACTION_BITS;
+    uint64_t timestamp_us = static_cast<uint64_t>(first_sample_timestamp_ms) * 1000 + lap_offset_us;
+
+    uint32_t timestamp = static_cast<uint32_t>(timestamp_us / 1000);
+    uint16_t timestamp_fraction_us = static_cast<uint16_t>(timestamp_us % 1000);
+    PassSignature signature = correlators[channel].get_pass_signature();
+    if (latency_tracer) {
+        latency_tracer->on_lap_detected();
+    }
+    event_dispatcher.emit_event(NewLap(timestamp, timestamp_fraction_us, channel, signature));
+    LOG_INFO("NEW LAP EVENT on channel %u: %u.%03u, peak %u, correlation %u%%",
+        channel,
+        timestamp,
+        timestamp_fraction_us,
+        signature.get_peak(),
+        signature.get_confidence()
+    );
+}
+
+void MatchedFilterRssiReaderDelegate::finish_learning(uint8_t channel) {
+    const PassCorrelator& correlator = correlators[channel];
+    RssiProfile profile = correlator.get_profile();
+    bool successful = correlator.is_learning_successful();
+    if (successful) {
+        LOG_INFO("Pass template of channel %u learned: floor %u, peak %u", channel, profile.get_noise_floor(), profile.get_peak());
+        learned_templates[channel] = correlator.get_pass_template();
+    } else {
+        LOG_WARNING("Pass template of channel %u not learned, no gate pass detected.", channel);
+    }
+    event_dispatcher.emit_event(RssiCalibrationFinished(profile, successful, channel));
+}
+
+uint32_t MatchedFilterRssiReaderDelegate::ms_to_ticks(uint32_t ms) const {
+    return static_cast<uint32_t>(static_cast<uint64_t>(ms) * 1000 / sample_interval_us);
+}
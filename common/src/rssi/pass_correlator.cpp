@@ -0,0 +1,288 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "rssi/pass_correlator.h"
+
+#include <algorithm>
+#include <cmath>
+
+PassCorrelator::PassCorrelator() :
+    bin_ticks(0),
+    bin_start_tick(0),
+    bin_sum(0),
+    bin_samples(0),
+    bin_started(false),
+    bins(),
+    oldest_bin(0),
+    bins_count(0),
+    pass_template(),
+    correlation(0),
+    previous_correlation(0),
+    in_peak(false),
+    best_correlation(0),
+    before_best_correlation(0),
+    after_best_correlation(0),
+    bins_since_best(0),
+    best_center_tick(0),
+    best_window(),
+    lockout_ticks(0),
+    lap_detected(false),
+    next_lap_tick(0),
+    lap_tick(0),
+    lap_correlation(0),
+    lap_window(),
+    learning(false),
+    learning_end_tick(0),
+    learning_ticks(0),
+    learning_successful(false) {
+    // Path loss of a drone flying straight through the gate, relative to the closest point.
+    for (uint8_t i = 0; i < TEMPLATE_LENGTH; i++) {
+        float time = (i + 0.5f - TEMPLATE_LENGTH / 2) * BIN_TIME_MS / DEFAULT_PASS_TIME_CONSTANT_MS;
+        pass_template[i] = -std::log10(1.0f + time * time);
+    }
+    normalize(pass_template);
+}
+
+void PassCorrelator::set_sample_interval_us(uint32_t sample_interval_us) {
+    bin_ticks = std::max<uint32_t>(BIN_TIME_MS * 1000 / sample_interval_us, 1);
+    reset();
+}
+
+void PassCorrelator::reset() {
+    bin_started = false;
+    oldest_bin = 0;
+    bins_count = 0;
+    in_peak = false;
+}
+
+void PassCorrelator::set_lockout_ticks(uint32_t lockout_ticks) {
+    this->lockout_ticks = lockout_ticks;
+}
+
+void PassCorrelator::start_learning(uint32_t duration_ms) {
+    learning = true;
+    learning_successful = false;
+    // End is set by the next sample, its tick isn't known yet.
+    learning_ticks = std::max<uint32_t>(static_cast<uint64_t>(duration_ms) * bin_ticks / BIN_TIME_MS, 1);
+    in_peak = false;
+}
+
+bool PassCorrelator::is_learning_successful() const {
+    return learning_successful;
+}
+
+RssiProfile PassCorrelator::get_profile() const {
+    auto [min, max] = std::minmax_element(lap_window.begin(), lap_window.end());
+    return RssiProfile(static_cast<uint16_t>(*min), static_cast<uint16_t>(*max));
+}
+
+PassTemplate PassCorrelator::get_pass_template() const {
+    std::array<int8_t, TEMPLATE_LENGTH> values;
+    for (uint8_t i = 0; i < TEMPLATE_LENGTH; i++) {
+        values[i] = static_cast<int8_t>(std::lround(std::clamp(pass_template[i], -1.0f, 1.0f) * PassTemplate::SCALE));
+    }
+    return PassTemplate(values);
+}
+
+void PassCorrelator::set_pass_template(const PassTemplate& stored_template) {
+    const std::array<int8_t, TEMPLATE_LENGTH>& values = stored_template.get_values();
+    // Flat template would never correlate, keep the current one.
+    if (std::all_of(values.begin(), values.end(), [](int8_t value) { return value == 0; })) {
+        return;
+    }
+    for (uint8_t i = 0; i < TEMPLATE_LENGTH; i++) {
+        pass_template[i] = values[i] / PassTemplate::SCALE;
+    }
+    // Quantization moves mean and norm slightly.
+    normalize(pass_template);
+}
+
+PassCorrelator::Result PassCorrelator::process_sample(uint16_t filtered_sample, uint32_t tick) {
+    if (bin_ticks == 0) {
+        return PASS_CORRELATOR_RESULT_NONE;
+    }
+    if (learning_ticks > 0) {
+        learning_end_tick = tick + learning_ticks;
+        learning_ticks = 0;
+    }
+
+    Result result = PASS_CORRELATOR_RESULT_NONE;
+    if (bin_started && tick - bin_start_tick >= bin_ticks) {
+        uint32_t closed_bin_start_tick = bin_start_tick;
+        float bin = static_cast<float>(bin_sum) / bin_samples;
+        bin_start_tick += bin_ticks;
+        bin_sum = 0;
+        bin_samples = 0;
+        if (tick - bin_start_tick >= bin_ticks) {
+            // Whole bin is missing, the window doesn't describe continuous signal.
+            reset();
+        } else {
+            result = process_bin(bin, closed_bin_start_tick);
+        }
+    }
+    if (!bin_started) {
+        bin_started = true;
+        bin_start_tick = tick;
+        bin_sum = 0;
+        bin_samples = 0;
+    }
+    bin_sum += filtered_sample;
+    bin_samples++;
+
+    if (learning && learning_ticks == 0 && static_cast<int32_t>(tick - learning_end_tick) >= 0) {
+        learning = false;
+        return PASS_CORRELATOR_RESULT_LEARNING_FINISHED;
+    }
+    return result;
+}
+
+PassCorrelator::Result PassCorrelator::process_bin(float bin, uint32_t bin_start_tick) {
+    if (bins_count < TEMPLATE_LENGTH) {
+        bins[bins_count++] = bin;
+    } else {
+        bins[oldest_bin] = bin;
+        oldest_bin = oldest_bin + 1 == TEMPLATE_LENGTH ? 0 : oldest_bin + 1;
+    }
+    if (bins_count < TEMPLATE_LENGTH) {
+        return PASS_CORRELATOR_RESULT_NONE;
+    }
+
+    Window window = get_window();
+    float mean = 0;
+    for (float value : window) {
+        mean += value;
+    }
+    mean /= TEMPLATE_LENGTH;
+    float squares = 0;
+    float product = 0;
+    for (uint8_t i = 0; i < TEMPLATE_LENGTH; i++) {
+        float deviation = window[i] - mean;
+        squares += deviation * deviation;
+        product += deviation * pass_template[i];
+    }
+    float deviation = std::sqrt(squares / TEMPLATE_LENGTH);
+    correlation = squares > 0 ? product / std::sqrt(squares) : 0;
+
+    uint32_t center_tick = bin_start_tick + bin_ticks - TEMPLATE_LENGTH / 2 * bin_ticks;
+    bool locked_out = lap_detected && static_cast<int32_t>(center_tick - next_lap_tick) < 0;
+    float required_correlation = learning ? LEARNING_CORRELATION : DETECTION_CORRELATION;
+    bool candidate = !locked_out && correlation >= required_correlation && deviation >= MIN_DEVIATION;
+
+    Result result = PASS_CORRELATOR_RESULT_NONE;
+    if (in_peak) {
+        bins_since_best++;
+        if (bins_since_best == 1) {
+            after_best_correlation = correlation;
+        }
+    }
+    if (candidate && (!in_peak || correlation > best_correlation)) {
+        in_peak = true;
+        best_correlation = correlation;
+        before_best_correlation = previous_correlation;
+        after_best_correlation = correlation;
+        bins_since_best = 0;
+        best_center_tick = center_tick;
+        best_window = window;
+    } else if (in_peak && (!candidate || bins_since_best >= TEMPLATE_LENGTH / 2)) {
+        result = finish_peak();
+    }
+    previous_correlation = correlation;
+    return result;
+}
+
+PassCorrelator::Result PassCorrelator::finish_peak() {
+    in_peak = false;
+
+    // Vertex of the parabola through the correlation around the peak.
+    float curvature = before_best_correlation - 2 * best_correlation + after_best_correlation;
+    float offset = curvature < 0 ? 0.5f * (before_best_correlation - after_best_correlation) / curvature : 0;
+    offset = std::clamp(offset, -0.5f, 0.5f);
+    int64_t offset_ticks = static_cast<int64_t>(offset * bin_ticks * (1 << GatePassEstimator::TICK_FRACTION_BITS));
+    uint64_t tick = (static_cast<uint64_t>(best_center_tick) << GatePassEstimator::TICK_FRACTION_BITS) + offset_ticks;
+
+    lap_detected = true;
+    next_lap_tick = best_center_tick + std::max<uint32_t>(lockout_ticks, TEMPLATE_LENGTH * bin_ticks);
+    lap_window = best_window;
+
+    Window pass = best_window;
+    normalize(pass);
+    float rate = learning && !learning_successful ? 1.0f : TEMPLATE_ADAPTATION_RATE;
+    for (uint8_t i = 0; i < TEMPLATE_LENGTH; i++) {
+        pass_template[i] += (pass[i] - pass_template[i]) * rate;
+    }
+    normalize(pass_template);
+
+    if (learning) {
+        learning_successful = true;
+        return PASS_CORRELATOR_RESULT_NONE;
+    }
+    lap_tick = tick;
+    lap_correlation = best_correlation;
+    return PASS_CORRELATOR_RESULT_LAP;
+}
+
+PassSignature PassCorrelator::get_pass_signature() const {
+    auto [min, max] = std::minmax_element(lap_window.begin(), lap_window.end());
+    float level = (*min + *max) / 2;
+    uint8_t peak_bin = static_cast<uint8_t>(max - lap_window.begin());
+    uint8_t first_bin = peak_bin;
+    while (first_bin > 0 && lap_window[first_bin - 1] >= level) {
+        first_bin--;
+    }
+    uint8_t last_bin = peak_bin;
+    while (last_bin + 1 < TEMPLATE_LENGTH && lap_window[last_bin + 1] >= level) {
+        last_bin++;
+    }
+    float rise = *max - level;
+    uint32_t rise_time_ms = std::max<uint32_t>((peak_bin - first_bin) * BIN_TIME_MS, 1);
+    uint32_t fall_time_ms = std::max<uint32_t>((last_bin - peak_bin) * BIN_TIME_MS, 1);
+    uint8_t confidence = static_cast<uint8_t>(std::clamp(lap_correlation * 100, 0.0f, 100.0f));
+    return PassSignature(static_cast<uint16_t>(*max), static_cast<uint16_t>((last_bin - first_bin + 1) * BIN_TIME_MS),
+        static_cast<uint16_t>(rise / rise_time_ms), static_cast<uint16_t>(rise / fall_time_ms), confidence);
+}
+
+void PassCorrelator::normalize(Window& window) {
+    float mean = 0;
+    for (float value : window) {
+        mean += value;
+    }
+    mean /= TEMPLATE_LENGTH;
+    float squares = 0;
+    for (float& value : window) {
+        value -= mean;
+        squares += value * value;
+    }
+    if (squares > 0) {
+        float norm = std::sqrt(squares);
+        for (float& value : window) {
+            value /= norm;
+        }
+    }
+}
+
+PassCorrelator::Window PassCorrelator::get_window() const {
+    Window window;
+    for (uint8_t i = 0; i < TEMPLATE_LENGTH; i++) {
+        window[i] = bins[(oldest_bin + i) % TEMPLATE_LENGTH];
+    }
+    return window;
+}
@@ -0,0 +1,95 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "rssi/rssi_sample_bus.h"
+
+#include <algorithm>
+
+RssiSampleBus::RssiSampleBus() :
+    sinks(),
+    sinks_count(0),
+    next_ticks() {
+    next_ticks.fill(UINT32_MAX);
+}
+
+bool RssiSampleBus::add_sink(BufferedRssiReaderDelegate& sink, uint8_t decimation) {
+    if (sinks_count == MAX_SINKS_COUNT || decimation == 0) {
+        return false;
+    }
+    sinks[sinks_count].delegate = &sink;
+    sinks[sinks_count].decimation = decimation;
+    sinks[sinks_count].skipped_samples.fill(0);
+    sinks_count++;
+    return true;
+}
+
+void RssiSampleBus::on_initialized(RssiReaderInterface& rssi_reader) {
+    for (uint8_t i = 0; i < sinks_count; i++) {
+        sinks[i].delegate->on_initialized(rssi_reader);
+    }
+}
+
+void RssiSampleBus::on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+    if (channel >= RssiReaderInterface::MAX_CHANNELS_COUNT) {
+        return;
+    }
+    bool continuous = first_sample_tick == next_ticks[channel];
+    next_ticks[channel] = first_sample_tick + count * tick_stride;
+
+    for (uint8_t i = 0; i < sinks_count; i++) {
+        Sink& sink = sinks[i];
+        if (sink.decimation == 1) {
+            sink.delegate->on_samples_captured(channel, samples, count, first_sample_tick, tick_stride);
+            continue;
+        }
+        if (!continuous) {
+            sink.skipped_samples[channel] = 0;
+        }
+        pass_decimated(sink, channel, samples, count, first_sample_tick, tick_stride);
+    }
+}
+
+void RssiSampleBus::pass_decimated(Sink& sink, uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+    uint8_t& skipped = sink.skipped_samples[channel];
+    if (skipped >= count) {
+        skipped -= static_cast<uint8_t>(count);
+        return;
+    }
+
+    uint16_t decimated[MAX_BLOCK_LENGTH];
+    size_t length = 0;
+    size_t first = skipped;
+    size_t index = first;
+    uint8_t decimated_stride = static_cast<uint8_t>(std::min<uint32_t>(tick_stride * sink.decimation, UINT8_MAX));
+    for (; index < count; index += sink.decimation) {
+        decimated[length++] = samples[index];
+        if (length == MAX_BLOCK_LENGTH) {
+            sink.delegate->on_samples_captured(channel, decimated, length, first_sample_tick + first * tick_stride, decimated_stride);
+            first = index + sink.decimation;
+            length = 0;
+        }
+    }
+    if (length > 0) {
+        sink.delegate->on_samples_captured(channel, decimated, length, first_sample_tick + first * tick_stride, decimated_stride);
+    }
+    skipped = static_cast<uint8_t>(index - count);
+}
@@ -0,0 +1,206 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "rssi/rssi_summary_stream.h"
+
+#include <algorithm>
+
+RssiSummaryStream::RssiSummaryStream(EventDispatcherInterface& event_dispatcher) :
+    event_dispatcher(event_dispatcher),
+    sample_interval_us(0),
+    channels_count(0),
+    requested_channel(0),
+    requested_rate_hz(0),
+    configuration_requested(false),
+    client(nullptr),
+    channel(0),
+    period_ticks(0),
+    period_started(false),
+    period_first_tick(0),
+    period_min(0),
+    period_max(0),
+    period_sum(0),
+    period_count(0),
+    summaries(),
+    sending_scheduled(false),
+    notification(),
+    notification_client(nullptr),
+    notification_first_tick(0),
+    notification_period_ticks(0),
+    sequence(0) {
+    event_dispatcher.register_observer(this, EVENTS);
+}
+
+bool RssiSummaryStream::start(Client& client, uint8_t channel, uint8_t rate_hz) {
+    if (sample_interval_us == 0 || channel >= channels_count) {
+        return false;
+    }
+    if (rate_hz < RSSI_STREAM_MIN_RATE_HZ || rate_hz > RSSI_STREAM_MAX_RATE_HZ) {
+        return false;
+    }
+    requested_channel.store(channel, std::memory_order_relaxed);
+    requested_rate_hz.store(rate_hz, std::memory_order_relaxed);
+    configuration_requested.store(true, std::memory_order_release);
+    this->client.store(&client, std::memory_order_release);
+    return true;
+}
+
+void RssiSummaryStream::stop(Client& client) {
+    Client* expected = &client;
+    if (this->client.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+        requested_rate_hz.store(0, std::memory_order_relaxed);
+        configuration_requested.store(true, std::memory_order_release);
+    }
+}
+
+void RssiSummaryStream::on_initialized(RssiReaderInterface& rssi_reader) {
+    sample_interval_us = rssi_reader.get_sample_interval_us();
+    channels_count = rssi_reader.get_channels_count();
+}
+
+void RssiSummaryStream::on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+    if (configuration_requested.exchange(false, std::memory_order_acquire)) {
+        uint32_t rate_hz = requested_rate_hz.load(std::memory_order_relaxed);
+        this->channel = requested_channel.load(std::memory_order_relaxed);
+        period_ticks = 0;
+        if (rate_hz > 0) {
+            uint32_t period_us = 1000000 / rate_hz;
+            period_ticks = std::max<uint32_t>((period_us + sample_interval_us / 2) / sample_interval_us, 1);
+        }
+        period_started = false;
+    }
+    if (period_ticks == 0 || channel != this->channel) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t tick = first_sample_tick + i * tick_stride;
+        if (!period_started || tick - period_first_tick >= period_ticks) {
+            if (period_started) {
+                finish_period();
+                // Periods without samples are skipped.
+                period_first_tick += (tick - period_first_tick) / period_ticks * period_ticks;
+            } else {
+                period_first_tick = tick;
+                period_started = true;
+            }
+            period_min = UINT16_MAX;
+            period_max = 0;
+            period_sum = 0;
+            period_count = 0;
+        }
+        period_min = std::min(period_min, samples[i]);
+        period_max = std::max(period_max, samples[i]);
+        period_sum += samples[i];
+        period_count++;
+    }
+}
+
+void RssiSummaryStream::finish_period() {
+    Summary* summary = summaries.reserve();
+    if (summary) {
+        summary->first_tick = period_first_tick;
+        summary->period_ticks = period_ticks;
+        summary->channel = channel;
+        summary->summary.min = period_min;
+        summary->summary.max = period_max;
+        summary->summary.mean = static_cast<uint16_t>(period_sum / period_count);
+        summaries.commit();
+    }
+
+    if (!sending_scheduled.exchange(true, std::memory_order_acq_rel)) {
+        event_dispatcher.emit_event(RssiSummariesAvailable());
+    }
+}
+
+void RssiSummaryStream::on_event(const Event& event) {
+    std::visit(overloaded{
+        [this](const RssiSummariesAvailable& summaries_available) {
+            send_queued_summaries();
+        },
+        [](auto other) {}
+    }, event);
+}
+
+size_t RssiSummaryStream::send_queued_summaries() {
+    // Summaries queued from now on need another event.
+    sending_scheduled.store(false, std::memory_order_release);
+
+    Client* current_client = client.load(std::memory_order_acquire);
+    if (current_client != notification_client) {
+        notification = Notification();
+        notification_client = current_client;
+        sequence = 0;
+    }
+    size_t max_length = current_client ? current_client->get_max_notification_length() : 0;
+    if (max_length < Notification::header_length + Notification::summary_length) {
+        // Nobody listens, summaries of the stopped stream are dropped.
+        while (summaries.front()) {
+            summaries.pop();
+        }
+        return 0;
+    }
+    size_t capacity = std::min<size_t>((max_length - Notification::header_length) / Notification::summary_length, MAX_SUMMARIES_PER_NOTIFICATION);
+
+    size_t sent = 0;
+    while (const Summary* summary = summaries.front()) {
+        if (notification.get_summary_count() > 0 && (notification.get_summary_count() >= capacity || !is_continuation(*summary))) {
+            if (!send_notification()) {
+                return sent;
+            }
+            sent++;
+        }
+        if (notification.get_summary_count() == 0) {
+            uint32_t first_time_ms = static_cast<uint32_t>(static_cast<uint64_t>(summary->first_tick) * sample_interval_us / 1000);
+            notification = Notification(summary->channel, sequence, first_time_ms, summary->period_ticks * sample_interval_us);
+            notification_first_tick = summary->first_tick;
+            notification_period_ticks = summary->period_ticks;
+        }
+        notification.add_summary(summary->summary);
+        summaries.pop();
+    }
+
+    uint64_t waiting_us = static_cast<uint64_t>(notification.get_summary_count()) * notification_period_ticks * sample_interval_us;
+    if (notification.get_summary_count() >= capacity || (notification.get_summary_count() > 0 && waiting_us >= MAX_LATENCY_MS * 1000)) {
+        if (send_notification()) {
+            sent++;
+        }
+    }
+    return sent;
+}
+
+bool RssiSummaryStream::is_continuation(const Summary& summary) const {
+    return summary.channel == notification.get_channel() &&
+           summary.period_ticks == notification_period_ticks &&
+           summary.first_tick == notification_first_tick + notification.get_summary_count() * notification_period_ticks;
+}
+
+bool RssiSummaryStream::send_notification() {
+    uint8_t data[Notification::max_length];
+    size_t length = notification.length();
+    if (!notification.serialize(data, length) || !notification_client->send_rssi_stream_notification(data, length)) {
+        return false;
+    }
+    sequence++;
+    notification = Notification();
+    return true;
+}
@@ -0,0 +1,112 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "rssi/sampling_scheduler.h"
+
+#include <algorithm>
+
+SamplingScheduler::SamplingScheduler() :
+    tick_interval_us(0),
+    channels() {}
+
+void SamplingScheduler::set_tick_interval_us(uint32_t tick_interval_us) {
+    this->tick_interval_us = tick_interval_us;
+}
+
+uint8_t SamplingScheduler::get_stride(Profile profile) const {
+    if (profile == SAMPLING_PROFILE_PASS || tick_interval_us == 0) {
+        return 1;
+    }
+    return static_cast<uint8_t>(std::clamp<uint32_t>(IDLE_SAMPLE_INTERVAL_US / tick_interval_us, 1, UINT8_MAX));
+}
+
+void SamplingScheduler::add_sample(uint8_t channel, uint16_t sample, uint32_t tick, bool calm) {
+    if (channel >= channels.size()) {
+        return;
+    }
+    ChannelState& state = channels[channel];
+    bool rising = state.has_trend && sample > state.trend_sample && sample - state.trend_sample >= TREND_MIN_RISE;
+    if (!calm || rising) {
+        state.last_active_tick = tick;
+    }
+    // Trend compares samples with the first one of the current window.
+    if (!state.has_trend || tick - state.trend_tick >= ms_to_ticks(TREND_WINDOW_MS)) {
+        state.has_trend = true;
+        state.trend_tick = tick;
+        state.trend_sample = sample;
+    }
+}
+
+void SamplingScheduler::add_lap(uint8_t channel, uint32_t lap_tick) {
+    if (channel >= channels.size()) {
+        return;
+    }
+    ChannelState& state = channels[channel];
+    if (state.has_lap) {
+        state.lap_ticks[state.next_lap_index] = lap_tick - state.last_lap_tick;
+        state.next_lap_index = (state.next_lap_index + 1) % LAP_HISTORY_LENGTH;
+    }
+    state.last_lap_tick = lap_tick;
+    state.has_lap = true;
+}
+
+void SamplingScheduler::reset_laps() {
+    for (ChannelState& state : channels) {
+        state.lap_ticks.fill(0);
+        state.next_lap_index = 0;
+        state.has_lap = false;
+    }
+}
+
+SamplingScheduler::Profile SamplingScheduler::get_profile(uint32_t tick) const {
+    uint32_t idle_enter_ticks = ms_to_ticks(IDLE_ENTER_TIME_MS);
+    for (const ChannelState& state : channels) {
+        if (tick - state.last_active_tick < idle_enter_ticks || is_pass_predicted(state, tick)) {
+            return SAMPLING_PROFILE_PASS;
+        }
+    }
+    return SAMPLING_PROFILE_IDLE;
+}
+
+bool SamplingScheduler::is_pass_predicted(const ChannelState& state, uint32_t tick) const {
+    uint32_t shortest_lap = 0;
+    for (uint32_t lap : state.lap_ticks) {
+        if (lap > 0 && (shortest_lap == 0 || lap < shortest_lap)) {
+            shortest_lap = lap;
+        }
+    }
+    if (shortest_lap == 0) {
+        return false;
+    }
+    // Drone which crashed or landed doesn't keep the full rate forever.
+    int32_t distance = static_cast<int32_t>(tick - (state.last_lap_tick + shortest_lap));
+    int32_t margin = static_cast<int32_t>(ms_to_ticks(PREDICTION_MARGIN_MS));
+    return distance >= -margin && distance <= margin;
+}
+
+uint32_t SamplingScheduler::ms_to_ticks(uint32_t ms) const {
+    if (tick_interval_us == 0) {
+        return 0;
+    }
+    return static_cast<uint32_t>(static_cast<uint64_t>(ms) * 1000 / tick_interval_us);
+}
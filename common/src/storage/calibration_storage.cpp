@@ -0,0 +1,117 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "storage/calibration_storage.h"
+#include "utils/log.h"
+
+CalibrationStorage::CalibrationStorage(EventDispatcherInterface &event_dispatcher, FlashStorageInterface &flash_storage)
+    : event_dispatcher(event_dispatcher),
+      flash_storage(flash_storage),
+      profile_records_data{},
+      template_records_data{} {
+    event_dispatcher.register_observer(this, EVENTS);
+}
+
+void CalibrationStorage::on_event(const Event& event) {
+    std::visit(overloaded{
+        [this](const SessionStorageInitialized& initialized) { on_session_storage_initialized(initialized); },
+        [this](const RssiCalibrationFinished& calibration_finished) { on_calibration_finished(calibration_finished); },
+        [](auto other) {}
+    }, event);
+}
+
+void CalibrationStorage::on_session_storage_initialized(const SessionStorageInitialized& initialized) {
+    for (uint8_t channel = 0; channel < RssiReaderInterface::MAX_CHANNELS_COUNT; channel++) {
+        RssiProfileRecordData record_data = {};
+        uint16_t words_count = sizeof(record_data) / 4;
+        uint16_t record_id = RSSI_PROFILE_RECORD_ID + channel;
+        if (!flash_storage.read_record(CALIBRATION_FILE_ID, record_id, reinterpret_cast<uint32_t*>(&record_data), &words_count)) {
+            continue;
+        }
+
+        if (words_count != sizeof(record_data) / 4 || record_data.version != RSSI_PROFILE_VERSION) {
+            LOG_WARNING("Stored RSSI profile of channel %u is not compatible, using default one.", channel);
+            continue;
+        }
+
+        event_dispatcher.emit_event(RssiProfileLoaded(RssiProfile(record_data.noise_floor, record_data.peak), channel));
+    }
+}
+
+bool CalibrationStorage::load_pass_template(uint8_t channel, PassTemplate& pass_template) {
+    if (channel >= RssiReaderInterface::MAX_CHANNELS_COUNT) {
+        return false;
+    }
+
+    PassTemplateRecordData record_data = {};
+    uint16_t words_count = sizeof(record_data) / 4;
+    uint16_t record_id = PASS_TEMPLATE_RECORD_ID + channel;
+    if (!flash_storage.read_record(CALIBRATION_FILE_ID, record_id, reinterpret_cast<uint32_t*>(&record_data), &words_count)) {
+        return false;
+    }
+
+    if (words_count != sizeof(record_data) / 4 || record_data.version != PASS_TEMPLATE_VERSION) {
+        LOG_WARNING("Stored pass template of channel %u is not compatible, using default one.", channel);
+        return false;
+    }
+
+    pass_template = PassTemplate(record_data.values);
+    return true;
+}
+
+void CalibrationStorage::on_calibration_finished(const RssiCalibrationFinished& calibration_finished) {
+    uint8_t channel = calibration_finished.get_channel();
+    if (!calibration_finished.is_successful() || channel >= RssiReaderInterface::MAX_CHANNELS_COUNT) {
+        return;
+    }
+
+    RssiProfile profile = calibration_finished.get_profile();
+    RssiProfileRecordData& record_data = profile_records_data[channel];
+    record_data.version = RSSI_PROFILE_VERSION;
+    record_data.noise_floor = profile.get_noise_floor();
+    record_data.peak = profile.get_peak();
+
+    LOG_INFO("Saving RSSI profile of channel %u...", channel);
+    uint16_t record_id = RSSI_PROFILE_RECORD_ID + channel;
+    if (!flash_storage.write_record(CALIBRATION_FILE_ID, record_id, reinterpret_cast<const uint32_t*>(&record_data), sizeof(record_data) / 4)) {
+        LOG_WARNING("Failed to save RSSI profile of channel %u.", channel);
+    }
+}
+
+bool CalibrationStorage::save_pass_template(uint8_t channel, const PassTemplate& pass_template) {
+    if (channel >= RssiReaderInterface::MAX_CHANNELS_COUNT) {
+        return false;
+    }
+
+    PassTemplateRecordData& record_data = template_records_data[channel];
+    record_data.version = PASS_TEMPLATE_VERSION;
+    record_data.values = pass_template.get_values();
+
+    LOG_INFO("Saving pass template of channel %u...", channel);
+    uint16_t record_id = PASS_TEMPLATE_RECORD_ID + channel;
+    if (!flash_storage.write_record(CALIBRATION_FILE_ID, record_id, reinterpret_cast<const uint32_t*>(&record_data), sizeof(record_data) / 4)) {
+        LOG_WARNING("Failed to save pass template of channel %u.", channel);
+        return false;
+    }
+    return true;
+}
@@ -32,9 +32,12 @@ SessionStorage::SessionStorage(EventDispatcherInterface &event_dispatcher, Flash
       first_session_id(0),
       last_session_id(0),
       last_lap_id(0),
-      last_session_completed(true) {
+      last_session_completed(true),
+      lap_records_data{},
+      last_pass_timestamps_us{},
+      last_pass_valid{} {
     flash_storage.set_delegate(this);
-    event_dispatcher.register_observer(this);
+    event_dispatcher.register_observer(this, EVENTS);
 }
 
 void SessionStorage::on_event(const Event& event) {
@@ -43,6 +46,7 @@ void SessionStorage::on_event(const Event& event) {
         [this](const StartSession& start_session) { on_start_session(start_session); },
         [this](const StopSession& stop_session) { on_stop_session(stop_session); },
         [this](const AddLapTime& add_lap_time) { on_add_lap_time(add_lap_time); },
+        [this](const NewLap& new_lap) { on_new_lap(new_lap); },
         [](auto other) {}
     }, event);
 }
@@ -117,10 +121,9 @@ void SessionStorage::send_reset_storage_result(bool successful) {
 
 void SessionStorage::on_start_session(const StartSession& start_session) {
     LOG_INFO("Saving new session...");
-    if (!last_session_completed) {
-        last_session_completed = false;
-        last_lap_id = 0;
-    }
+    last_session_completed = false;
+    last_lap_id = 0;
+    last_pass_valid.fill(false);
     if (first_session_id == 0) {
         first_session_id++;
     }
@@ -134,4 +137,58 @@ void SessionStorage::on_stop_session(const StopSession& stop_session) {
 
 void SessionStorage::on_add_lap_time(const AddLapTime& add_lap_time) {
     LOG_INFO("Adding lap time...");
+    if (last_session_completed || last_lap_id == UINT8_MAX) {
+        LOG_WARNING("Lap time added outside of a session.");
+        return;
+    }
+
+    last_lap_id++;
+    const PassSignature& signature = add_lap_time.get_pass_signature();
+    LapRecordData& record_data = lap_records_data[last_lap_id % LAP_RECORDS_IN_FLIGHT];
+    record_data = {};
+    record_data.lap_time = add_lap_time.get_lap_time();
+    record_data.peak = signature.get_peak();
+    record_data.duration_ms = signature.get_duration_ms();
+    record_data.rise_slope = signature.get_rise_slope();
+    record_data.fall_slope = signature.get_fall_slope();
+    record_data.confidence = signature.get_confidence();
+    record_data.channel = add_lap_time.get_channel();
+
+    if (!flash_storage.write_record(last_session_id, last_lap_id, reinterpret_cast<const uint32_t*>(&record_data), sizeof(record_data) / 4)) {
+        LOG_WARNING("Failed to save lap %u of session %u.", last_lap_id, last_session_id);
+    }
+}
+
+void SessionStorage::on_new_lap(const NewLap& new_lap) {
+    uint8_t channel = new_lap.get_channel();
+    if (last_session_completed || channel >= RssiReaderInterface::MAX_CHANNELS_COUNT) {
+        return;
+    }
+    // First pass of a session only starts the lap.
+    uint64_t timestamp_us = new_lap.get_timestamp_us();
+    if (last_pass_valid[channel]) {
+        uint32_t lap_time = static_cast<uint32_t>((timestamp_us - last_pass_timestamps_us[channel]) / 1000);
+        event_dispatcher.emit_event(AddLapTime(lap_time, new_lap.get_pass_signature(), channel));
+    }
+    last_pass_timestamps_us[channel] = timestamp_us;
+    last_pass_valid[channel] = true;
+}
+
+bool SessionStorage::load_lap(uint16_t session_id, uint8_t lap_id, uint32_t& lap_time, PassSignature& pass_signature, uint8_t& channel) {
+    LapRecordData record_data = {};
+    uint16_t words_count = sizeof(record_data) / 4;
+    if (!flash_storage.read_record(session_id, lap_id, reinterpret_cast<uint32_t*>(&record_data), &words_count) || words_count == 0) {
+        return false;
+    }
+    // Older records contain only the lap time.
+    lap_time = record_data.lap_time;
+    pass_signature = PassSignature(
+        record_data.peak,
+        record_data.duration_ms,
+        record_data.rise_slope,
+        record_data.fall_slope,
+        record_data.confidence
+    );
+    channel = record_data.channel;
+    return true;
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "telemetry/telemetry_frame.h"
+#include "utils/byte_utils.h"
+#include "utils/crc16.h"
+
+#include <algorithm>
+#include <cstring>
+
+static size_t write_varint(uint32_t value, uint8_t* data) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        data[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    data[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+static size_t read_varint(const uint8_t* data, size_t length, uint32_t* value) {
+    *value = 0;
+    for (size_t i = 0; i < length && i < TelemetryFrame::MAX_SAMPLE_LENGTH; i++) {
+        *value |= static_cast<uint32_t>(data[i] & 0x7F) << (7 * i);
+        if ((data[i] & 0x80) == 0) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t zigzag_encode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+TelemetryFrame::TelemetryFrame() : TelemetryFrame(0, 0, 0, 0) {}
+
+TelemetryFrame::TelemetryFrame(uint8_t channel, uint16_t sequence, uint32_t first_sample_tick, uint16_t dropped_frames, uint8_t tick_stride) :
+    channel(channel),
+    sequence(sequence),
+    first_sample_tick(first_sample_tick),
+    dropped_frames(dropped_frames),
+    tick_stride(tick_stride),
+    samples{},
+    samples_count(0) {}
+
+size_t TelemetryFrame::set_samples(const uint16_t* samples, size_t count) {
+    samples_count = std::min(count, MAX_SAMPLES);
+    std::memcpy(this->samples, samples, samples_count * sizeof(uint16_t));
+    return samples_count;
+}
+
+size_t TelemetryFrame::encode(uint8_t* buffer, size_t length) const {
+    uint8_t frame[MAX_LENGTH];
+    frame[0] = VERSION;
+    frame[1] = channel;
+    write_uint16_le(sequence, frame + 2);
+    write_uint32_le(first_sample_tick, frame + 4);
+    write_uint16_le(dropped_frames, frame + 8);
+    frame[10] = static_cast<uint8_t>(samples_count);
+    frame[11] = tick_stride;
+
+    size_t frame_length = HEADER_LENGTH;
+    uint16_t previous_sample = 0;
+    for (size_t i = 0; i < samples_count; i++) {
+        int32_t delta = static_cast<int32_t>(samples[i]) - previous_sample;
+        frame_length += write_varint(zigzag_encode(delta), frame + frame_length);
+        previous_sample = samples[i];
+    }
+
+    write_uint16_le(crc16_ccitt(frame, frame_length), frame + frame_length);
+    frame_length += CRC_LENGTH;
+
+    if (length == 0) {
+        return 0;
+    }
+    size_t encoded_length = cobs_encode(frame, frame_length, buffer, length - 1);
+    if (encoded_length == 0) {
+        return 0;
+    }
+    buffer[encoded_length++] = DELIMITER;
+    return encoded_length;
+}
+
+bool TelemetryFrame::decode(const uint8_t* buffer, size_t length) {
+    uint8_t frame[MAX_LENGTH];
+    size_t frame_length = cobs_decode(buffer, length, frame, sizeof(frame));
+    // Frames without the tick stride are still accepted, so older captures can be replayed.
+    size_t header_length = frame_length > 0 && frame[0] == UNSTRIDED_VERSION ? HEADER_LENGTH - 1 : HEADER_LENGTH;
+    if (frame_length < header_length + CRC_LENGTH) {
+        return false;
+    }
+
+    frame_length -= CRC_LENGTH;
+    if (read_uint16_le(frame + frame_length) != crc16_ccitt(frame, frame_length)) {
+        return false;
+    }
+    uint8_t frame_tick_stride = frame[0] == UNSTRIDED_VERSION ? 1 : frame[11];
+    if ((frame[0] != VERSION && frame[0] != UNSTRIDED_VERSION) || frame[10] > MAX_SAMPLES || frame_tick_stride == 0) {
+        return false;
+    }
+
+    size_t offset = header_length;
+    uint16_t previous_sample = 0;
+    for (size_t i = 0; i < frame[10]; i++) {
+        uint32_t value;
+        size_t value_length = read_varint(frame + offset, frame_length - offset, &value);
+        if (value_length == 0) {
+            return false;
+        }
+        offset += value_length;
+        samples[i] = static_cast<uint16_t>(previous_sample + zigzag_decode(value));
+        previous_sample = samples[i];
+    }
+    if (offset != frame_length) {
+        return false;
+    }
+
+    channel = frame[1];
+    sequence = read_uint16_le(frame + 2);
+    first_sample_tick = read_uint32_le(frame + 4);
+    dropped_frames = read_uint16_le(frame + 8);
+    tick_stride = frame_tick_stride;
+    samples_count = frame[10];
+    return true;
+}
@@ -0,0 +1,114 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "trace/latency_tracer.h"
+#include "utils/log.h"
+
+LatencyTracer::LatencyTracer(EventDispatcherInterface& event_dispatcher, CycleCounterInterface& cycle_counter) :
+    cycle_counter(cycle_counter),
+    histograms(),
+    priorities(),
+    block_captured_cycles(0),
+    block_captured_priority(CycleCounterInterface::THREAD_PRIORITY),
+    block_processing_cycles(0),
+    trace_state(TRACE_STATE_IDLE),
+    trace_start_cycles(0),
+    trace_mark_cycles(0),
+    completed_traces(0) {
+    priorities.fill(CycleCounterInterface::THREAD_PRIORITY);
+    event_dispatcher.register_observer(this, EVENTS);
+}
+
+void LatencyTracer::on_event(const Event& event) {
+    std::visit(overloaded{
+        [this](const NewLap& new_lap) {
+            if (trace_state != TRACE_STATE_DETECTED) {
+                return;
+            }
+            uint32_t cycles = cycle_counter.get_cycles();
+            uint8_t priority = cycle_counter.get_execution_priority();
+            add_stage(LATENCY_STAGE_DISPATCH, trace_mark_cycles, cycles, priority);
+            add_stage(LATENCY_STAGE_TOTAL, trace_start_cycles, cycles, priority);
+            trace_state = TRACE_STATE_IDLE;
+
+            completed_traces++;
+            if (completed_traces % LOG_INTERVAL_TRACES == 0) {
+                log_summary();
+            }
+        },
+        [](auto other) {}
+    }, event);
+}
+
+void LatencyTracer::on_block_processing(uint32_t captured_cycles, uint8_t captured_priority) {
+    block_captured_cycles = captured_cycles;
+    block_captured_priority = captured_priority;
+    block_processing_cycles = cycle_counter.get_cycles();
+}
+
+void LatencyTracer::on_lap_detected() {
+    uint32_t cycles = cycle_counter.get_cycles();
+    // Block is queued by the interrupt which captured it.
+    add_stage(LATENCY_STAGE_QUEUE, block_captured_cycles, block_processing_cycles, block_captured_priority);
+    add_stage(LATENCY_STAGE_DETECTION, block_processing_cycles, cycles, cycle_counter.get_execution_priority());
+    trace_start_cycles = block_captured_cycles;
+    trace_mark_cycles = cycles;
+    trace_state = TRACE_STATE_DETECTED;
+}
+
+void LatencyTracer::reset() {
+    for (auto& histogram : histograms) {
+        histogram.reset();
+    }
+    priorities.fill(CycleCounterInterface::THREAD_PRIORITY);
+    trace_state = TRACE_STATE_IDLE;
+    completed_traces = 0;
+}
+
+void LatencyTracer::log_summary() const {
+    // Unused when logs are compiled out.
+    [[maybe_unused]] static const char* const stage_names[LATENCY_STAGES_COUNT] = {
+        "queue", "detection", "dispatch", "total"
+    };
+    for (uint8_t stage = 0; stage < LATENCY_STAGES_COUNT; stage++) {
+        [[maybe_unused]] const LatencyHistogram& histogram = histograms[stage];
+        // Logger takes at most 6 arguments.
+        LOG_INFO("Latency %s: count=%u min=%uus max=%uus priority=%u",
+            stage_names[stage],
+            static_cast<unsigned>(histogram.get_count()),
+            static_cast<unsigned>(histogram.get_min_us()),
+            static_cast<unsigned>(histogram.get_max_us()),
+            static_cast<unsigned>(priorities[stage])
+        );
+        LOG_INFO("Latency %s: p50=%uus p99=%uus",
+            stage_names[stage],
+            static_cast<unsigned>(histogram.get_percentile_us(50)),
+            static_cast<unsigned>(histogram.get_percentile_us(99))
+        );
+    }
+}
+
+void LatencyTracer::add_stage(Stage stage, uint32_t start_cycles, uint32_t end_cycles, uint8_t priority) {
+    // Unsigned difference is correct across a single counter wrap-around.
+    histograms[stage].add((end_cycles - start_cycles) / cycle_counter.get_cycles_per_us());
+    priorities[stage] = priority;
+}
@@ -0,0 +1,90 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "utils/cobs.h"
+
+size_t cobs_encode(const uint8_t* data, size_t length, uint8_t* output, size_t output_length) {
+    if (output_length == 0) {
+        return 0;
+    }
+
+    // Each block starts with a code byte: distance to the next zero, up to 254 data bytes.
+    size_t code_index = 0;
+    size_t output_index = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] != 0) {
+            if (output_index >= output_length) {
+                return 0;
+            }
+            output[output_index++] = data[i];
+            code++;
+        }
+
+        if (data[i] == 0 || code == 0xFF) {
+            output[code_index] = code;
+            code = 1;
+            // Full block at the very end doesn't need a following empty block.
+            if (data[i] != 0 && i + 1 == length) {
+                return output_index;
+            }
+            if (output_index >= output_length) {
+                return 0;
+            }
+            code_index = output_index++;
+        }
+    }
+
+    output[code_index] = code;
+    return output_index;
+}
+
+size_t cobs_decode(const uint8_t* data, size_t length, uint8_t* output, size_t output_length) {
+    size_t output_index = 0;
+    size_t i = 0;
+
+    while (i < length) {
+        uint8_t code = data[i++];
+        if (code == 0 || i + code - 1 > length) {
+            return 0;
+        }
+
+        for (uint8_t j = 1; j < code; j++) {
+            if (data[i] == 0 || output_index >= output_length) {
+                return 0;
+            }
+            output[output_index++] = data[i++];
+        }
+
+        // Block shorter than maximum is followed by a zero, except for the last one.
+        if (code != 0xFF && i < length) {
+            if (output_index >= output_length) {
+                return 0;
+            }
+            output[output_index++] = 0;
+        }
+    }
+
+    return output_index;
+}
@@ -0,0 +1,76 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "utils/dsp.h"
+
+size_t dsp_decimate2(const uint16_t* input, size_t count, uint16_t* output) {
+    size_t output_count = count / 2;
+    size_t i = 0;
+    // Four input samples give two averages: rounded (a + b) / 2 is (a | b) - ((a ^ b) >> 1),
+    // which doesn't carry between lanes.
+    for (; i + 1 < output_count; i += 2) {
+        uint32_t first = simd_load_pair(&input[2 * i]);
+        uint32_t second = simd_load_pair(&input[2 * i + 2]);
+        uint32_t a = simd_pack_low(first, second);
+        uint32_t b = simd_pack_high(first, second);
+        simd_store_pair(&output[i], (a | b) - (((a ^ b) >> 1) & 0x7FFF7FFF));
+    }
+    if (i < output_count) {
+        output[i] = static_cast<uint16_t>((input[2 * i] + input[2 * i + 1] + 1) / 2);
+    }
+    return output_count;
+}
+
+size_t dsp_decimate2_scalar(const uint16_t* input, size_t count, uint16_t* output) {
+    size_t output_count = count / 2;
+    for (size_t i = 0; i < output_count; i++) {
+        output[i] = static_cast<uint16_t>((input[2 * i] + input[2 * i + 1] + 1) / 2);
+    }
+    return output_count;
+}
+
+size_t dsp_find_above(const uint16_t* samples, size_t count, uint16_t level) {
+    if (level == UINT16_MAX) {
+        return count;
+    }
+    uint32_t levels = (level + 1u) * 0x00010001u;
+    size_t i = 0;
+    for (; i + 1 < count; i += 2) {
+        uint32_t mask = simd_mask_ge_u16(simd_load_pair(&samples[i]), levels);
+        if (mask) {
+            return (mask & 0xFFFF) ? i : i + 1;
+        }
+    }
+    if (i < count && samples[i] > level) {
+        return i;
+    }
+    return count;
+}
+
+size_t dsp_find_above_scalar(const uint16_t* samples, size_t count, uint16_t level) {
+    for (size_t i = 0; i < count; i++) {
+        if (samples[i] > level) {
+            return i;
+        }
+    }
+    return count;
+}
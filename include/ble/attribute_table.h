@@ -78,6 +78,18 @@ class AttributeTable {
             return rx_characteristic_uuid;
         }
 
+        ///
+        /// @brief Get the LapTimer RSSI stream characteristic UUID.
+        ///
+        /// Peripheral sends RSSI summaries as notifications of this
+        /// attribute, see RssiStreamNotification.
+        ///
+        /// @return ble_uuid_t LapTimer RSSI stream characteristic.
+        ///
+        ble_uuid_t get_stream_characteristic_uuid() const {
+            return stream_characteristic_uuid;
+        }
+
         ///
         /// @brief Get the LapTimer service handle.
         /// 
@@ -105,6 +117,15 @@ class AttributeTable {
             return rx_characteristic_handles.value_handle;
         }
 
+        ///
+        /// @brief Get the LapTimer RSSI stream handle.
+        ///
+        /// @return uint16_t LapTimer RSSI stream handle.
+        ///
+        uint16_t get_stream_characteristic_handle() const {
+            return stream_characteristic_handles.value_handle;
+        }
+
     private:
         ble_uuid128_t base_uuid128;
         uint8_t base_uuid_type;
@@ -123,6 +144,12 @@ class AttributeTable {
         ble_gatts_attr_md_t rx_characteristic_attr_md;
         ble_gatts_attr_t rx_characteristic_attr;
         ble_gatts_char_handles_t rx_characteristic_handles;
+
+        ble_uuid_t stream_characteristic_uuid;
+        ble_gatts_char_md_t stream_characteristic_md;
+        ble_gatts_attr_md_t stream_characteristic_attr_md;
+        ble_gatts_attr_t stream_characteristic_attr;
+        ble_gatts_char_handles_t stream_characteristic_handles;
 };
 
 #endif // LAP_TIMER_BLE_ATTRIBUTE_TABLE_H
\ No newline at end of file
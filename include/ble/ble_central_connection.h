@@ -141,6 +141,7 @@ public:
     }
 
     virtual bool send_to_rx(const uint8_t* data, uint16_t length) override;
+    virtual bool send_to_stream(const uint8_t* data, uint16_t length) override;
 
 private:
     constexpr static int mac_address_string_len = BLE_GAP_ADDR_LEN * 3;
@@ -25,12 +25,28 @@
 
 #include "app_timer.h"
 
+#include "events/delayed_event_queue.h"
 #include "events/event_dispatcher_interface.h"
+#include "events/event_lanes.h"
 #include "events/event_observer.h"
-
-#include <array>
-#include <atomic>
-
+#include "events/event_subscriptions.h"
+
+// Maximum number of pending scheduled events, each takes sizeof(Event) + 16 bytes.
+#ifndef EVENT_DISPATCHER_DELAYED_EVENTS_COUNT
+#define EVENT_DISPATCHER_DELAYED_EVENTS_COUNT 16
+#endif
+
+///
+/// @brief Event dispatcher running observers in the main loop.
+///
+/// Emitted events wait in an urgent or a background lane, see EVENT_MASK_URGENT. Urgent events are
+/// always dispatched first, background ones only within the cycle budget of handle_events().
+///
+/// Scheduled events wait in a min-heap ordered by their RealTimeClock deadline. A single app_timer
+/// is armed for the earliest deadline, so the number of pending events is limited only by the heap
+/// size. Periodic events are due at multiples of their period from RealTimeClock, so they don't
+/// drift with timer latency.
+///
 class EventDispatcher : public EventDispatcherInterface {
 public:
     static EventDispatcher& get_instance() {
@@ -44,35 +60,57 @@ public:
     EventDispatcher& operator=(EventDispatcher&&) = delete;
 
     void initialize();
+    static constexpr uint32_t UNLIMITED_CYCLE_BUDGET = UINT32_MAX;
+
+    ///
+    /// @brief Sleep until an interrupt, unless there are pending events.
+    ///
     void wait_for_event();
-    void handle_events();
+
+    ///
+    /// @brief Dispatch pending events.
+    ///
+    /// All urgent events are dispatched, including ones emitted meanwhile. Background events are
+    /// dispatched until the budget runs out, the rest waits for the next call.
+    ///
+    /// @param cycle_budget CPU cycles after which background events yield to the main loop.
+    ///
+    void handle_events(uint32_t cycle_budget = UNLIMITED_CYCLE_BUDGET);
 
 public:
-    bool register_observer(EventObserver* observer) override;
+    using EventDispatcherInterface::register_observer;
+    bool register_observer(EventObserver* observer, EventMask events) override;
     bool unregister_observer(EventObserver* observer) override;
     void emit_event(const Event& event) override;
-    void emit_event_delayed(const Event& event, uint32_t ms_delay) override;
+    EventHandle emit_event_delayed(const Event& event, uint32_t ms_delay) override;
+    EventHandle emit_event_at(const Event& event, uint32_t timestamp_ms) override;
+    EventHandle emit_event_periodic(const Event& event, uint32_t ms_period) override;
+    bool cancel(EventHandle handle) override;
 
 private:
     EventDispatcher();
 
     static void handle_timer_event(void *context);
-    static void handle_app_event(void *event_data, uint16_t event_size);
-
-    static constexpr size_t MAX_EVENTS_COUNT = 16;
-    static constexpr size_t MAX_OBSERVERS_COUNT = 4;
-    static constexpr size_t MAX_TIMERS_COUNT = 8;
-    
-    struct TimerState {
-        TimerState() : timer {0}, timer_id {nullptr} {}
-        app_timer_t timer;
-        app_timer_id_t timer_id;
-        Event event;
-        std::atomic<bool> used;
-    };
-
-    std::array<EventObserver*, MAX_OBSERVERS_COUNT> observers;
-    std::array<TimerState, MAX_TIMERS_COUNT> timers;
+
+    void push_event(const Event& event);
+    bool pop_event(Event& event, bool include_background);
+
+    EventHandle schedule(const Event& event, uint32_t timestamp_ms, uint32_t ms_period);
+    void start_timer(uint32_t now);
+
+    static constexpr uint8_t MAX_URGENT_EVENTS_COUNT = 16;
+    static constexpr uint8_t MAX_BACKGROUND_EVENTS_COUNT = 16;
+    static constexpr size_t MAX_OBSERVERS_COUNT = 8;
+    // Longer delays are waited for in parts, app_timer can't wait longer than half of its counter.
+    static constexpr uint32_t MAX_TIMEOUT_TICKS = APP_TIMER_MAX_CNT_VAL / 2;
+
+    EventSubscriptions<MAX_OBSERVERS_COUNT> subscriptions;
+
+    // Accessed in critical regions only.
+    EventLanes<MAX_URGENT_EVENTS_COUNT, MAX_BACKGROUND_EVENTS_COUNT> lanes;
+    DelayedEventQueue<EVENT_DISPATCHER_DELAYED_EVENTS_COUNT> delayed_events;
+    app_timer_t timer;
+    app_timer_id_t timer_id;
 };
 
 #endif // LAP_TIMER_EVENT_DISPATCHER_H
\ No newline at end of file
@@ -23,12 +23,24 @@
 
 #include "rssi/rssi_reader_interface.h"
 #include <nrfx_saadc.h>
-#include <nrfx_uart.h>
 #include <nrfx_timer.h>
 #include <nrf_ppi.h>
 
+#include <array>
+#include <atomic>
+
 #include "time/real_time_clock.h"
 
+// Number of samples captured by EasyDMA before the SAADC raises an interrupt.
+#ifndef RSSI_READER_SAMPLES_IN_BLOCK
+#define RSSI_READER_SAMPLES_IN_BLOCK 32
+#endif
+
+// Number of SAADC inputs scanned, each one connected to a separate video receiver.
+#ifndef RSSI_READER_CHANNELS_COUNT
+#define RSSI_READER_CHANNELS_COUNT 1
+#endif
+
 class RssiReader : RssiReaderInterface {
 public:
     RssiReader(const RssiReader&) = delete;
@@ -54,27 +66,133 @@ public:
     ///
     void initialize(RssiReaderInterface::Delegate& delegate) override;
 
+    ///
+    /// @brief Get time between two consecutive samples.
+    ///
+    /// @return uint32_t Sample interval in microseconds.
+    ///
+    uint32_t get_sample_interval_us() const override;
+
+    ///
+    /// @brief Get number of channels sampled simultaneously.
+    ///
+    /// @return uint8_t Number of channels.
+    ///
+    uint8_t get_channels_count() const override;
+
+    ///
+    /// @brief Stop triggering SAADC until the given tick.
+    ///
+    /// Sampling stops at the end of the block being captured, so the pause is aligned to blocks.
+    /// Both the pause and the resume are triggered by TIMER2 counting sampling timer events through
+    /// PPI, so the resumed sampling stays in phase with the ticks.
+    ///
+    /// @param resume_tick Tick of the first sample captured after the pause.
+    ///
+    void suspend_sampling(uint32_t resume_tick) override;
+
+    ///
+    /// @brief Stop passing blocks until a sample rises above the SAADC upper limit of its channel.
+    ///
+    /// SAADC keeps converting into a single buffer restarted by PPI, with the END interrupt disabled,
+    /// so only the LIMIT interrupt wakes up the CPU. Wake-up is armed at the end of the next block.
+    ///
+    /// @param levels Wake-up level of each channel, normalized to 16 bits precision.
+    ///
+    void arm_wakeup(const std::array<uint16_t, MAX_CHANNELS_COUNT>& levels) override;
+
+    ///
+    /// @brief Oversample each sample stride times more, so it spans stride ticks.
+    ///
+    /// Sampling timer keeps its period, so ticks and the trigger counter are not affected. Change is
+    /// made during a short pause after the next block, like suspend_sampling(), so no buffer is lost.
+    /// Strides are rounded down to a power of two up to MAX_SAMPLE_STRIDE, scan mode supports only 1.
+    ///
+    /// @param stride Ticks between consecutive samples.
+    ///
+    void set_sample_stride(uint8_t stride) override;
+
 private:
     RssiReader();
 
     void initialize_adc();
     void initialize_sampling_timer();
-    void initalize_uart_logger();
+    void initialize_trigger_counter();
     void enable_sampling();
+    void update_pause(uint32_t block_end_tick);
+    void schedule_pause(uint32_t pause_tick, uint32_t resume_tick);
+    void schedule_stride_change(uint32_t block_end_tick);
+    void enter_idle();
+    void wake_up();
 
+    static nrf_saadc_oversample_t get_oversample(uint8_t stride);
     static void handle_adc_event(nrfx_saadc_evt_t const * p_event);
     bool handle_adc_event_impl(nrfx_saadc_evt_t const * p_event);
-    void log_sample(uint16_t sample);
+
+    enum PauseState : uint8_t {
+        PAUSE_STATE_NONE      = 0x00,
+        // Pause and resume are programmed into TIMER2, sampling runs.
+        PAUSE_STATE_SCHEDULED = 0x01,
+        // Sampling was paused, the next block is captured after the resume.
+        PAUSE_STATE_PAUSED    = 0x02,
+    };
 
     Delegate* delegate;
 
     const nrfx_timer_t timer;
-    const nrfx_uart_t uart;
-
-    static constexpr size_t SAMPLES_IN_BUFFER = 1;
-    nrf_saadc_value_t buffer_pool[2][SAMPLES_IN_BUFFER];
-    nrf_ppi_channel_t ppi_channel;
-    uint8_t sample_seq;
+    // Counts sampling timer events, including ones skipped during pause.
+    const nrfx_timer_t trigger_counter;
+
+    static constexpr uint8_t CHANNELS_COUNT = RSSI_READER_CHANNELS_COUNT;
+    static_assert(CHANNELS_COUNT > 0 && CHANNELS_COUNT <= RssiReaderInterface::MAX_CHANNELS_COUNT);
+    static constexpr nrf_saadc_input_t CHANNEL_INPUTS[RssiReaderInterface::MAX_CHANNELS_COUNT] = {
+        NRF_SAADC_INPUT_AIN7, NRF_SAADC_INPUT_AIN6, NRF_SAADC_INPUT_AIN5, NRF_SAADC_INPUT_AIN4,
+        NRF_SAADC_INPUT_AIN3, NRF_SAADC_INPUT_AIN2, NRF_SAADC_INPUT_AIN1, NRF_SAADC_INPUT_AIN0,
+    };
+
+    // Oversampling in scan mode works only with burst, when a single trigger converts all channels
+    // with all oversampled conversions. It takes 8 * (5us + 2us) per channel, so 8 channels fit in 500us.
+    // A single channel is oversampled 64 times without burst, one conversion per timer trigger.
+    static constexpr bool SCAN_MODE = CHANNELS_COUNT > 1;
+    static constexpr uint32_t SAMPLING_TIMER_FREQUENCY_HZ = 16000000;
+    static constexpr uint32_t SAMPLING_TIMER_COMPARE_VALUE = SCAN_MODE ? 8000 : 100;
+    static constexpr uint32_t TRIGGERS_PER_TICK = SCAN_MODE ? 1 : 64;
+    // Oversampling goes up to 256x, four times more than at a single tick.
+    static constexpr uint8_t MAX_SAMPLE_STRIDE = SCAN_MODE ? 1 : 4;
+    // Ticks between the pause and the resume of a stride change, SAADC is reconfigured in between.
+    static constexpr uint32_t STRIDE_CHANGE_GAP_TICKS = 2;
+    static constexpr size_t SAMPLES_IN_BLOCK = RSSI_READER_SAMPLES_IN_BLOCK;
+
+    // SAADC stores samples of all channels interleaved.
+    nrf_saadc_value_t buffer_pool[2][SAMPLES_IN_BLOCK * CHANNELS_COUNT];
+    // Buffer converted after the current one, the driver keeps both.
+    nrf_saadc_value_t* queued_buffer;
+    uint16_t block[CHANNELS_COUNT][SAMPLES_IN_BLOCK];
+    uint32_t next_block_tick;
+    nrf_ppi_channel_t sampling_ppi_channel;
+    nrf_ppi_channel_t counting_ppi_channel;
+    nrf_ppi_channel_t pause_ppi_channel;
+    nrf_ppi_channel_t resume_ppi_channel;
+    // Restarts conversions into the same buffer while idle.
+    nrf_ppi_channel_t idle_ppi_channel;
+    // Contains only the sampling channel, so it can be enabled and disabled by events.
+    nrf_ppi_channel_group_t sampling_ppi_group;
+
+    PauseState pause_state;
+    uint32_t pause_tick;
+    uint32_t resume_tick;
+    uint32_t requested_resume_tick;
+    std::atomic<bool> pause_requested;
+
+    bool idle;
+    std::array<uint16_t, RssiReaderInterface::MAX_CHANNELS_COUNT> requested_wakeup_levels;
+    std::atomic<bool> wakeup_requested;
+
+    // Ticks between samples, changed only while paused.
+    uint8_t sample_stride;
+    uint8_t pending_stride;
+    uint8_t requested_stride;
+    std::atomic<bool> stride_requested;
 };
 
 #endif //LAP_TIMER_RSSI_READER_H
@@ -0,0 +1,99 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_TELEMETRY_SENDER_H
+#define LAP_TIMER_TELEMETRY_SENDER_H
+
+#include <nrfx_uarte.h>
+
+#include "rssi/rssi_reader_interface.h"
+#include "telemetry/telemetry_stream.h"
+
+#include <atomic>
+
+// Size of the ring buffer of encoded frames waiting for UARTE.
+#ifndef TELEMETRY_SENDER_BUFFER_SIZE
+#define TELEMETRY_SENDER_BUFFER_SIZE 2048
+#endif
+
+///
+/// @brief Sends RSSI telemetry frames over UARTE with EasyDMA.
+///
+/// Frames are queued in a TelemetryStream and each contiguous chunk of the ring buffer is sent
+/// as a single DMA transfer, so CPU is involved only once per chunk. The sender is a sink of
+/// the RssiSampleBus behind a BufferedRssiReaderDelegate, so frames are encoded in the event loop.
+///
+/// @note push_samples() starts a transfer only when none is in progress, so the UARTE interrupt,
+///       which starts the following ones, can't run meanwhile.
+///
+class TelemetrySender : public RssiReaderInterface::Delegate {
+public:
+    TelemetrySender(const TelemetrySender&) = delete;
+    TelemetrySender(TelemetrySender&&) = delete;
+    TelemetrySender& operator=(const TelemetrySender&) = delete;
+    TelemetrySender& operator=(TelemetrySender&&) = delete;
+
+    ///
+    /// @brief Get global singleton instance
+    ///
+    /// @return TelemetrySender& singleton instance
+    ///
+    static TelemetrySender& get_instance() {
+        static TelemetrySender sender;
+        return sender;
+    }
+
+    void initialize();
+
+    ///
+    /// @brief Queue samples for transmission.
+    ///
+    /// @return true Samples were queued.
+    /// @return false Buffer is full, at least one frame was dropped.
+    ///
+    bool push_samples(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride);
+
+    void on_initialized(RssiReaderInterface& rssi_reader) override;
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override;
+
+    uint32_t get_dropped_frames() const {
+        return stream.get_dropped_frames();
+    }
+
+    uint32_t get_sent_frames() const {
+        return stream.get_pushed_frames();
+    }
+
+private:
+    TelemetrySender();
+
+    static void handle_uarte_event(nrfx_uarte_event_t const * p_event, void * p_context);
+    void start_transfer();
+
+    const nrfx_uarte_t uarte;
+    TelemetryStream<TELEMETRY_SENDER_BUFFER_SIZE> stream;
+    // Written by the UARTE interrupt, read by push_samples().
+    std::atomic<size_t> transfer_length;
+};
+
+#endif // LAP_TIMER_TELEMETRY_SENDER_H
@@ -0,0 +1,61 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_CYCLE_COUNTER_H
+#define LAP_TIMER_CYCLE_COUNTER_H
+
+#include <nrf.h>
+#include "time/cycle_counter_interface.h"
+
+///
+/// @brief CPU cycle counter of the DWT unit.
+///
+class CycleCounter : public CycleCounterInterface {
+public:
+    CycleCounter(const CycleCounter&) = delete;
+    CycleCounter(CycleCounter&&) = delete;
+    CycleCounter& operator=(const CycleCounter&) = delete;
+    CycleCounter& operator=(CycleCounter&&) = delete;
+
+    ///
+    /// @brief Get global singleton instance
+    ///
+    /// @return CycleCounter& singleton instance
+    ///
+    static CycleCounter& get_instance();
+
+    ///
+    /// @brief Provides DWT CYCCNT value, which overflows every 67 seconds.
+    ///
+    uint32_t get_cycles() const override;
+    uint32_t get_cycles_per_us() const override;
+
+    ///
+    /// @brief Provides NVIC priority of the active exception, read from IPSR.
+    ///
+    uint8_t get_execution_priority() const override;
+
+private:
+    CycleCounter();
+};
+
+#endif // LAP_TIMER_CYCLE_COUNTER_H
@@ -42,7 +42,7 @@ public:
 
     ///
     /// @brief Provides current timestamp in milliseconds since the Clock was initialized. Timestamp overflows
-    /// after approximately 4.5 hours.
+    /// after approximately 49.7 days, RTC counter overflows are counted so it stays monotonic until then.
     ///
     /// @return uint32_t current timestamp
     ///
@@ -51,9 +51,12 @@ public:
 private:
     RealTimeClock();
     void initalize_rtc();
+    static void rtc_handler(nrfx_rtc_int_type_t int_type);
 
     const nrfx_rtc_t rtc_counter;
+    static volatile uint32_t overflows;
     static const uint16_t RTC_COUNTER_FREQUENCY = 1024;
+    static const uint8_t RTC_COUNTER_BITS = 24;
 };
 
 
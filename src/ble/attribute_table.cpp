@@ -122,6 +122,48 @@ AttributeTable::AttributeTable() :
         .init_offs = 0,
         .max_len = BLE_GATTS_VAR_ATTR_LEN_MAX,
         .p_value = nullptr
+    }),
+
+    // RSSI Stream Characteristic
+    stream_characteristic_uuid({
+        .uuid = 0x1003,
+        .type = base_uuid_type
+    }),
+    stream_characteristic_md({
+        .char_props = {
+            .notify = 1
+        },
+        .char_ext_props = {
+        },
+        .p_char_user_desc = reinterpret_cast<const uint8_t*>(u8"Lap Timer RSSI"),
+        .char_user_desc_max_size = 14,
+        .char_user_desc_size = 14,
+        .p_char_pf = nullptr,
+        .p_user_desc_md = nullptr,
+        .p_cccd_md = nullptr,
+        .p_sccd_md = nullptr
+    }),
+    stream_characteristic_attr_md({
+        .read_perm = {
+            .sm = 1,
+            .lv = 1
+        },
+        .write_perm = {
+            .sm = 1,
+            .lv = 1
+        },
+        .vlen = 1,
+        .vloc = BLE_GATTS_VLOC_STACK,
+        .rd_auth = 0,
+        .wr_auth = 0
+    }),
+    stream_characteristic_attr({
+        .p_uuid = &stream_characteristic_uuid,
+        .p_attr_md = &stream_characteristic_attr_md,
+        .init_len = 0,
+        .init_offs = 0,
+        .max_len = BLE_GATTS_VAR_ATTR_LEN_MAX,
+        .p_value = nullptr
     }) {}
 
 void AttributeTable::initialize() {
@@ -130,6 +172,7 @@ void AttributeTable::initialize() {
         service_uuid.type = base_uuid_type;
         tx_characteristic_uuid.type = base_uuid_type;
         rx_characteristic_uuid.type = base_uuid_type;
+        stream_characteristic_uuid.type = base_uuid_type;
 
         APP_ERROR_CHECK(sd_ble_gatts_service_add(BLE_GATTS_SRVC_TYPE_PRIMARY, &service_uuid, &service_handle));
         
@@ -146,4 +189,11 @@ void AttributeTable::initialize() {
             &rx_characteristic_attr, 
             &rx_characteristic_handles
         ));
+
+        APP_ERROR_CHECK(sd_ble_gatts_characteristic_add(
+            service_handle, 
+            &stream_characteristic_md, 
+            &stream_characteristic_attr, 
+            &stream_characteristic_handles
+        ));
 }
@@ -73,6 +73,28 @@ bool BleCentralConnection::send_to_rx(const uint8_t *data, uint16_t length) {
     }
 }
 
+bool BleCentralConnection::send_to_stream(const uint8_t *data, uint16_t length) {
+    // Sent up to 200 times per second, so only failures are logged.
+    uint16_t sent_length = length;
+    ble_gatts_hvx_params_t params = {
+        .handle = manager.get_attribute_table().get_stream_characteristic_handle(),
+        .type = BLE_GATT_HVX_NOTIFICATION,
+        .offset = 0,
+        .p_len = &sent_length,
+        .p_data = data
+    };
+
+    uint32_t error_code = sd_ble_gatts_hvx(connection_handle, &params);
+    if (error_code == NRF_SUCCESS) {
+        return true;
+    }
+    // Queue of the SoftDevice is full or notifications aren't enabled by the central.
+    if (error_code != NRF_ERROR_RESOURCES && error_code != NRF_ERROR_INVALID_STATE) {
+        NRF_LOG_ERROR("[%s] Got an error during stream notification: %u", get_mac_address(), error_code);
+    }
+    return false;
+}
+
 bool BleCentralConnection::handle_common_event(uint16_t id, const ble_common_evt_t& common_event) {
     switch(id) {
         case BLE_EVT_USER_MEM_REQUEST: {
@@ -21,93 +21,140 @@
 // SOFTWARE.
 
 #include "events/event_dispatcher.h"
-#include "app_scheduler.h"
+#include "app_util_platform.h"
 #include "nrf_soc.h"
 #include "nrf_log.h"
+#include "time/cycle_counter.h"
+#include "time/real_time_clock.h"
 
-EventDispatcher::EventDispatcher() {
-    for (size_t i = 0; i < MAX_OBSERVERS_COUNT; i++) {
-        observers[i] = nullptr;
-    }
-}
+#include <algorithm>
+
+EventDispatcher::EventDispatcher() :
+    subscriptions(),
+    lanes(),
+    delayed_events(),
+    timer {0},
+    timer_id(&timer) {}
 
 void EventDispatcher::initialize() {
-    APP_SCHED_INIT(sizeof(Event), MAX_EVENTS_COUNT);
     APP_ERROR_CHECK(app_timer_init());
-
-    for (size_t i = 0; i < MAX_TIMERS_COUNT; i++) {
-        timers[i].timer_id = &timers[i].timer;
-        APP_ERROR_CHECK(app_timer_create(&timers[i].timer_id, APP_TIMER_MODE_SINGLE_SHOT, EventDispatcher::handle_timer_event));
-    }
+    APP_ERROR_CHECK(app_timer_create(&timer_id, APP_TIMER_MODE_SINGLE_SHOT, EventDispatcher::handle_timer_event));
 }
 
-void EventDispatcher::handle_events() {
-    app_sched_execute();
+void EventDispatcher::handle_events(uint32_t cycle_budget) {
+    const CycleCounter& cycle_counter = CycleCounter::get_instance();
+    uint32_t start_cycles = cycle_counter.get_cycles();
+    Event event;
+    while (pop_event(event, cycle_counter.get_cycles() - start_cycles < cycle_budget)) {
+        subscriptions.dispatch(event);
+    }
 }
 
 void EventDispatcher::wait_for_event() {
+    bool idle = false;
+    CRITICAL_REGION_ENTER();
+    idle = lanes.is_empty();
+    CRITICAL_REGION_EXIT();
+    // Background events left over by handle_events() shouldn't wait for an unrelated interrupt.
+    if (!idle) {
+        return;
+    }
     auto error_code = sd_app_evt_wait();
     APP_ERROR_CHECK(error_code);
 }
 
-void EventDispatcher::handle_timer_event(void *context) {
-    TimerState* timer_state = reinterpret_cast<TimerState*>(context);
-    timer_state->used.store(false);
-    APP_ERROR_CHECK(app_sched_event_put(&timer_state->event, sizeof(Event), EventDispatcher::handle_app_event));
+void EventDispatcher::push_event(const Event& event) {
+    bool pushed = false;
+    CRITICAL_REGION_ENTER();
+    pushed = lanes.push(event);
+    CRITICAL_REGION_EXIT();
+    if (!pushed) {
+        APP_ERROR_CHECK(NRF_ERROR_NO_MEM);
+    }
+}
+
+bool EventDispatcher::pop_event(Event& event, bool include_background) {
+    bool popped = false;
+    CRITICAL_REGION_ENTER();
+    popped = lanes.pop(event, include_background);
+    CRITICAL_REGION_EXIT();
+    return popped;
 }
 
-void EventDispatcher::handle_app_event(void *event_data, uint16_t event_size) {
-    const Event* event = reinterpret_cast<const Event*>(event_data);
-    EventDispatcher& event_dispatcher = EventDispatcher::get_instance();
-    for (size_t i = 0; i < MAX_OBSERVERS_COUNT; i++) {
-        EventObserver* observer = event_dispatcher.observers[i];
-        if (observer) {
-            observer->on_event(*event);
-        }
+void EventDispatcher::start_timer(uint32_t now) {
+    APP_ERROR_CHECK(app_timer_stop(timer_id));
+    if (delayed_events.is_empty()) {
+        return;
     }
+    int32_t remaining_ms = std::max<int32_t>(delayed_events.get_next_deadline() - now, 0);
+    // RealTimeClock ticks at 1024 Hz, one more ms makes sure the deadline has passed when the timer fires.
+    uint64_t timeout = APP_TIMER_TICKS(static_cast<uint64_t>(remaining_ms) + 1);
+    timeout = std::clamp<uint64_t>(timeout, APP_TIMER_MIN_TIMEOUT_TICKS, MAX_TIMEOUT_TICKS);
+    APP_ERROR_CHECK(app_timer_start(timer_id, timeout, this));
 }
 
-bool EventDispatcher::register_observer(EventObserver* observer) {
-    bool registered = false;
-    for (size_t i = 0; i < MAX_OBSERVERS_COUNT; i++) {
-        if (!observers[i]) {
-            observers[i] = observer;
-            registered = true;
-            break;
-        }
+void EventDispatcher::handle_timer_event(void *context) {
+    EventDispatcher* event_dispatcher = static_cast<EventDispatcher*>(context);
+    Event event;
+    CRITICAL_REGION_ENTER();
+    uint32_t now = RealTimeClock::get_instance().get_current_timestamp_ms();
+    while (event_dispatcher->delayed_events.pop_due(now, event)) {
+        event_dispatcher->push_event(event);
     }
-    return registered;
+    event_dispatcher->start_timer(now);
+    CRITICAL_REGION_EXIT();
+}
+
+bool EventDispatcher::register_observer(EventObserver* observer, EventMask events) {
+    return subscriptions.subscribe(observer, events);
 }
 
 bool EventDispatcher::unregister_observer(EventObserver* observer) {
-    bool unregistered = false;
-    for (size_t i = 0; i < MAX_OBSERVERS_COUNT; i++) {
-        if (observers[i] == observer) {
-            observers[i] = nullptr;
-            unregistered = true;
-            break;
-        }
-    }
-    return unregistered;
+    return subscriptions.unsubscribe(observer);
 }
 
 void EventDispatcher::emit_event(const Event& event) {
-    APP_ERROR_CHECK(app_sched_event_put(&event, sizeof(event), EventDispatcher::handle_app_event));
+    push_event(event);
+}
+
+EventHandle EventDispatcher::emit_event_delayed(const Event& event, uint32_t ms_delay) {
+    return schedule(event, RealTimeClock::get_instance().get_current_timestamp_ms() + ms_delay, 0);
 }
 
-void EventDispatcher::emit_event_delayed(const Event& event, uint32_t ms_delay) {
-    TimerState* timer_state = nullptr;
-    size_t timer_id = 0;
-    for (; timer_id < MAX_TIMERS_COUNT; timer_id++) {
-        bool expected = false;
-        if (timers[timer_id].used.compare_exchange_strong(expected, true)) {
-            timer_state = &timers[timer_id];
-            timer_state->event = event;
-            break;
-        }
+EventHandle EventDispatcher::emit_event_at(const Event& event, uint32_t timestamp_ms) {
+    return schedule(event, timestamp_ms, 0);
+}
+
+EventHandle EventDispatcher::emit_event_periodic(const Event& event, uint32_t ms_period) {
+    if (ms_period == 0) {
+        return INVALID_EVENT_HANDLE;
     }
-    
-    // Make sure that we have a timer.
-    APP_ERROR_CHECK_BOOL(timer_state != nullptr);
-    APP_ERROR_CHECK(app_timer_start(timer_state->timer_id, APP_TIMER_TICKS(ms_delay), timer_state));
-}
\ No newline at end of file
+    return schedule(event, RealTimeClock::get_instance().get_current_timestamp_ms() + ms_period, ms_period);
+}
+
+bool EventDispatcher::cancel(EventHandle handle) {
+    bool canceled = false;
+    CRITICAL_REGION_ENTER();
+    canceled = delayed_events.cancel(handle);
+    // Timer armed for the canceled event just finds nothing due and is armed again.
+    CRITICAL_REGION_EXIT();
+    return canceled;
+}
+
+EventHandle EventDispatcher::schedule(const Event& event, uint32_t timestamp_ms, uint32_t ms_period) {
+    EventHandle handle = INVALID_EVENT_HANDLE;
+    CRITICAL_REGION_ENTER();
+    uint32_t now = RealTimeClock::get_instance().get_current_timestamp_ms();
+    // Timer is moved only for a new earliest deadline.
+    bool earliest = delayed_events.is_empty() || static_cast<int32_t>(timestamp_ms - delayed_events.get_next_deadline()) < 0;
+    handle = delayed_events.push(event, timestamp_ms, ms_period);
+    if (handle != INVALID_EVENT_HANDLE && earliest) {
+        start_timer(now);
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (handle == INVALID_EVENT_HANDLE) {
+        NRF_LOG_WARNING("Scheduled event dropped, %u events pending", EVENT_DISPATCHER_DELAYED_EVENTS_COUNT);
+    }
+    return handle;
+}
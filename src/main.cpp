@@ -34,12 +34,53 @@ SOFTWARE. */
 #include "ble/ble_manager_delegate.h"
 #include "events/event_dispatcher.h"
 #include "events/event_observer.h"
+#include "events/static_dispatcher.h"
 
 #include "storage/session_storage.h"
+#include "storage/calibration_storage.h"
 #include "storage/flash_storage.h"
 
+#include "telemetry/telemetry_sender.h"
+
 #include "rssi/rssi_reader.h"
+#include "rssi/buffered_rssi_reader_delegate.h"
+#include "rssi/matched_filter_rssi_reader_delegate.h"
 #include "rssi/rssi_reader_delegate.h"
+#include "rssi/rssi_sample_bus.h"
+#include "rssi/rssi_summary_stream.h"
+
+#include "time/cycle_counter.h"
+#include "trace/latency_tracer.h"
+
+// Minimum lap time in milliseconds, 0 disables the lockout.
+#ifndef RSSI_LAP_LOCKOUT_MS
+#define RSSI_LAP_LOCKOUT_MS 0
+#endif
+
+// Leave SAADC waiting for a pass on its own while the gate is quiet.
+#ifndef RSSI_IDLE_WAKEUP
+#define RSSI_IDLE_WAKEUP 0
+#endif
+
+// Lower the sampling rate while no pass is expected.
+#ifndef RSSI_SAMPLING_PROFILES
+#define RSSI_SAMPLING_PROFILES 0
+#endif
+
+// Measure latency of laps from SAADC interrupt to NewLap observers.
+#ifndef LATENCY_TRACING
+#define LATENCY_TRACING 0
+#endif
+
+// Detect laps by correlation with a pass template instead of thresholds.
+#ifndef RSSI_MATCHED_FILTER
+#define RSSI_MATCHED_FILTER 0
+#endif
+
+// Time background events may take in one pass of the main loop, urgent events aren't limited.
+#ifndef EVENT_LOOP_BUDGET_US
+#define EVENT_LOOP_BUDGET_US 2000
+#endif
 
 static void initialize_logger() {
     APP_ERROR_CHECK(NRF_LOG_INIT(app_timer_cnt_get));
@@ -49,25 +90,21 @@ static void initialize_logger() {
 // Event Observer Demo.
 class LEDObserver : public EventObserver {
 public:
-    LEDObserver(EventDispatcher& event_dispatcher) : event_dispatcher(event_dispatcher) {
-        event_dispatcher.register_observer(this);
-        event_dispatcher.emit_event(FlashLED(0, 1));
+    static constexpr EventMask EVENTS = event_mask<FlashLED>();
+
+    LEDObserver(EventDispatcherInterface& event_dispatcher) : event_dispatcher(event_dispatcher), led_id(0) {
+        event_dispatcher.register_observer(this, EVENTS);
+        // One periodic event drives the whole chase, no need to schedule it again on every flash.
+        event_dispatcher.emit_event_periodic(FlashLED(0, FLASH_PERIOD_MS), FLASH_PERIOD_MS);
     }
 
     void on_event(const Event& event) override {
         std::visit(overloaded{
             [this](const FlashLED& data) {
-                bsp_board_led_invert(data.get_led_id());
-                uint8_t new_led_id = data.get_led_id();
-                uint8_t new_ms_delay = data.get_ms_delay();
-                if (new_ms_delay == 64) {
-                    new_ms_delay = 1;
-                    new_led_id = (new_led_id + 1) % LEDS_NUMBER;
-                } else {
-                    new_ms_delay++;
+                bsp_board_led_invert(led_id);
+                if (!bsp_board_led_state_get(led_id)) {
+                    led_id = (led_id + 1) % LEDS_NUMBER;
                 }
-                event_dispatcher.emit_event_delayed(FlashLED(new_led_id, new_ms_delay), new_ms_delay);
-                ASSERT(false);
             },
             [](auto other) {
 
@@ -76,33 +113,111 @@ public:
     }
 
 private:
-    EventDispatcher &event_dispatcher;
+    static constexpr uint8_t FLASH_PERIOD_MS = 64;
+
+    EventDispatcherInterface &event_dispatcher;
+    uint8_t led_id;
 };
 
+#if RSSI_MATCHED_FILTER
+typedef MatchedFilterRssiReaderDelegate LapRssiReaderDelegate;
+#else
+typedef RssiReaderDelegate LapRssiReaderDelegate;
+#endif
+
+typedef BleManagerDelegate<NRF_SDH_BLE_PERIPHERAL_LINK_COUNT> LapBleManagerDelegate;
+
+// Observers are fixed, so events are passed to them without virtual calls.
+typedef StaticDispatcher<
+    LEDObserver,
+    LapBleManagerDelegate,
+#if LATENCY_TRACING
+    LatencyTracer,
+#endif
+    SessionStorage,
+    CalibrationStorage,
+    LapRssiReaderDelegate,
+    BufferedRssiReaderDelegate,
+    BufferedRssiReaderDelegate,
+    BufferedRssiReaderDelegate,
+    RssiSummaryStream
+> ObserverDispatcher;
+
 int main(void) {
     initialize_logger();
     bsp_board_init(BSP_INIT_LEDS);
 
     EventDispatcher& event_dispatcher = EventDispatcher::get_instance();
     event_dispatcher.initialize();
+    ObserverDispatcher observer_dispatcher(event_dispatcher);
+
+    LEDObserver observer(observer_dispatcher);
 
-    LEDObserver observer(event_dispatcher);
+#if LATENCY_TRACING
+    LatencyTracer latency_tracer(observer_dispatcher, CycleCounter::get_instance());
+    LatencyTracer* tracer = &latency_tracer;
+#else
+    LatencyTracer* tracer = nullptr;
+#endif
 
     BleManager &ble_manager = BleManager::get_instance();
-    BleManagerDelegate<NRF_SDH_BLE_PERIPHERAL_LINK_COUNT> ble_delegate;
+    LapBleManagerDelegate ble_delegate(observer_dispatcher);
     ble_manager.initialize(ble_delegate);
 
     FlashStorage &flash_storage = FlashStorage::get_instance();
-    SessionStorage session_storage(event_dispatcher, flash_storage);
+    SessionStorage session_storage(observer_dispatcher, flash_storage);
+    ble_delegate.set_session_storage(&session_storage);
+    ble_delegate.set_latency_tracer(tracer);
+    CalibrationStorage calibration_storage(observer_dispatcher, flash_storage);
     flash_storage.initialize();
 
     RssiReader &rssi_reader = RssiReader::get_instance();
-    RssiReaderDelegate rssi_delegate(RealTimeClock::get_instance(), event_dispatcher);
-    rssi_reader.initialize(rssi_delegate);
-
+#if RSSI_MATCHED_FILTER
+    // Needs continuous samples, neither idle wake-up nor sampling profiles are used.
+    LapRssiReaderDelegate rssi_delegate(RealTimeClock::get_instance(), observer_dispatcher);
+    rssi_delegate.set_calibration_storage(&calibration_storage);
+#else
+    LapRssiReaderDelegate rssi_delegate(RealTimeClock::get_instance(), observer_dispatcher);
+    rssi_delegate.set_idle_wakeup_enabled(RSSI_IDLE_WAKEUP);
+    rssi_delegate.set_sampling_profiles_enabled(RSSI_SAMPLING_PROFILES);
+#endif
+    rssi_delegate.set_latency_tracer(tracer);
+    // Lap detection runs in the event loop, SAADC interrupt only queues samples.
+    BufferedRssiReaderDelegate buffered_rssi_delegate(observer_dispatcher, rssi_delegate);
+    buffered_rssi_delegate.set_latency_tracer(tracer);
+    // Frames are encoded in the event loop too, after lap detection of the same blocks.
+    BufferedRssiReaderDelegate buffered_telemetry_sender(observer_dispatcher, TelemetrySender::get_instance());
+    // Telemetry gets every sample, frames carry the tick stride of sampling profiles.
+    RssiSampleBus rssi_sample_bus;
+    rssi_sample_bus.add_sink(buffered_rssi_delegate);
+    rssi_sample_bus.add_sink(buffered_telemetry_sender);
+    RssiSummaryStream rssi_summary_stream(observer_dispatcher);
+    BufferedRssiReaderDelegate buffered_rssi_summary_stream(observer_dispatcher, rssi_summary_stream);
+    rssi_sample_bus.add_sink(buffered_rssi_summary_stream);
+    ble_delegate.set_rssi_summary_stream(&rssi_summary_stream);
+    rssi_reader.initialize(rssi_sample_bus);
+    event_dispatcher.emit_event(SetLapLockout(RSSI_LAP_LOCKOUT_MS));
+
+    // Events emitted so far are queued until the event loop starts.
+    observer_dispatcher.attach(
+        observer,
+        ble_delegate,
+#if LATENCY_TRACING
+        latency_tracer,
+#endif
+        session_storage,
+        calibration_storage,
+        rssi_delegate,
+        buffered_rssi_delegate,
+        buffered_telemetry_sender,
+        buffered_rssi_summary_stream,
+        rssi_summary_stream
+    );
+
+    const uint32_t event_loop_cycle_budget = EVENT_LOOP_BUDGET_US * CycleCounter::get_instance().get_cycles_per_us();
     while (true) {
         while(NRF_LOG_PROCESS());
-        event_dispatcher.handle_events();
+        event_dispatcher.handle_events(event_loop_cycle_budget);
         event_dispatcher.wait_for_event();
     }
 }
\ No newline at end of file
@@ -20,6 +20,7 @@
 
 
 #include "rssi/rssi_reader.h"
+#include "rssi/trigger_ticks.h"
 #include <algorithm>
 #include <nrf.h>
 #include <nrf_saadc.h>
@@ -29,20 +30,41 @@
 #include <nrfx_ppi.h>
 #include <nrf_ppi.h>
 #include <nrfx_timer.h>
-#include <nrf_uart.h>
-#include <nrfx_uart.h>
 #include <nrf_gpio.h>
 #include <libraries/timer/app_timer.h>
 
-// Dumb handlers just to force asynchronous peripheral mode
-static void uart_handler(const nrfx_uart_event_t* event_type, void * p_context) {}
+
+// Wait for SAADC events in microseconds, longer than a burst conversion with 256x oversampling.
+static constexpr uint32_t SAADC_EVENT_TIMEOUT_US = 2000;
+
+// Dumb handler just to force asynchronous peripheral mode
 static void timer_handler(nrf_timer_event_t event_type, void * p_context) {}
 
+static nrfx_err_t wait_for_saadc_event(nrf_saadc_event_t event) {
+    bool occurred;
+    NRFX_WAIT_FOR(nrf_saadc_event_check(event), SAADC_EVENT_TIMEOUT_US, 1, occurred);
+    return occurred ? NRFX_SUCCESS : NRFX_ERROR_TIMEOUT;
+}
+
 
 RssiReader::RssiReader() :
 delegate(nullptr),
 timer(NRFX_TIMER_INSTANCE(1)),
-uart(NRFX_UART_INSTANCE(0)) {}
+trigger_counter(NRFX_TIMER_INSTANCE(2)),
+queued_buffer(nullptr),
+next_block_tick(0),
+pause_state(PAUSE_STATE_NONE),
+pause_tick(0),
+resume_tick(0),
+requested_resume_tick(0),
+pause_requested(false),
+idle(false),
+requested_wakeup_levels(),
+wakeup_requested(false),
+sample_stride(1),
+pending_stride(1),
+requested_stride(1),
+stride_requested(false) {}
 
 
 void RssiReader::initialize(RssiReaderInterface::Delegate& delegate) {
@@ -50,7 +72,7 @@ void RssiReader::initialize(RssiReaderInterface::Delegate& delegate) {
 
     initialize_adc();
     initialize_sampling_timer();
-    initalize_uart_logger();
+    initialize_trigger_counter();
     delegate.on_initialized(*this);
     enable_sampling();
 }
@@ -60,7 +82,7 @@ void RssiReader::initialize_sampling_timer() {
     nrfx_timer_config_t timer_cfg = {
             .frequency = NRF_TIMER_FREQ_16MHz,
             .mode = NRF_TIMER_MODE_TIMER,
-            .bit_width = NRF_TIMER_BIT_WIDTH_8,
+            .bit_width = NRF_TIMER_BIT_WIDTH_16,
             .interrupt_priority = NRFX_TIMER_DEFAULT_CONFIG_IRQ_PRIORITY,
             .p_context = NULL,
     };
@@ -69,21 +91,217 @@ void RssiReader::initialize_sampling_timer() {
 
     nrf_timer_shorts_enable(timer.p_reg, NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK);
 
-    nrfx_timer_compare(&timer, NRF_TIMER_CC_CHANNEL0, 100, false);
+    nrfx_timer_compare(&timer, NRF_TIMER_CC_CHANNEL0, SAMPLING_TIMER_COMPARE_VALUE, false);
 
     nrfx_timer_enable(&timer);
 
-    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&ppi_channel));
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&sampling_ppi_channel));
 
     APP_ERROR_CHECK(nrfx_ppi_channel_assign(
-            ppi_channel,
+            sampling_ppi_channel,
             nrfx_timer_compare_event_address_get(&timer, NRF_TIMER_CC_CHANNEL0),
             nrfx_saadc_sample_task_get()
     ));
 }
 
+void RssiReader::initialize_trigger_counter() {
+    nrfx_timer_config_t counter_cfg = {
+            .frequency = NRF_TIMER_FREQ_16MHz,
+            .mode = NRF_TIMER_MODE_COUNTER,
+            .bit_width = NRF_TIMER_BIT_WIDTH_32,
+            .interrupt_priority = NRFX_TIMER_DEFAULT_CONFIG_IRQ_PRIORITY,
+            .p_context = NULL,
+    };
+
+    APP_ERROR_CHECK(nrfx_timer_init(&trigger_counter, &counter_cfg, timer_handler));
+    nrfx_timer_enable(&trigger_counter);
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&counting_ppi_channel));
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(
+            counting_ppi_channel,
+            nrfx_timer_compare_event_address_get(&timer, NRF_TIMER_CC_CHANNEL0),
+            nrfx_timer_task_address_get(&trigger_counter, NRF_TIMER_TASK_COUNT)
+    ));
+
+    APP_ERROR_CHECK(nrfx_ppi_group_alloc(&sampling_ppi_group));
+    APP_ERROR_CHECK(nrfx_ppi_channel_include_in_group(sampling_ppi_channel, sampling_ppi_group));
+
+    // CC1 pauses sampling right after the last trigger of a sample, CC0 resumes it before the first one.
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&pause_ppi_channel));
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(
+            pause_ppi_channel,
+            nrfx_timer_compare_event_address_get(&trigger_counter, NRF_TIMER_CC_CHANNEL1),
+            nrfx_ppi_task_addr_group_disable_get(sampling_ppi_group)
+    ));
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&resume_ppi_channel));
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(
+            resume_ppi_channel,
+            nrfx_timer_compare_event_address_get(&trigger_counter, NRF_TIMER_CC_CHANNEL0),
+            nrfx_ppi_task_addr_group_enable_get(sampling_ppi_group)
+    ));
+
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&idle_ppi_channel));
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(
+            idle_ppi_channel,
+            nrf_saadc_event_address_get(NRF_SAADC_EVENT_END),
+            nrf_saadc_task_address_get(NRF_SAADC_TASK_START)
+    ));
+}
+
+uint32_t RssiReader::get_sample_interval_us() const {
+    return static_cast<uint64_t>(SAMPLING_TIMER_COMPARE_VALUE) * TRIGGERS_PER_TICK * 1000000 / SAMPLING_TIMER_FREQUENCY_HZ;
+}
+
+uint8_t RssiReader::get_channels_count() const {
+    return CHANNELS_COUNT;
+}
+
 void RssiReader::enable_sampling() {
-    APP_ERROR_CHECK(nrfx_ppi_channel_enable(ppi_channel));
+    // Both channels are enabled at once, so the counter starts in phase with the samples.
+    nrfx_timer_clear(&trigger_counter);
+    nrf_ppi_channels_enable((1UL << sampling_ppi_channel) | (1UL << counting_ppi_channel));
+}
+
+void RssiReader::suspend_sampling(uint32_t resume_tick) {
+    requested_resume_tick = resume_tick;
+    pause_requested.store(true, std::memory_order_release);
+}
+
+void RssiReader::set_sample_stride(uint8_t stride) {
+    requested_stride = stride;
+    stride_requested.store(true, std::memory_order_release);
+}
+
+void RssiReader::update_pause(uint32_t block_end_tick) {
+    switch (pause_state) {
+        case PAUSE_STATE_PAUSED:
+            // This block was captured after the resume.
+            APP_ERROR_CHECK(nrfx_ppi_channel_disable(resume_ppi_channel));
+            pause_state = PAUSE_STATE_NONE;
+            break;
+        case PAUSE_STATE_SCHEDULED:
+            if (block_end_tick == pause_tick) {
+                APP_ERROR_CHECK(nrfx_ppi_channel_disable(pause_ppi_channel));
+                if (pending_stride != sample_stride) {
+                    // No conversion is in progress, the next one starts at the resume.
+                    nrf_saadc_oversample_set(get_oversample(pending_stride));
+                    sample_stride = pending_stride;
+                }
+                next_block_tick = resume_tick;
+                pause_state = PAUSE_STATE_PAUSED;
+                NRF_LOG_DEBUG("Sampling paused at tick %u until %u", pause_tick, resume_tick);
+            }
+            return;
+        default:
+            break;
+    }
+
+    if (!pause_requested.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+    // The next block is already being captured, the pause starts after it.
+    uint32_t next_pause_tick = block_end_tick + SAMPLES_IN_BLOCK * sample_stride;
+    if (static_cast<int32_t>(requested_resume_tick - next_pause_tick) <= 0) {
+        return;
+    }
+    schedule_pause(next_pause_tick, requested_resume_tick);
+}
+
+void RssiReader::schedule_pause(uint32_t pause_tick, uint32_t resume_tick) {
+    this->pause_tick = pause_tick;
+    this->resume_tick = resume_tick;
+    nrfx_timer_compare(&trigger_counter, NRF_TIMER_CC_CHANNEL1, pause_tick * TRIGGERS_PER_TICK, false);
+    nrfx_timer_compare(&trigger_counter, NRF_TIMER_CC_CHANNEL0, resume_tick * TRIGGERS_PER_TICK, false);
+    APP_ERROR_CHECK(nrfx_ppi_channel_enable(pause_ppi_channel));
+    APP_ERROR_CHECK(nrfx_ppi_channel_enable(resume_ppi_channel));
+    pause_state = PAUSE_STATE_SCHEDULED;
+}
+
+void RssiReader::schedule_stride_change(uint32_t block_end_tick) {
+    uint8_t stride = 1;
+    while (stride * 2 <= std::min(requested_stride, MAX_SAMPLE_STRIDE)) {
+        stride *= 2;
+    }
+    if (stride == sample_stride) {
+        return;
+    }
+    // Sampling pauses after the block being captured, with a new oversampling it resumes shortly after.
+    pending_stride = stride;
+    uint32_t next_pause_tick = block_end_tick + SAMPLES_IN_BLOCK * sample_stride;
+    schedule_pause(next_pause_tick, next_pause_tick + STRIDE_CHANGE_GAP_TICKS);
+    NRF_LOG_DEBUG("Sample stride %u from tick %u", stride, pause_tick + STRIDE_CHANGE_GAP_TICKS);
+}
+
+nrf_saadc_oversample_t RssiReader::get_oversample(uint8_t stride) {
+    switch (stride) {
+        case 4:
+            return NRF_SAADC_OVERSAMPLE_256X;
+        case 2:
+            return NRF_SAADC_OVERSAMPLE_128X;
+        default:
+            return SCAN_MODE ? NRF_SAADC_OVERSAMPLE_8X : NRF_SAADC_OVERSAMPLE_64X;
+    }
+}
+
+void RssiReader::arm_wakeup(const std::array<uint16_t, MAX_CHANNELS_COUNT>& levels) {
+    requested_wakeup_levels = levels;
+    wakeup_requested.store(true, std::memory_order_release);
+}
+
+void RssiReader::enter_idle() {
+    // Both buffers are queued, conversions continue into the second one and then restart into it.
+    for (uint8_t channel = 0; channel < CHANNELS_COUNT; channel++) {
+        // Driver accepts only 12-bit limits, but it reports only limit events it has enabled. It
+        // enables the interrupt with an in-range limit, the 14-bit one is written through the HAL.
+        int16_t limit = static_cast<int16_t>(requested_wakeup_levels[channel] >> 2u);
+        nrfx_saadc_limits_set(channel, NRFX_SAADC_LIMITL_DISABLED, 0);
+        nrf_saadc_channel_limits_set(channel, NRFX_SAADC_LIMITL_DISABLED, limit);
+        // Placeholder limit or an earlier idle period may have left the event set.
+        nrf_saadc_event_clear(nrf_saadc_event_limit_get(channel, NRF_SAADC_LIMIT_HIGH));
+    }
+    APP_ERROR_CHECK(nrfx_ppi_channel_enable(idle_ppi_channel));
+    nrf_saadc_int_disable(NRF_SAADC_INT_END);
+    idle = true;
+    NRF_LOG_DEBUG("Sampling idle after tick %u", next_block_tick);
+}
+
+void RssiReader::wake_up() {
+    // Sampling is resumed in phase with the ticks, like after a pause.
+    APP_ERROR_CHECK(nrfx_ppi_group_disable(sampling_ppi_group));
+    APP_ERROR_CHECK(nrfx_ppi_channel_disable(idle_ppi_channel));
+    for (uint8_t channel = 0; channel < CHANNELS_COUNT; channel++) {
+        nrfx_saadc_limits_set(channel, NRFX_SAADC_LIMITL_DISABLED, NRFX_SAADC_LIMITH_DISABLED);
+    }
+    // Driver would stay busy until its STOPPED handler, so conversions are restarted through the HAL
+    // and the driver keeps its buffers: the current one is filled first, the queued one after it.
+    nrf_saadc_value_t* current_buffer = queued_buffer == buffer_pool[0] ? buffer_pool[1] : buffer_pool[0];
+    nrf_saadc_int_disable(NRF_SAADC_INT_STOPPED);
+    nrf_saadc_task_trigger(NRF_SAADC_TASK_STOP);
+    // Waits run in the interrupt, a SAADC which doesn't respond is a hardware fault.
+    APP_ERROR_CHECK(wait_for_saadc_event(NRF_SAADC_EVENT_STOPPED));
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_STOPPED);
+    nrf_saadc_int_enable(NRF_SAADC_INT_STOPPED);
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_END);
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_STARTED);
+    nrf_saadc_buffer_init(current_buffer, SAMPLES_IN_BLOCK * CHANNELS_COUNT);
+    nrf_saadc_task_trigger(NRF_SAADC_TASK_START);
+    APP_ERROR_CHECK(wait_for_saadc_event(NRF_SAADC_EVENT_STARTED));
+    nrf_saadc_event_clear(NRF_SAADC_EVENT_STARTED);
+    // Pointer is double buffered, the driver starts the queued buffer at the end of the current one.
+    nrf_saadc_buffer_init(queued_buffer, SAMPLES_IN_BLOCK * CHANNELS_COUNT);
+    nrf_saadc_int_enable(NRF_SAADC_INT_END);
+
+    // Second sample after the current one leaves enough time to program the resume. Trigger counter
+    // wraps long before ticks do, so the tick is counted from the last known one.
+    uint32_t triggers = nrfx_timer_capture(&trigger_counter, NRF_TIMER_CC_CHANNEL2);
+    resume_tick = get_trigger_tick(next_block_tick, triggers, TRIGGERS_PER_TICK) + 2;
+    nrfx_timer_compare(&trigger_counter, NRF_TIMER_CC_CHANNEL0, resume_tick * TRIGGERS_PER_TICK, false);
+    APP_ERROR_CHECK(nrfx_ppi_channel_enable(resume_ppi_channel));
+    next_block_tick = resume_tick;
+    pause_state = PAUSE_STATE_PAUSED;
+    idle = false;
+    NRF_LOG_DEBUG("Sampling woken up at tick %u", resume_tick);
 }
 
 void RssiReader::handle_adc_event(nrfx_saadc_evt_t const * p_event) {
@@ -95,36 +313,56 @@ void RssiReader::handle_adc_event(nrfx_saadc_evt_t const * p_event) {
 
 bool RssiReader::handle_adc_event_impl(nrfx_saadc_evt_t const * p_event) {
     if (p_event->type == NRFX_SAADC_EVT_DONE) {
-        APP_ERROR_CHECK(nrfx_saadc_buffer_convert(p_event->data.done.p_buffer, SAMPLES_IN_BUFFER));
-        uint16_t sample = std::max(static_cast<int16_t>(0), p_event->data.done.p_buffer[0]);
-        log_sample(sample);
-
-        // The sample is shifted by two bits to normalize the value to 16bits precision.
-        delegate->on_sample_captured(sample << 2u);
+        nrf_saadc_value_t* buffer = p_event->data.done.p_buffer;
+        size_t count = p_event->data.done.size / CHANNELS_COUNT;
+        for (size_t i = 0; i < count; i++) {
+            for (uint8_t channel = 0; channel < CHANNELS_COUNT; channel++) {
+                block[channel][i] = std::max(static_cast<int16_t>(0), buffer[i * CHANNELS_COUNT + channel]);
+            }
+        }
+
+        // Second buffer is already being filled, so this one can be queued right after it.
+        APP_ERROR_CHECK(nrfx_saadc_buffer_convert(buffer, SAMPLES_IN_BLOCK * CHANNELS_COUNT));
+        queued_buffer = buffer;
+
+        // Stride may change at the pause, following blocks are captured with the new one.
+        uint8_t block_stride = sample_stride;
+        uint32_t first_sample_tick = next_block_tick;
+        next_block_tick += count * block_stride;
+        update_pause(next_block_tick);
+        // Wake-up is ignored while sampling is being suspended, the delegate requests it again.
+        if (wakeup_requested.exchange(false, std::memory_order_acquire) && pause_state == PAUSE_STATE_NONE) {
+            enter_idle();
+        }
+        // Stride change waits for the pause to finish.
+        if (pause_state == PAUSE_STATE_NONE && !idle && stride_requested.exchange(false, std::memory_order_acquire)) {
+            schedule_stride_change(next_block_tick);
+        }
+        for (uint8_t channel = 0; channel < CHANNELS_COUNT; channel++) {
+            // Samples are shifted by two bits to normalize the value to 16bits precision.
+            for (size_t i = 0; i < count; i++) {
+                block[channel][i] <<= 2u;
+            }
+            delegate->on_samples_captured(channel, block[channel], count, first_sample_tick, block_stride);
+        }
+        return true;
+    }
+    if (p_event->type == NRFX_SAADC_EVT_LIMIT) {
+        // Every channel above its limit raises the event, only the first one wakes up.
+        if (idle) {
+            wake_up();
+        }
         return true;
     }
     return false;
 }
 
 
-void RssiReader::log_sample(uint16_t sample) {
-    // The sample data is 14 bits long - two most significant bits of sample parameter should be equal to zero.
-    // Therefore we can concatenate two lsb bits of sequence number with the 14bits of sample data. The result is saved in
-    // uint8_t array (big-endian) and transmited over uart. The aim of the SEQ bits is to allow validation on the receiver side.
-
-    ++sample_seq;
-    uint8_t data[2] = {
-            static_cast<uint8_t>(((sample_seq << 6u) & 0xc0u)|((sample >> 8u) & 0x3fu)), // 2 bits of seq and 6 msb of sample
-            static_cast<uint8_t>(sample & 0xffu) // 8 lsb of sample
-    };
-    nrfx_uart_tx(&uart, data, 2);
-}
-
 void RssiReader::initialize_adc()
 {
     nrfx_saadc_config_t saadc_config = {
             .resolution         = NRF_SAADC_RESOLUTION_14BIT,
-            .oversample         = NRF_SAADC_OVERSAMPLE_64X,
+            .oversample         = get_oversample(1),
             .interrupt_priority = NRFX_SAADC_CONFIG_IRQ_PRIORITY,
             .low_power_mode     = NRFX_SAADC_CONFIG_LP_MODE,
     };
@@ -136,31 +374,19 @@ void RssiReader::initialize_adc()
             .reference  = NRF_SAADC_REFERENCE_INTERNAL,
             .acq_time   = NRF_SAADC_ACQTIME_5US,
             .mode       = NRF_SAADC_MODE_SINGLE_ENDED,
-            .burst      = NRF_SAADC_BURST_DISABLED,
-            .pin_p      = NRF_SAADC_INPUT_AIN7,
+            .burst      = SCAN_MODE ? NRF_SAADC_BURST_ENABLED : NRF_SAADC_BURST_DISABLED,
+            .pin_p      = NRF_SAADC_INPUT_DISABLED,
             .pin_n      = NRF_SAADC_INPUT_DISABLED,
     };
 
     APP_ERROR_CHECK(nrfx_saadc_init(&saadc_config, handle_adc_event));
-    APP_ERROR_CHECK(nrfx_saadc_channel_init(0, &channel_config));
-    APP_ERROR_CHECK(nrfx_saadc_buffer_convert(buffer_pool[0], SAMPLES_IN_BUFFER));
-    APP_ERROR_CHECK(nrfx_saadc_buffer_convert(buffer_pool[1], SAMPLES_IN_BUFFER));
-}
-
-
-void RssiReader::initalize_uart_logger() {
-    nrfx_uart_config_t uart_config = {
-            .pseltxd            = NRF_GPIO_PIN_MAP(1, 10),
-            .pselrxd            = NRF_UART_PSEL_DISCONNECTED,
-            .pselcts            = NRF_UART_PSEL_DISCONNECTED,
-            .pselrts            = NRF_UART_PSEL_DISCONNECTED,
-            .p_context          = nullptr,
-            .hwfc               = (nrf_uart_hwfc_t)NRFX_UART_DEFAULT_CONFIG_HWFC,
-            .parity             = (nrf_uart_parity_t)NRFX_UART_DEFAULT_CONFIG_PARITY,
-            .baudrate           = (nrf_uart_baudrate_t)NRFX_UART_DEFAULT_CONFIG_BAUDRATE,
-            .interrupt_priority = NRFX_UART_DEFAULT_CONFIG_IRQ_PRIORITY
-    };
-
-    APP_ERROR_CHECK(nrfx_uart_init(&uart, &uart_config, uart_handler));
-    nrf_uart_enable(uart.p_reg);
+    // Multiple enabled channels put SAADC into scan mode.
+    for (uint8_t channel = 0; channel < CHANNELS_COUNT; channel++) {
+        channel_config.pin_p = CHANNEL_INPUTS[channel];
+        APP_ERROR_CHECK(nrfx_saadc_channel_init(channel, &channel_config));
+    }
+    APP_ERROR_CHECK(nrfx_saadc_buffer_convert(buffer_pool[0], SAMPLES_IN_BLOCK * CHANNELS_COUNT));
+    APP_ERROR_CHECK(nrfx_saadc_buffer_convert(buffer_pool[1], SAMPLES_IN_BLOCK * CHANNELS_COUNT));
+    queued_buffer = buffer_pool[1];
 }
+
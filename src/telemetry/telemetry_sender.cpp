@@ -0,0 +1,95 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "telemetry/telemetry_sender.h"
+
+#include <algorithm>
+#include <app_error.h>
+#include <nrf_gpio.h>
+#include <nrf_log.h>
+
+// EasyDMA transfer length register of UARTE is 8 bits wide on nRF52832, keep chunks portable.
+static constexpr size_t MAX_TRANSFER_LENGTH = 255;
+
+TelemetrySender::TelemetrySender() :
+    uarte(NRFX_UARTE_INSTANCE(0)),
+    stream(),
+    transfer_length(0) {}
+
+void TelemetrySender::initialize() {
+    nrfx_uarte_config_t uarte_config = {
+            .pseltxd            = NRF_GPIO_PIN_MAP(1, 10),
+            .pselrxd            = NRF_UARTE_PSEL_DISCONNECTED,
+            .pselcts            = NRF_UARTE_PSEL_DISCONNECTED,
+            .pselrts            = NRF_UARTE_PSEL_DISCONNECTED,
+            .p_context          = this,
+            .hwfc               = (nrf_uarte_hwfc_t)NRFX_UARTE_DEFAULT_CONFIG_HWFC,
+            .parity             = (nrf_uarte_parity_t)NRFX_UARTE_DEFAULT_CONFIG_PARITY,
+            .baudrate           = (nrf_uarte_baudrate_t)NRFX_UARTE_DEFAULT_CONFIG_BAUDRATE,
+            .interrupt_priority = NRFX_UARTE_DEFAULT_CONFIG_IRQ_PRIORITY
+    };
+
+    APP_ERROR_CHECK(nrfx_uarte_init(&uarte, &uarte_config, handle_uarte_event));
+}
+
+bool TelemetrySender::push_samples(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+    bool pushed = stream.push_samples(channel, samples, count, first_sample_tick, tick_stride);
+    if (transfer_length == 0) {
+        start_transfer();
+    }
+    return pushed;
+}
+
+void TelemetrySender::on_initialized(RssiReaderInterface& rssi_reader) {
+    initialize();
+}
+
+void TelemetrySender::on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) {
+    push_samples(channel, samples, count, first_sample_tick, tick_stride);
+}
+
+void TelemetrySender::handle_uarte_event(nrfx_uarte_event_t const * p_event, void * p_context) {
+    TelemetrySender* sender = static_cast<TelemetrySender*>(p_context);
+    switch (p_event->type) {
+        case NRFX_UARTE_EVT_TX_DONE:
+            sender->stream.consume(sender->transfer_length);
+            sender->start_transfer();
+            break;
+        default:
+            NRF_LOG_WARNING("Unhandled UARTE event: %u", p_event->type);
+            break;
+    }
+}
+
+void TelemetrySender::start_transfer() {
+    const uint8_t* data;
+    transfer_length = std::min(stream.get_pending(&data), MAX_TRANSFER_LENGTH);
+    if (transfer_length == 0) {
+        return;
+    }
+
+    // Ring buffer is statically allocated in RAM, which is required by EasyDMA.
+    if (nrfx_uarte_tx(&uarte, data, transfer_length) != NRFX_SUCCESS) {
+        transfer_length = 0;
+    }
+}
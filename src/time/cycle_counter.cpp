@@ -0,0 +1,51 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "time/cycle_counter.h"
+
+CycleCounter::CycleCounter() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+CycleCounter& CycleCounter::get_instance() {
+    static CycleCounter counter;
+    return counter;
+}
+
+uint32_t CycleCounter::get_cycles() const {
+    return DWT->CYCCNT;
+}
+
+uint32_t CycleCounter::get_cycles_per_us() const {
+    return SystemCoreClock / 1000000;
+}
+
+uint8_t CycleCounter::get_execution_priority() const {
+    uint32_t exception = __get_IPSR();
+    if (exception == 0) {
+        return THREAD_PRIORITY;
+    }
+    // System exceptions have negative IRQ numbers.
+    return static_cast<uint8_t>(NVIC_GetPriority(static_cast<IRQn_Type>(static_cast<int32_t>(exception) - 16)));
+}
@@ -21,9 +21,15 @@
 #include "time/real_time_clock.h"
 #include <nrf_rtc.h>
 #include <nrfx_rtc.h>
+#include "app_util_platform.h"
 
-//Dumb handler, needed because nrfx API requires one
-static void rtc_handler(nrfx_rtc_int_type_t int_type) {}
+volatile uint32_t RealTimeClock::overflows = 0;
+
+void RealTimeClock::rtc_handler(nrfx_rtc_int_type_t int_type) {
+    if (int_type == NRFX_RTC_INT_OVERFLOW) {
+        overflows++;
+    }
+}
 
 RealTimeClock::RealTimeClock() :
 rtc_counter(NRFX_RTC_INSTANCE(2)) {
@@ -36,8 +42,20 @@ RealTimeClock& RealTimeClock::get_instance() {
 }
 
 uint32_t RealTimeClock::get_current_timestamp_ms() const {
-    uint64_t counter_value = nrf_rtc_counter_get(rtc_counter.p_reg);
-    return 1000 * counter_value / RTC_COUNTER_FREQUENCY;
+    uint64_t overflows_count;
+    uint64_t counter_value;
+    CRITICAL_REGION_ENTER();
+    overflows_count = overflows;
+    counter_value = nrf_rtc_counter_get(rtc_counter.p_reg);
+    // Counter has wrapped but the interrupt wasn't handled yet, read it again to be sure it's past the wrap.
+    if (nrf_rtc_event_pending(rtc_counter.p_reg, NRF_RTC_EVENT_OVERFLOW)) {
+        overflows_count++;
+        counter_value = nrf_rtc_counter_get(rtc_counter.p_reg);
+    }
+    CRITICAL_REGION_EXIT();
+
+    uint64_t ticks = (overflows_count << RTC_COUNTER_BITS) | counter_value;
+    return static_cast<uint32_t>(1000 * ticks / RTC_COUNTER_FREQUENCY);
 }
 
 void RealTimeClock::initalize_rtc() {
@@ -48,6 +66,7 @@ void RealTimeClock::initalize_rtc() {
         .reliable           = false,
     };
 
-    APP_ERROR_CHECK(nrfx_rtc_init(&rtc_counter, &rtc_config, rtc_handler));
+    APP_ERROR_CHECK(nrfx_rtc_init(&rtc_counter, &rtc_config, RealTimeClock::rtc_handler));
+    nrfx_rtc_overflow_enable(&rtc_counter, true);
     nrfx_rtc_enable(&rtc_counter);
 }
\ No newline at end of file
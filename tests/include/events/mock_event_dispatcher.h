@@ -23,53 +23,56 @@
 #ifndef LAP_TIMER_MOCK_EVENT_DISPATCHER_H
 #define LAP_TIMER_MOCK_EVENT_DISPATCHER_H
 
+#include "events/delayed_event_queue.h"
 #include "events/event_dispatcher_interface.h"
 #include "events/event_observer.h"
+#include "events/event_subscriptions.h"
 
-#include <unordered_set>
 #include <optional>
-#include <deque>
 
+///
+/// @brief Dispatcher running on virtual time.
+///
+/// Time stands still until the next event is processed, then jumps to its deadline. Events with
+/// the same deadline are processed in order they were emitted.
+///
 class MockEventDispatcher : public EventDispatcherInterface {
 public:
+    MockEventDispatcher() : subscriptions(), events_queue(), current_time_ms(0) {}
+
+    ///
+    /// @brief Process the earliest event, advancing time to its deadline.
+    ///
     std::optional<Event> process_next_event();
 
-    bool register_observer(EventObserver* observer) override;
+    ///
+    /// @brief Process events due until the time, then advance time to it.
+    ///
+    /// Needed when periodic events are scheduled, processing them never runs out of events.
+    ///
+    /// @return size_t Number of processed events.
+    ///
+    size_t process_events_until(uint32_t time_ms);
+
+    uint32_t get_current_time_ms() const {
+        return current_time_ms;
+    }
+
+    using EventDispatcherInterface::register_observer;
+    bool register_observer(EventObserver* observer, EventMask events) override;
     bool unregister_observer(EventObserver* observer) override;
 
 public:
     void emit_event(const Event& event) override;
-    void emit_event_delayed(const Event& event, uint32_t ms_delay) override;
+    EventHandle emit_event_delayed(const Event& event, uint32_t ms_delay) override;
+    EventHandle emit_event_at(const Event& event, uint32_t timestamp_ms) override;
+    EventHandle emit_event_periodic(const Event& event, uint32_t ms_period) override;
+    bool cancel(EventHandle handle) override;
 
 private:
-
-    class EventState {
-    public:
-        EventState(const Event& event, size_t delay) : event(event), delay(delay) {}
-        
-        Event get_event() const {
-            return event;
-        }
-
-        size_t get_delay() const {
-            return delay;
-        }
-
-        void substract_delay(size_t delay) {
-            this->delay -= delay;
-        }
-
-        bool operator<(const EventState& other) const {
-            return delay < other.delay;
-        }
-
-    private:
-        Event event;
-        size_t delay;
-    };
-
-    std::unordered_set<EventObserver*> observers;
-    std::deque<EventState> events_queue;
+    EventSubscriptions<32> subscriptions;
+    DelayedEventQueue<256> events_queue;
+    uint32_t current_time_ms;
 };
 
-#endif // LAP_TIMER_MOCK_EVENT_DISPATCHER_H
\ No newline at end of file
+#endif // LAP_TIMER_MOCK_EVENT_DISPATCHER_H
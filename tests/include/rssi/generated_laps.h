@@ -0,0 +1,87 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_GENERATED_LAPS_H
+#define LAP_TIMER_GENERATED_LAPS_H
+
+#include "catch.hpp"
+#include "events/mock_event_dispatcher.h"
+#include "rssi/mock_rssi_reader.h"
+#include "rssi/rssi_signal_generator.h"
+
+#include <cstdlib>
+#include <vector>
+
+// Generated signal is captured in chunks of this length, so events are handled in between as in the firmware.
+static constexpr uint32_t REPLAY_CHUNK_MS = 100;
+
+///
+/// @brief Capture signal of the generator with the reader and process all emitted events.
+///
+/// @return std::vector<Event> Processed events.
+///
+inline std::vector<Event> replay_generated(MockRssiReader& reader, MockEventDispatcher& dispatcher,
+                                           RssiSignalGenerator& generator, uint32_t duration_ms) {
+    std::vector<Event> events;
+    uint32_t chunk_samples = REPLAY_CHUNK_MS * 1000 / reader.get_sample_interval_us();
+    for (uint32_t chunks = duration_ms / REPLAY_CHUNK_MS; chunks > 0; chunks--) {
+        reader.capture_channels(generator.generate(chunk_samples));
+        while (auto event = dispatcher.process_next_event()) {
+            events.push_back(*event);
+        }
+    }
+    return events;
+}
+
+inline std::vector<NewLap> get_laps(const std::vector<Event>& events) {
+    std::vector<NewLap> laps;
+    for (const Event& event : events) {
+        if (auto lap = std::get_if<NewLap>(&event)) {
+            laps.push_back(*lap);
+        }
+    }
+    return laps;
+}
+
+///
+/// @brief Require exactly one lap per generated pass on every channel, within the tolerance.
+///
+inline void require_laps_match_passes(const std::vector<NewLap>& laps, const RssiSignalGenerator& generator, int64_t tolerance_us) {
+    for (uint8_t channel = 0; channel < generator.get_channels_count(); channel++) {
+        const std::vector<uint64_t>& passes = generator.get_pass_timestamps_us(channel);
+        std::vector<NewLap> channel_laps;
+        for (const NewLap& lap : laps) {
+            if (lap.get_channel() == channel) {
+                channel_laps.push_back(lap);
+            }
+        }
+        INFO("channel " << static_cast<int>(channel));
+        REQUIRE(channel_laps.size() == passes.size());
+        for (size_t i = 0; i < passes.size(); i++) {
+            int64_t error_us = static_cast<int64_t>(channel_laps[i].get_timestamp_us()) - static_cast<int64_t>(passes[i]);
+            INFO("pass " << passes[i] << " us, lap " << channel_laps[i].get_timestamp_us() << " us");
+            REQUIRE(std::llabs(error_us) <= tolerance_us);
+        }
+    }
+}
+
+#endif // LAP_TIMER_GENERATED_LAPS_H
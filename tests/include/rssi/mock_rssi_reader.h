@@ -0,0 +1,96 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_MOCK_RSSI_READER_H
+#define LAP_TIMER_MOCK_RSSI_READER_H
+
+#include "rssi/rssi_reader_interface.h"
+
+#include <vector>
+
+class MockRssiReader : public RssiReaderInterface {
+public:
+    MockRssiReader(uint32_t sample_interval_us, size_t block_length, uint8_t channels_count = 1);
+
+    ///
+    /// @brief Pass samples of the first channel to the delegate split into blocks.
+    ///
+    /// @param samples Samples to be captured, one for each tick. With a stride only every
+    ///        stride-th sample is passed.
+    ///
+    void capture(const std::vector<uint16_t>& samples);
+
+    ///
+    /// @brief Pass samples of all channels to the delegate split into blocks.
+    ///
+    /// @param channels Samples to be captured for each channel, all of the same length.
+    ///
+    void capture_channels(const std::vector<std::vector<uint16_t>>& channels);
+
+    uint32_t get_next_tick() const {
+        return next_tick;
+    }
+
+    bool is_wakeup_armed() const {
+        return wakeup_armed;
+    }
+
+    uint8_t get_sample_stride() const {
+        return sample_stride;
+    }
+
+    ///
+    /// @brief Get number of ticks of each channel not passed due to suspended sampling or waiting for wake-up.
+    ///
+    size_t get_skipped_samples() const {
+        return skipped_samples;
+    }
+
+public:
+    void initialize(Delegate &delegate) override;
+    uint32_t get_sample_interval_us() const override;
+    uint8_t get_channels_count() const override;
+    void suspend_sampling(uint32_t resume_tick) override;
+    void arm_wakeup(const std::array<uint16_t, MAX_CHANNELS_COUNT>& levels) override;
+    void set_sample_stride(uint8_t stride) override;
+
+private:
+    size_t find_wakeup_offset(const std::vector<std::vector<uint16_t>>& channels, size_t offset) const;
+
+    Delegate* delegate;
+    uint32_t sample_interval_us;
+    size_t block_length;
+    uint8_t channels_count;
+    uint32_t next_tick;
+    bool suspended;
+    uint32_t resume_tick;
+    size_t skipped_samples;
+    bool wakeup_armed;
+    std::array<uint16_t, MAX_CHANNELS_COUNT> wakeup_levels;
+    uint8_t sample_stride;
+    uint8_t requested_stride;
+    // Ticks of the next capture covered by the last sample of the previous one.
+    size_t covered_ticks;
+};
+
+#endif // LAP_TIMER_MOCK_RSSI_READER_H
@@ -0,0 +1,148 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_RSSI_SIGNAL_GENERATOR_H
+#define LAP_TIMER_RSSI_SIGNAL_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+///
+/// @brief Generates RSSI of drones flying laps through the gate, as sampled by the SAADC.
+///
+/// Every drone transmits on its own video channel and is received by a receiver of the same
+/// index. Distance to the gate follows the pass speed around the moment of each pass, path
+/// loss is applied with separate exponents for the approach and the departure. Received
+/// power is disturbed by multipath fading along the track, by the props modulating the
+/// antenna orientation and by other drones leaking through the adjacent channel rejection
+/// of the receiver. Receiver noise is added and the result is quantized by the 14 bit ADC.
+///
+/// Samples are normalized to 16 bits, as RssiReader does, and can be passed to the
+/// MockRssiReader.
+///
+class RssiSignalGenerator {
+public:
+    static constexpr uint8_t ADC_RESOLUTION_BITS = 14;
+    static constexpr uint16_t ADC_MAX = (1 << ADC_RESOLUTION_BITS) - 1;
+
+    struct DroneParameters {
+        // Time of the first pass through the gate.
+        uint32_t first_pass_ms = 5000;
+        uint32_t lap_time_ms = 20000;
+        // Each lap is up to this much shorter or longer.
+        uint32_t lap_time_jitter_ms = 0;
+        // Speed while passing the gate.
+        float speed_mps = 20.0f;
+        // Distance from the receiver antenna at the moment of the pass.
+        float closest_distance_m = 1.5f;
+        // Received power at 1m from the drone.
+        float power_at_1m_dbm = -35.0f;
+        // Path loss exponents, the drone body shadows its antenna after the pass.
+        float approach_exponent = 2.0f;
+        float depart_exponent = 2.6f;
+    };
+
+    struct EnvironmentParameters {
+        // Receiver RSSI output is linear in dBm between floor and ceiling.
+        float rssi_floor_dbm = -90.0f;
+        float rssi_ceiling_dbm = -20.0f;
+        uint16_t adc_floor = 4000;
+        uint16_t adc_ceiling = 14000;
+        // Standard deviation of the receiver noise.
+        float noise_db = 0.5f;
+        // Ripple caused by spinning props.
+        float prop_noise_db = 1.0f;
+        float prop_frequency_hz = 300.0f;
+        // Ground reflection interferes with the direct path, maxima are fading_period_m apart.
+        float fading_depth_db = 4.0f;
+        float fading_period_m = 3.0f;
+        // Adjacent channel rejection, drones on other channels are attenuated by it.
+        float crosstalk_db = -35.0f;
+    };
+
+    explicit RssiSignalGenerator(uint32_t sample_interval_us, uint32_t seed = 1);
+
+    void set_environment(const EnvironmentParameters& environment) {
+        this->environment = environment;
+    }
+
+    ///
+    /// @brief Add a drone with a receiver on its channel.
+    ///
+    /// @return uint8_t Receiver channel of the drone.
+    ///
+    uint8_t add_drone(const DroneParameters& parameters);
+
+    uint8_t get_channels_count() const {
+        return static_cast<uint8_t>(drones.size());
+    }
+
+    ///
+    /// @brief Generate the following samples of all receivers.
+    ///
+    /// @param count Number of samples of each channel.
+    /// @return std::vector<std::vector<uint16_t>> Samples of each channel.
+    ///
+    std::vector<std::vector<uint16_t>> generate(size_t count);
+
+    ///
+    /// @brief Generate the following samples of all receivers, appending them to channels.
+    ///
+    void generate(std::vector<std::vector<uint16_t>>& channels, size_t count);
+
+    ///
+    /// @brief Get timestamps of all passes of the drone generated so far.
+    ///
+    const std::vector<uint64_t>& get_pass_timestamps_us(uint8_t channel) const {
+        return drones[channel].pass_timestamps_us;
+    }
+
+    uint64_t get_timestamp_us() const {
+        return tick * sample_interval_us;
+    }
+
+private:
+    struct Drone {
+        DroneParameters parameters;
+        int64_t previous_pass_us;
+        int64_t next_pass_us;
+        float fading_phase;
+        float prop_phase;
+        std::vector<uint64_t> pass_timestamps_us;
+    };
+
+    float get_received_power_dbm(Drone& drone, int64_t timestamp_us);
+    uint16_t quantize(float rssi_dbm) const;
+    uint32_t next_random();
+    float next_uniform();
+    float next_gaussian();
+
+    uint32_t sample_interval_us;
+    EnvironmentParameters environment;
+    std::vector<Drone> drones;
+    std::vector<float> received_mw;
+    uint64_t tick;
+    uint32_t random_state;
+};
+
+#endif // LAP_TIMER_RSSI_SIGNAL_GENERATOR_H
@@ -0,0 +1,65 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_MOCK_CYCLE_COUNTER_H
+#define LAP_TIMER_MOCK_CYCLE_COUNTER_H
+
+#include "time/cycle_counter_interface.h"
+
+class MockCycleCounter : public CycleCounterInterface {
+public:
+    MockCycleCounter(uint32_t cycles_per_us = 64) :
+        cycles(0),
+        cycles_per_us(cycles_per_us),
+        priority(THREAD_PRIORITY) {}
+
+    void set_cycles(uint32_t cycles) {
+        this->cycles = cycles;
+    }
+
+    void advance_us(uint32_t us) {
+        cycles += us * cycles_per_us;
+    }
+
+    void set_execution_priority(uint8_t priority) {
+        this->priority = priority;
+    }
+
+    uint32_t get_cycles() const override {
+        return cycles;
+    }
+
+    uint32_t get_cycles_per_us() const override {
+        return cycles_per_us;
+    }
+
+    uint8_t get_execution_priority() const override {
+        return priority;
+    }
+
+private:
+    uint32_t cycles;
+    uint32_t cycles_per_us;
+    uint8_t priority;
+};
+
+#endif // LAP_TIMER_MOCK_CYCLE_COUNTER_H
@@ -0,0 +1,45 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_MOCK_REAL_TIME_CLOCK_H
+#define LAP_TIMER_MOCK_REAL_TIME_CLOCK_H
+
+#include "time/real_time_clock_interface.h"
+
+class MockRealTimeClock : public RealTimeClockInterface {
+public:
+    MockRealTimeClock(uint32_t timestamp_ms = 0) : timestamp_ms(timestamp_ms) {}
+
+    void set_current_timestamp_ms(uint32_t timestamp_ms) {
+        this->timestamp_ms = timestamp_ms;
+    }
+
+    uint32_t get_current_timestamp_ms() const override {
+        return timestamp_ms;
+    }
+
+private:
+    uint32_t timestamp_ms;
+};
+
+#endif // LAP_TIMER_MOCK_REAL_TIME_CLOCK_H
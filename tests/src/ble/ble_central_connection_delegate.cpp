@@ -0,0 +1,133 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "ble/ble_manager_delegate.h"
+#include "events/mock_event_dispatcher.h"
+
+#include <vector>
+
+class RecordingCentralConnection : public BleCentralConnectionInterface {
+public:
+    RecordingCentralConnection() : delegate(nullptr) {}
+
+    void set_delegate(Delegate* delegate) override {
+        this->delegate = delegate;
+    }
+
+    uint16_t get_mtu() const override {
+        return 23;
+    }
+
+    const char* get_mac_address() const override {
+        return "00:00:00:00:00:00";
+    }
+
+    bool send_to_rx(const uint8_t* data, uint16_t length) override {
+        rx_packets.emplace_back(data, data + length);
+        return true;
+    }
+
+    bool send_to_stream(const uint8_t* data, uint16_t length) override {
+        return true;
+    }
+
+    template<typename T>
+    void write_command(const T& command) {
+        uint8_t data[T::max_length];
+        REQUIRE(command.serialize(data, T::max_length));
+        delegate->on_tx_write_request(data, command.length());
+    }
+
+    Delegate* delegate;
+    std::vector<std::vector<uint8_t>> rx_packets;
+};
+
+static std::vector<Event> process_events(MockEventDispatcher& dispatcher) {
+    std::vector<Event> events;
+    while (auto event = dispatcher.process_next_event()) {
+        events.push_back(*event);
+    }
+    return events;
+}
+
+TEST_CASE("RSSI calibration command starts calibration and reports its result", "[ble_central_connection_delegate]") {
+    MockEventDispatcher dispatcher;
+    BleManagerDelegate<2> delegate(dispatcher);
+    RecordingCentralConnection requesting;
+    RecordingCentralConnection other;
+    delegate.on_central_connected(requesting, 0);
+    delegate.on_central_connected(other, 1);
+
+    requesting.write_command(RssiCalibrationCommand(2000));
+    std::vector<Event> events = process_events(dispatcher);
+    REQUIRE(events.size() == 1);
+    REQUIRE(std::get<StartRssiCalibration>(events[0]) == StartRssiCalibration(2000));
+
+    dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(15000, 30000), true, 0));
+    dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(), false, 1));
+    process_events(dispatcher);
+
+    // Only the central which asked for the calibration gets the results, one per channel.
+    REQUIRE(other.rx_packets.empty());
+    REQUIRE(requesting.rx_packets.size() == 2);
+    RssiCalibrationCommandResponse response(0xFF, false, 0, 0);
+    REQUIRE(response.deserialize(requesting.rx_packets[0].data(), requesting.rx_packets[0].size()));
+    REQUIRE(response.get_channel() == 0);
+    REQUIRE(response.is_successful());
+    REQUIRE(response.get_noise_floor() == 15000);
+    REQUIRE(response.get_peak() == 30000);
+    REQUIRE(response.deserialize(requesting.rx_packets[1].data(), requesting.rx_packets[1].size()));
+    REQUIRE(response.get_channel() == 1);
+    REQUIRE_FALSE(response.is_successful());
+}
+
+TEST_CASE("RSSI calibration command is rejected without a duration", "[ble_central_connection_delegate]") {
+    MockEventDispatcher dispatcher;
+    BleManagerDelegate<1> delegate(dispatcher);
+    RecordingCentralConnection central;
+    delegate.on_central_connected(central, 0);
+
+    central.write_command(RssiCalibrationCommand(0));
+    REQUIRE(process_events(dispatcher).empty());
+
+    dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(15000, 30000), true, 0));
+    process_events(dispatcher);
+    REQUIRE(central.rx_packets.empty());
+}
+
+TEST_CASE("RSSI calibration result isn't sent after the central reconnects", "[ble_central_connection_delegate]") {
+    MockEventDispatcher dispatcher;
+    BleManagerDelegate<1> delegate(dispatcher);
+    RecordingCentralConnection central;
+    delegate.on_central_connected(central, 0);
+    central.write_command(RssiCalibrationCommand(2000));
+    process_events(dispatcher);
+
+    delegate.on_central_disconnected(central, 0);
+    RecordingCentralConnection next_central;
+    delegate.on_central_connected(next_central, 0);
+    dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(15000, 30000), true, 0));
+    process_events(dispatcher);
+    REQUIRE(central.rx_packets.empty());
+    REQUIRE(next_central.rx_packets.empty());
+}
@@ -0,0 +1,118 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "events/delayed_event_queue.h"
+
+#include <vector>
+
+template<size_t CAPACITY>
+static std::vector<Event> pop_all_due(DelayedEventQueue<CAPACITY>& queue, uint32_t now) {
+    std::vector<Event> events;
+    Event event;
+    while (queue.pop_due(now, event)) {
+        events.push_back(event);
+    }
+    return events;
+}
+
+TEST_CASE("Delayed events are popped in order of deadlines", "[delayed_event_queue]") {
+    DelayedEventQueue<8> queue;
+    REQUIRE(queue.is_empty());
+    REQUIRE(queue.push(FlashLED(0, 0), 1000));
+    REQUIRE(queue.push(FlashLED(0, 1), 200));
+    REQUIRE(queue.push(FlashLED(1, 3), 1300));
+    REQUIRE(queue.push(FlashLED(0, 2), 0));
+    REQUIRE(queue.push(FlashLED(2, 2), 0));
+    REQUIRE(queue.push(FlashLED(0, 3), 300));
+    REQUIRE(queue.get_size() == 6);
+    REQUIRE(queue.get_next_deadline() == 0);
+
+    // Events with the same deadline keep their order.
+    REQUIRE(pop_all_due(queue, 0) == std::vector<Event>{ FlashLED(0, 2), FlashLED(2, 2) });
+    REQUIRE(queue.get_next_deadline() == 200);
+    REQUIRE(pop_all_due(queue, 199).empty());
+    REQUIRE(pop_all_due(queue, 1000) == std::vector<Event>{ FlashLED(0, 1), FlashLED(0, 3), FlashLED(0, 0) });
+    REQUIRE(pop_all_due(queue, 5000) == std::vector<Event>{ FlashLED(1, 3) });
+    REQUIRE(queue.is_empty());
+    REQUIRE(queue.get_high_water_mark() == 6);
+}
+
+TEST_CASE("Delayed events survive clock wrap", "[delayed_event_queue]") {
+    DelayedEventQueue<4> queue;
+    uint32_t now = UINT32_MAX - 10;
+    REQUIRE(queue.push(StopSession(), now + 20));
+    REQUIRE(queue.push(StartSession(), now + 5));
+    REQUIRE(queue.get_next_deadline() == now + 5);
+    REQUIRE(pop_all_due(queue, now).empty());
+    REQUIRE(pop_all_due(queue, now + 5) == std::vector<Event>{ StartSession() });
+    REQUIRE(pop_all_due(queue, now + 19).empty());
+    REQUIRE(pop_all_due(queue, now + 25) == std::vector<Event>{ StopSession() });
+}
+
+TEST_CASE("Full delayed event queue drops events", "[delayed_event_queue]") {
+    DelayedEventQueue<2> queue;
+    REQUIRE(queue.push(StartSession(), 10));
+    REQUIRE(queue.push(StartSession(), 20));
+    REQUIRE_FALSE(queue.push(StopSession(), 5));
+    REQUIRE(queue.get_overflows() == 1);
+    REQUIRE(queue.get_next_deadline() == 10);
+
+    // Popped event frees space.
+    REQUIRE(pop_all_due(queue, 10).size() == 1);
+    REQUIRE(queue.push(StopSession(), 5));
+    REQUIRE(pop_all_due(queue, 20) == std::vector<Event>{ StopSession(), StartSession() });
+}
+
+TEST_CASE("Periodic events keep their phase", "[delayed_event_queue]") {
+    DelayedEventQueue<4> queue;
+    REQUIRE(queue.push(FlashLED(0, 0), 100, 100));
+    REQUIRE(pop_all_due(queue, 105) == std::vector<Event>{ FlashLED(0, 0) });
+    REQUIRE(queue.get_size() == 1);
+    // Late pop doesn't shift the next deadline.
+    REQUIRE(queue.get_next_deadline() == 200);
+
+    // Missed periods are skipped, not emitted in a burst.
+    REQUIRE(pop_all_due(queue, 450) == std::vector<Event>{ FlashLED(0, 0) });
+    REQUIRE(queue.get_next_deadline() == 500);
+    REQUIRE(pop_all_due(queue, 499).empty());
+}
+
+TEST_CASE("Canceled events are not popped", "[delayed_event_queue]") {
+    DelayedEventQueue<4> queue;
+    EventHandle periodic = queue.push(FlashLED(0, 0), 10, 10);
+    EventHandle first = queue.push(StartSession(), 15);
+    EventHandle second = queue.push(StopSession(), 20);
+    REQUIRE(periodic != INVALID_EVENT_HANDLE);
+    REQUIRE(first != periodic);
+    REQUIRE(second != first);
+
+    REQUIRE(queue.cancel(first));
+    REQUIRE_FALSE(queue.cancel(first));
+    // Late pop of the periodic event covers its period due at 20 as well.
+    REQUIRE(pop_all_due(queue, 20) == std::vector<Event>{ FlashLED(0, 0), StopSession() });
+    REQUIRE_FALSE(queue.cancel(second));
+
+    REQUIRE(queue.cancel(periodic));
+    REQUIRE(queue.is_empty());
+    REQUIRE(pop_all_due(queue, 100).empty());
+}
@@ -0,0 +1,77 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "events/event_lanes.h"
+
+#include <vector>
+
+template<uint8_t URGENT_CAPACITY, uint8_t BACKGROUND_CAPACITY>
+static std::vector<Event> pop_all(EventLanes<URGENT_CAPACITY, BACKGROUND_CAPACITY>& lanes, bool include_background = true) {
+    std::vector<Event> events;
+    Event event;
+    while (lanes.pop(event, include_background)) {
+        events.push_back(event);
+    }
+    return events;
+}
+
+TEST_CASE("Urgent events overtake background events", "[event_lanes]") {
+    EventLanes<4, 4> lanes;
+    REQUIRE(lanes.is_empty());
+    REQUIRE(lanes.push(AddLapTime(1000)));
+    REQUIRE(lanes.push(FlashLED(0, 1)));
+    REQUIRE(lanes.push(NewLap(100)));
+    REQUIRE(lanes.push(ResetStorage()));
+    REQUIRE(lanes.push(RssiSamplesAvailable()));
+    REQUIRE(lanes.get_urgent_size() == 2);
+    REQUIRE(lanes.get_background_size() == 3);
+
+    REQUIRE(pop_all(lanes) == std::vector<Event>{
+        NewLap(100),
+        RssiSamplesAvailable(),
+        AddLapTime(1000),
+        FlashLED(0, 1),
+        ResetStorage()
+    });
+    REQUIRE(lanes.is_empty());
+}
+
+TEST_CASE("Background events can be left pending", "[event_lanes]") {
+    EventLanes<4, 4> lanes;
+    REQUIRE(lanes.push(FlashLED(0, 1)));
+    REQUIRE(lanes.push(StopSession()));
+
+    REQUIRE(pop_all(lanes, false) == std::vector<Event>{ StopSession() });
+    REQUIRE_FALSE(lanes.is_empty());
+    REQUIRE(pop_all(lanes) == std::vector<Event>{ FlashLED(0, 1) });
+}
+
+TEST_CASE("Full lane doesn't block the other one", "[event_lanes]") {
+    EventLanes<1, 2> lanes;
+    REQUIRE(lanes.push(ResetStorage()));
+    REQUIRE(lanes.push(ResetStorage()));
+    REQUIRE_FALSE(lanes.push(ResetStorage()));
+    REQUIRE(lanes.push(NewLap(100)));
+    REQUIRE_FALSE(lanes.push(NewLap(200)));
+    REQUIRE(lanes.get_overflows() == 2);
+}
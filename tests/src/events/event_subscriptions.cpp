@@ -0,0 +1,114 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "events/event_subscriptions.h"
+
+#include <vector>
+
+class CountingEventObserver : public EventObserver {
+public:
+    CountingEventObserver() : events() {}
+
+    void on_event(const Event& event) override {
+        events.push_back(event);
+    }
+
+    std::vector<Event> events;
+};
+
+class UnsubscribingEventObserver : public EventObserver {
+public:
+    UnsubscribingEventObserver(EventSubscriptions<4>& subscriptions, EventObserver* other) :
+        subscriptions(subscriptions),
+        other(other) {}
+
+    void on_event(const Event& event) override {
+        subscriptions.unsubscribe(other);
+    }
+
+private:
+    EventSubscriptions<4>& subscriptions;
+    EventObserver* other;
+};
+
+TEST_CASE("Event mask is derived from event index", "[event_subscriptions]") {
+    REQUIRE(event_mask<>() == 0);
+    REQUIRE(event_mask<StartSession>() == (EventMask(1) << Event(StartSession()).index()));
+    REQUIRE(event_mask<StartSession, NewLap>() == (event_mask<StartSession>() | event_mask<NewLap>()));
+    REQUIRE((event_mask<NewLap>() & EVENT_MASK_ALL) == event_mask<NewLap>());
+    REQUIRE((EVENT_MASK_ALL >> (EVENT_TYPES_COUNT - 1)) == 1);
+}
+
+TEST_CASE("Events are dispatched only to subscribed observers", "[event_subscriptions]") {
+    EventSubscriptions<4> subscriptions;
+    CountingEventObserver session_observer;
+    CountingEventObserver lap_observer;
+    CountingEventObserver all_observer;
+    REQUIRE(subscriptions.subscribe(&session_observer, event_mask<StartSession, StopSession>()));
+    REQUIRE(subscriptions.subscribe(&lap_observer, event_mask<NewLap>()));
+    REQUIRE(subscriptions.subscribe(&all_observer, EVENT_MASK_ALL));
+
+    REQUIRE(subscriptions.dispatch(StartSession()) == 2);
+    REQUIRE(subscriptions.dispatch(NewLap(1000)) == 2);
+    REQUIRE(subscriptions.dispatch(FlashLED(0, 1)) == 1);
+    REQUIRE(session_observer.events == std::vector<Event>{ StartSession() });
+    REQUIRE(lap_observer.events == std::vector<Event>{ NewLap(1000) });
+    REQUIRE(all_observer.events.size() == 3);
+
+    // Registering again replaces events.
+    REQUIRE(subscriptions.subscribe(&session_observer, event_mask<NewLap>()));
+    REQUIRE(subscriptions.dispatch(StartSession()) == 1);
+    REQUIRE(subscriptions.dispatch(NewLap(2000)) == 3);
+    REQUIRE(session_observer.events == std::vector<Event>{ StartSession(), NewLap(2000) });
+
+    REQUIRE(subscriptions.unsubscribe(&all_observer));
+    REQUIRE_FALSE(subscriptions.unsubscribe(&all_observer));
+    REQUIRE(subscriptions.dispatch(StartSession()) == 0);
+}
+
+TEST_CASE("Event subscriptions have limited slots", "[event_subscriptions]") {
+    EventSubscriptions<4> subscriptions;
+    std::array<CountingEventObserver, 5> observers;
+    for (size_t i = 0; i < 4; i++) {
+        REQUIRE(subscriptions.subscribe(&observers[i], event_mask<StopSession>()));
+    }
+    REQUIRE_FALSE(subscriptions.subscribe(&observers[4], event_mask<StopSession>()));
+
+    // Freed slot is reused.
+    REQUIRE(subscriptions.unsubscribe(&observers[1]));
+    REQUIRE(subscriptions.subscribe(&observers[4], event_mask<StopSession>()));
+    REQUIRE(subscriptions.dispatch(StopSession()) == 4);
+    REQUIRE(observers[1].events.empty());
+    REQUIRE(observers[4].events.size() == 1);
+}
+
+TEST_CASE("Observer unsubscribed while dispatching doesn't get the event", "[event_subscriptions]") {
+    EventSubscriptions<4> subscriptions;
+    CountingEventObserver observer;
+    UnsubscribingEventObserver unsubscribing_observer(subscriptions, &observer);
+    REQUIRE(subscriptions.subscribe(&unsubscribing_observer, EVENT_MASK_ALL));
+    REQUIRE(subscriptions.subscribe(&observer, EVENT_MASK_ALL));
+
+    REQUIRE(subscriptions.dispatch(StopSession()) == 1);
+    REQUIRE(observer.events.empty());
+}
@@ -22,49 +22,6 @@
 
 #include "catch.hpp"
 #include "events/mock_event_dispatcher.h"
-#include <algorithm>
-
-std::optional<Event> MockEventDispatcher::process_next_event() {
-    if (events_queue.empty()) {
-        return std::nullopt;
-    }
-
-    EventState first_event_state = events_queue.front();
-    for (EventState& event_state: events_queue) {
-        event_state.substract_delay(first_event_state.get_delay());
-    }
-    events_queue.pop_front();
-
-    for (EventObserver *observer : observers) {
-        if (observer) {
-            observer->on_event(first_event_state.get_event());
-        }
-    }
-
-    return first_event_state.get_event();
-}
-
-bool MockEventDispatcher::register_observer(EventObserver* observer) {
-    observers.insert(observer);
-    return true;
-}
-
-bool MockEventDispatcher::unregister_observer(EventObserver* observer) {
-    observers.erase(observer);
-    return true;
-}
-
-void MockEventDispatcher::emit_event(const Event& event) {
-    events_queue.push_back(EventState(event, 0));
-    std::stable_sort(events_queue.begin(), events_queue.end());
-}
-
-void MockEventDispatcher::emit_event_delayed(const Event& event, uint32_t ms_delay) {
-    events_queue.push_back(EventState(event, ms_delay));
-    std::stable_sort(events_queue.begin(), events_queue.end());
-}
-
-// TESTS ----------------------------------------------------------------------
 
 class MockEventObserver : public EventObserver {
 public:
@@ -119,4 +76,49 @@ TEST_CASE("mock event dispatcher is implemented properly", "[event_dispatcher]")
     REQUIRE(dispatcher.process_next_event() == make_event(FlashLED{0, 0}));
     REQUIRE(dispatcher.process_next_event() == make_event(FlashLED{1, 3}));
     REQUIRE(dispatcher.process_next_event() == std::nullopt);
-}
\ No newline at end of file
+}
+
+TEST_CASE("mock event dispatcher advances virtual time to processed events", "[event_dispatcher]") {
+    MockEventDispatcher dispatcher;
+
+    dispatcher.emit_event_delayed(FlashLED{0, 0}, 100);
+    dispatcher.emit_event_at(FlashLED{0, 1}, 50);
+    REQUIRE(dispatcher.get_current_time_ms() == 0);
+
+    REQUIRE(dispatcher.process_next_event() == make_event(FlashLED{0, 1}));
+    REQUIRE(dispatcher.get_current_time_ms() == 50);
+
+    dispatcher.emit_event_delayed(FlashLED{0, 2}, 10);
+    dispatcher.emit_event_at(FlashLED{0, 3}, 20);
+    REQUIRE(dispatcher.process_next_event() == make_event(FlashLED{0, 3}));
+    REQUIRE(dispatcher.get_current_time_ms() == 50);
+    REQUIRE(dispatcher.process_next_event() == make_event(FlashLED{0, 2}));
+    REQUIRE(dispatcher.get_current_time_ms() == 60);
+    REQUIRE(dispatcher.process_next_event() == make_event(FlashLED{0, 0}));
+    REQUIRE(dispatcher.get_current_time_ms() == 100);
+    REQUIRE(dispatcher.process_next_event() == std::nullopt);
+}
+
+TEST_CASE("mock event dispatcher emits periodic events until canceled", "[event_dispatcher]") {
+    MockEventDispatcher dispatcher;
+    MockEventObserver observer(dispatcher);
+    REQUIRE(dispatcher.register_observer(&observer));
+
+    REQUIRE(dispatcher.emit_event_periodic(FlashLED{0, 0}, 0) == INVALID_EVENT_HANDLE);
+    EventHandle handle = dispatcher.emit_event_periodic(FlashLED{1, 0}, 30);
+    REQUIRE(handle != INVALID_EVENT_HANDLE);
+    dispatcher.emit_event_delayed(FlashLED{2, 0}, 45);
+
+    REQUIRE(dispatcher.process_events_until(29) == 0);
+    REQUIRE(observer.get_last_event() == std::nullopt);
+    REQUIRE(dispatcher.process_events_until(100) == 4);
+    REQUIRE(dispatcher.get_current_time_ms() == 100);
+    REQUIRE(observer.get_last_event() == make_event(FlashLED{1, 0}));
+
+    REQUIRE(dispatcher.process_next_event() == make_event(FlashLED{1, 0}));
+    REQUIRE(dispatcher.get_current_time_ms() == 120);
+
+    REQUIRE(dispatcher.cancel(handle));
+    REQUIRE_FALSE(dispatcher.cancel(handle));
+    REQUIRE(dispatcher.process_next_event() == std::nullopt);
+}
@@ -0,0 +1,97 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "events/mock_event_dispatcher.h"
+#include "events/static_dispatcher.h"
+
+#include <vector>
+
+class SessionObserver : public EventObserver {
+public:
+    static constexpr EventMask EVENTS = event_mask<StartSession, StopSession>();
+
+    SessionObserver(EventDispatcherInterface& event_dispatcher) : events() {
+        REQUIRE(event_dispatcher.register_observer(this, EVENTS));
+    }
+
+    void on_event(const Event& event) override {
+        events.push_back(event);
+    }
+
+    std::vector<Event> events;
+};
+
+class LapObserver : public EventObserver {
+public:
+    static constexpr EventMask EVENTS = event_mask<NewLap, StopSession>();
+
+    LapObserver(EventDispatcherInterface& event_dispatcher) : event_dispatcher(event_dispatcher), events() {
+        REQUIRE(event_dispatcher.register_observer(this, EVENTS));
+    }
+
+    void on_event(const Event& event) override {
+        events.push_back(event);
+        if (std::holds_alternative<NewLap>(event)) {
+            event_dispatcher.emit_event(AddLapTime(std::get<NewLap>(event).get_timestamp()));
+        }
+    }
+
+    EventDispatcherInterface& event_dispatcher;
+    std::vector<Event> events;
+};
+
+TEST_CASE("Static dispatcher passes events to wired observers", "[static_dispatcher]") {
+    MockEventDispatcher event_queue;
+    StaticDispatcher<SessionObserver, LapObserver> dispatcher(event_queue);
+    SessionObserver session_observer(dispatcher);
+    LapObserver lap_observer(dispatcher);
+
+    // Events emitted before observers are attached are queued.
+    dispatcher.emit_event(StartSession());
+    dispatcher.attach(session_observer, lap_observer);
+
+    REQUIRE(event_queue.process_next_event() == std::optional<Event>(StartSession()));
+    dispatcher.emit_event(NewLap(1000));
+    dispatcher.emit_event(StopSession());
+    dispatcher.emit_event(FlashLED(0, 1));
+    while (event_queue.process_next_event()) {}
+
+    REQUIRE(session_observer.events == std::vector<Event>{ StartSession(), StopSession() });
+    REQUIRE(lap_observer.events == std::vector<Event>{ NewLap(1000), StopSession() });
+}
+
+TEST_CASE("Static dispatcher accepts only wired observers", "[static_dispatcher]") {
+    MockEventDispatcher event_queue;
+    StaticDispatcher<SessionObserver> dispatcher(event_queue);
+    SessionObserver session_observer(dispatcher);
+    REQUIRE_FALSE(dispatcher.register_observer(&session_observer, event_mask<NewLap>()));
+    REQUIRE_FALSE(dispatcher.unregister_observer(&session_observer));
+    REQUIRE(StaticDispatcher<SessionObserver, LapObserver>::EVENTS == event_mask<StartSession, StopSession, NewLap>());
+
+    // Events are delayed by the wrapped dispatcher.
+    dispatcher.attach(session_observer);
+    dispatcher.emit_event_delayed(StopSession(), 100);
+    dispatcher.emit_event(StartSession());
+    while (event_queue.process_next_event()) {}
+    REQUIRE(session_observer.events == std::vector<Event>{ StartSession(), StopSession() });
+}
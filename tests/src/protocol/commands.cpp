@@ -286,3 +286,140 @@ TEST_CASE("Get Session Record command should deserialize properly", "[commands]"
     REQUIRE(payload.get_lap_times()[1] == 0x05060708);
     REQUIRE(payload.length() == 10);
 }
+
+TEST_CASE("Lap Signature command should serialize properly", "[commands]") {
+    REQUIRE(serialize_command<LapSignatureCommand>(LapSignatureCommand(0x2010, 0x05), { 0x08, 0x10, 0x20, 0x05 }));
+    REQUIRE(serialize_command<LapSignatureCommandResponse>(LapSignatureCommandResponse(), { 0x88, 0x00 }));
+    REQUIRE(serialize_command<LapSignatureCommandResponse>(LapSignatureCommandResponse(0x2010, 0x05, 0x01020304, 0xC350, 0x00C8, 0x1234, 0x5678, 0x64),
+        { 0x88, 0x01, 0x10, 0x20, 0x05, 0x04, 0x03, 0x02, 0x01, 0x50, 0xC3, 0xC8, 0x00, 0x34, 0x12, 0x78, 0x56, 0x64 }));
+}
+
+TEST_CASE("Lap Signature command should deserialize properly", "[commands]") {
+    LapSignatureCommand command(0xFFFF, 0xFF);
+    REQUIRE(deserialize_command(command, { 0x08, 0x10, 0x20, 0x05 }));
+    REQUIRE(command.get_id() == LAP_SIGNATURE_CODE);
+    REQUIRE(command.get_session_id() == 0x2010);
+    REQUIRE(command.get_lap_id() == 0x05);
+    REQUIRE(command.length() == 4);
+
+    LapSignatureCommandResponse missing(0xFFFF, 0xFF, 0, 0, 0, 0, 0, 0);
+    REQUIRE(deserialize_command(missing, { 0x88, 0x00 }));
+    REQUIRE_FALSE(missing.is_found());
+    REQUIRE(missing.length() == 2);
+
+    LapSignatureCommandResponse response;
+    REQUIRE_FALSE(deserialize_command(response, { 0x88, 0x01, 0x10, 0x20 }));
+    REQUIRE(deserialize_command(response, { 0x88, 0x01, 0x10, 0x20, 0x05, 0x04, 0x03, 0x02, 0x01, 0x50, 0xC3, 0xC8, 0x00, 0x34, 0x12, 0x78, 0x56, 0x64 }));
+    REQUIRE(response.get_id() == (LAP_SIGNATURE_CODE | COMMAND_RESPONSE_BIT));
+    REQUIRE(response.is_found());
+    REQUIRE(response.get_session_id() == 0x2010);
+    REQUIRE(response.get_lap_id() == 0x05);
+    REQUIRE(response.get_lap_time() == 0x01020304);
+    REQUIRE(response.get_peak() == 50000);
+    REQUIRE(response.get_duration_ms() == 200);
+    REQUIRE(response.get_rise_slope() == 0x1234);
+    REQUIRE(response.get_fall_slope() == 0x5678);
+    REQUIRE(response.get_confidence() == 100);
+    REQUIRE(response.length() == 18);
+}
+
+TEST_CASE("Latency Stats command should serialize properly", "[commands]") {
+    REQUIRE(serialize_command<LatencyStatsCommand>(LatencyStatsCommand(0x04), { 0x09, 0x04 }));
+    REQUIRE(serialize_command<LatencyStatsCommandResponse>(LatencyStatsCommandResponse(0x04, 0xFF, 0x0A, 0x0102, 0x0304, 0x01020304, 0x05060708),
+        { 0x89, 0x04, 0xFF, 0x0A, 0x00, 0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x04, 0x03, 0x00, 0x00,
+          0x04, 0x03, 0x02, 0x01, 0x08, 0x07, 0x06, 0x05 }));
+}
+
+TEST_CASE("Latency Stats command should deserialize properly", "[commands]") {
+    LatencyStatsCommand command(0xFF);
+    REQUIRE(deserialize_command(command, { 0x09, 0x04 }));
+    REQUIRE(command.get_id() == LATENCY_STATS_CODE);
+    REQUIRE(command.get_stage() == 0x04);
+    REQUIRE(command.length() == 2);
+
+    LatencyStatsCommandResponse response(0, 0, 0, 0, 0, 0, 0);
+    REQUIRE_FALSE(deserialize_command(response, { 0x89, 0x04, 0xFF }));
+    REQUIRE(deserialize_command(response, { 0x89, 0x04, 0xFF, 0x0A, 0x00, 0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x04, 0x03, 0x00, 0x00,
+                                            0x04, 0x03, 0x02, 0x01, 0x08, 0x07, 0x06, 0x05 }));
+    REQUIRE(response.get_id() == (LATENCY_STATS_CODE | COMMAND_RESPONSE_BIT));
+    REQUIRE(response.get_stage() == 0x04);
+    REQUIRE(response.get_priority() == 0xFF);
+    REQUIRE(response.get_count() == 0x0A);
+    REQUIRE(response.get_min_us() == 0x0102);
+    REQUIRE(response.get_p50_us() == 0x0304);
+    REQUIRE(response.get_p99_us() == 0x01020304);
+    REQUIRE(response.get_max_us() == 0x05060708);
+    REQUIRE(response.length() == 23);
+}
+
+TEST_CASE("RSSI Stream command should serialize properly", "[commands]") {
+    REQUIRE(serialize_command<RssiStreamCommand>(RssiStreamCommand(0x01, 0x64), { 0x0A, 0x01, 0x64 }));
+    REQUIRE(serialize_command<RssiStreamCommandResponse>(RssiStreamCommandResponse(0x01, 0x00), { 0x8A, 0x01, 0x00 }));
+
+    RssiStreamNotification<2> notification(0x01, 0x0102, 0x01020304, 0x1388);
+    REQUIRE(notification.length() == 13);
+    REQUIRE(notification.add_summary({ 0x0100, 0x0300, 0x0200 }));
+    REQUIRE(notification.add_summary({ 0x0101, 0x0301, 0x0201 }));
+    REQUIRE_FALSE(notification.add_summary({ 0x0102, 0x0302, 0x0202 }));
+    REQUIRE(serialize_command<RssiStreamNotification<2>>(notification,
+        { 0x4A, 0x01, 0x02, 0x01, 0x04, 0x03, 0x02, 0x01, 0x88, 0x13, 0x00, 0x00, 0x02,
+          0x00, 0x01, 0x00, 0x03, 0x00, 0x02, 0x01, 0x01, 0x01, 0x03, 0x01, 0x02 }));
+}
+
+TEST_CASE("RSSI Stream command should deserialize properly", "[commands]") {
+    RssiStreamCommand command(0, 0);
+    REQUIRE_FALSE(deserialize_command(command, { 0x0A, 0x01 }));
+    REQUIRE(deserialize_command(command, { 0x0A, 0x01, 0x64 }));
+    REQUIRE(command.get_id() == RSSI_STREAM_CODE);
+    REQUIRE(command.get_channel() == 0x01);
+    REQUIRE(command.get_rate_hz() == 0x64);
+    REQUIRE(command.length() == 3);
+
+    RssiStreamCommandResponse response(0, 0);
+    REQUIRE(deserialize_command(response, { 0x8A, 0x01, 0x64 }));
+    REQUIRE(response.get_id() == (RSSI_STREAM_CODE | COMMAND_RESPONSE_BIT));
+    REQUIRE(response.get_channel() == 0x01);
+    REQUIRE(response.get_rate_hz() == 0x64);
+
+    RssiStreamNotification<2> notification;
+    // Summary count doesn't match the length.
+    REQUIRE_FALSE(deserialize_command(notification, { 0x4A, 0x01, 0x02, 0x01, 0x04, 0x03, 0x02, 0x01, 0x88, 0x13, 0x00, 0x00, 0x01 }));
+    // More summaries than fit.
+    REQUIRE_FALSE(deserialize_command(notification, { 0x4A, 0x01, 0x02, 0x01, 0x04, 0x03, 0x02, 0x01, 0x88, 0x13, 0x00, 0x00, 0x03 }));
+    REQUIRE(deserialize_command(notification,
+        { 0x4A, 0x01, 0x02, 0x01, 0x04, 0x03, 0x02, 0x01, 0x88, 0x13, 0x00, 0x00, 0x01,
+          0x00, 0x01, 0x00, 0x03, 0x00, 0x02 }));
+    REQUIRE(notification.get_id() == (RSSI_STREAM_CODE | COMMAND_INDICATION_BIT));
+    REQUIRE(notification.get_channel() == 0x01);
+    REQUIRE(notification.get_sequence() == 0x0102);
+    REQUIRE(notification.get_first_time_ms() == 0x01020304);
+    REQUIRE(notification.get_period_us() == 0x1388);
+    REQUIRE(notification.get_summary_count() == 1);
+    REQUIRE(notification.get_summaries()[0] == RssiStreamSummary{ 0x0100, 0x0300, 0x0200 });
+    REQUIRE(notification.length() == 19);
+}
+
+TEST_CASE("RSSI Calibration command should serialize properly", "[commands]") {
+    REQUIRE(serialize_command<RssiCalibrationCommand>(RssiCalibrationCommand(0x01020304), { 0x0B, 0x04, 0x03, 0x02, 0x01 }));
+    REQUIRE(serialize_command<RssiCalibrationCommandResponse>(RssiCalibrationCommandResponse(0x01, true, 0x0102, 0x0304),
+        { 0x8B, 0x01, 0x01, 0x02, 0x01, 0x04, 0x03 }));
+}
+
+TEST_CASE("RSSI Calibration command should deserialize properly", "[commands]") {
+    RssiCalibrationCommand command(0);
+    REQUIRE_FALSE(deserialize_command(command, { 0x0B, 0x04, 0x03 }));
+    REQUIRE(deserialize_command(command, { 0x0B, 0x04, 0x03, 0x02, 0x01 }));
+    REQUIRE(command.get_id() == RSSI_CALIBRATION_CODE);
+    REQUIRE(command.get_duration_ms() == 0x01020304);
+    REQUIRE(command.length() == 5);
+
+    RssiCalibrationCommandResponse response(0, true, 0, 0);
+    REQUIRE_FALSE(deserialize_command(response, { 0x8A, 0x01, 0x00, 0x02, 0x01, 0x04, 0x03 }));
+    REQUIRE(deserialize_command(response, { 0x8B, 0x01, 0x00, 0x02, 0x01, 0x04, 0x03 }));
+    REQUIRE(response.get_id() == (RSSI_CALIBRATION_CODE | COMMAND_RESPONSE_BIT));
+    REQUIRE(response.get_channel() == 0x01);
+    REQUIRE_FALSE(response.is_successful());
+    REQUIRE(response.get_noise_floor() == 0x0102);
+    REQUIRE(response.get_peak() == 0x0304);
+    REQUIRE(response.length() == 7);
+}
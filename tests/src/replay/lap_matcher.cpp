@@ -0,0 +1,85 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "replay/lap_matcher.h"
+
+#include <sstream>
+
+TEST_CASE("ground truth is parsed", "[lap_matcher]") {
+    std::istringstream input(
+        "# timestamp_ms channel\n"
+        "1500\n"
+        "\n"
+        "2750.5 3\n");
+
+    std::optional<std::vector<LapRecord>> laps = parse_ground_truth(input);
+
+    REQUIRE(laps);
+    REQUIRE(laps->size() == 2);
+    REQUIRE((*laps)[0].get_timestamp_us() == 1500000);
+    REQUIRE((*laps)[0].get_channel() == 0);
+    REQUIRE((*laps)[1].get_timestamp_us() == 2750500);
+    REQUIRE((*laps)[1].get_channel() == 3);
+}
+
+TEST_CASE("invalid ground truth is rejected", "[lap_matcher]") {
+    std::istringstream invalid_timestamp("1500\nlap\n");
+    REQUIRE_FALSE(parse_ground_truth(invalid_timestamp));
+
+    std::istringstream negative_timestamp("-10\n");
+    REQUIRE_FALSE(parse_ground_truth(negative_timestamp));
+
+    std::istringstream invalid_channel("1500 256\n");
+    REQUIRE_FALSE(parse_ground_truth(invalid_channel));
+}
+
+TEST_CASE("lap matcher matches nearest laps", "[lap_matcher]") {
+    LapMatcher matcher(100);
+
+    matcher.match(
+        {LapRecord(1000000), LapRecord(5000000), LapRecord(9000000), LapRecord(5000000, 1)},
+        {LapRecord(1020000), LapRecord(985000), LapRecord(5090000), LapRecord(9200000), LapRecord(5000000, 2)});
+
+    REQUIRE(matcher.get_matches().size() == 4);
+    REQUIRE(matcher.get_matches()[0].get_detected()->get_timestamp_us() == 985000);
+    REQUIRE(matcher.get_matches()[0].get_error_us() == -15000);
+    REQUIRE(matcher.get_matches()[1].get_error_us() == 90000);
+    REQUIRE_FALSE(matcher.get_matches()[2].get_detected());
+    REQUIRE_FALSE(matcher.get_matches()[3].get_detected());
+    REQUIRE(matcher.get_matched_count() == 2);
+    REQUIRE(matcher.get_missed_count() == 2);
+    REQUIRE(matcher.get_false_laps().size() == 3);
+    REQUIRE(matcher.get_mean_abs_error_us() == 52500);
+    REQUIRE(matcher.get_max_abs_error_us() == 90000);
+}
+
+TEST_CASE("lap matcher matches each detected lap once", "[lap_matcher]") {
+    LapMatcher matcher(100);
+
+    matcher.match({LapRecord(1000000), LapRecord(1050000)}, {LapRecord(1040000)});
+
+    REQUIRE(matcher.get_matched_count() == 1);
+    REQUIRE(matcher.get_missed_count() == 1);
+    REQUIRE(matcher.get_false_laps().empty());
+}
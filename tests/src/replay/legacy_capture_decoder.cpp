@@ -0,0 +1,113 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "replay/legacy_capture_decoder.h"
+
+static std::vector<uint8_t> encode_legacy(const std::vector<uint16_t>& samples, uint8_t first_sequence = 0) {
+    std::vector<uint8_t> data;
+    uint8_t sequence = first_sequence;
+    for (uint16_t sample : samples) {
+        data.push_back((sequence << 6) | (sample >> 8));
+        data.push_back(sample & 0xFF);
+        sequence = (sequence + 1) & 0x03;
+    }
+    return data;
+}
+
+static std::vector<uint16_t> make_samples(size_t count) {
+    std::vector<uint16_t> samples;
+    for (size_t i = 0; i < count; i++) {
+        samples.push_back((i * 37 + 1000) & 0x3FFF);
+    }
+    return samples;
+}
+
+static std::vector<uint16_t> normalized(const std::vector<uint16_t>& samples) {
+    std::vector<uint16_t> result;
+    for (uint16_t sample : samples) {
+        result.push_back(sample << 2);
+    }
+    return result;
+}
+
+TEST_CASE("legacy capture decoder decodes aligned capture", "[legacy_capture_decoder]") {
+    std::vector<uint16_t> samples = make_samples(100);
+    LegacyCaptureDecoder decoder;
+
+    REQUIRE(decoder.decode(encode_legacy(samples, 2)) == normalized(samples));
+    REQUIRE(decoder.get_lost_samples() == 0);
+    REQUIRE(decoder.get_resyncs() == 0);
+}
+
+TEST_CASE("legacy capture decoder skips partial first sample", "[legacy_capture_decoder]") {
+    std::vector<uint16_t> samples = make_samples(100);
+    std::vector<uint8_t> data = encode_legacy(samples);
+    data.erase(data.begin());
+    LegacyCaptureDecoder decoder;
+
+    std::vector<uint16_t> expected = normalized(samples);
+    expected.erase(expected.begin());
+    REQUIRE(decoder.decode(data) == expected);
+}
+
+TEST_CASE("legacy capture decoder resynchronizes after lost byte", "[legacy_capture_decoder]") {
+    std::vector<uint16_t> samples = make_samples(100);
+    std::vector<uint8_t> data = encode_legacy(samples);
+    // Low byte of sample 40 is lost.
+    data.erase(data.begin() + 81);
+    LegacyCaptureDecoder decoder;
+
+    std::vector<uint16_t> decoded = decoder.decode(data);
+
+    std::vector<uint16_t> expected = normalized(samples);
+    expected[40] = expected[39];
+
+    REQUIRE(decoded == expected);
+    REQUIRE(decoder.get_resyncs() == 1);
+    REQUIRE(decoder.get_lost_samples() == 1);
+}
+
+TEST_CASE("legacy capture decoder fills lost samples", "[legacy_capture_decoder]") {
+    std::vector<uint16_t> samples = make_samples(100);
+    std::vector<uint8_t> data = encode_legacy(samples);
+    // Samples 50 and 51 are lost.
+    data.erase(data.begin() + 100, data.begin() + 104);
+    LegacyCaptureDecoder decoder;
+
+    std::vector<uint16_t> decoded = decoder.decode(data);
+    std::vector<uint16_t> expected = normalized(samples);
+    expected[50] = expected[49];
+    expected[51] = expected[49];
+
+    REQUIRE(decoded == expected);
+    REQUIRE(decoder.get_lost_samples() == 2);
+    REQUIRE(decoder.get_resyncs() == 0);
+}
+
+TEST_CASE("legacy capture decoder ignores garbage", "[legacy_capture_decoder]") {
+    LegacyCaptureDecoder decoder;
+
+    REQUIRE(decoder.decode({}).empty());
+    REQUIRE(decoder.decode(std::vector<uint8_t>(64, 0x00)).empty());
+}
@@ -0,0 +1,132 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "replay/telemetry_capture_decoder.h"
+#include "telemetry/telemetry_frame.h"
+
+static void append_frame(std::vector<uint8_t>& data, uint8_t channel, uint16_t sequence, uint32_t first_sample_tick,
+                         const std::vector<uint16_t>& samples, uint16_t dropped_frames = 0, uint8_t tick_stride = 1) {
+    TelemetryFrame frame(channel, sequence, first_sample_tick, dropped_frames, tick_stride);
+    frame.set_samples(samples.data(), samples.size());
+    uint8_t buffer[TelemetryFrame::MAX_ENCODED_LENGTH];
+    size_t length = frame.encode(buffer, sizeof(buffer));
+    data.insert(data.end(), buffer, buffer + length);
+}
+
+static std::vector<uint16_t> make_samples(uint16_t first, size_t count) {
+    std::vector<uint16_t> samples;
+    for (size_t i = 0; i < count; i++) {
+        samples.push_back(first + i * 11);
+    }
+    return samples;
+}
+
+TEST_CASE("telemetry capture decoder decodes channels", "[telemetry_capture_decoder]") {
+    std::vector<uint8_t> data = {0x12, 0x34, TelemetryFrame::DELIMITER};
+    append_frame(data, 0, 0, 100, make_samples(1000, 32));
+    append_frame(data, 1, 1, 100, make_samples(2000, 32));
+    append_frame(data, 0, 2, 132, make_samples(3000, 32));
+    append_frame(data, 1, 3, 132, make_samples(4000, 32));
+    TelemetryCaptureDecoder decoder;
+
+    std::vector<std::vector<uint16_t>> channels = decoder.decode(data);
+
+    REQUIRE(channels.size() == 2);
+    std::vector<uint16_t> expected = make_samples(1000, 32);
+    std::vector<uint16_t> next = make_samples(3000, 32);
+    expected.insert(expected.end(), next.begin(), next.end());
+    REQUIRE(channels[0] == expected);
+    expected = make_samples(2000, 32);
+    next = make_samples(4000, 32);
+    expected.insert(expected.end(), next.begin(), next.end());
+    REQUIRE(channels[1] == expected);
+    REQUIRE(decoder.get_frames() == 4);
+    REQUIRE(decoder.get_invalid_frames() == 0);
+    REQUIRE(decoder.get_lost_samples() == 0);
+}
+
+TEST_CASE("telemetry capture decoder skips cut first frame", "[telemetry_capture_decoder]") {
+    std::vector<uint8_t> frame;
+    append_frame(frame, 0, 0, 0, make_samples(1000, 16));
+    std::vector<uint8_t> data(frame.begin() + 5, frame.end());
+    append_frame(data, 0, 1, 16, make_samples(2000, 16));
+    TelemetryCaptureDecoder decoder;
+
+    std::vector<std::vector<uint16_t>> channels = decoder.decode(data);
+
+    REQUIRE(channels.size() == 1);
+    REQUIRE(channels[0] == make_samples(2000, 16));
+    REQUIRE(decoder.get_invalid_frames() == 0);
+}
+
+TEST_CASE("telemetry capture decoder fills lost frames", "[telemetry_capture_decoder]") {
+    std::vector<uint8_t> data = {TelemetryFrame::DELIMITER};
+    append_frame(data, 0, 0, 0, make_samples(1000, 16));
+    std::vector<uint8_t> corrupted;
+    append_frame(corrupted, 0, 1, 16, make_samples(2000, 16));
+    corrupted[6] = corrupted[6] == 0x01 ? 0x02 : 0x01;
+    data.insert(data.end(), corrupted.begin(), corrupted.end());
+    append_frame(data, 0, 3, 48, make_samples(3000, 16), 1);
+    TelemetryCaptureDecoder decoder;
+
+    std::vector<std::vector<uint16_t>> channels = decoder.decode(data);
+
+    REQUIRE(channels.size() == 1);
+    REQUIRE(channels[0].size() == 64);
+    REQUIRE(std::all_of(channels[0].begin() + 16, channels[0].begin() + 48,
+                        [](uint16_t sample) { return sample == 1000 + 15 * 11; }));
+    REQUIRE(decoder.get_frames() == 2);
+    REQUIRE(decoder.get_invalid_frames() == 1);
+    REQUIRE(decoder.get_lost_samples() == 32);
+    REQUIRE(decoder.get_dropped_frames() == 1);
+}
+
+TEST_CASE("telemetry capture decoder repeats strided samples", "[telemetry_capture_decoder]") {
+    std::vector<uint8_t> data = {TelemetryFrame::DELIMITER};
+    append_frame(data, 0, 0, 0, { 10, 20 });
+    append_frame(data, 0, 1, 2, { 30, 40 }, 0, 4);
+    append_frame(data, 0, 2, 10, { 50 });
+    TelemetryCaptureDecoder decoder;
+
+    std::vector<std::vector<uint16_t>> channels = decoder.decode(data);
+
+    REQUIRE(channels.size() == 1);
+    REQUIRE(channels[0] == std::vector<uint16_t>{ 10, 20, 30, 30, 30, 30, 40, 40, 40, 40, 50 });
+    REQUIRE(decoder.get_lost_samples() == 0);
+}
+
+TEST_CASE("telemetry capture decoder equalizes channel lengths", "[telemetry_capture_decoder]") {
+    std::vector<uint8_t> data = {TelemetryFrame::DELIMITER};
+    append_frame(data, 0, 0, 0, make_samples(1000, 16));
+    append_frame(data, 1, 1, 0, make_samples(2000, 16));
+    append_frame(data, 0, 2, 16, make_samples(3000, 16));
+    TelemetryCaptureDecoder decoder;
+
+    std::vector<std::vector<uint16_t>> channels = decoder.decode(data);
+
+    REQUIRE(channels.size() == 2);
+    REQUIRE(channels[0].size() == 32);
+    REQUIRE(channels[1].size() == 32);
+    REQUIRE(decoder.get_lost_samples() == 16);
+}
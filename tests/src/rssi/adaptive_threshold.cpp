@@ -0,0 +1,136 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "rssi/adaptive_threshold.h"
+
+static void track(AdaptiveThreshold& threshold, uint16_t sample, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        threshold.track(sample);
+    }
+}
+
+TEST_CASE("Adaptive threshold derives thresholds from the profile", "[adaptive_threshold]") {
+    AdaptiveThreshold threshold;
+    REQUIRE(threshold.get_profile() == RssiProfile(AdaptiveThreshold::DEFAULT_NOISE_FLOOR, AdaptiveThreshold::DEFAULT_PEAK));
+    REQUIRE(threshold.get_enter_threshold() == 36100);
+
+    threshold.set_profile(RssiProfile(10000, 30000));
+    REQUIRE(threshold.get_enter_threshold() == 20000);
+    REQUIRE(threshold.get_exit_threshold() == 17000);
+
+    // Thresholds stay away from the floor when the peak is unknown.
+    threshold.set_profile(RssiProfile(10000, 10000));
+    REQUIRE(threshold.get_enter_threshold() == 10000 + AdaptiveThreshold::MIN_SPAN / 2);
+    REQUIRE(threshold.get_exit_threshold() > 10000);
+}
+
+TEST_CASE("Adaptive threshold places thresholds at configured levels", "[adaptive_threshold]") {
+    AdaptiveThreshold threshold;
+    threshold.set_profile(RssiProfile(10000, 30000));
+    threshold.set_levels(60, 40);
+    REQUIRE(threshold.get_enter_threshold() == 22000);
+    REQUIRE(threshold.get_exit_threshold() == 18000);
+
+    // Exit threshold never exceeds the enter one.
+    threshold.set_levels(30, 50);
+    REQUIRE(threshold.get_enter_threshold() == 16000);
+    REQUIRE(threshold.get_exit_threshold() == 16000);
+}
+
+TEST_CASE("Adaptive threshold converts time to samples", "[adaptive_threshold]") {
+    AdaptiveThreshold threshold;
+    threshold.set_sample_interval_us(400);
+    REQUIRE(threshold.ms_to_samples(80) == 200);
+    REQUIRE(threshold.ms_to_samples(8000) == 20000);
+
+    threshold.set_sample_interval_us(100);
+    REQUIRE(threshold.ms_to_samples(80) == 800);
+}
+
+TEST_CASE("Adaptive threshold tracks noise floor in time, not in samples", "[adaptive_threshold]") {
+    for (uint32_t sample_interval_us : { 100, 400, 1000 }) {
+        AdaptiveThreshold threshold;
+        threshold.set_sample_interval_us(sample_interval_us);
+        threshold.set_profile(RssiProfile(20000, 40000));
+
+        // After one time constant floor covers ~63% of the step.
+        track(threshold, 10000, threshold.ms_to_samples(AdaptiveThreshold::NOISE_FLOOR_TIME_CONSTANT_MS));
+        uint16_t floor = threshold.get_profile().get_noise_floor();
+        REQUIRE(floor > 20000 - 6600);
+        REQUIRE(floor < 20000 - 6000);
+        REQUIRE(threshold.get_profile().get_peak() == 40000);
+
+        track(threshold, 10000, threshold.ms_to_samples(10 * AdaptiveThreshold::NOISE_FLOOR_TIME_CONSTANT_MS));
+        REQUIRE(threshold.get_profile().get_noise_floor() <= 10010);
+    }
+}
+
+TEST_CASE("Adaptive threshold ignores samples above exit threshold", "[adaptive_threshold]") {
+    AdaptiveThreshold threshold;
+    threshold.set_sample_interval_us(400);
+    threshold.set_profile(RssiProfile(20000, 40000));
+
+    track(threshold, threshold.get_exit_threshold(), 10000);
+    REQUIRE(threshold.get_profile() == RssiProfile(20000, 40000));
+}
+
+TEST_CASE("Adaptive threshold follows pass peaks", "[adaptive_threshold]") {
+    AdaptiveThreshold threshold;
+    threshold.set_profile(RssiProfile(20000, 40000));
+
+    threshold.add_pass_peak(48000);
+    REQUIRE(threshold.get_profile().get_peak() == 42000);
+    threshold.add_pass_peak(34000);
+    REQUIRE(threshold.get_profile().get_peak() == 40000);
+}
+
+TEST_CASE("Adaptive threshold calibrates profile", "[adaptive_threshold]") {
+    AdaptiveThreshold threshold;
+    threshold.set_sample_interval_us(400);
+    threshold.start_calibration(1000);
+    REQUIRE(threshold.is_calibrating());
+
+    track(threshold, 15000, 1000);
+    track(threshold, 30000, 100);
+    REQUIRE(!threshold.track(15000));
+    track(threshold, 15000, 1398);
+    REQUIRE(threshold.is_calibrating());
+    REQUIRE(threshold.track(15000));
+    REQUIRE(!threshold.is_calibrating());
+    REQUIRE(threshold.is_calibration_successful());
+    REQUIRE(threshold.get_profile() == RssiProfile(15000, 30000));
+    REQUIRE(threshold.get_enter_threshold() == 22500);
+}
+
+TEST_CASE("Adaptive threshold keeps profile if calibration fails", "[adaptive_threshold]") {
+    AdaptiveThreshold threshold;
+    threshold.set_sample_interval_us(400);
+    threshold.set_profile(RssiProfile(20000, 40000));
+    threshold.start_calibration(100);
+
+    track(threshold, 15000, 249);
+    REQUIRE(threshold.track(15000 + AdaptiveThreshold::MIN_SPAN - 1));
+    REQUIRE(!threshold.is_calibration_successful());
+    REQUIRE(threshold.get_profile() == RssiProfile(20000, 40000));
+}
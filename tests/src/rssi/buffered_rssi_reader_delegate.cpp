@@ -0,0 +1,115 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "events/mock_event_dispatcher.h"
+#include "rssi/buffered_rssi_reader_delegate.h"
+#include "rssi/mock_rssi_reader.h"
+
+#include <vector>
+
+class RecordingRssiReaderDelegate : public RssiReaderInterface::Delegate {
+public:
+    RecordingRssiReaderDelegate() : reader(nullptr) {}
+
+    void on_initialized(RssiReaderInterface& rssi_reader) override {
+        reader = &rssi_reader;
+    }
+
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override {
+        channels.push_back(channel);
+        ticks.push_back(first_sample_tick);
+        this->samples.insert(this->samples.end(), samples, samples + count);
+    }
+
+    RssiReaderInterface* reader;
+    std::vector<uint8_t> channels;
+    std::vector<uint32_t> ticks;
+    std::vector<uint16_t> samples;
+};
+
+static std::vector<uint16_t> make_samples(size_t count) {
+    std::vector<uint16_t> samples;
+    for (size_t i = 0; i < count; i++) {
+        samples.push_back(static_cast<uint16_t>(i));
+    }
+    return samples;
+}
+
+TEST_CASE("Buffered delegate passes samples from the event loop", "[buffered_rssi_reader_delegate]") {
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 8, 2);
+    RecordingRssiReaderDelegate recording_delegate;
+    BufferedRssiReaderDelegate delegate(dispatcher, recording_delegate);
+    reader.initialize(delegate);
+    REQUIRE(recording_delegate.reader == &reader);
+
+    reader.capture_channels({ make_samples(16), make_samples(16) });
+    REQUIRE(recording_delegate.samples.empty());
+
+    // Single event for all queued blocks.
+    REQUIRE(dispatcher.process_next_event() == Event(RssiSamplesAvailable()));
+    REQUIRE_FALSE(dispatcher.process_next_event());
+    REQUIRE(recording_delegate.channels == std::vector<uint8_t>{ 0, 1, 0, 1 });
+    REQUIRE(recording_delegate.ticks == std::vector<uint32_t>{ 0, 0, 8, 8 });
+    REQUIRE(recording_delegate.samples.size() == 32);
+    REQUIRE(delegate.get_high_water_mark() == 4);
+
+    reader.capture_channels({ make_samples(8), make_samples(8) });
+    REQUIRE(dispatcher.process_next_event() == Event(RssiSamplesAvailable()));
+    REQUIRE(recording_delegate.ticks.size() == 6);
+}
+
+TEST_CASE("Buffered delegate splits long blocks", "[buffered_rssi_reader_delegate]") {
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 100);
+    RecordingRssiReaderDelegate recording_delegate;
+    BufferedRssiReaderDelegate delegate(dispatcher, recording_delegate);
+    reader.initialize(delegate);
+
+    reader.capture(make_samples(100));
+    REQUIRE(delegate.process_queued_blocks() == 4);
+    REQUIRE(recording_delegate.ticks == std::vector<uint32_t>{ 0, 32, 64, 96 });
+    REQUIRE(recording_delegate.samples == make_samples(100));
+}
+
+TEST_CASE("Buffered delegate drops blocks when event loop doesn't keep up", "[buffered_rssi_reader_delegate]") {
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, BufferedRssiReaderDelegate::MAX_BLOCK_LENGTH);
+    RecordingRssiReaderDelegate recording_delegate;
+    BufferedRssiReaderDelegate delegate(dispatcher, recording_delegate);
+    reader.initialize(delegate);
+
+    size_t blocks_count = BufferedRssiReaderDelegate::BLOCKS_COUNT;
+    reader.capture(make_samples((blocks_count + 2) * BufferedRssiReaderDelegate::MAX_BLOCK_LENGTH));
+    REQUIRE(delegate.get_overflows() == 2);
+    REQUIRE(delegate.get_high_water_mark() == blocks_count);
+
+    REQUIRE(dispatcher.process_next_event() == Event(RssiSamplesAvailable()));
+    REQUIRE(recording_delegate.ticks.size() == blocks_count);
+
+    // Processing continues after the overflow.
+    reader.capture(make_samples(BufferedRssiReaderDelegate::MAX_BLOCK_LENGTH));
+    REQUIRE(dispatcher.process_next_event() == Event(RssiSamplesAvailable()));
+    REQUIRE(recording_delegate.ticks.back() == (blocks_count + 2) * BufferedRssiReaderDelegate::MAX_BLOCK_LENGTH);
+}
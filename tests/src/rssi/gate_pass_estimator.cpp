@@ -0,0 +1,97 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "rssi/gate_pass_estimator.h"
+
+#include <vector>
+
+static constexpr uint64_t ONE_TICK = 1 << GatePassEstimator::TICK_FRACTION_BITS;
+
+static uint64_t estimate(GatePassEstimator::Method method, uint16_t threshold, uint32_t first_tick, const std::vector<uint16_t>& samples) {
+    GatePassEstimator estimator(method);
+    estimator.reset(threshold);
+    REQUIRE(estimator.is_empty());
+    for (size_t i = 0; i < samples.size(); i++) {
+        estimator.add_sample(samples[i], first_tick + i);
+    }
+    REQUIRE(!estimator.is_empty());
+    return estimator.get_pass_tick();
+}
+
+TEST_CASE("Gate pass estimator finds centroid of symmetric excursion", "[gate_pass_estimator]") {
+    std::vector<uint16_t> samples = { 110, 120, 130, 140, 130, 120, 110 };
+    REQUIRE(estimate(GatePassEstimator::GATE_PASS_METHOD_CENTROID, 100, 1000, samples) == 1003 * ONE_TICK);
+}
+
+TEST_CASE("Gate pass estimator finds centroid between samples", "[gate_pass_estimator]") {
+    std::vector<uint16_t> samples = { 110, 130, 130, 110 };
+    REQUIRE(estimate(GatePassEstimator::GATE_PASS_METHOD_CENTROID, 100, 10, samples) == 11 * ONE_TICK + ONE_TICK / 2);
+}
+
+TEST_CASE("Gate pass estimator centroid follows the energy", "[gate_pass_estimator]") {
+    // Weights 10 and 30 give centroid at 3/4 of the distance.
+    std::vector<uint16_t> samples = { 110, 100, 100, 100, 130 };
+    REQUIRE(estimate(GatePassEstimator::GATE_PASS_METHOD_CENTROID, 100, 0, samples) == 3 * ONE_TICK);
+}
+
+TEST_CASE("Gate pass estimator centroid weights samples by their span", "[gate_pass_estimator]") {
+    // Constant excursion over ticks 0 to 15, first two samples span 4 ticks each.
+    GatePassEstimator estimator(GatePassEstimator::GATE_PASS_METHOD_CENTROID);
+    estimator.reset(100);
+    estimator.add_sample(110, 0, 4);
+    estimator.add_sample(110, 4, 4);
+    for (uint32_t tick = 8; tick < 16; tick++) {
+        estimator.add_sample(110, tick);
+    }
+    REQUIRE(estimator.get_pass_tick() == 7 * ONE_TICK + ONE_TICK / 2);
+}
+
+TEST_CASE("Gate pass estimator finds symmetric peak", "[gate_pass_estimator]") {
+    std::vector<uint16_t> samples = { 110, 120, 130, 140, 130, 120, 110 };
+    REQUIRE(estimate(GatePassEstimator::GATE_PASS_METHOD_PEAK, 100, 1000, samples) == 1003 * ONE_TICK);
+}
+
+TEST_CASE("Gate pass estimator interpolates asymmetric peak", "[gate_pass_estimator]") {
+    // Parabola through (-1, 120), (0, 140), (1, 130) has a vertex at 1/6.
+    std::vector<uint16_t> samples = { 110, 120, 140, 130, 110 };
+    REQUIRE(estimate(GatePassEstimator::GATE_PASS_METHOD_PEAK, 100, 0, samples) == 2 * ONE_TICK + ONE_TICK / 6);
+}
+
+TEST_CASE("Gate pass estimator finds middle of a plateau", "[gate_pass_estimator]") {
+    std::vector<uint16_t> samples = { 110, 140, 140, 140, 140, 120 };
+    REQUIRE(estimate(GatePassEstimator::GATE_PASS_METHOD_PEAK, 100, 0, samples) == 2 * ONE_TICK + ONE_TICK / 2);
+}
+
+TEST_CASE("Gate pass estimator remembers peak value", "[gate_pass_estimator]") {
+    GatePassEstimator estimator;
+    estimator.reset(100);
+    estimator.add_sample(120, 0);
+    estimator.add_sample(150, 1);
+    estimator.add_sample(130, 2);
+    REQUIRE(estimator.get_peak_value() == 150);
+
+    estimator.reset(100);
+    REQUIRE(estimator.is_empty());
+    REQUIRE(estimator.get_peak_value() == 0);
+}
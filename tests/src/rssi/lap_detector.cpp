@@ -0,0 +1,186 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "rssi/lap_detector.h"
+
+#include <vector>
+
+static std::vector<uint64_t> detect_laps(LapDetector& detector, uint16_t sample, uint32_t count, uint32_t& tick) {
+    std::vector<uint64_t> laps;
+    for (uint32_t i = 0; i < count; i++) {
+        if (detector.process_sample(sample, tick++) == LapDetector::LAP_DETECTOR_RESULT_LAP) {
+            laps.push_back(detector.get_lap_tick());
+        }
+    }
+    return laps;
+}
+
+TEST_CASE("Lap detector timing doesn't depend on sampling rate", "[lap_detector]") {
+    for (uint32_t sample_interval_us : { 100, 250, 1000 }) {
+        LapDetector detector;
+        detector.set_sample_interval_us(sample_interval_us);
+        uint32_t samples_per_ms = 1000 / sample_interval_us;
+        uint32_t tick = 0;
+
+        // Pass shorter than PASS_MIN_TIME_MS is ignored.
+        REQUIRE(detect_laps(detector, 20000, 100 * samples_per_ms, tick).empty());
+        REQUIRE(detect_laps(detector, 50000, 70 * samples_per_ms, tick).empty());
+        REQUIRE(detect_laps(detector, 20000, 100 * samples_per_ms, tick).empty());
+
+        REQUIRE(detect_laps(detector, 50000, 200 * samples_per_ms, tick).empty());
+        REQUIRE(detect_laps(detector, 20000, 100 * samples_per_ms, tick).size() == 1);
+
+        // Next lap is possible only after REARM_TIME_MS.
+        REQUIRE(detect_laps(detector, 20000, 7000 * samples_per_ms, tick).empty());
+        REQUIRE(detect_laps(detector, 50000, 200 * samples_per_ms, tick).empty());
+        REQUIRE(detect_laps(detector, 20000, 9000 * samples_per_ms, tick).empty());
+        REQUIRE(detect_laps(detector, 50000, 200 * samples_per_ms, tick).empty());
+        REQUIRE(detect_laps(detector, 20000, 100 * samples_per_ms, tick).size() == 1);
+    }
+}
+
+TEST_CASE("Lap detector uses configured pass times", "[lap_detector]") {
+    LapDetector::Parameters parameters;
+    parameters.pass_min_time_ms = 40;
+    parameters.rearm_time_ms = 1000;
+
+    for (bool before_interval : { true, false }) {
+        LapDetector detector;
+        if (before_interval) {
+            detector.set_parameters(parameters);
+        }
+        detector.set_sample_interval_us(1000);
+        if (!before_interval) {
+            detector.set_parameters(parameters);
+        }
+        REQUIRE(detector.get_parameters().rearm_time_ms == 1000);
+        uint32_t tick = 0;
+
+        REQUIRE(detect_laps(detector, 20000, 100, tick).empty());
+        REQUIRE(detect_laps(detector, 50000, 50, tick).empty());
+        REQUIRE(detect_laps(detector, 20000, 100, tick).size() == 1);
+
+        REQUIRE(detect_laps(detector, 20000, 500, tick).empty());
+        REQUIRE(detect_laps(detector, 50000, 200, tick).empty());
+        REQUIRE(detect_laps(detector, 20000, 1500, tick).empty());
+        REQUIRE(detect_laps(detector, 50000, 200, tick).empty());
+        REQUIRE(detect_laps(detector, 20000, 100, tick).size() == 1);
+    }
+}
+
+TEST_CASE("Lap detector closes too long passes", "[lap_detector]") {
+    LapDetector detector;
+    detector.set_sample_interval_us(400);
+    uint32_t tick = 0;
+
+    std::vector<uint64_t> laps = detect_laps(detector, 50000, 10000, tick);
+    REQUIRE(laps.size() == 1);
+    REQUIRE(tick == 10000);
+}
+
+TEST_CASE("Lap detector ignores passes during lockout", "[lap_detector]") {
+    LapDetector detector;
+    detector.set_sample_interval_us(1000);
+    detector.set_lockout_ticks(5000);
+    uint32_t tick = 0;
+
+    REQUIRE(detect_laps(detector, 20000, 100, tick).empty());
+    REQUIRE(detect_laps(detector, 50000, 200, tick).empty());
+    REQUIRE(detect_laps(detector, 20000, 100, tick).size() == 1);
+    REQUIRE(detector.is_locked_out());
+    // Pass centroid is at tick 199.5.
+    REQUIRE(detector.get_lockout_end_tick() == 5199);
+
+    // Double trigger.
+    REQUIRE(detect_laps(detector, 50000, 200, tick).empty());
+    REQUIRE(detect_laps(detector, 20000, 100, tick).empty());
+
+    // Samples till the end of the lockout are skipped, short time below the threshold rearms.
+    tick = detector.get_lockout_end_tick();
+    REQUIRE(detect_laps(detector, 20000, LapDetector::LOCKOUT_REARM_TIME_MS + 1, tick).empty());
+    REQUIRE_FALSE(detector.is_locked_out());
+    REQUIRE(detect_laps(detector, 50000, 200, tick).empty());
+    REQUIRE(detect_laps(detector, 20000, 100, tick).size() == 1);
+}
+
+TEST_CASE("Lap detector waits for the drone to leave after lockout", "[lap_detector]") {
+    LapDetector detector;
+    detector.set_sample_interval_us(1000);
+    detector.set_lockout_ticks(1000);
+    uint32_t tick = 0;
+
+    REQUIRE(detect_laps(detector, 50000, 200, tick).empty());
+    REQUIRE(detect_laps(detector, 20000, 100, tick).size() == 1);
+
+    // Drone hovers in the gate after the lockout.
+    REQUIRE(detect_laps(detector, 50000, 3000, tick).empty());
+    REQUIRE(detector.is_locked_out());
+    REQUIRE(detect_laps(detector, 20000, LapDetector::LOCKOUT_REARM_TIME_MS + 1, tick).empty());
+    REQUIRE_FALSE(detector.is_locked_out());
+}
+
+TEST_CASE("Lap detector keeps pass duration when sample interval changes", "[lap_detector]") {
+    for (uint32_t last_samples : { 5, 10 }) {
+        LapDetector detector;
+        detector.set_sample_interval_us(1000);
+        uint32_t tick = 0;
+
+        REQUIRE(detect_laps(detector, 20000, 100, tick).empty());
+        REQUIRE(detect_laps(detector, 50000, 50, tick).empty());
+        detector.set_sample_interval_us(4000);
+        REQUIRE(detect_laps(detector, 50000, last_samples, tick).empty());
+
+        // 50ms + 20ms is shorter than PASS_MIN_TIME_MS, 50ms + 40ms is not.
+        std::vector<uint64_t> laps = detect_laps(detector, 20000, 10, tick);
+        REQUIRE(laps.size() == (last_samples * 4 + 50 > LapDetector::PASS_MIN_TIME_MS ? 1 : 0));
+    }
+}
+
+TEST_CASE("Lap detector describes the pass which finished the lap", "[lap_detector]") {
+    LapDetector detector;
+    detector.set_sample_interval_us(1000);
+    uint32_t tick = 0;
+
+    REQUIRE(detect_laps(detector, 20000, 100, tick).empty());
+    REQUIRE(detect_laps(detector, 50000, LapDetector::CONFIDENT_PASS_TIME_MS, tick).empty());
+    REQUIRE(detect_laps(detector, 20000, 100, tick).size() == 1);
+    PassSignature confident = detector.get_pass_signature(1000);
+    REQUIRE(confident.get_peak() == 50000);
+    REQUIRE(confident.get_duration_ms() == LapDetector::CONFIDENT_PASS_TIME_MS);
+    REQUIRE(confident.get_rise_slope() > 0);
+    REQUIRE(confident.get_confidence() > 0);
+
+    // Shorter pass is less likely to be a real one.
+    REQUIRE(detect_laps(detector, 20000, 20000, tick).empty());
+    REQUIRE(detect_laps(detector, 50000, LapDetector::PASS_MIN_TIME_MS + 1, tick).empty());
+    REQUIRE(detect_laps(detector, 20000, 100, tick).size() == 1);
+    PassSignature short_pass = detector.get_pass_signature(1000);
+    REQUIRE(short_pass.get_duration_ms() == LapDetector::PASS_MIN_TIME_MS + 1);
+    REQUIRE(short_pass.get_confidence() < confident.get_confidence());
+
+    // Drone staying at the gate isn't a clean pass either.
+    REQUIRE(detect_laps(detector, 20000, 20000, tick).empty());
+    REQUIRE(detect_laps(detector, 50000, LapDetector::PASS_MAX_TIME_MS + 100, tick).size() == 1);
+    REQUIRE(detector.get_pass_signature(1000).get_confidence() < confident.get_confidence());
+}
@@ -0,0 +1,183 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "rssi/matched_filter_rssi_reader_delegate.h"
+#include "rssi/generated_laps.h"
+#include "rssi/mock_rssi_reader.h"
+#include "rssi/rssi_signal_generator.h"
+#include "events/mock_event_dispatcher.h"
+#include "storage/calibration_storage.h"
+#include "storage/mock_flash_storage.h"
+#include "time/mock_real_time_clock.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+static constexpr int64_t LAP_TOLERANCE_US = 20000;
+
+TEST_CASE("Matched filter delegate detects generated passes", "[matched_filter_rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    MatchedFilterRssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    RssiSignalGenerator generator(400);
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 3000;
+    drone.lap_time_ms = 6000;
+    drone.lap_time_jitter_ms = 1000;
+    generator.add_drone(drone);
+
+    std::vector<NewLap> laps = get_laps(replay_generated(reader, dispatcher, generator, 60000));
+    REQUIRE(laps.size() >= 9);
+    require_laps_match_passes(laps, generator, LAP_TOLERANCE_US);
+}
+TEST_CASE("Matched filter delegate keeps detecting when the noise floor rises", "[matched_filter_rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    MatchedFilterRssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    RssiSignalGenerator generator(400);
+    // Floor of the receiver at ~36000, above the default enter threshold, with strong noise.
+    RssiSignalGenerator::EnvironmentParameters environment;
+    environment.adc_floor = 9000;
+    environment.noise_db = 3.0f;
+    generator.set_environment(environment);
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 3000;
+    drone.lap_time_ms = 6000;
+    drone.closest_distance_m = 4.0f;
+    drone.power_at_1m_dbm = -50.0f;
+    generator.add_drone(drone);
+
+    std::vector<NewLap> laps = get_laps(replay_generated(reader, dispatcher, generator, 60000));
+    REQUIRE(laps.size() == 10);
+    require_laps_match_passes(laps, generator, LAP_TOLERANCE_US);
+}
+
+TEST_CASE("Matched filter delegate ignores passes during lockout", "[matched_filter_rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    MatchedFilterRssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+    dispatcher.emit_event(SetLapLockout(5000));
+
+    RssiSignalGenerator generator(400);
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 3000;
+    drone.lap_time_ms = 3000;
+    generator.add_drone(drone);
+
+    std::vector<NewLap> laps = get_laps(replay_generated(reader, dispatcher, generator, 20000));
+    const std::vector<uint64_t>& passes = generator.get_pass_timestamps_us(0);
+    REQUIRE(passes.size() == 6);
+    REQUIRE(laps.size() == 3);
+    for (size_t i = 0; i < laps.size(); i++) {
+        REQUIRE(std::llabs(static_cast<int64_t>(laps[i].get_timestamp_us() - passes[2 * i])) <= LAP_TOLERANCE_US);
+    }
+}
+
+TEST_CASE("Matched filter delegate learns the pass template during calibration", "[matched_filter_rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockFlashStorage flash_storage(10);
+    CalibrationStorage calibration_storage(dispatcher, flash_storage);
+    MockRssiReader reader(400, 32);
+    MatchedFilterRssiReaderDelegate delegate(clock, dispatcher);
+    delegate.set_calibration_storage(&calibration_storage);
+    reader.initialize(delegate);
+    dispatcher.emit_event(StartRssiCalibration(5000));
+
+    RssiSignalGenerator generator(400);
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 3000;
+    drone.lap_time_ms = 6000;
+    generator.add_drone(drone);
+
+    std::vector<Event> events = replay_generated(reader, dispatcher, generator, 30000);
+    auto calibration = std::find_if(events.begin(), events.end(), [](const Event& event) {
+        return std::holds_alternative<RssiCalibrationFinished>(event);
+    });
+    REQUIRE(calibration != events.end());
+    const RssiCalibrationFinished& finished = std::get<RssiCalibrationFinished>(*calibration);
+    REQUIRE(finished.is_successful());
+    REQUIRE(finished.get_profile().get_peak() > finished.get_profile().get_noise_floor() + 4000);
+
+    // Learned template is saved with the profile.
+    PassTemplate learned;
+    REQUIRE(calibration_storage.load_pass_template(0, learned));
+    REQUIRE_FALSE(learned == PassTemplate());
+    REQUIRE(flash_storage.get_total_records() == 2);
+
+    // Pass used for learning isn't a lap.
+    std::vector<NewLap> laps = get_laps(events);
+    const std::vector<uint64_t>& passes = generator.get_pass_timestamps_us(0);
+    REQUIRE(laps.size() == passes.size() - 1);
+    REQUIRE(std::llabs(static_cast<int64_t>(laps[0].get_timestamp_us() - passes[1])) <= LAP_TOLERANCE_US);
+}
+
+TEST_CASE("Matched filter delegate detects passes with a restored template", "[matched_filter_rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockFlashStorage flash_storage(10);
+    CalibrationStorage calibration_storage(dispatcher, flash_storage);
+    MockRssiReader reader(400, 32);
+    MatchedFilterRssiReaderDelegate delegate(clock, dispatcher);
+    delegate.set_calibration_storage(&calibration_storage);
+    reader.initialize(delegate);
+    dispatcher.emit_event(StartRssiCalibration(5000));
+
+    RssiSignalGenerator generator(400);
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 3000;
+    drone.lap_time_ms = 6000;
+    generator.add_drone(drone);
+
+    std::vector<Event> events = replay_generated(reader, dispatcher, generator, 6000);
+    REQUIRE(std::any_of(events.begin(), events.end(), [](const Event& event) {
+        return std::holds_alternative<RssiCalibrationFinished>(event);
+    }));
+
+    // After reboot the template is loaded instead of learned again.
+    MockEventDispatcher restored_dispatcher;
+    CalibrationStorage restored_calibration_storage(restored_dispatcher, flash_storage);
+    MockRssiReader restored_reader(400, 32);
+    MatchedFilterRssiReaderDelegate restored_delegate(clock, restored_dispatcher);
+    restored_delegate.set_calibration_storage(&restored_calibration_storage);
+    restored_reader.initialize(restored_delegate);
+    restored_dispatcher.emit_event(SessionStorageInitialized());
+
+    RssiSignalGenerator restored_generator(400);
+    restored_generator.add_drone(drone);
+    std::vector<NewLap> laps = get_laps(replay_generated(restored_reader, restored_dispatcher, restored_generator, 30000));
+    require_laps_match_passes(laps, restored_generator, LAP_TOLERANCE_US);
+    // Default template correlates below 90 % with these passes.
+    for (const NewLap& lap : laps) {
+        REQUIRE(lap.get_pass_signature().get_confidence() >= 95);
+    }
+}
@@ -0,0 +1,136 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "rssi/mock_rssi_reader.h"
+
+class MockRssiReaderDelegate : public RssiReaderInterface::Delegate {
+public:
+    MockRssiReaderDelegate() : reader(nullptr), captured_ticks() {}
+
+    void on_initialized(RssiReaderInterface& rssi_reader) override {
+        reader = &rssi_reader;
+    }
+
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override {
+        size_t skipped_samples = static_cast<MockRssiReader*>(reader)->get_skipped_samples();
+        REQUIRE(first_sample_tick == captured_ticks[channel] + skipped_samples);
+        captured_ticks[channel] += count * tick_stride;
+        channels_samples[channel].insert(channels_samples[channel].end(), samples, samples + count);
+        if (channel == 0) {
+            block_lengths.push_back(count);
+            tick_strides.push_back(tick_stride);
+        }
+    }
+
+    RssiReaderInterface* reader;
+    std::vector<uint16_t> channels_samples[RssiReaderInterface::MAX_CHANNELS_COUNT];
+    std::vector<size_t> block_lengths;
+    std::vector<uint8_t> tick_strides;
+    size_t captured_ticks[RssiReaderInterface::MAX_CHANNELS_COUNT];
+};
+
+TEST_CASE("Mock rssi reader splits samples into blocks", "[rssi_reader]") {
+    MockRssiReader reader(400, 4);
+    MockRssiReaderDelegate delegate;
+    reader.initialize(delegate);
+    REQUIRE(delegate.reader == &reader);
+    REQUIRE(reader.get_sample_interval_us() == 400);
+
+    reader.capture({ 1, 2, 3, 4, 5, 6 });
+    reader.capture({ 7, 8, 9 });
+    REQUIRE(delegate.channels_samples[0] == std::vector<uint16_t>{ 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    REQUIRE(delegate.block_lengths == std::vector<size_t>{ 4, 2, 3 });
+    REQUIRE(reader.get_next_tick() == 9);
+}
+
+TEST_CASE("Mock rssi reader passes all channels with the same ticks", "[rssi_reader]") {
+    MockRssiReader reader(400, 2, 3);
+    MockRssiReaderDelegate delegate;
+    reader.initialize(delegate);
+    REQUIRE(reader.get_channels_count() == 3);
+
+    reader.capture_channels({ { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } });
+    REQUIRE(delegate.channels_samples[0] == std::vector<uint16_t>{ 1, 2, 3 });
+    REQUIRE(delegate.channels_samples[1] == std::vector<uint16_t>{ 4, 5, 6 });
+    REQUIRE(delegate.channels_samples[2] == std::vector<uint16_t>{ 7, 8, 9 });
+    REQUIRE(delegate.block_lengths == std::vector<size_t>{ 2, 1 });
+    REQUIRE(reader.get_next_tick() == 3);
+}
+
+TEST_CASE("Mock rssi reader skips samples while suspended", "[rssi_reader]") {
+    MockRssiReader reader(400, 4);
+    MockRssiReaderDelegate delegate;
+    reader.initialize(delegate);
+
+    reader.capture({ 1, 2, 3, 4 });
+    reader.suspend_sampling(6);
+    reader.capture({ 5, 6, 7, 8, 9, 10 });
+
+    REQUIRE(delegate.channels_samples[0] == std::vector<uint16_t>{ 1, 2, 3, 4, 7, 8, 9, 10 });
+    REQUIRE(delegate.block_lengths == std::vector<size_t>{ 4, 4 });
+    REQUIRE(reader.get_skipped_samples() == 2);
+    REQUIRE(reader.get_next_tick() == 10);
+
+    // Past ticks are ignored.
+    reader.suspend_sampling(10);
+    reader.capture({ 11 });
+    REQUIRE(reader.get_skipped_samples() == 2);
+}
+
+TEST_CASE("Mock rssi reader skips samples until wake-up", "[rssi_reader]") {
+    MockRssiReader reader(400, 4, 2);
+    MockRssiReaderDelegate delegate;
+    reader.initialize(delegate);
+
+    std::array<uint16_t, RssiReaderInterface::MAX_CHANNELS_COUNT> levels;
+    levels.fill(UINT16_MAX);
+    levels[1] = 10;
+    reader.arm_wakeup(levels);
+    REQUIRE(reader.is_wakeup_armed());
+    reader.capture_channels({ { 1, 2, 3 }, { 10, 10, 10 } });
+    reader.capture_channels({ { 4, 5, 6, 7, 8, 9 }, { 10, 11, 10, 10, 10, 10 } });
+
+    REQUIRE_FALSE(reader.is_wakeup_armed());
+    REQUIRE(delegate.channels_samples[0] == std::vector<uint16_t>{ 5, 6, 7, 8, 9 });
+    REQUIRE(delegate.block_lengths == std::vector<size_t>{ 4, 1 });
+    REQUIRE(reader.get_skipped_samples() == 4);
+    REQUIRE(reader.get_next_tick() == 9);
+}
+
+TEST_CASE("Mock rssi reader changes stride at block boundary", "[rssi_reader]") {
+    MockRssiReader reader(400, 4);
+    MockRssiReaderDelegate delegate;
+    reader.initialize(delegate);
+
+    reader.set_sample_stride(2);
+    reader.capture({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    reader.capture({ 10, 11, 12 });
+    // Last sample covers tick 13 too.
+    reader.set_sample_stride(1);
+    reader.capture({ 13, 14 });
+
+    REQUIRE(delegate.channels_samples[0] == std::vector<uint16_t>{ 0, 2, 4, 6, 8, 10, 12, 14 });
+    REQUIRE(delegate.block_lengths == std::vector<size_t>{ 4, 1, 2, 1 });
+    REQUIRE(delegate.tick_strides == std::vector<uint8_t>{ 2, 2, 2, 1 });
+    REQUIRE(reader.get_next_tick() == 15);
+}
@@ -0,0 +1,148 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "rssi/pass_correlator.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+static constexpr uint32_t SAMPLE_INTERVAL_US = 400;
+
+static std::vector<uint64_t> correlate(PassCorrelator& correlator, const std::vector<uint16_t>& samples, uint32_t first_tick = 0) {
+    std::vector<uint64_t> laps;
+    for (uint32_t i = 0; i < samples.size(); i++) {
+        if (correlator.process_sample(samples[i], first_tick + i) == PassCorrelator::PASS_CORRELATOR_RESULT_LAP) {
+            laps.push_back(correlator.get_lap_tick());
+        }
+    }
+    return laps;
+}
+
+// Gaussian bump of the given height on a floor, centered at the given time.
+static std::vector<uint16_t> make_pass(float center_ms, float height, float width_ms, uint32_t length_ms) {
+    std::vector<uint16_t> samples(length_ms * 1000 / SAMPLE_INTERVAL_US);
+    for (uint32_t tick = 0; tick < samples.size(); tick++) {
+        float time = tick * SAMPLE_INTERVAL_US / 1000.0f - center_ms;
+        samples[tick] = static_cast<uint16_t>(20000 + height * std::exp(-time * time / (2 * width_ms * width_ms)));
+    }
+    return samples;
+}
+
+TEST_CASE("Pass correlator times the pass between bins", "[pass_correlator]") {
+    for (float center_ms : { 1000.0f, 1003.2f, 1005.0f, 1006.8f }) {
+        PassCorrelator correlator;
+        correlator.set_sample_interval_us(SAMPLE_INTERVAL_US);
+
+        std::vector<uint64_t> laps = correlate(correlator, make_pass(center_ms, 20000, 50, 2000));
+        REQUIRE(laps.size() == 1);
+        float lap_ms = static_cast<float>(laps[0]) / (1 << GatePassEstimator::TICK_FRACTION_BITS) * SAMPLE_INTERVAL_US / 1000;
+        REQUIRE(lap_ms == Approx(center_ms).margin(1.0f));
+        REQUIRE(correlator.get_pass_signature().get_confidence() >= 80);
+        REQUIRE(correlator.get_pass_signature().get_peak() > 39000);
+    }
+}
+
+TEST_CASE("Pass correlator ignores noise and level changes", "[pass_correlator]") {
+    PassCorrelator correlator;
+    correlator.set_sample_interval_us(SAMPLE_INTERVAL_US);
+
+    std::mt19937 generator(1);
+    std::normal_distribution<float> noise(30000, 2000);
+    std::vector<uint16_t> samples(10000 * 1000 / SAMPLE_INTERVAL_US);
+    for (size_t i = 0; i < samples.size(); i++) {
+        // Floor steps up in the middle.
+        samples[i] = static_cast<uint16_t>(noise(generator) + (i < samples.size() / 2 ? 0 : 10000));
+    }
+    REQUIRE(correlate(correlator, samples).empty());
+
+    // Shape of a pass, too low to be one.
+    REQUIRE(correlate(correlator, make_pass(1000, 1000, 50, 2000)).empty());
+}
+
+TEST_CASE("Pass correlator reports one lap per pass and respects lockout", "[pass_correlator]") {
+    std::vector<uint16_t> samples;
+    for (uint32_t i = 0; i < 4; i++) {
+        std::vector<uint16_t> pass = make_pass(1000, 20000, 50, 2000);
+        samples.insert(samples.end(), pass.begin(), pass.end());
+    }
+
+    PassCorrelator correlator;
+    correlator.set_sample_interval_us(SAMPLE_INTERVAL_US);
+    REQUIRE(correlate(correlator, samples).size() == 4);
+
+    PassCorrelator locked_correlator;
+    locked_correlator.set_sample_interval_us(SAMPLE_INTERVAL_US);
+    locked_correlator.set_lockout_ticks(3000 * 1000 / SAMPLE_INTERVAL_US);
+    REQUIRE(correlate(locked_correlator, samples).size() == 2);
+}
+
+TEST_CASE("Pass correlator learns the template from the first pass", "[pass_correlator]") {
+    PassCorrelator correlator;
+    correlator.set_sample_interval_us(SAMPLE_INTERVAL_US);
+    correlator.start_learning(3000);
+
+    std::vector<uint16_t> samples = make_pass(1000, 20000, 80, 3000);
+    bool finished = false;
+    for (uint32_t tick = 0; tick < samples.size() + 10; tick++) {
+        PassCorrelator::Result result = correlator.process_sample(samples[std::min<size_t>(tick, samples.size() - 1)], tick);
+        REQUIRE(result != PassCorrelator::PASS_CORRELATOR_RESULT_LAP);
+        finished |= result == PassCorrelator::PASS_CORRELATOR_RESULT_LEARNING_FINISHED;
+    }
+    REQUIRE(finished);
+    REQUIRE(correlator.is_learning_successful());
+    REQUIRE(correlator.get_profile().get_noise_floor() >= 20000);
+    REQUIRE(correlator.get_profile().get_peak() > 39000);
+
+    // Template has the shape of the learned pass, it matches the next one almost perfectly.
+    std::vector<uint64_t> laps = correlate(correlator, make_pass(1000, 10000, 80, 2000), samples.size() + 10);
+    REQUIRE(laps.size() == 1);
+    REQUIRE(correlator.get_pass_signature().get_confidence() >= 98);
+}
+
+TEST_CASE("Pass correlator restores stored template", "[pass_correlator]") {
+    PassCorrelator learner;
+    learner.set_sample_interval_us(SAMPLE_INTERVAL_US);
+    learner.start_learning(3000);
+    std::vector<uint16_t> samples = make_pass(1000, 20000, 80, 3000);
+    for (uint32_t tick = 0; tick < samples.size(); tick++) {
+        learner.process_sample(samples[tick], tick);
+    }
+    REQUIRE(learner.is_learning_successful());
+
+    PassCorrelator correlator;
+    correlator.set_sample_interval_us(SAMPLE_INTERVAL_US);
+    // Flat template is rejected.
+    correlator.set_pass_template(PassTemplate());
+    REQUIRE(correlator.get_template() == PassCorrelator().get_template());
+
+    correlator.set_pass_template(learner.get_pass_template());
+    REQUIRE(correlator.get_pass_template() == learner.get_pass_template());
+    for (uint8_t i = 0; i < PassCorrelator::TEMPLATE_LENGTH; i++) {
+        REQUIRE(correlator.get_template()[i] == Approx(learner.get_template()[i]).margin(0.01f));
+    }
+
+    std::vector<uint64_t> laps = correlate(correlator, make_pass(1000, 10000, 80, 2000));
+    REQUIRE(laps.size() == 1);
+    REQUIRE(correlator.get_pass_signature().get_confidence() >= 98);
+}
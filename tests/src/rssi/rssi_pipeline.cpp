@@ -0,0 +1,202 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "rssi/rssi_pipeline.h"
+
+#include <algorithm>
+#include <vector>
+
+template<typename Stage>
+static std::vector<uint16_t> run(Stage& stage, const std::vector<uint16_t>& samples, std::vector<uint32_t>* ticks = nullptr) {
+    std::vector<uint16_t> output;
+    for (size_t i = 0; i < samples.size(); i++) {
+        uint16_t sample = samples[i];
+        uint32_t tick = i;
+        if (stage.process(sample, tick)) {
+            output.push_back(sample);
+            if (ticks) {
+                ticks->push_back(tick);
+            }
+        }
+    }
+    return output;
+}
+
+TEST_CASE("decimation averages samples", "[rssi_pipeline]") {
+    RssiDecimate<4> decimate;
+    std::vector<uint32_t> ticks;
+
+    REQUIRE(run(decimate, {10, 20, 30, 40, 100, 100, 101, 101, 7}, &ticks) == std::vector<uint16_t>{25, 101});
+    REQUIRE(ticks == std::vector<uint32_t>{1, 5});
+}
+
+TEST_CASE("median stage removes spikes", "[rssi_pipeline]") {
+    RssiMedian<3> median;
+    median.prime(100);
+
+    REQUIRE(run(median, {100, 500, 100, 100, 0, 100}) == std::vector<uint16_t>{100, 100, 100, 100, 100, 100});
+}
+
+TEST_CASE("IIR stage converges to input", "[rssi_pipeline]") {
+    RssiIir<1 << 12> iir;
+    iir.prime(1000);
+
+    std::vector<uint16_t> output = run(iir, std::vector<uint16_t>(200, 2000));
+
+    REQUIRE(output[0] == 1125);
+    REQUIRE(std::is_sorted(output.begin(), output.end()));
+    REQUIRE(output.back() == 2000);
+}
+
+TEST_CASE("IIR stage with unity coefficient passes samples", "[rssi_pipeline]") {
+    RssiIir<1 << 15> iir;
+    std::vector<uint16_t> samples = {0, 65535, 1, 30000, 65535};
+
+    REQUIRE(run(iir, samples) == samples);
+}
+
+TEST_CASE("hysteresis stage ignores changes within the band", "[rssi_pipeline]") {
+    RssiHysteresis<10> hysteresis;
+    hysteresis.prime(100);
+
+    REQUIRE(run(hysteresis, {105, 95, 110, 111, 120, 115, 105, 0}) == std::vector<uint16_t>{100, 100, 100, 101, 110, 110, 110, 10});
+}
+
+TEST_CASE("pipeline chains stages", "[rssi_pipeline]") {
+    RssiPipeline<RssiDecimate<2>, RssiMedian<3>, RssiDecimate<3>> pipeline;
+    static_assert(decltype(pipeline)::DECIMATION == 6);
+    pipeline.prime(100);
+    std::vector<uint32_t> ticks;
+
+    std::vector<uint16_t> samples = {100, 100, 900, 900, 100, 100, 200, 200, 200, 200, 200, 200};
+    REQUIRE(run(pipeline, samples, &ticks) == std::vector<uint16_t>{100, 200});
+    // Tick of the middle of each stage window.
+    REQUIRE(ticks == std::vector<uint32_t>{2, 8});
+}
+
+TEST_CASE("empty pipeline passes samples", "[rssi_pipeline]") {
+    RssiPipeline<> pipeline;
+    static_assert(decltype(pipeline)::DECIMATION == 1);
+    pipeline.prime(0);
+    std::vector<uint32_t> ticks;
+
+    REQUIRE(run(pipeline, {1, 2, 3}, &ticks) == std::vector<uint16_t>{1, 2, 3});
+    REQUIRE(ticks == std::vector<uint32_t>{0, 1, 2});
+}
+
+template<typename Pipeline>
+static std::vector<uint16_t> run_blocks(Pipeline& pipeline, const std::vector<uint16_t>& samples, size_t block_length, std::vector<uint32_t>* ticks = nullptr) {
+    std::vector<uint16_t> output;
+    for (size_t offset = 0; offset < samples.size(); offset += block_length) {
+        size_t count = std::min(block_length, samples.size() - offset);
+        pipeline.process_block(&samples[offset], count, offset, 1, [&output, ticks](uint16_t sample, uint32_t tick) {
+            output.push_back(sample);
+            if (ticks) {
+                ticks->push_back(tick);
+            }
+        });
+    }
+    return output;
+}
+
+static std::vector<uint16_t> make_noise(size_t count) {
+    std::vector<uint16_t> samples(count);
+    uint32_t state = 12345;
+    for (uint16_t& sample : samples) {
+        state = state * 1103515245 + 12345;
+        sample = static_cast<uint16_t>(state >> 16);
+    }
+    return samples;
+}
+
+TEST_CASE("block decimation matches decimation stage across odd blocks", "[rssi_pipeline]") {
+    std::vector<uint16_t> samples = make_noise(301);
+    RssiPipeline<RssiDecimate<2>, RssiMedian<3>> reference;
+    std::vector<uint32_t> reference_ticks;
+    std::vector<uint16_t> expected = run(reference, samples, &reference_ticks);
+
+    for (size_t block_length : {1, 7, 32, 45}) {
+        RssiPipeline<RssiBlockDecimate2, RssiMedian<3>> pipeline;
+        static_assert(decltype(pipeline)::DECIMATION == 2);
+        std::vector<uint32_t> ticks;
+
+        REQUIRE(run_blocks(pipeline, samples, block_length, &ticks) == expected);
+        REQUIRE(ticks == reference_ticks);
+    }
+}
+
+TEST_CASE("block decimation doesn't pair samples across a gap", "[rssi_pipeline]") {
+    RssiPipeline<RssiBlockDecimate2> pipeline;
+    std::vector<uint16_t> output;
+    std::vector<uint32_t> ticks;
+    auto collect = [&output, &ticks](uint16_t sample, uint32_t tick) {
+        output.push_back(sample);
+        ticks.push_back(tick);
+    };
+    const uint16_t first[] = {10, 20, 30};
+    const uint16_t second[] = {100, 200};
+
+    pipeline.process_block(first, 3, 0, 1, collect);
+    pipeline.process_block(second, 2, 10, 1, collect);
+
+    REQUIRE(output == std::vector<uint16_t>{15, 150});
+    REQUIRE(ticks == std::vector<uint32_t>{0, 10});
+}
+
+TEST_CASE("FIR stage smooths steps and moves ticks to the middle of the window", "[rssi_pipeline]") {
+    RssiPipeline<RssiFir<8192, 16384, 8192>> pipeline;
+    pipeline.prime(100);
+    std::vector<uint32_t> ticks;
+
+    REQUIRE(run_blocks(pipeline, {100, 100, 500, 500, 500}, 32, &ticks) == std::vector<uint16_t>{100, 100, 200, 400, 500});
+    REQUIRE(ticks == std::vector<uint32_t>{UINT32_MAX, 0, 1, 2, 3});
+}
+
+TEST_CASE("FIR stage doesn't depend on block length", "[rssi_pipeline]") {
+    std::vector<uint16_t> samples = make_noise(200);
+    RssiPipeline<RssiFir<4096, 8192, 8192, 8192, 4096>, RssiHysteresis<16>> reference;
+    std::vector<uint32_t> reference_ticks;
+    std::vector<uint16_t> expected = run_blocks(reference, samples, samples.size(), &reference_ticks);
+
+    for (size_t block_length : {1, 5, 32, 33}) {
+        RssiPipeline<RssiFir<4096, 8192, 8192, 8192, 4096>, RssiHysteresis<16>> pipeline;
+        std::vector<uint32_t> ticks;
+
+        REQUIRE(run_blocks(pipeline, samples, block_length, &ticks) == expected);
+        REQUIRE(ticks == reference_ticks);
+    }
+}
+
+TEST_CASE("pipeline without block stages filters blocks sample by sample", "[rssi_pipeline]") {
+    std::vector<uint16_t> samples = make_noise(100);
+    RssiPipeline<RssiDecimate<2>, RssiMedian<3>> reference;
+    std::vector<uint32_t> reference_ticks;
+    std::vector<uint16_t> expected = run(reference, samples, &reference_ticks);
+
+    RssiPipeline<RssiDecimate<2>, RssiMedian<3>> pipeline;
+    std::vector<uint32_t> ticks;
+
+    REQUIRE(run_blocks(pipeline, samples, 13, &ticks) == expected);
+    REQUIRE(ticks == reference_ticks);
+}
@@ -0,0 +1,476 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "rssi/rssi_reader_delegate.h"
+#include "rssi/generated_laps.h"
+#include "rssi/mock_rssi_reader.h"
+#include "rssi/rssi_signal_generator.h"
+#include "events/mock_event_dispatcher.h"
+#include "time/mock_real_time_clock.h"
+
+#include <cstdlib>
+#include <vector>
+
+static constexpr uint16_t RSSI_LOW = 20000;
+static constexpr uint16_t RSSI_HIGH = 50000;
+
+static std::vector<NewLap> collect_laps(MockEventDispatcher& dispatcher) {
+    std::vector<NewLap> laps;
+    while (auto event = dispatcher.process_next_event()) {
+        if (auto lap = std::get_if<NewLap>(&*event)) {
+            laps.push_back(*lap);
+        }
+    }
+    return laps;
+}
+
+static std::vector<uint16_t> make_pass(size_t track_length, size_t pass_length) {
+    std::vector<uint16_t> samples(track_length, RSSI_LOW);
+    samples.insert(samples.end(), pass_length, RSSI_HIGH);
+    samples.insert(samples.end(), track_length, RSSI_LOW);
+    return samples;
+}
+
+TEST_CASE("Rssi reader delegate derives lap timestamp from sample tick", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(1000);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    // Clock is not read after initialization.
+    clock.set_current_timestamp_ms(123456);
+
+    reader.capture(make_pass(1000, 500));
+
+    std::vector<NewLap> laps = collect_laps(dispatcher);
+    REQUIRE(laps.size() == 1);
+
+    // Median filter delays the pass by two samples, its centroid is at tick 1251.5.
+    REQUIRE(laps[0].get_timestamp() == 1000 + 500);
+    REQUIRE(laps[0].get_timestamp_fraction_us() == 600);
+    REQUIRE(laps[0].get_timestamp_us() == 1500600);
+}
+
+TEST_CASE("Rssi reader delegate doesn't depend on block length", "[rssi_reader_delegate]") {
+    std::vector<uint16_t> samples = make_pass(1000, 500);
+
+    for (size_t block_length : { 1, 7, 32, 256 }) {
+        MockRealTimeClock clock(0);
+        MockEventDispatcher dispatcher;
+        MockRssiReader reader(400, block_length);
+        RssiReaderDelegate delegate(clock, dispatcher);
+        reader.initialize(delegate);
+        reader.capture(samples);
+
+        std::vector<NewLap> laps = collect_laps(dispatcher);
+        REQUIRE(laps.size() == 1);
+        REQUIRE(laps[0].get_timestamp_us() == 500600);
+    }
+}
+
+TEST_CASE("Rssi reader delegate reports pass in the middle regardless of its length", "[rssi_reader_delegate]") {
+    for (size_t pass_length : { 250, 1000, 3000 }) {
+        MockRealTimeClock clock(0);
+        MockEventDispatcher dispatcher;
+        MockRssiReader reader(400, 32);
+        RssiReaderDelegate delegate(clock, dispatcher);
+        reader.initialize(delegate);
+        reader.capture(make_pass(1000, pass_length));
+
+        std::vector<NewLap> laps = collect_laps(dispatcher);
+        REQUIRE(laps.size() == 1);
+        // Middle of the pass shifted by the median filter delay.
+        uint64_t middle_tick_x2 = 2 * (1000 + 2) + pass_length - 1;
+        REQUIRE(laps[0].get_timestamp_us() == middle_tick_x2 * 400 / 2);
+    }
+}
+
+TEST_CASE("Rssi reader delegate ignores too short passes", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+    reader.capture(make_pass(1000, 150));
+
+    REQUIRE(collect_laps(dispatcher).empty());
+}
+
+TEST_CASE("Rssi reader delegate waits for the drone to leave before next lap", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    // Second pass comes before 8 seconds of silence.
+    reader.capture(make_pass(1000, 500));
+    reader.capture(make_pass(1000, 500));
+    REQUIRE(collect_laps(dispatcher).size() == 1);
+
+    reader.capture(std::vector<uint16_t>(20000, RSSI_LOW));
+    reader.capture(make_pass(1000, 500));
+    REQUIRE(collect_laps(dispatcher).size() == 1);
+}
+
+TEST_CASE("Rssi reader delegate uses loaded profile", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    // Too weak for the default profile.
+    std::vector<uint16_t> weak_pass(1000, 15000);
+    weak_pass.insert(weak_pass.end(), 500, 30000);
+    weak_pass.insert(weak_pass.end(), 1000, 15000);
+    reader.capture(weak_pass);
+    REQUIRE(collect_laps(dispatcher).empty());
+
+    dispatcher.emit_event(RssiProfileLoaded(RssiProfile(15000, 30000)));
+    collect_laps(dispatcher);
+    reader.capture(weak_pass);
+    REQUIRE(collect_laps(dispatcher).size() == 1);
+}
+
+TEST_CASE("Rssi reader delegate calibrates thresholds", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    std::vector<uint16_t> weak_pass(1000, 15000);
+    weak_pass.insert(weak_pass.end(), 500, 30000);
+    weak_pass.insert(weak_pass.end(), 1000, 15000);
+
+    dispatcher.emit_event(StartRssiCalibration(2000));
+    collect_laps(dispatcher);
+
+    // No laps are reported during calibration.
+    reader.capture(weak_pass);
+    reader.capture(std::vector<uint16_t>(2500, 15000));
+
+    std::vector<RssiCalibrationFinished> results;
+    while (auto event = dispatcher.process_next_event()) {
+        REQUIRE(!std::holds_alternative<NewLap>(*event));
+        if (auto result = std::get_if<RssiCalibrationFinished>(&*event)) {
+            results.push_back(*result);
+        }
+    }
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].is_successful());
+    REQUIRE(results[0].get_profile() == RssiProfile(15000, 30000));
+
+    reader.capture(weak_pass);
+    REQUIRE(collect_laps(dispatcher).size() == 1);
+}
+
+TEST_CASE("Rssi reader delegate detects laps on every channel independently", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32, 3);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    // Pilots pass the gate one after another, third one is still on the track.
+    std::vector<uint16_t> first = make_pass(1000, 500);
+    first.insert(first.end(), 1000, RSSI_LOW);
+    std::vector<uint16_t> second(2000, RSSI_LOW);
+    second.insert(second.end(), 500, RSSI_HIGH);
+    second.insert(second.end(), 1000, RSSI_LOW);
+    std::vector<uint16_t> third(3500, RSSI_LOW);
+    reader.capture_channels({ first, second, third });
+
+    std::vector<NewLap> laps = collect_laps(dispatcher);
+    REQUIRE(laps.size() == 2);
+    REQUIRE(laps[0] == NewLap(500, 600, 0, laps[0].get_pass_signature()));
+    REQUIRE(laps[1] == NewLap(900, 600, 1, laps[1].get_pass_signature()));
+}
+
+TEST_CASE("Rssi reader delegate attaches pass signature to laps", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32, 1);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    std::vector<uint16_t> samples = make_pass(1000, 500);
+    samples.insert(samples.end(), 1000, RSSI_LOW);
+    reader.capture_channels({ samples });
+
+    std::vector<NewLap> laps = collect_laps(dispatcher);
+    REQUIRE(laps.size() == 1);
+    const PassSignature& signature = laps[0].get_pass_signature();
+    REQUIRE(signature.get_peak() == RSSI_HIGH);
+    // 500 samples, 400 us apart.
+    REQUIRE(signature.get_duration_ms() == 200);
+    // Square pulse rises and falls within a single sample.
+    REQUIRE(signature.get_rise_slope() > 0);
+    REQUIRE(signature.get_rise_slope() == signature.get_fall_slope());
+    REQUIRE(signature.get_confidence() == 100);
+}
+
+TEST_CASE("Rssi reader delegate loads profiles per channel", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32, 2);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    std::vector<uint16_t> weak_pass(1000, 15000);
+    weak_pass.insert(weak_pass.end(), 500, 30000);
+    weak_pass.insert(weak_pass.end(), 1000, 15000);
+
+    dispatcher.emit_event(RssiProfileLoaded(RssiProfile(15000, 30000), 1));
+    collect_laps(dispatcher);
+    reader.capture_channels({ weak_pass, weak_pass });
+
+    std::vector<NewLap> laps = collect_laps(dispatcher);
+    REQUIRE(laps.size() == 1);
+    REQUIRE(laps[0].get_channel() == 1);
+}
+
+TEST_CASE("Rssi reader delegate suspends sampling during lap lockout", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    dispatcher.emit_event(SetLapLockout(5000));
+    collect_laps(dispatcher);
+
+    reader.capture(make_pass(1000, 500));
+    REQUIRE(collect_laps(dispatcher).size() == 1);
+
+    // Double trigger isn't even sampled.
+    reader.capture(make_pass(1000, 500));
+    reader.capture(std::vector<uint16_t>(10000, RSSI_LOW));
+    REQUIRE(collect_laps(dispatcher).empty());
+
+    // Lockout ends 5s after the lap at tick 1251, sampling is resumed 500ms earlier.
+    // Lap is detected in the block ending at tick 1504.
+    REQUIRE(reader.get_skipped_samples() == 13751 - 1250 - 1504);
+
+    reader.capture(make_pass(1000, 500));
+    std::vector<NewLap> laps = collect_laps(dispatcher);
+    REQUIRE(laps.size() == 1);
+    REQUIRE(laps[0].get_timestamp_us() == (2 * (15000 + 1000 + 2) + 499) * 400 / 2);
+}
+
+TEST_CASE("Rssi reader delegate suspends sampling only if all channels are locked out", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32, 2);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    dispatcher.emit_event(SetLapLockout(5000));
+    collect_laps(dispatcher);
+
+    // First pilot passes the gate, second one is still on the track.
+    std::vector<uint16_t> first = make_pass(1000, 500);
+    first.resize(4000, RSSI_LOW);
+    reader.capture_channels({ first, std::vector<uint16_t>(4000, RSSI_LOW) });
+    REQUIRE(collect_laps(dispatcher).size() == 1);
+    REQUIRE(reader.get_skipped_samples() == 0);
+
+    std::vector<uint16_t> second(500, RSSI_HIGH);
+    second.insert(second.end(), 10000, RSSI_LOW);
+    reader.capture_channels({ std::vector<uint16_t>(second.size(), RSSI_LOW), second });
+    REQUIRE(collect_laps(dispatcher).size() == 1);
+    // Second lap is detected in the block ending at tick 4512, sampling is resumed before
+    // the first channel's lockout ends.
+    REQUIRE(reader.get_skipped_samples() == 13751 - 1250 - 4512);
+}
+
+TEST_CASE("Rssi reader delegate leaves the reader waiting for a pass when idle", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    delegate.set_idle_wakeup_enabled(true);
+    reader.initialize(delegate);
+
+    // Wake-up is armed after a second below the level.
+    reader.capture(std::vector<uint16_t>(2400, RSSI_LOW));
+    REQUIRE_FALSE(reader.is_wakeup_armed());
+    reader.capture(std::vector<uint16_t>(200, RSSI_LOW));
+    REQUIRE(reader.is_wakeup_armed());
+    // Block ending at tick 2528 was the last one passed.
+    REQUIRE(reader.get_skipped_samples() == 2600 - 2528);
+
+    // Reader wakes up at the first sample of the pass, median filter is primed with it.
+    reader.capture(make_pass(1000, 500));
+    REQUIRE_FALSE(reader.is_wakeup_armed());
+    std::vector<NewLap> laps = collect_laps(dispatcher);
+    REQUIRE(laps.size() == 1);
+    REQUIRE(laps[0].get_timestamp_us() == (2 * (2600 + 1000) + 501) * 400 / 2);
+
+    // No wake-up until the detector rearms.
+    reader.capture(std::vector<uint16_t>(20000, RSSI_LOW));
+    REQUIRE_FALSE(reader.is_wakeup_armed());
+    reader.capture(std::vector<uint16_t>(3000, RSSI_LOW));
+    REQUIRE(reader.is_wakeup_armed());
+}
+
+TEST_CASE("Rssi reader delegate keeps the reader awake until all channels are quiet", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32, 2);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    delegate.set_idle_wakeup_enabled(true);
+    reader.initialize(delegate);
+
+    // Drone is hovering near the gate, above the exit but below the enter threshold.
+    reader.capture_channels({ std::vector<uint16_t>(5000, RSSI_LOW), std::vector<uint16_t>(5000, 33000) });
+    REQUIRE_FALSE(reader.is_wakeup_armed());
+    REQUIRE(collect_laps(dispatcher).empty());
+
+    reader.capture_channels({ std::vector<uint16_t>(3000, RSSI_LOW), std::vector<uint16_t>(3000, RSSI_LOW) });
+    REQUIRE(reader.is_wakeup_armed());
+}
+
+TEST_CASE("Rssi reader delegate doesn't leave the reader idle by default", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    reader.capture(std::vector<uint16_t>(10000, RSSI_LOW));
+    REQUIRE_FALSE(reader.is_wakeup_armed());
+    REQUIRE(reader.get_skipped_samples() == 0);
+}
+
+TEST_CASE("Rssi reader delegate lowers sampling rate while no pass is expected", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    delegate.set_sampling_profiles_enabled(true);
+    reader.initialize(delegate);
+
+    // Idle profile after 500ms of calm RSSI.
+    reader.capture(std::vector<uint16_t>(1248, RSSI_LOW));
+    REQUIRE(reader.get_sample_stride() == 1);
+    reader.capture(std::vector<uint16_t>(752, RSSI_LOW));
+    REQUIRE(reader.get_sample_stride() == 4);
+
+    // Full rate is back for the pass, which is timed as with the full rate only.
+    reader.capture(make_pass(1000, 500));
+    std::vector<NewLap> laps = collect_laps(dispatcher);
+    REQUIRE(laps.size() == 1);
+    int64_t error_us = static_cast<int64_t>(laps[0].get_timestamp_us()) - (2000 + 1000 + 251.5) * 400;
+    REQUIRE(std::abs(error_us) <= 2000);
+
+    // Detector is in checkpoint for REARM_TIME_MS.
+    reader.capture(std::vector<uint16_t>(20000, RSSI_LOW));
+    REQUIRE(reader.get_sample_stride() == 1);
+    reader.capture(std::vector<uint16_t>(2000, RSSI_LOW));
+    REQUIRE(reader.get_sample_stride() == 4);
+}
+
+TEST_CASE("Rssi reader delegate detects passes at low sampling rate", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    // Pass and lockout durations stay in milliseconds.
+    reader.set_sample_stride(4);
+    dispatcher.emit_event(SetLapLockout(5000));
+    collect_laps(dispatcher);
+    reader.capture(make_pass(1000, 500));
+    // Second pass is in the lockout, third one is shorter than PASS_MIN_TIME_MS.
+    reader.capture(make_pass(1000, 500));
+    reader.capture(make_pass(15000, 180));
+    reader.capture(make_pass(1000, 220));
+    std::vector<NewLap> laps = collect_laps(dispatcher);
+    REQUIRE(laps.size() == 2);
+    // Median filter delays the pass by two samples, eight ticks. Each sample stands for four ticks.
+    REQUIRE(laps[0].get_timestamp_us() == 1257.5 * 400);
+}
+
+TEST_CASE("Rssi reader delegate doesn't change sampling rate by default", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    reader.capture(std::vector<uint16_t>(10000, RSSI_LOW));
+    REQUIRE(reader.get_sample_stride() == 1);
+}
+
+// Steeper departure moves the centre of the pass before the gate.
+static constexpr int64_t LAP_TOLERANCE_US = 50000;
+
+TEST_CASE("Rssi reader delegate keeps up with 3 second laps", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+    dispatcher.emit_event(SetLapLockout(2000));
+    collect_laps(dispatcher);
+
+    RssiSignalGenerator generator(400);
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 3000;
+    drone.lap_time_ms = 3000;
+    drone.lap_time_jitter_ms = 300;
+    drone.speed_mps = 30;
+    generator.add_drone(drone);
+
+    std::vector<NewLap> laps = get_laps(replay_generated(reader, dispatcher, generator, 60000));
+    REQUIRE(laps.size() >= 15);
+    require_laps_match_passes(laps, generator, LAP_TOLERANCE_US);
+}
+
+TEST_CASE("Rssi reader delegate separates drones in the gate at once", "[rssi_reader_delegate]") {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 32, 2);
+    RssiReaderDelegate delegate(clock, dispatcher);
+    reader.initialize(delegate);
+
+    RssiSignalGenerator generator(400);
+    RssiSignalGenerator::DroneParameters leader;
+    leader.first_pass_ms = 3000;
+    leader.lap_time_ms = 12000;
+    generator.add_drone(leader);
+    // Second drone flies right next to the leader, closer to the receiver antenna.
+    RssiSignalGenerator::DroneParameters follower = leader;
+    follower.first_pass_ms = 3050;
+    follower.closest_distance_m = 0.5f;
+    generator.add_drone(follower);
+
+    std::vector<NewLap> laps = get_laps(replay_generated(reader, dispatcher, generator, 40000));
+    REQUIRE(laps.size() == 8);
+    require_laps_match_passes(laps, generator, LAP_TOLERANCE_US);
+}
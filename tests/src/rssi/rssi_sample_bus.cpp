@@ -0,0 +1,176 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "events/mock_event_dispatcher.h"
+#include "rssi/buffered_rssi_reader_delegate.h"
+#include "rssi/mock_rssi_reader.h"
+#include "rssi/rssi_sample_bus.h"
+
+#include <vector>
+
+class RecordingSink : public RssiReaderInterface::Delegate {
+public:
+    RecordingSink() : reader(nullptr) {}
+
+    void on_initialized(RssiReaderInterface& rssi_reader) override {
+        reader = &rssi_reader;
+    }
+
+    void on_samples_captured(uint8_t channel, const uint16_t* samples, size_t count, uint32_t first_sample_tick, uint8_t tick_stride) override {
+        channels.push_back(channel);
+        ticks.push_back(first_sample_tick);
+        strides.push_back(tick_stride);
+        this->samples.insert(this->samples.end(), samples, samples + count);
+    }
+
+    RssiReaderInterface* reader;
+    std::vector<uint8_t> channels;
+    std::vector<uint32_t> ticks;
+    std::vector<uint8_t> strides;
+    std::vector<uint16_t> samples;
+};
+
+// Records samples once the event loop drains the ring.
+class BufferedSink {
+public:
+    explicit BufferedSink(EventDispatcherInterface& dispatcher) : recording(), buffered(dispatcher, recording) {}
+
+    RecordingSink& drain() {
+        buffered.process_queued_blocks();
+        return recording;
+    }
+
+    RecordingSink recording;
+    BufferedRssiReaderDelegate buffered;
+};
+
+static std::vector<uint16_t> make_ramp(uint16_t first, size_t count) {
+    std::vector<uint16_t> samples;
+    for (size_t i = 0; i < count; i++) {
+        samples.push_back(static_cast<uint16_t>(first + i));
+    }
+    return samples;
+}
+
+TEST_CASE("Sample bus passes all samples to every sink", "[rssi_sample_bus]") {
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 8, 2);
+    BufferedSink first_sink(dispatcher);
+    BufferedSink second_sink(dispatcher);
+    RssiSampleBus bus;
+    REQUIRE(bus.add_sink(first_sink.buffered));
+    REQUIRE(bus.add_sink(second_sink.buffered));
+    reader.initialize(bus);
+    REQUIRE(first_sink.recording.reader == &reader);
+    REQUIRE(second_sink.recording.reader == &reader);
+
+    reader.capture_channels({ make_ramp(0, 16), make_ramp(100, 16) });
+    // Nothing reaches the sinks before the event loop runs.
+    REQUIRE(first_sink.recording.samples.empty());
+    for (BufferedSink* sink : { &first_sink, &second_sink }) {
+        RecordingSink& recording = sink->drain();
+        REQUIRE(recording.channels == std::vector<uint8_t>{ 0, 1, 0, 1 });
+        REQUIRE(recording.ticks == std::vector<uint32_t>{ 0, 0, 8, 8 });
+        REQUIRE(recording.strides == std::vector<uint8_t>{ 1, 1, 1, 1 });
+        REQUIRE(recording.samples.size() == 32);
+    }
+}
+
+TEST_CASE("Sample bus decimates samples across blocks", "[rssi_sample_bus]") {
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 8, 1);
+    BufferedSink full_sink(dispatcher);
+    BufferedSink decimated_sink(dispatcher);
+    RssiSampleBus bus;
+    REQUIRE(bus.add_sink(full_sink.buffered));
+    REQUIRE(bus.add_sink(decimated_sink.buffered, 3));
+    reader.initialize(bus);
+
+    reader.capture(make_ramp(0, 24));
+    REQUIRE(full_sink.drain().samples == make_ramp(0, 24));
+    RecordingSink& decimated = decimated_sink.drain();
+    REQUIRE(decimated.samples == std::vector<uint16_t>{ 0, 3, 6, 9, 12, 15, 18, 21 });
+    // Every block starts at the tick of its first kept sample.
+    REQUIRE(decimated.ticks == std::vector<uint32_t>{ 0, 9, 18 });
+    REQUIRE(decimated.strides == std::vector<uint8_t>{ 3, 3, 3 });
+}
+
+TEST_CASE("Sample bus restarts decimation after a gap", "[rssi_sample_bus]") {
+    MockEventDispatcher dispatcher;
+    BufferedSink sink(dispatcher);
+    RssiSampleBus bus;
+    REQUIRE(bus.add_sink(sink.buffered, 4));
+
+    std::vector<uint16_t> samples = make_ramp(0, 6);
+    bus.on_samples_captured(0, samples.data(), samples.size(), 0, 1);
+    REQUIRE(sink.drain().samples == std::vector<uint16_t>{ 0, 4 });
+
+    // Samples 6 and 7 were never captured, the first sample after the gap is kept.
+    samples = make_ramp(8, 6);
+    bus.on_samples_captured(0, samples.data(), samples.size(), 8, 1);
+    REQUIRE(sink.drain().samples == std::vector<uint16_t>{ 0, 4, 8, 12 });
+    REQUIRE(sink.recording.ticks == std::vector<uint32_t>{ 0, 8 });
+
+    // Strided blocks keep every 4th captured sample.
+    samples = make_ramp(20, 8);
+    bus.on_samples_captured(0, samples.data(), samples.size(), 20, 2);
+    RecordingSink& recording = sink.drain();
+    REQUIRE(recording.ticks == std::vector<uint32_t>{ 0, 8, 20 });
+    REQUIRE(recording.strides == std::vector<uint8_t>{ 4, 4, 8 });
+    REQUIRE(recording.samples == std::vector<uint16_t>{ 0, 4, 8, 12, 20, 24 });
+}
+
+TEST_CASE("Sample bus limits number of sinks", "[rssi_sample_bus]") {
+    MockEventDispatcher dispatcher;
+    BufferedSink sink(dispatcher);
+    RssiSampleBus bus;
+    REQUIRE_FALSE(bus.add_sink(sink.buffered, 0));
+    for (uint8_t i = 0; i < RssiSampleBus::MAX_SINKS_COUNT; i++) {
+        REQUIRE(bus.add_sink(sink.buffered));
+    }
+    REQUIRE_FALSE(bus.add_sink(sink.buffered));
+}
+
+TEST_CASE("Slow sink drops only its own samples", "[rssi_sample_bus]") {
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(400, 8, 1);
+    BufferedSink fast_sink(dispatcher);
+    BufferedSink slow_sink(dispatcher);
+    RssiSampleBus bus;
+    REQUIRE(bus.add_sink(fast_sink.buffered));
+    REQUIRE(bus.add_sink(slow_sink.buffered));
+    reader.initialize(bus);
+
+    // Fast sink is drained after every block, the slow one not until its ring overflows.
+    size_t blocks_count = BufferedRssiReaderDelegate::BLOCKS_COUNT + 4;
+    for (size_t i = 0; i < blocks_count; i++) {
+        reader.capture(make_ramp(static_cast<uint16_t>(i * 8), 8));
+        fast_sink.drain();
+    }
+    REQUIRE(fast_sink.recording.samples == make_ramp(0, blocks_count * 8));
+    REQUIRE(fast_sink.buffered.get_overflows() == 0);
+    REQUIRE(slow_sink.buffered.get_overflows() > 0);
+
+    while (dispatcher.process_next_event()) {}
+    REQUIRE(slow_sink.recording.samples.size() < fast_sink.recording.samples.size());
+}
@@ -0,0 +1,133 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "rssi/rssi_signal_generator.h"
+
+static RssiSignalGenerator::EnvironmentParameters make_quiet_environment() {
+    RssiSignalGenerator::EnvironmentParameters environment;
+    environment.noise_db = 0;
+    environment.prop_noise_db = 0;
+    environment.fading_depth_db = 0;
+    return environment;
+}
+
+TEST_CASE("Rssi signal generator stays at the floor while drones are far", "[rssi_signal_generator]") {
+    RssiSignalGenerator generator(400);
+    generator.set_environment(make_quiet_environment());
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 100000;
+    drone.power_at_1m_dbm = -60;
+    generator.add_drone(drone);
+
+    std::vector<std::vector<uint16_t>> channels = generator.generate(1000);
+    REQUIRE(channels.size() == 1);
+    REQUIRE(channels[0].size() == 1000);
+    uint16_t floor = RssiSignalGenerator::EnvironmentParameters().adc_floor << 2;
+    for (uint16_t sample : channels[0]) {
+        REQUIRE(sample == floor);
+    }
+}
+
+TEST_CASE("Rssi signal generator peaks at the pass", "[rssi_signal_generator]") {
+    RssiSignalGenerator generator(1000);
+    generator.set_environment(make_quiet_environment());
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 1000;
+    generator.add_drone(drone);
+
+    std::vector<uint16_t> samples = generator.generate(2000)[0];
+    REQUIRE(*std::max_element(samples.begin(), samples.end()) == samples[1000]);
+    REQUIRE(generator.get_pass_timestamps_us(0) == std::vector<uint64_t>{ 1000000 });
+
+    // -35dBm - 20 * log10(1.5m), linearly mapped to 4000 - 14000 between -90 and -20dBm.
+    REQUIRE(samples[1000] == 11354 << 2);
+    // Drone shadows its antenna after the pass.
+    REQUIRE(samples[800] > samples[1200]);
+}
+
+TEST_CASE("Rssi signal generator quantizes like the ADC", "[rssi_signal_generator]") {
+    RssiSignalGenerator generator(400);
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 200;
+    drone.power_at_1m_dbm = 0;
+    generator.add_drone(drone);
+
+    std::vector<uint16_t> samples = generator.generate(1000)[0];
+    REQUIRE(*std::max_element(samples.begin(), samples.end()) == RssiSignalGenerator::ADC_MAX << 2);
+    for (uint16_t sample : samples) {
+        REQUIRE((sample & 3) == 0);
+    }
+}
+
+TEST_CASE("Rssi signal generator leaks drones to other channels", "[rssi_signal_generator]") {
+    RssiSignalGenerator generator(1000);
+    generator.set_environment(make_quiet_environment());
+    RssiSignalGenerator::DroneParameters first;
+    first.first_pass_ms = 100000;
+    generator.add_drone(first);
+    RssiSignalGenerator::DroneParameters second;
+    second.first_pass_ms = 500;
+    generator.add_drone(second);
+
+    std::vector<std::vector<uint16_t>> channels = generator.generate(1000);
+    uint16_t floor = RssiSignalGenerator::EnvironmentParameters().adc_floor << 2;
+    REQUIRE(channels[0][500] > floor);
+    REQUIRE(channels[0][500] < channels[1][500]);
+}
+
+TEST_CASE("Rssi signal generator varies lap times", "[rssi_signal_generator]") {
+    RssiSignalGenerator generator(1000, 7);
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 1000;
+    drone.lap_time_ms = 3000;
+    drone.lap_time_jitter_ms = 500;
+    generator.add_drone(drone);
+
+    generator.generate(60000);
+    const std::vector<uint64_t>& passes = generator.get_pass_timestamps_us(0);
+    REQUIRE(passes.size() >= 60000 / 3500);
+    bool varied = false;
+    for (size_t i = 1; i < passes.size(); i++) {
+        uint64_t lap_time_us = passes[i] - passes[i - 1];
+        REQUIRE(lap_time_us >= 2500000);
+        REQUIRE(lap_time_us <= 3500000);
+        varied = varied || lap_time_us != 3000000;
+    }
+    REQUIRE(varied);
+}
+
+TEST_CASE("Rssi signal generator continues across calls", "[rssi_signal_generator]") {
+    RssiSignalGenerator::DroneParameters drone;
+    drone.first_pass_ms = 300;
+    RssiSignalGenerator whole_generator(400, 3);
+    whole_generator.add_drone(drone);
+    RssiSignalGenerator split_generator(400, 3);
+    split_generator.add_drone(drone);
+
+    std::vector<std::vector<uint16_t>> whole = whole_generator.generate(2000);
+    std::vector<std::vector<uint16_t>> split;
+    split_generator.generate(split, 700);
+    split_generator.generate(split, 1300);
+    REQUIRE(split == whole);
+    REQUIRE(split_generator.get_timestamp_us() == 800000);
+}
@@ -0,0 +1,190 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "events/mock_event_dispatcher.h"
+#include "rssi/mock_rssi_reader.h"
+#include "rssi/rssi_summary_stream.h"
+
+#include <vector>
+
+class RecordingStreamClient : public RssiSummaryStream::Client {
+public:
+    RecordingStreamClient(size_t max_notification_length) :
+        max_notification_length(max_notification_length),
+        accepting(true) {}
+
+    size_t get_max_notification_length() const override {
+        return max_notification_length;
+    }
+
+    bool send_rssi_stream_notification(const uint8_t* data, size_t length) override {
+        if (!accepting) {
+            return false;
+        }
+        RssiSummaryStream::Notification notification;
+        REQUIRE(notification.deserialize(data, length));
+        notifications.push_back(notification);
+        return true;
+    }
+
+    size_t get_summary_count() const {
+        size_t count = 0;
+        for (const auto& notification : notifications) {
+            count += notification.get_summary_count();
+        }
+        return count;
+    }
+
+    size_t max_notification_length;
+    bool accepting;
+    std::vector<RssiSummaryStream::Notification> notifications;
+};
+
+static void process_events(MockEventDispatcher& dispatcher) {
+    while (dispatcher.process_next_event()) {}
+}
+
+TEST_CASE("Summary stream summarizes samples at requested rate", "[rssi_summary_stream]") {
+    MockEventDispatcher dispatcher;
+    // Single sample per millisecond.
+    MockRssiReader reader(1000, 10, 2);
+    RssiSummaryStream stream(dispatcher);
+    reader.initialize(stream);
+    RecordingStreamClient client(244);
+
+    REQUIRE_FALSE(stream.start(client, 2, 100));
+    REQUIRE_FALSE(stream.start(client, 1, RSSI_STREAM_MIN_RATE_HZ - 1));
+    REQUIRE_FALSE(stream.start(client, 1, RSSI_STREAM_MAX_RATE_HZ + 1));
+    REQUIRE(stream.start(client, 1, 100));
+
+    // Ramp on the streamed channel, flat line on the other one.
+    std::vector<uint16_t> ramp;
+    for (uint16_t i = 0; i < 101; i++) {
+        ramp.push_back(1000 + i);
+    }
+    reader.capture_channels({ std::vector<uint16_t>(101, 5000), ramp });
+    process_events(dispatcher);
+
+    // 10 summaries of 10ms wait for MAX_LATENCY_MS and are sent together.
+    REQUIRE(client.notifications.size() == 1);
+    const RssiSummaryStream::Notification& notification = client.notifications[0];
+    REQUIRE(notification.get_channel() == 1);
+    REQUIRE(notification.get_sequence() == 0);
+    REQUIRE(notification.get_first_time_ms() == 0);
+    REQUIRE(notification.get_period_us() == 10000);
+    REQUIRE(notification.get_summary_count() == 10);
+    REQUIRE(notification.get_summaries()[0] == RssiStreamSummary{ 1000, 1009, 1004 });
+    REQUIRE(notification.get_summaries()[9] == RssiStreamSummary{ 1090, 1099, 1094 });
+}
+
+TEST_CASE("Summary stream packs as many summaries as fit", "[rssi_summary_stream]") {
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(1000, 10, 1);
+    RssiSummaryStream stream(dispatcher);
+    reader.initialize(stream);
+    // Default ATT_MTU of 23 bytes fits single summary.
+    RecordingStreamClient client(20);
+    REQUIRE(stream.start(client, 0, 200));
+
+    reader.capture(std::vector<uint16_t>(21, 2000));
+    process_events(dispatcher);
+    REQUIRE(client.notifications.size() == 4);
+    for (uint16_t i = 0; i < 4; i++) {
+        REQUIRE(client.notifications[i].get_sequence() == i);
+        REQUIRE(client.notifications[i].get_first_time_ms() == i * 5u);
+        REQUIRE(client.notifications[i].get_summary_count() == 1);
+    }
+
+    // Larger MTU is used as soon as it's negotiated.
+    client.max_notification_length = 13 + 3 * 6;
+    reader.capture(std::vector<uint16_t>(30, 2000));
+    process_events(dispatcher);
+    REQUIRE(client.notifications.size() == 6);
+    REQUIRE(client.notifications[4].get_first_time_ms() == 20);
+    REQUIRE(client.notifications[4].get_summary_count() == 3);
+    REQUIRE(client.notifications[5].get_first_time_ms() == 35);
+}
+
+TEST_CASE("Summary stream splits notifications at gaps", "[rssi_summary_stream]") {
+    MockEventDispatcher dispatcher;
+    RssiSummaryStream stream(dispatcher);
+    MockRssiReader reader(1000, 10, 1);
+    reader.initialize(stream);
+    RecordingStreamClient client(244);
+    REQUIRE(stream.start(client, 0, 100));
+
+    std::vector<uint16_t> samples(20, 3000);
+    stream.on_samples_captured(0, samples.data(), samples.size(), 0, 1);
+    process_events(dispatcher);
+    REQUIRE(client.notifications.empty());
+
+    // Samples 20 - 49 are missing, summaries of 20 - 49 are skipped.
+    stream.on_samples_captured(0, samples.data(), samples.size(), 50, 1);
+    process_events(dispatcher);
+    REQUIRE(client.notifications.size() == 1);
+    REQUIRE(client.notifications[0].get_first_time_ms() == 0);
+    REQUIRE(client.notifications[0].get_summary_count() == 2);
+
+    // Stream stays consecutive at lower sampling rate.
+    samples.assign(65, 3000);
+    stream.on_samples_captured(0, samples.data(), samples.size(), 70, 2);
+    process_events(dispatcher);
+    REQUIRE(client.notifications.size() == 2);
+    REQUIRE(client.notifications[1].get_first_time_ms() == 50);
+    REQUIRE(client.notifications[1].get_summary_count() == 14);
+    REQUIRE(client.get_summary_count() == 16);
+}
+
+TEST_CASE("Summary stream retries notifications and stops", "[rssi_summary_stream]") {
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(1000, 10, 1);
+    RssiSummaryStream stream(dispatcher);
+    reader.initialize(stream);
+    RecordingStreamClient client(20);
+    RecordingStreamClient other_client(20);
+    REQUIRE(stream.start(client, 0, 100));
+
+    client.accepting = false;
+    reader.capture(std::vector<uint16_t>(31, 2000));
+    process_events(dispatcher);
+    REQUIRE(client.notifications.empty());
+
+    client.accepting = true;
+    reader.capture(std::vector<uint16_t>(10, 2000));
+    process_events(dispatcher);
+    REQUIRE(client.notifications.size() == 4);
+    REQUIRE(client.notifications[0].get_first_time_ms() == 0);
+    REQUIRE(client.notifications[3].get_sequence() == 3);
+
+    // Only the current client stops the stream.
+    stream.stop(other_client);
+    reader.capture(std::vector<uint16_t>(10, 2000));
+    process_events(dispatcher);
+    REQUIRE(client.notifications.size() == 5);
+
+    stream.stop(client);
+    reader.capture(std::vector<uint16_t>(30, 2000));
+    process_events(dispatcher);
+    REQUIRE(client.notifications.size() == 5);
+    REQUIRE(other_client.notifications.empty());
+}
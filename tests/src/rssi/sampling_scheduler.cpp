@@ -0,0 +1,113 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "rssi/sampling_scheduler.h"
+
+// 400us ticks, 1250 ticks per 500ms.
+static constexpr uint32_t TICK_INTERVAL_US = 400;
+
+static void add_calm_samples(SamplingScheduler& scheduler, uint32_t first_tick, uint32_t last_tick) {
+    for (uint32_t tick = first_tick; tick < last_tick; tick++) {
+        scheduler.add_sample(0, 20000, tick, true);
+    }
+}
+
+TEST_CASE("Sampling scheduler converts profiles to strides", "[sampling_scheduler]") {
+    SamplingScheduler scheduler;
+    scheduler.set_tick_interval_us(400);
+    REQUIRE(scheduler.get_stride(SamplingScheduler::SAMPLING_PROFILE_PASS) == 1);
+    REQUIRE(scheduler.get_stride(SamplingScheduler::SAMPLING_PROFILE_IDLE) == 4);
+
+    scheduler.set_tick_interval_us(500);
+    REQUIRE(scheduler.get_stride(SamplingScheduler::SAMPLING_PROFILE_IDLE) == 3);
+
+    scheduler.set_tick_interval_us(2000);
+    REQUIRE(scheduler.get_stride(SamplingScheduler::SAMPLING_PROFILE_IDLE) == 1);
+}
+
+TEST_CASE("Sampling scheduler lowers the rate after calm period", "[sampling_scheduler]") {
+    SamplingScheduler scheduler;
+    scheduler.set_tick_interval_us(TICK_INTERVAL_US);
+
+    add_calm_samples(scheduler, 0, 1249);
+    REQUIRE(scheduler.get_profile(1249) == SamplingScheduler::SAMPLING_PROFILE_PASS);
+    add_calm_samples(scheduler, 1249, 1250);
+    REQUIRE(scheduler.get_profile(1250) == SamplingScheduler::SAMPLING_PROFILE_IDLE);
+
+    // Any sample which is not calm restores the full rate.
+    scheduler.add_sample(0, 20000, 2000, false);
+    REQUIRE(scheduler.get_profile(2001) == SamplingScheduler::SAMPLING_PROFILE_PASS);
+    add_calm_samples(scheduler, 2001, 3250);
+    REQUIRE(scheduler.get_profile(3250) == SamplingScheduler::SAMPLING_PROFILE_IDLE);
+}
+
+TEST_CASE("Sampling scheduler restores the rate when RSSI rises", "[sampling_scheduler]") {
+    SamplingScheduler scheduler;
+    scheduler.set_tick_interval_us(TICK_INTERVAL_US);
+    add_calm_samples(scheduler, 0, 2000);
+    REQUIRE(scheduler.get_profile(2000) == SamplingScheduler::SAMPLING_PROFILE_IDLE);
+
+    // Slow drift is not a trend.
+    for (uint32_t tick = 2000; tick < 3000; tick++) {
+        scheduler.add_sample(0, 20000 + (tick - 2000), tick, true);
+    }
+    REQUIRE(scheduler.get_profile(3000) == SamplingScheduler::SAMPLING_PROFILE_IDLE);
+
+    // Rise within 100ms is, even below the approach level.
+    for (uint32_t tick = 3000; tick < 3100; tick++) {
+        scheduler.add_sample(0, 21000 + (tick - 3000) * 20, tick, true);
+    }
+    REQUIRE(scheduler.get_profile(3100) == SamplingScheduler::SAMPLING_PROFILE_PASS);
+}
+
+TEST_CASE("Sampling scheduler restores the rate before the predicted pass", "[sampling_scheduler]") {
+    SamplingScheduler scheduler;
+    scheduler.set_tick_interval_us(TICK_INTERVAL_US);
+
+    // Laps of 20s and 25s, next one is expected 20s after the last one.
+    scheduler.add_lap(0, 0);
+    scheduler.add_lap(0, 62500);
+    scheduler.add_lap(0, 112500);
+    uint32_t predicted_tick = 112500 + 50000;
+    add_calm_samples(scheduler, 112500, predicted_tick + 5000);
+
+    REQUIRE(scheduler.get_profile(predicted_tick - 2501) == SamplingScheduler::SAMPLING_PROFILE_IDLE);
+    REQUIRE(scheduler.get_profile(predicted_tick - 2500) == SamplingScheduler::SAMPLING_PROFILE_PASS);
+    REQUIRE(scheduler.get_profile(predicted_tick + 2500) == SamplingScheduler::SAMPLING_PROFILE_PASS);
+    // Drone didn't come.
+    REQUIRE(scheduler.get_profile(predicted_tick + 2501) == SamplingScheduler::SAMPLING_PROFILE_IDLE);
+
+    scheduler.reset_laps();
+    REQUIRE(scheduler.get_profile(predicted_tick) == SamplingScheduler::SAMPLING_PROFILE_IDLE);
+}
+
+TEST_CASE("Sampling scheduler keeps the full rate if any channel is active", "[sampling_scheduler]") {
+    SamplingScheduler scheduler;
+    scheduler.set_tick_interval_us(TICK_INTERVAL_US);
+    for (uint32_t tick = 0; tick < 2000; tick++) {
+        scheduler.add_sample(0, 20000, tick, true);
+        scheduler.add_sample(1, 40000, tick, false);
+    }
+    REQUIRE(scheduler.get_profile(2000) == SamplingScheduler::SAMPLING_PROFILE_PASS);
+}
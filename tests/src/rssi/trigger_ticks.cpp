@@ -0,0 +1,42 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "rssi/trigger_ticks.h"
+
+TEST_CASE("Trigger tick is found from the counter value", "[trigger_ticks]") {
+    REQUIRE(get_trigger_tick(0, 0, 64) == 0);
+    REQUIRE(get_trigger_tick(0, 63, 64) == 0);
+    REQUIRE(get_trigger_tick(10, 64 * 12 + 5, 64) == 12);
+    REQUIRE(get_trigger_tick(10, 12, 1) == 12);
+}
+
+TEST_CASE("Trigger tick survives counter wrap-around", "[trigger_ticks]") {
+    // Counter wraps at tick 2^26 with 64 triggers per tick.
+    REQUIRE(get_trigger_tick(0x03FFFFF0, 0xFFFFFC00, 64) == 0x03FFFFF0);
+    REQUIRE(get_trigger_tick(0x03FFFFF0, 0x00000400, 64) == 0x04000010);
+
+    // Later wraps leave the counter far below the tick.
+    uint32_t tick = 5 * (1u << 26) + 100;
+    REQUIRE(get_trigger_tick(tick, tick * 64u + 64 * 3 + 1, 64) == tick + 3);
+    REQUIRE(get_trigger_tick(0xFFFFFFFF, 0xFFFFFFC0 + 64 * 2, 64) == 1);
+}
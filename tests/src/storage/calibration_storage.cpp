@@ -0,0 +1,124 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "storage/calibration_storage.h"
+#include "storage/mock_flash_storage.h"
+#include "events/mock_event_dispatcher.h"
+
+#include <vector>
+
+static std::vector<RssiProfileLoaded> collect_loaded_profiles(MockEventDispatcher& dispatcher) {
+    std::vector<RssiProfileLoaded> profiles;
+    while (auto event = dispatcher.process_next_event()) {
+        if (auto profile = std::get_if<RssiProfileLoaded>(&*event)) {
+            profiles.push_back(*profile);
+        }
+    }
+    return profiles;
+}
+
+TEST_CASE("Calibration storage starts without a profile", "[calibration_storage]") {
+    MockFlashStorage flash_storage(10);
+    MockEventDispatcher dispatcher;
+    CalibrationStorage storage(dispatcher, flash_storage);
+
+    dispatcher.emit_event(SessionStorageInitialized());
+    REQUIRE(collect_loaded_profiles(dispatcher).empty());
+}
+
+TEST_CASE("Calibration storage restores last calibrated profile", "[calibration_storage]") {
+    MockFlashStorage flash_storage(10);
+    {
+        MockEventDispatcher dispatcher;
+        CalibrationStorage storage(dispatcher, flash_storage);
+        dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(15000, 30000), true));
+        dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(16000, 31000), true));
+        dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(1000, 2000), false));
+        REQUIRE(collect_loaded_profiles(dispatcher).empty());
+        REQUIRE(flash_storage.get_total_records() == 1);
+    }
+
+    MockEventDispatcher dispatcher;
+    CalibrationStorage storage(dispatcher, flash_storage);
+    dispatcher.emit_event(SessionStorageInitialized());
+
+    std::vector<RssiProfileLoaded> profiles = collect_loaded_profiles(dispatcher);
+    REQUIRE(profiles.size() == 1);
+    REQUIRE(profiles[0].get_profile() == RssiProfile(16000, 31000));
+}
+
+TEST_CASE("Calibration storage ignores incompatible record", "[calibration_storage]") {
+    MockFlashStorage flash_storage(10);
+    uint32_t record[2] = { 0xFFFFFFFF, 0x12345678 };
+    flash_storage.write_record(CalibrationStorage::CALIBRATION_FILE_ID, CalibrationStorage::RSSI_PROFILE_RECORD_ID, record, 2);
+
+    MockEventDispatcher dispatcher;
+    CalibrationStorage storage(dispatcher, flash_storage);
+    dispatcher.emit_event(SessionStorageInitialized());
+    REQUIRE(collect_loaded_profiles(dispatcher).empty());
+}
+
+TEST_CASE("Calibration storage keeps profiles of all channels", "[calibration_storage]") {
+    MockFlashStorage flash_storage(10);
+    {
+        MockEventDispatcher dispatcher;
+        CalibrationStorage storage(dispatcher, flash_storage);
+        dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(15000, 30000), true, 0));
+        dispatcher.emit_event(RssiCalibrationFinished(RssiProfile(16000, 31000), true, 3));
+        collect_loaded_profiles(dispatcher);
+    }
+
+    MockEventDispatcher dispatcher;
+    CalibrationStorage storage(dispatcher, flash_storage);
+    dispatcher.emit_event(SessionStorageInitialized());
+
+    std::vector<RssiProfileLoaded> profiles = collect_loaded_profiles(dispatcher);
+    REQUIRE(profiles.size() == 2);
+    REQUIRE(profiles[0] == RssiProfileLoaded(RssiProfile(15000, 30000), 0));
+    REQUIRE(profiles[1] == RssiProfileLoaded(RssiProfile(16000, 31000), 3));
+}
+
+TEST_CASE("Calibration storage restores learned pass templates", "[calibration_storage]") {
+    std::array<int8_t, PassTemplate::LENGTH> values;
+    for (uint8_t i = 0; i < PassTemplate::LENGTH; i++) {
+        values[i] = static_cast<int8_t>(i - PassTemplate::LENGTH / 2);
+    }
+    PassTemplate pass_template(values);
+
+    MockFlashStorage flash_storage(10);
+    {
+        MockEventDispatcher dispatcher;
+        CalibrationStorage storage(dispatcher, flash_storage);
+        REQUIRE(storage.save_pass_template(2, pass_template));
+        REQUIRE_FALSE(storage.save_pass_template(RssiReaderInterface::MAX_CHANNELS_COUNT, pass_template));
+        REQUIRE(flash_storage.get_total_records() == 1);
+    }
+
+    MockEventDispatcher dispatcher;
+    CalibrationStorage storage(dispatcher, flash_storage);
+    PassTemplate loaded;
+    REQUIRE_FALSE(storage.load_pass_template(0, loaded));
+    REQUIRE(storage.load_pass_template(2, loaded));
+    REQUIRE(loaded == pass_template);
+}
@@ -23,122 +23,6 @@
 #include "catch.hpp"
 #include "storage/mock_flash_storage.h"
 
-MockFlashStorage::MockFlashStorage(uint16_t record_capacity) : delegate(nullptr), total_records(0), record_capacity(record_capacity) {
-}
-
-void MockFlashStorage::set_delegate(Delegate *delegate) {
-    this->delegate = delegate;
-}
-
-void MockFlashStorage::initialize() {
-    if (delegate) {
-        delegate->on_initialized(true, *this);
-    }
-}
-
-bool MockFlashStorage::collect_garbage() {
-    if (delegate) {
-        delegate->on_garbage_collected(true);
-    }
-    return true;
-}
-
-bool MockFlashStorage::delete_all_files() {
-    total_records = 0;
-    file_map.clear();
-    if (delegate) {
-        delegate->on_all_files_deleted(true);
-    }
-    return true;
-}
-
-bool MockFlashStorage::delete_file(uint16_t file_id) {
-    bool deleted = false;
-    auto it = file_map.find(file_id);
-    
-    if (it != file_map.end()) {
-        deleted = true;
-        total_records -= it->second.size();
-        file_map.erase(file_id);
-    }
-
-    if (delegate) {
-        delegate->on_file_deleted(deleted, file_id);
-    }
-
-    return true;
-}
-
-bool MockFlashStorage::delete_record(uint16_t file_id, uint16_t record_id) {
-    bool deleted = false;
-    auto it = file_map.find(file_id);
-    if (it != file_map.end()) {
-        RecordMap& record_map = it->second;
-        if (record_map.erase(record_id) > 0) {
-            deleted = true;
-            total_records -= 1;
-        }
-    }
-
-    if (delegate) {
-        delegate->on_record_deleted(deleted, file_id, record_id);
-    }
-
-    return true;
-}
-
-bool MockFlashStorage::read_record(uint16_t file_id, uint16_t record_id, uint32_t* data, uint16_t *words_count) {
-    bool read = false;
-    auto file_it = file_map.find(file_id);
-    if (file_it != file_map.end()) {
-        auto record_it = file_it->second.find(record_id);
-        if (record_it != file_it->second.end()) {
-            std::vector<uint32_t>& record_data = record_it->second;
-            *words_count = std::min(*words_count, static_cast<uint16_t>(record_data.size()));
-            std::memcpy(data, record_data.data(), *words_count * 4);
-            read = true;
-        }
-    }
-
-    return read;
-}
-
-bool MockFlashStorage::write_record(uint16_t file_id, uint16_t record_id, const uint32_t* data, uint16_t words_count) {
-    bool wrote = true;
-    RecordMap& record_map = file_map[file_id];
-    if (record_map.find(record_id) == record_map.end()) {
-        if (total_records >= record_capacity) {
-            wrote = false;
-        } else {
-            total_records++;
-        }
-    }
-
-    if (wrote) {
-        std::vector<uint32_t>& record_data = record_map[record_id];
-        record_data.resize(std::max(words_count, static_cast<uint16_t>(record_data.size())));
-        std::memcpy(record_data.data(), data, words_count * 4);
-    }
-
-    if (delegate) {
-        delegate->on_record_written(wrote, file_id, record_id);
-    }
-
-    return true;
-}
-
-bool MockFlashStorage::iterate_records(std::function<void(uint16_t file_id, uint16_t record_id, const uint32_t* record_data, uint16_t record_data_length)> callback) {
-    for (auto file_it = file_map.begin(); file_it != file_map.end(); file_it++) {
-        const RecordMap& record_map = file_it->second;
-        for (auto record_it = record_map.begin(); record_it != record_map.end(); record_it++) {
-            callback(file_it->first, record_it->first, record_it->second.data(), static_cast<uint16_t>(record_it->second.size()));
-        }
-    }
-    return true;
-}
-
-// TESTS
-
 class MockStorageDelegate : public FlashStorageInterface::Delegate {
 public:
     MockStorageDelegate() :
@@ -0,0 +1,97 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "storage/session_storage.h"
+#include "storage/mock_flash_storage.h"
+#include "events/mock_event_dispatcher.h"
+
+#include <vector>
+
+static std::vector<AddLapTime> collect_lap_times(MockEventDispatcher& dispatcher) {
+    std::vector<AddLapTime> lap_times;
+    while (auto event = dispatcher.process_next_event()) {
+        if (auto lap_time = std::get_if<AddLapTime>(&*event)) {
+            lap_times.push_back(*lap_time);
+        }
+    }
+    return lap_times;
+}
+
+TEST_CASE("Session storage measures lap times between passes", "[session_storage]") {
+    MockFlashStorage flash_storage(10);
+    MockEventDispatcher dispatcher;
+    SessionStorage storage(dispatcher, flash_storage);
+
+    // Passes outside of a session are not laps.
+    dispatcher.emit_event(NewLap(1000, 0, 0));
+    dispatcher.emit_event(StartSession());
+    dispatcher.emit_event(NewLap(2000, 0, 0));
+    dispatcher.emit_event(NewLap(2500, 0, 1));
+    dispatcher.emit_event(NewLap(32000, 500, 0, PassSignature(50000, 200, 1000, 900, 80)));
+    dispatcher.emit_event(NewLap(33500, 0, 1));
+
+    std::vector<AddLapTime> lap_times = collect_lap_times(dispatcher);
+    REQUIRE(lap_times.size() == 2);
+    REQUIRE(lap_times[0] == AddLapTime(30000, PassSignature(50000, 200, 1000, 900, 80), 0));
+    REQUIRE(lap_times[1] == AddLapTime(31000, PassSignature(), 1));
+}
+
+TEST_CASE("Session storage keeps pass signature of each lap", "[session_storage]") {
+    MockFlashStorage flash_storage(10);
+    MockEventDispatcher dispatcher;
+    SessionStorage storage(dispatcher, flash_storage);
+
+    dispatcher.emit_event(StartSession());
+    dispatcher.emit_event(AddLapTime(30000, PassSignature(50000, 200, 1000, 900, 80), 2));
+    dispatcher.emit_event(AddLapTime(31000));
+    collect_lap_times(dispatcher);
+    REQUIRE(flash_storage.get_total_records() == 2);
+
+    uint32_t lap_time = 0;
+    PassSignature signature;
+    uint8_t channel = 0;
+    REQUIRE(storage.load_lap(1, 1, lap_time, signature, channel));
+    REQUIRE(lap_time == 30000);
+    REQUIRE(signature == PassSignature(50000, 200, 1000, 900, 80));
+    REQUIRE(channel == 2);
+
+    REQUIRE(storage.load_lap(1, 2, lap_time, signature, channel));
+    REQUIRE(lap_time == 31000);
+    REQUIRE(signature == PassSignature());
+    REQUIRE(channel == 0);
+
+    REQUIRE_FALSE(storage.load_lap(1, 3, lap_time, signature, channel));
+}
+
+TEST_CASE("Session storage ignores laps after session is stopped", "[session_storage]") {
+    MockFlashStorage flash_storage(10);
+    MockEventDispatcher dispatcher;
+    SessionStorage storage(dispatcher, flash_storage);
+
+    dispatcher.emit_event(AddLapTime(30000));
+    dispatcher.emit_event(StartSession());
+    dispatcher.emit_event(StopSession());
+    dispatcher.emit_event(AddLapTime(31000));
+    collect_lap_times(dispatcher);
+    REQUIRE(flash_storage.get_total_records() == 0);
+}
@@ -0,0 +1,127 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "telemetry/telemetry_frame.h"
+#include "utils/byte_utils.h"
+#include "utils/crc16.h"
+
+#include <vector>
+
+static TelemetryFrame round_trip(const TelemetryFrame& frame) {
+    uint8_t buffer[TelemetryFrame::MAX_ENCODED_LENGTH];
+    size_t length = frame.encode(buffer, sizeof(buffer));
+    REQUIRE(length > 0);
+    REQUIRE(buffer[length - 1] == TelemetryFrame::DELIMITER);
+    for (size_t i = 0; i < length - 1; i++) {
+        REQUIRE(buffer[i] != TelemetryFrame::DELIMITER);
+    }
+
+    TelemetryFrame decoded;
+    REQUIRE(decoded.decode(buffer, length - 1));
+    return decoded;
+}
+
+TEST_CASE("Telemetry frame survives encoding", "[telemetry]") {
+    std::vector<uint16_t> samples = { 0, 65535, 0, 36100, 36101, 36099, 100, 100, 20000 };
+    TelemetryFrame frame(3, 0xBEEF, 0x12345678, 7);
+    REQUIRE(frame.set_samples(samples.data(), samples.size()) == samples.size());
+
+    TelemetryFrame decoded = round_trip(frame);
+    REQUIRE(decoded.get_channel() == 3);
+    REQUIRE(decoded.get_sequence() == 0xBEEF);
+    REQUIRE(decoded.get_first_sample_tick() == 0x12345678);
+    REQUIRE(decoded.get_dropped_frames() == 7);
+    REQUIRE(decoded.get_tick_stride() == 1);
+    REQUIRE(std::vector<uint16_t>(decoded.get_samples(), decoded.get_samples() + decoded.get_samples_count()) == samples);
+}
+
+TEST_CASE("Telemetry frame carries tick stride", "[telemetry]") {
+    std::vector<uint16_t> samples = { 100, 200, 300 };
+    TelemetryFrame frame(1, 2, 3000, 0, 4);
+    frame.set_samples(samples.data(), samples.size());
+
+    TelemetryFrame decoded = round_trip(frame);
+    REQUIRE(decoded.get_first_sample_tick() == 3000);
+    REQUIRE(decoded.get_tick_stride() == 4);
+    REQUIRE(decoded.get_samples_count() == 3);
+
+    frame = TelemetryFrame(1, 2, 3000, 0, 0);
+    uint8_t buffer[TelemetryFrame::MAX_ENCODED_LENGTH];
+    size_t length = frame.encode(buffer, sizeof(buffer));
+    REQUIRE(!decoded.decode(buffer, length - 1));
+}
+
+TEST_CASE("Telemetry frame decodes frames without tick stride", "[telemetry]") {
+    // Version 1 frame of channel 2, sequence 5, tick 1000 and samples 10, 12.
+    uint8_t frame[] = { TelemetryFrame::UNSTRIDED_VERSION, 2, 5, 0, 0xE8, 0x03, 0, 0, 0, 0, 2, 20, 4, 0, 0 };
+    write_uint16_le(crc16_ccitt(frame, sizeof(frame) - 2), frame + sizeof(frame) - 2);
+    uint8_t buffer[TelemetryFrame::MAX_ENCODED_LENGTH];
+    size_t length = cobs_encode(frame, sizeof(frame), buffer, sizeof(buffer));
+
+    TelemetryFrame decoded;
+    REQUIRE(decoded.decode(buffer, length));
+    REQUIRE(decoded.get_channel() == 2);
+    REQUIRE(decoded.get_sequence() == 5);
+    REQUIRE(decoded.get_first_sample_tick() == 1000);
+    REQUIRE(decoded.get_tick_stride() == 1);
+    REQUIRE(std::vector<uint16_t>(decoded.get_samples(), decoded.get_samples() + decoded.get_samples_count()) == std::vector<uint16_t>{ 10, 12 });
+}
+
+TEST_CASE("Telemetry frame packs slowly changing samples", "[telemetry]") {
+    std::vector<uint16_t> samples(TelemetryFrame::MAX_SAMPLES);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = 30000 + (i % 8) * 4;
+    }
+    TelemetryFrame frame;
+    frame.set_samples(samples.data(), samples.size() + 10);
+    REQUIRE(frame.get_samples_count() == TelemetryFrame::MAX_SAMPLES);
+
+    uint8_t buffer[TelemetryFrame::MAX_ENCODED_LENGTH];
+    size_t length = frame.encode(buffer, sizeof(buffer));
+    // Small differences take a single byte instead of two bytes of a raw sample.
+    REQUIRE(length < TelemetryFrame::HEADER_LENGTH + TelemetryFrame::MAX_SAMPLES + 8);
+}
+
+TEST_CASE("Telemetry frame detects corruption", "[telemetry]") {
+    std::vector<uint16_t> samples = { 100, 200, 300 };
+    TelemetryFrame frame(0, 1, 2, 0);
+    frame.set_samples(samples.data(), samples.size());
+
+    uint8_t buffer[TelemetryFrame::MAX_ENCODED_LENGTH];
+    size_t length = frame.encode(buffer, sizeof(buffer)) - 1;
+
+    for (size_t i = 0; i < length; i++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            uint8_t corrupted[TelemetryFrame::MAX_ENCODED_LENGTH];
+            std::copy(buffer, buffer + length, corrupted);
+            corrupted[i] ^= 1 << bit;
+            TelemetryFrame decoded;
+            REQUIRE(!decoded.decode(corrupted, length));
+        }
+    }
+
+    TelemetryFrame decoded;
+    REQUIRE(!decoded.decode(buffer, length - 1));
+    REQUIRE(frame.encode(buffer, 10) == 0);
+}
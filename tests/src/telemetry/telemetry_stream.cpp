@@ -0,0 +1,140 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "telemetry/telemetry_stream.h"
+
+#include <vector>
+
+static std::vector<TelemetryFrame> receive(std::vector<uint8_t>& received) {
+    std::vector<TelemetryFrame> frames;
+    auto begin = received.begin();
+    for (auto it = received.begin(); it != received.end(); it++) {
+        if (*it == TelemetryFrame::DELIMITER) {
+            TelemetryFrame frame;
+            REQUIRE(frame.decode(&*begin, it - begin));
+            frames.push_back(frame);
+            begin = it + 1;
+        }
+    }
+    received.erase(received.begin(), begin);
+    return frames;
+}
+
+template<size_t N>
+static void transmit(TelemetryStream<N>& stream, std::vector<uint8_t>& received, size_t max_chunk) {
+    const uint8_t* data;
+    while (size_t length = stream.get_pending(&data)) {
+        length = std::min(length, max_chunk);
+        received.insert(received.end(), data, data + length);
+        stream.consume(length);
+    }
+}
+
+TEST_CASE("Telemetry stream splits samples into frames", "[telemetry]") {
+    TelemetryStream<1024> stream;
+    std::vector<uint16_t> samples(150);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = static_cast<uint16_t>(i * 100);
+    }
+
+    REQUIRE(stream.is_empty());
+    REQUIRE(stream.push_samples(2, samples.data(), samples.size(), 1000, 1));
+    REQUIRE(!stream.is_empty());
+    REQUIRE(stream.get_pushed_frames() == 3);
+
+    std::vector<uint8_t> received;
+    transmit(stream, received, 7);
+    REQUIRE(stream.is_empty());
+
+    std::vector<TelemetryFrame> frames = receive(received);
+    REQUIRE(frames.size() == 3);
+    std::vector<uint16_t> received_samples;
+    for (size_t i = 0; i < frames.size(); i++) {
+        REQUIRE(frames[i].get_channel() == 2);
+        REQUIRE(frames[i].get_sequence() == i);
+        REQUIRE(frames[i].get_first_sample_tick() == 1000 + i * TelemetryFrame::MAX_SAMPLES);
+        received_samples.insert(received_samples.end(), frames[i].get_samples(), frames[i].get_samples() + frames[i].get_samples_count());
+    }
+    REQUIRE(received_samples == samples);
+}
+
+TEST_CASE("Telemetry stream keeps tick stride of samples", "[telemetry]") {
+    TelemetryStream<1024> stream;
+    std::vector<uint16_t> samples(100, 500);
+    REQUIRE(stream.push_samples(0, samples.data(), samples.size(), 40, 4));
+
+    std::vector<uint8_t> received;
+    transmit(stream, received, 1024);
+    std::vector<TelemetryFrame> frames = receive(received);
+    REQUIRE(frames.size() == 2);
+    REQUIRE(frames[0].get_first_sample_tick() == 40);
+    REQUIRE(frames[1].get_first_sample_tick() == 40 + TelemetryFrame::MAX_SAMPLES * 4);
+    REQUIRE(frames[1].get_tick_stride() == 4);
+}
+
+TEST_CASE("Telemetry stream drops and reports frames which don't fit", "[telemetry]") {
+    TelemetryStream<512> stream;
+    std::vector<uint16_t> samples(TelemetryFrame::MAX_SAMPLES);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i] = static_cast<uint16_t>(i * 1000);
+    }
+
+    // Consumer is stalled, some frames are dropped.
+    uint32_t tick = 0;
+    for (size_t i = 0; i < 6; i++) {
+        stream.push_samples(0, samples.data(), samples.size(), tick, 1);
+        tick += samples.size();
+    }
+    REQUIRE(stream.get_dropped_frames() > 0);
+    REQUIRE(stream.get_pushed_frames() + stream.get_dropped_frames() == 6);
+    uint32_t dropped = stream.get_dropped_frames();
+
+    std::vector<uint8_t> received;
+    transmit(stream, received, 1000);
+    REQUIRE(stream.push_samples(0, samples.data(), samples.size(), tick, 1));
+    transmit(stream, received, 1000);
+
+    std::vector<TelemetryFrame> frames = receive(received);
+    REQUIRE(frames.size() == stream.get_pushed_frames());
+    // Sequence gap and counter in the last frame tell the receiver how many frames were lost.
+    TelemetryFrame& last = frames.back();
+    REQUIRE(last.get_sequence() == 6);
+    REQUIRE(last.get_dropped_frames() == dropped);
+    REQUIRE(last.get_sequence() + 1 - frames.size() == dropped);
+}
+
+TEST_CASE("Telemetry stream wraps around the buffer", "[telemetry]") {
+    TelemetryStream<300> stream;
+    std::vector<uint16_t> samples = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    std::vector<uint8_t> received;
+
+    for (uint32_t i = 0; i < 100; i++) {
+        REQUIRE(stream.push_samples(1, samples.data(), samples.size(), i, 1));
+        transmit(stream, received, 13);
+        std::vector<TelemetryFrame> frames = receive(received);
+        REQUIRE(frames.size() == 1);
+        REQUIRE(frames[0].get_sequence() == i);
+    }
+    REQUIRE(stream.get_dropped_frames() == 0);
+}
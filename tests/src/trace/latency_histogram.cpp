@@ -0,0 +1,77 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "trace/latency_histogram.h"
+
+TEST_CASE("Latency histogram is empty at start", "[latency_histogram]") {
+    LatencyHistogram histogram;
+    REQUIRE(histogram.get_count() == 0);
+    REQUIRE(histogram.get_min_us() == 0);
+    REQUIRE(histogram.get_max_us() == 0);
+    REQUIRE(histogram.get_percentile_us(50) == 0);
+}
+
+TEST_CASE("Latency histogram buckets cover the whole range", "[latency_histogram]") {
+    for (size_t bucket = 0; bucket < LatencyHistogram::BUCKETS_COUNT; bucket++) {
+        uint32_t start = LatencyHistogram::get_bucket_start(bucket);
+        REQUIRE(LatencyHistogram::get_bucket(start) == bucket);
+        if (bucket > 0) {
+            REQUIRE(LatencyHistogram::get_bucket(start - 1) == bucket - 1);
+        }
+    }
+    REQUIRE(LatencyHistogram::get_bucket(UINT32_MAX) == LatencyHistogram::BUCKETS_COUNT - 1);
+}
+
+TEST_CASE("Latency histogram reports percentiles within a bucket", "[latency_histogram]") {
+    LatencyHistogram histogram;
+    for (uint32_t latency_us = 1; latency_us <= 1000; latency_us++) {
+        histogram.add(latency_us);
+    }
+    REQUIRE(histogram.get_count() == 1000);
+    REQUIRE(histogram.get_min_us() == 1);
+    REQUIRE(histogram.get_max_us() == 1000);
+
+    // Buckets are at most 25% wide.
+    uint32_t p50 = histogram.get_percentile_us(50);
+    REQUIRE(p50 >= 500);
+    REQUIRE(p50 < 500 * 5 / 4);
+    uint32_t p99 = histogram.get_percentile_us(99);
+    REQUIRE(p99 >= 990);
+    REQUIRE(p99 <= 1000);
+    REQUIRE(histogram.get_percentile_us(100) == 1000);
+
+    histogram.reset();
+    REQUIRE(histogram.get_count() == 0);
+}
+
+TEST_CASE("Latency histogram reports outliers in p99 only", "[latency_histogram]") {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 98; i++) {
+        histogram.add(100);
+    }
+    histogram.add(100000);
+    histogram.add(100000);
+    REQUIRE(histogram.get_percentile_us(50) < 100 * 5 / 4);
+    REQUIRE(histogram.get_percentile_us(98) < 100 * 5 / 4);
+    REQUIRE(histogram.get_percentile_us(99) == 100000);
+}
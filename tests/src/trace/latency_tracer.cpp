@@ -0,0 +1,91 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "trace/latency_tracer.h"
+#include "events/mock_event_dispatcher.h"
+#include "time/mock_cycle_counter.h"
+
+static constexpr uint8_t SAADC_PRIORITY = 6;
+
+static void trace_lap(LatencyTracer& tracer, MockCycleCounter& counter, MockEventDispatcher& dispatcher,
+                      uint32_t queue_us, uint32_t detection_us, uint32_t dispatch_us) {
+    counter.set_execution_priority(SAADC_PRIORITY);
+    uint32_t captured_cycles = tracer.get_cycles();
+    uint8_t captured_priority = tracer.get_execution_priority();
+    counter.set_execution_priority(CycleCounterInterface::THREAD_PRIORITY);
+    counter.advance_us(queue_us);
+    tracer.on_block_processing(captured_cycles, captured_priority);
+    counter.advance_us(detection_us);
+    tracer.on_lap_detected();
+    dispatcher.emit_event(NewLap(1000, 0, 0));
+    counter.advance_us(dispatch_us);
+    while (dispatcher.process_next_event());
+}
+
+TEST_CASE("Latency tracer measures each stage of a lap", "[latency_tracer]") {
+    MockCycleCounter counter;
+    MockEventDispatcher dispatcher;
+    LatencyTracer tracer(dispatcher, counter);
+
+    trace_lap(tracer, counter, dispatcher, 300, 50, 20);
+
+    REQUIRE(tracer.get_histogram(LatencyTracer::LATENCY_STAGE_QUEUE).get_max_us() == 300);
+    REQUIRE(tracer.get_histogram(LatencyTracer::LATENCY_STAGE_DETECTION).get_max_us() == 50);
+    REQUIRE(tracer.get_histogram(LatencyTracer::LATENCY_STAGE_DISPATCH).get_max_us() == 20);
+    REQUIRE(tracer.get_histogram(LatencyTracer::LATENCY_STAGE_TOTAL).get_max_us() == 370);
+    REQUIRE(tracer.get_priority(LatencyTracer::LATENCY_STAGE_QUEUE) == SAADC_PRIORITY);
+    REQUIRE(tracer.get_priority(LatencyTracer::LATENCY_STAGE_DETECTION) == CycleCounterInterface::THREAD_PRIORITY);
+}
+
+TEST_CASE("Latency tracer survives cycle counter wrap-around", "[latency_tracer]") {
+    MockCycleCounter counter;
+    MockEventDispatcher dispatcher;
+    LatencyTracer tracer(dispatcher, counter);
+
+    counter.set_cycles(UINT32_MAX - 64 * 100);
+    trace_lap(tracer, counter, dispatcher, 300, 50, 20);
+    REQUIRE(tracer.get_histogram(LatencyTracer::LATENCY_STAGE_TOTAL).get_max_us() == 370);
+}
+
+TEST_CASE("Latency tracer ends the trace when observers receive the lap", "[latency_tracer]") {
+    MockCycleCounter counter;
+    MockEventDispatcher dispatcher;
+    LatencyTracer tracer(dispatcher, counter);
+
+    // Laps which weren't detected with the tracer are not traced.
+    dispatcher.emit_event(NewLap(1000, 0, 0));
+    while (dispatcher.process_next_event());
+    REQUIRE(tracer.get_histogram(LatencyTracer::LATENCY_STAGE_TOTAL).get_count() == 0);
+
+    trace_lap(tracer, counter, dispatcher, 300, 50, 20);
+    // Only the first NewLap after detection belongs to the trace.
+    counter.advance_us(5000);
+    dispatcher.emit_event(NewLap(2000, 0, 0));
+    while (dispatcher.process_next_event());
+    const LatencyHistogram& total = tracer.get_histogram(LatencyTracer::LATENCY_STAGE_TOTAL);
+    REQUIRE(total.get_count() == 1);
+    REQUIRE(total.get_max_us() == 370);
+
+    tracer.reset();
+    REQUIRE(total.get_count() == 0);
+}
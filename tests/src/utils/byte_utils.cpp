@@ -23,6 +23,8 @@
 #include "catch.hpp"
 #include "utils/byte_utils.h"
 
+#include <cstring>
+
 TEST_CASE("Byte utils properly parses to the binary form", "[byte_utils]") {
     const size_t data_len = 4;
     const uint8_t data[data_len] = { 0xAA, 0x3D, 0x02, 0x80 };
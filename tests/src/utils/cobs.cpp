@@ -0,0 +1,90 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "utils/cobs.h"
+
+#include <vector>
+
+static std::vector<uint8_t> encode(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> output(cobs_max_encoded_length(data.size()));
+    output.resize(cobs_encode(data.data(), data.size(), output.data(), output.size()));
+    return output;
+}
+
+static std::vector<uint8_t> decode(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> output(data.size());
+    output.resize(cobs_decode(data.data(), data.size(), output.data(), output.size()));
+    return output;
+}
+
+TEST_CASE("COBS encodes reference vectors", "[cobs]") {
+    REQUIRE(encode({ 0x00 }) == std::vector<uint8_t>{ 0x01, 0x01 });
+    REQUIRE(encode({ 0x00, 0x00 }) == std::vector<uint8_t>{ 0x01, 0x01, 0x01 });
+    REQUIRE(encode({ 0x11, 0x22, 0x00, 0x33 }) == std::vector<uint8_t>{ 0x03, 0x11, 0x22, 0x02, 0x33 });
+    REQUIRE(encode({ 0x11, 0x22, 0x33, 0x44 }) == std::vector<uint8_t>{ 0x05, 0x11, 0x22, 0x33, 0x44 });
+    REQUIRE(encode({ 0x11, 0x00, 0x00, 0x00 }) == std::vector<uint8_t>{ 0x02, 0x11, 0x01, 0x01, 0x01 });
+}
+
+TEST_CASE("COBS encodes long blocks", "[cobs]") {
+    std::vector<uint8_t> data(254);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i + 1);
+    }
+    std::vector<uint8_t> encoded = encode(data);
+    REQUIRE(encoded.size() == 255);
+    REQUIRE(encoded[0] == 0xFF);
+
+    data.push_back(0x01);
+    encoded = encode(data);
+    REQUIRE(encoded.size() == 257);
+    REQUIRE(encoded[255] == 0x02);
+}
+
+TEST_CASE("COBS decodes what it encodes", "[cobs]") {
+    for (size_t length : { 1, 10, 253, 254, 255, 600 }) {
+        for (uint8_t zero_every : { 1, 3, 0 }) {
+            std::vector<uint8_t> data(length);
+            for (size_t i = 0; i < length; i++) {
+                data[i] = (zero_every != 0 && i % zero_every == 0) ? 0 : static_cast<uint8_t>(i % 255 + 1);
+            }
+            std::vector<uint8_t> encoded = encode(data);
+            REQUIRE(encoded.size() <= cobs_max_encoded_length(length));
+            for (uint8_t byte : encoded) {
+                REQUIRE(byte != 0);
+            }
+            REQUIRE(decode(encoded) == data);
+        }
+    }
+}
+
+TEST_CASE("COBS rejects malformed data and small buffers", "[cobs]") {
+    uint8_t output[4];
+    uint8_t too_long[] = { 0x05, 0x11, 0x22 };
+    REQUIRE(cobs_decode(too_long, sizeof(too_long), output, sizeof(output)) == 0);
+    uint8_t with_zero[] = { 0x03, 0x11, 0x00 };
+    REQUIRE(cobs_decode(with_zero, sizeof(with_zero), output, sizeof(output)) == 0);
+
+    uint8_t data[] = { 0x11, 0x22, 0x33, 0x44 };
+    REQUIRE(cobs_encode(data, sizeof(data), output, sizeof(output)) == 0);
+}
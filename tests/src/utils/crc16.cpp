@@ -0,0 +1,39 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "utils/crc16.h"
+
+#include <cstring>
+
+TEST_CASE("CRC16 matches reference check value", "[crc16]") {
+    const char* data = "123456789";
+    REQUIRE(crc16_ccitt(reinterpret_cast<const uint8_t*>(data), std::strlen(data)) == 0x29B1);
+    REQUIRE(crc16_ccitt(nullptr, 0) == 0xFFFF);
+}
+
+TEST_CASE("CRC16 can be calculated in chunks", "[crc16]") {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>("123456789");
+    uint16_t crc = crc16_ccitt(data, 4);
+    REQUIRE(crc16_ccitt(data + 4, 5, crc) == 0x29B1);
+}
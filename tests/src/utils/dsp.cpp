@@ -0,0 +1,136 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "catch.hpp"
+#include "rssi/rssi_pipeline.h"
+#include "utils/dsp.h"
+
+#include <random>
+#include <vector>
+
+static std::vector<uint16_t> make_samples(size_t count, uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<uint32_t> distribution(0, UINT16_MAX);
+    std::vector<uint16_t> samples(count);
+    for (uint16_t& sample : samples) {
+        sample = static_cast<uint16_t>(distribution(generator));
+    }
+    // Extremes are the usual overflow suspects.
+    samples[0] = UINT16_MAX;
+    samples[1] = UINT16_MAX;
+    samples[2] = 0;
+    return samples;
+}
+
+TEST_CASE("DSP decimation matches RSSI decimation stage", "[dsp]") {
+    for (size_t count : { 4, 5, 6, 7, 101 }) {
+        std::vector<uint16_t> samples = make_samples(count, count);
+        std::vector<uint16_t> packed(count / 2);
+        std::vector<uint16_t> scalar(count / 2);
+        REQUIRE(dsp_decimate2(samples.data(), count, packed.data()) == count / 2);
+        REQUIRE(dsp_decimate2_scalar(samples.data(), count, scalar.data()) == count / 2);
+        REQUIRE(packed == scalar);
+
+        RssiDecimate<2> stage;
+        std::vector<uint16_t> expected;
+        for (size_t i = 0; i < count; i++) {
+            uint16_t sample = samples[i];
+            uint32_t tick = i;
+            if (stage.process(sample, tick)) {
+                expected.push_back(sample);
+            }
+        }
+        REQUIRE(packed == expected);
+    }
+}
+
+TEST_CASE("DSP decimation works in place and on unaligned buffers", "[dsp]") {
+    std::vector<uint16_t> samples = make_samples(65, 1);
+    std::vector<uint16_t> expected(32);
+    dsp_decimate2_scalar(samples.data() + 1, 64, expected.data());
+
+    std::vector<uint16_t> in_place(samples.begin() + 1, samples.end());
+    dsp_decimate2(in_place.data(), 64, in_place.data());
+    REQUIRE(std::equal(expected.begin(), expected.end(), in_place.begin()));
+
+    std::vector<uint16_t> unaligned(33);
+    dsp_decimate2(samples.data() + 1, 64, unaligned.data() + 1);
+    REQUIRE(std::equal(expected.begin(), expected.end(), unaligned.begin() + 1));
+}
+
+TEST_CASE("DSP finds the first sample above the level", "[dsp]") {
+    std::vector<uint16_t> samples(9, 1000);
+    REQUIRE(dsp_find_above(samples.data(), samples.size(), 1000) == samples.size());
+    REQUIRE(dsp_find_above(samples.data(), samples.size(), 999) == 0);
+    REQUIRE(dsp_find_above(samples.data(), samples.size(), UINT16_MAX) == samples.size());
+
+    for (size_t i = 0; i < samples.size(); i++) {
+        std::vector<uint16_t> step = samples;
+        step[i] = 1001;
+        REQUIRE(dsp_find_above(step.data(), step.size(), 1000) == i);
+        REQUIRE(dsp_find_above(step.data() + 1, step.size() - 1, 1000) == (i > 0 ? i - 1 : step.size() - 1));
+    }
+
+    std::vector<uint16_t> random = make_samples(1000, 2);
+    for (uint16_t level : { 0, 1, 30000, 65000, 65534 }) {
+        REQUIRE(dsp_find_above(random.data() + 3, random.size() - 3, level) == dsp_find_above_scalar(random.data() + 3, random.size() - 3, level));
+    }
+}
+
+TEST_CASE("DSP FIR matches scalar reference across blocks", "[dsp]") {
+    const std::vector<uint16_t> samples = make_samples(1000, 3);
+
+    auto check = [&samples](auto packed, auto scalar) {
+        packed.prime(samples[0]);
+        scalar.prime(samples[0]);
+        std::vector<uint16_t> packed_output(samples.size());
+        std::vector<uint16_t> scalar_output(samples.size());
+        // Blocks of various lengths, including longer than a chunk.
+        size_t offset = 0;
+        for (size_t length = 1; offset < samples.size(); length = length * 3 % 71 + 1) {
+            length = std::min(length, samples.size() - offset);
+            packed.process_block(samples.data() + offset, length, packed_output.data() + offset);
+            scalar.process_block_scalar(samples.data() + offset, length, scalar_output.data() + offset);
+            offset += length;
+        }
+        REQUIRE(packed_output == scalar_output);
+    };
+
+    check(DspFir<1>({32767}), DspFir<1>({32767}));
+    check(DspFir<4>({8192, 8192, 8192, 8192}), DspFir<4>({8192, 8192, 8192, 8192}));
+    // Overshooting taps have to saturate.
+    check(DspFir<5>({-4000, 20000, 32767, 20000, -4000}), DspFir<5>({-4000, 20000, 32767, 20000, -4000}));
+    check(DspFir<8>({-32768, 32767, -32768, 32767, 32767, -32768, 32767, 1}), DspFir<8>({-32768, 32767, -32768, 32767, 32767, -32768, 32767, 1}));
+}
+
+TEST_CASE("DSP FIR averages and keeps DC", "[dsp]") {
+    DspFir<4> fir({8192, 8192, 8192, 8192});
+    fir.prime(1000);
+    std::vector<uint16_t> samples = {1000, 1000, 5000, 5000, 5000, 5000, 5000};
+    fir.process_block(samples.data(), samples.size(), samples.data());
+    REQUIRE(samples == std::vector<uint16_t>({1000, 1000, 2000, 3000, 4000, 5000, 5000}));
+
+    DspFir<3> gain({32767, 32767, 32767});
+    std::vector<uint16_t> saturated = {UINT16_MAX, UINT16_MAX, UINT16_MAX};
+    gain.process_block(saturated.data(), saturated.size(), saturated.data());
+    REQUIRE(saturated.back() == UINT16_MAX);
+}
@@ -0,0 +1,84 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "utils/median_filter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+template<uint8_t ORDER>
+static void check_against_sorted_window(uint32_t seed, uint16_t value_range) {
+    MedianFilter<uint16_t, ORDER> filter;
+    std::deque<uint16_t> window(ORDER, 0);
+    std::srand(seed);
+
+    for (size_t i = 0; i < 4 * 1024; i++) {
+        uint16_t sample = static_cast<uint16_t>(std::rand() % value_range);
+        window.pop_front();
+        window.push_back(sample);
+
+        std::vector<uint16_t> sorted(window.begin(), window.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        REQUIRE(filter.process(sample) == sorted[ORDER / 2]);
+    }
+}
+
+TEST_CASE("Median filter returns initial value until window is replaced", "[median_filter]") {
+    MedianFilter<uint16_t, 5> filter(100);
+    REQUIRE(filter.order() == 5);
+    REQUIRE(filter.median() == 100);
+    REQUIRE(filter.process(200) == 100);
+    REQUIRE(filter.process(200) == 100);
+    REQUIRE(filter.process(200) == 200);
+    REQUIRE(filter.process(0) == 200);
+    REQUIRE(filter.process(0) == 200);
+    REQUIRE(filter.process(0) == 0);
+
+    filter.reset(7);
+    REQUIRE(filter.median() == 7);
+}
+
+TEST_CASE("Median filter of order 1 passes samples through", "[median_filter]") {
+    MedianFilter<uint16_t, 1> filter;
+    REQUIRE(filter.process(10) == 10);
+    REQUIRE(filter.process(3) == 3);
+    REQUIRE(filter.process(65535) == 65535);
+}
+
+TEST_CASE("Median filter matches sorted window", "[median_filter]") {
+    check_against_sorted_window<3>(1, 65535);
+    check_against_sorted_window<5>(2, 65535);
+    check_against_sorted_window<31>(3, 65535);
+    check_against_sorted_window<127>(4, 65535);
+    check_against_sorted_window<255>(5, 65535);
+}
+
+TEST_CASE("Median filter matches sorted window with repeated values", "[median_filter]") {
+    check_against_sorted_window<5>(6, 4);
+    check_against_sorted_window<31>(7, 8);
+    check_against_sorted_window<255>(8, 16);
+}
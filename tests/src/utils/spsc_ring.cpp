@@ -0,0 +1,86 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "catch.hpp"
+#include "utils/spsc_ring.h"
+
+TEST_CASE("SPSC ring pushes and pops items in order", "[spsc_ring]") {
+    SpscRing<int, 4> ring;
+    REQUIRE(ring.is_empty());
+    REQUIRE(ring.front() == nullptr);
+
+    REQUIRE(ring.push(1));
+    REQUIRE(ring.push(2));
+    REQUIRE(ring.get_size() == 2);
+    REQUIRE(*ring.front() == 1);
+    ring.pop();
+    REQUIRE(*ring.front() == 2);
+    ring.pop();
+    REQUIRE(ring.is_empty());
+
+    // Wrap around.
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(ring.push(i));
+        REQUIRE(*ring.front() == i);
+        ring.pop();
+    }
+    REQUIRE(ring.is_empty());
+    REQUIRE(ring.get_overflows() == 0);
+    REQUIRE(ring.get_high_water_mark() == 2);
+}
+
+TEST_CASE("SPSC ring counts overflows", "[spsc_ring]") {
+    SpscRing<int, 4> ring;
+
+    for (int i = 0; i < 6; i++) {
+        ring.push(i);
+    }
+    REQUIRE(ring.get_size() == 4);
+    REQUIRE(ring.get_overflows() == 2);
+    REQUIRE(ring.get_high_water_mark() == 4);
+
+    // Dropped items are the newest ones.
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(*ring.front() == i);
+        ring.pop();
+    }
+    REQUIRE(ring.is_empty());
+    REQUIRE(ring.get_high_water_mark() == 4);
+}
+
+TEST_CASE("SPSC ring fills items in place", "[spsc_ring]") {
+    SpscRing<int, 2> ring;
+
+    int* slot = ring.reserve();
+    REQUIRE(slot != nullptr);
+    *slot = 7;
+    // Item is not visible until committed.
+    REQUIRE(ring.is_empty());
+    ring.commit();
+    REQUIRE(*ring.front() == 7);
+
+    REQUIRE(ring.reserve() != nullptr);
+    ring.commit();
+    REQUIRE(ring.reserve() == nullptr);
+    REQUIRE(ring.get_overflows() == 1);
+}
@@ -0,0 +1,82 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "events/mock_event_dispatcher.h"
+
+#include <algorithm>
+#include <cassert>
+
+std::optional<Event> MockEventDispatcher::process_next_event() {
+    if (events_queue.is_empty()) {
+        return std::nullopt;
+    }
+
+    Event event;
+    current_time_ms = std::max<int32_t>(events_queue.get_next_deadline() - current_time_ms, 0) + current_time_ms;
+    events_queue.pop_due(current_time_ms, event);
+
+    subscriptions.dispatch(event);
+
+    return event;
+}
+
+size_t MockEventDispatcher::process_events_until(uint32_t time_ms) {
+    size_t processed_events = 0;
+    while (!events_queue.is_empty() && static_cast<int32_t>(events_queue.get_next_deadline() - time_ms) <= 0) {
+        process_next_event();
+        processed_events++;
+    }
+    current_time_ms = time_ms;
+    return processed_events;
+}
+
+bool MockEventDispatcher::register_observer(EventObserver* observer, EventMask events) {
+    return subscriptions.subscribe(observer, events);
+}
+
+bool MockEventDispatcher::unregister_observer(EventObserver* observer) {
+    return subscriptions.unsubscribe(observer);
+}
+
+void MockEventDispatcher::emit_event(const Event& event) {
+    [[maybe_unused]] EventHandle handle = events_queue.push(event, current_time_ms);
+    assert(handle != INVALID_EVENT_HANDLE);
+}
+
+EventHandle MockEventDispatcher::emit_event_delayed(const Event& event, uint32_t ms_delay) {
+    return events_queue.push(event, current_time_ms + ms_delay);
+}
+
+EventHandle MockEventDispatcher::emit_event_at(const Event& event, uint32_t timestamp_ms) {
+    return events_queue.push(event, timestamp_ms);
+}
+
+EventHandle MockEventDispatcher::emit_event_periodic(const Event& event, uint32_t ms_period) {
+    if (ms_period == 0) {
+        return INVALID_EVENT_HANDLE;
+    }
+    return events_queue.push(event, current_time_ms + ms_period, ms_period);
+}
+
+bool MockEventDispatcher::cancel(EventHandle handle) {
+    return events_queue.cancel(handle);
+}
@@ -0,0 +1,130 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "rssi/mock_rssi_reader.h"
+
+#include <algorithm>
+#include <cassert>
+
+MockRssiReader::MockRssiReader(uint32_t sample_interval_us, size_t block_length, uint8_t channels_count) :
+    delegate(nullptr),
+    sample_interval_us(sample_interval_us),
+    block_length(block_length),
+    channels_count(channels_count),
+    next_tick(0),
+    suspended(false),
+    resume_tick(0),
+    skipped_samples(0),
+    wakeup_armed(false),
+    wakeup_levels(),
+    sample_stride(1),
+    requested_stride(1),
+    covered_ticks(0) {}
+
+void MockRssiReader::initialize(Delegate &delegate) {
+    this->delegate = &delegate;
+    delegate.on_initialized(*this);
+}
+
+uint32_t MockRssiReader::get_sample_interval_us() const {
+    return sample_interval_us;
+}
+
+uint8_t MockRssiReader::get_channels_count() const {
+    return channels_count;
+}
+
+void MockRssiReader::suspend_sampling(uint32_t resume_tick) {
+    if (static_cast<int32_t>(resume_tick - next_tick) > 0) {
+        suspended = true;
+        this->resume_tick = resume_tick;
+    }
+}
+
+void MockRssiReader::arm_wakeup(const std::array<uint16_t, MAX_CHANNELS_COUNT>& levels) {
+    wakeup_armed = true;
+    wakeup_levels = levels;
+}
+
+void MockRssiReader::set_sample_stride(uint8_t stride) {
+    requested_stride = std::max<uint8_t>(stride, 1);
+}
+
+size_t MockRssiReader::find_wakeup_offset(const std::vector<std::vector<uint16_t>>& channels, size_t offset) const {
+    size_t length = channels[0].size();
+    for (; offset < length; offset++) {
+        for (size_t channel = 0; channel < channels.size(); channel++) {
+            if (channels[channel][offset] > wakeup_levels[channel]) {
+                return offset;
+            }
+        }
+    }
+    return length;
+}
+
+void MockRssiReader::capture(const std::vector<uint16_t>& samples) {
+    capture_channels({ samples });
+}
+
+void MockRssiReader::capture_channels(const std::vector<std::vector<uint16_t>>& channels) {
+    size_t length = channels.empty() ? 0 : channels[0].size();
+    size_t offset = std::min(covered_ticks, length);
+    covered_ticks -= offset;
+    std::vector<uint16_t> block(block_length);
+    while (offset < length) {
+        // Samples are skipped until the resume tick, the following block starts right at it.
+        if (suspended) {
+            size_t skipped = std::min<size_t>(length - offset, resume_tick - next_tick);
+            offset += skipped;
+            next_tick += skipped;
+            skipped_samples += skipped;
+            suspended = next_tick != resume_tick;
+            continue;
+        }
+        // Wake-up happens right at the sample above the level, following block starts with it.
+        if (wakeup_armed) {
+            size_t wakeup_offset = find_wakeup_offset(channels, offset);
+            next_tick += wakeup_offset - offset;
+            skipped_samples += wakeup_offset - offset;
+            offset = wakeup_offset;
+            wakeup_armed = offset == length;
+            continue;
+        }
+
+        // Stride changes only at block boundaries, the last sample may cover ticks of the next capture.
+        sample_stride = requested_stride;
+        size_t count = std::min(block_length, (length - offset + sample_stride - 1) / sample_stride);
+        for (size_t channel = 0; channel < channels.size(); channel++) {
+            assert(channels[channel].size() == length);
+            for (size_t i = 0; i < count; i++) {
+                block[i] = channels[channel][offset + i * sample_stride];
+            }
+            if (delegate) {
+                delegate->on_samples_captured(channel, block.data(), count, next_tick, sample_stride);
+            }
+        }
+        size_t ticks = count * sample_stride;
+        covered_ticks = offset + ticks > length ? offset + ticks - length : 0;
+        offset = std::min(offset + ticks, length);
+        next_tick += ticks;
+    }
+}
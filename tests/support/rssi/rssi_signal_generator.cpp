@@ -0,0 +1,133 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "rssi/rssi_signal_generator.h"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr float PI = 3.14159265f;
+
+RssiSignalGenerator::RssiSignalGenerator(uint32_t sample_interval_us, uint32_t seed) :
+    sample_interval_us(sample_interval_us),
+    environment(),
+    drones(),
+    received_mw(),
+    tick(0),
+    random_state(seed ? seed : 1) {}
+
+uint8_t RssiSignalGenerator::add_drone(const DroneParameters& parameters) {
+    Drone drone;
+    drone.parameters = parameters;
+    // No pass before the first one.
+    drone.previous_pass_us = INT64_MIN / 2;
+    drone.next_pass_us = static_cast<int64_t>(parameters.first_pass_ms) * 1000;
+    drone.fading_phase = next_uniform() * 2 * PI;
+    drone.prop_phase = next_uniform() * 2 * PI;
+    drones.push_back(drone);
+    received_mw.push_back(0);
+    return static_cast<uint8_t>(drones.size() - 1);
+}
+
+std::vector<std::vector<uint16_t>> RssiSignalGenerator::generate(size_t count) {
+    std::vector<std::vector<uint16_t>> channels;
+    generate(channels, count);
+    return channels;
+}
+
+void RssiSignalGenerator::generate(std::vector<std::vector<uint16_t>>& channels, size_t count) {
+    channels.resize(drones.size());
+    for (std::vector<uint16_t>& samples : channels) {
+        samples.reserve(samples.size() + count);
+    }
+
+    float noise_mw = std::pow(10.0f, environment.rssi_floor_dbm / 10);
+    float crosstalk = std::pow(10.0f, environment.crosstalk_db / 10);
+    for (size_t i = 0; i < count; i++, tick++) {
+        int64_t timestamp_us = static_cast<int64_t>(tick * sample_interval_us);
+        float total_mw = 0;
+        for (size_t drone = 0; drone < drones.size(); drone++) {
+            received_mw[drone] = std::pow(10.0f, get_received_power_dbm(drones[drone], timestamp_us) / 10);
+            total_mw += received_mw[drone];
+        }
+        for (size_t channel = 0; channel < drones.size(); channel++) {
+            float channel_mw = noise_mw + received_mw[channel] + crosstalk * (total_mw - received_mw[channel]);
+            float rssi_dbm = 10 * std::log10(channel_mw) + next_gaussian() * environment.noise_db;
+            channels[channel].push_back(quantize(rssi_dbm));
+        }
+    }
+}
+
+float RssiSignalGenerator::get_received_power_dbm(Drone& drone, int64_t timestamp_us) {
+    const DroneParameters& parameters = drone.parameters;
+    while (timestamp_us >= drone.next_pass_us) {
+        drone.pass_timestamps_us.push_back(drone.next_pass_us);
+        int64_t lap_time_ms = parameters.lap_time_ms;
+        if (parameters.lap_time_jitter_ms) {
+            lap_time_ms += static_cast<int64_t>(next_random() % (2 * parameters.lap_time_jitter_ms + 1)) - parameters.lap_time_jitter_ms;
+        }
+        drone.previous_pass_us = drone.next_pass_us;
+        drone.next_pass_us += lap_time_ms * 1000;
+    }
+
+    // Distance to the gate is given by the nearest pass, the drone flies straight through it.
+    int64_t since_pass_us = timestamp_us - drone.previous_pass_us;
+    int64_t until_pass_us = drone.next_pass_us - timestamp_us;
+    bool approaching = until_pass_us < since_pass_us;
+    float along_track_m = parameters.speed_mps * (approaching ? until_pass_us : since_pass_us) / 1e6f;
+    float distance_m = std::sqrt(parameters.closest_distance_m * parameters.closest_distance_m + along_track_m * along_track_m);
+
+    // Exponents differ only away from the closest point, so there is no step at the pass.
+    float exponent = approaching ? parameters.approach_exponent : parameters.depart_exponent;
+    float power_dbm = parameters.power_at_1m_dbm
+        - 10 * parameters.approach_exponent * std::log10(parameters.closest_distance_m)
+        - 10 * exponent * std::log10(distance_m / parameters.closest_distance_m);
+    power_dbm += environment.fading_depth_db / 2 * std::sin(2 * PI * distance_m / environment.fading_period_m + drone.fading_phase);
+    float prop_cycles = environment.prop_frequency_hz * (timestamp_us % 1000000) / 1e6f;
+    power_dbm += environment.prop_noise_db / 2 * std::sin(2 * PI * prop_cycles + drone.prop_phase);
+    return power_dbm;
+}
+
+uint16_t RssiSignalGenerator::quantize(float rssi_dbm) const {
+    float level = (rssi_dbm - environment.rssi_floor_dbm) / (environment.rssi_ceiling_dbm - environment.rssi_floor_dbm);
+    float adc = environment.adc_floor + level * (environment.adc_ceiling - environment.adc_floor);
+    adc = std::min(std::max(adc, 0.0f), static_cast<float>(ADC_MAX));
+    return static_cast<uint16_t>(std::lround(adc)) << (16 - ADC_RESOLUTION_BITS);
+}
+
+uint32_t RssiSignalGenerator::next_random() {
+    // xorshift32
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+float RssiSignalGenerator::next_uniform() {
+    return (next_random() >> 8) / static_cast<float>(1 << 24);
+}
+
+float RssiSignalGenerator::next_gaussian() {
+    // Sum of 4 uniform variables has variance of 1/3, close enough to normal distribution.
+    float sum = next_uniform() + next_uniform() + next_uniform() + next_uniform();
+    return (sum - 2) * 1.7320508f;
+}
@@ -0,0 +1,112 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_LAP_MATCHER_H
+#define LAP_TIMER_LAP_MATCHER_H
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <vector>
+
+class LapRecord {
+public:
+    LapRecord(uint64_t timestamp_us, uint8_t channel = 0) : timestamp_us(timestamp_us), channel(channel) {}
+
+    uint64_t get_timestamp_us() const {
+        return timestamp_us;
+    }
+
+    uint8_t get_channel() const {
+        return channel;
+    }
+
+private:
+    uint64_t timestamp_us;
+    uint8_t channel;
+};
+
+///
+/// @brief Read ground truth laps.
+///
+/// Every line contains a timestamp in milliseconds (fraction allowed) and optionally a channel,
+/// separated by whitespace. Empty lines and lines starting with '#' are skipped.
+///
+/// @return std::optional<std::vector<LapRecord>> Laps or nothing if the input is malformed.
+///
+std::optional<std::vector<LapRecord>> parse_ground_truth(std::istream& input);
+
+///
+/// @brief Pairs detected laps with ground truth laps of the same channel.
+///
+/// Every expected lap is matched with the closest unmatched detected lap within the tolerance.
+///
+class LapMatcher {
+public:
+    class Match {
+    public:
+        Match(LapRecord expected, std::optional<LapRecord> detected) : expected(expected), detected(detected) {}
+
+        const LapRecord& get_expected() const {
+            return expected;
+        }
+
+        const std::optional<LapRecord>& get_detected() const {
+            return detected;
+        }
+
+        // Detected minus expected timestamp.
+        int64_t get_error_us() const {
+            return detected ? static_cast<int64_t>(detected->get_timestamp_us() - expected.get_timestamp_us()) : 0;
+        }
+
+    private:
+        LapRecord expected;
+        std::optional<LapRecord> detected;
+    };
+
+    explicit LapMatcher(uint32_t tolerance_ms);
+
+    void match(const std::vector<LapRecord>& expected, const std::vector<LapRecord>& detected);
+
+    const std::vector<Match>& get_matches() const {
+        return matches;
+    }
+
+    // Detected laps without a counterpart in the ground truth.
+    const std::vector<LapRecord>& get_false_laps() const {
+        return false_laps;
+    }
+
+    size_t get_matched_count() const;
+    size_t get_missed_count() const;
+    int64_t get_mean_abs_error_us() const;
+    int64_t get_max_abs_error_us() const;
+
+private:
+    uint64_t tolerance_us;
+    std::vector<Match> matches;
+    std::vector<LapRecord> false_laps;
+};
+
+#endif // LAP_TIMER_LAP_MATCHER_H
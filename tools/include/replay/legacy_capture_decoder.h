@@ -0,0 +1,75 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_LEGACY_CAPTURE_DECODER_H
+#define LAP_TIMER_LEGACY_CAPTURE_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+///
+/// @brief Decodes UART captures of the legacy 2 bytes per sample format.
+///
+/// Each sample is sent big endian, two most significant bits carry a sequence number
+/// incremented for every sample, the remaining 14 bits are the SAADC value:
+///
+///     [seq:2][sample 13..8:6] [sample 7..0:8]
+///
+/// Capture may start in the middle of a sample and bytes may be lost, so the decoder looks for
+/// the alignment with consistent sequence numbers. Samples lost between two received ones are
+/// replaced by the last received sample to keep the timing. Gaps of multiple of 4 samples can't
+/// be detected.
+///
+class LegacyCaptureDecoder {
+public:
+    // Number of consecutive samples with valid sequence numbers required to (re)synchronize.
+    static constexpr size_t SYNC_LENGTH = 8;
+
+    LegacyCaptureDecoder();
+
+    ///
+    /// @brief Decode whole capture.
+    ///
+    /// @param data Captured bytes.
+    /// @return std::vector<uint16_t> Samples normalized to 16 bits, as RssiReader does.
+    ///
+    std::vector<uint16_t> decode(const std::vector<uint8_t>& data);
+
+    size_t get_lost_samples() const {
+        return lost_samples;
+    }
+
+    size_t get_resyncs() const {
+        return resyncs;
+    }
+
+private:
+    static uint8_t get_sequence(const std::vector<uint8_t>& data, size_t offset);
+    static bool is_synchronized(const std::vector<uint8_t>& data, size_t offset);
+
+    size_t lost_samples;
+    size_t resyncs;
+};
+
+#endif // LAP_TIMER_LEGACY_CAPTURE_DECODER_H
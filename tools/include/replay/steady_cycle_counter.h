@@ -0,0 +1,49 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LAP_TIMER_STEADY_CYCLE_COUNTER_H
+#define LAP_TIMER_STEADY_CYCLE_COUNTER_H
+
+#include "time/cycle_counter_interface.h"
+
+#include <chrono>
+
+///
+/// @brief Host cycle counter backed by the monotonic clock, one cycle is a nanosecond.
+///
+class SteadyCycleCounter : public CycleCounterInterface {
+public:
+    uint32_t get_cycles() const override {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    }
+
+    uint32_t get_cycles_per_us() const override {
+        return 1000;
+    }
+
+    uint8_t get_execution_priority() const override {
+        return THREAD_PRIORITY;
+    }
+};
+
+#endif // LAP_TIMER_STEADY_CYCLE_COUNTER_H
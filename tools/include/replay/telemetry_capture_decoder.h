@@ -0,0 +1,77 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LAP_TIMER_TELEMETRY_CAPTURE_DECODER_H
+#define LAP_TIMER_TELEMETRY_CAPTURE_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rssi/rssi_reader_interface.h"
+
+///
+/// @brief Decodes UART captures of the telemetry stream (see TelemetryFrame).
+///
+/// Samples of lost frames are replaced by the last received sample of the channel, so all channels
+/// keep the timing given by the ticks of the frames. Samples of strided frames are repeated for
+/// every tick they span, so the decoded samples are always one tick apart.
+///
+class TelemetryCaptureDecoder {
+public:
+    TelemetryCaptureDecoder();
+
+    ///
+    /// @brief Decode whole capture.
+    ///
+    /// @param data Captured bytes.
+    /// @return std::vector<std::vector<uint16_t>> Samples of every tick of every channel, all of the
+    ///         same length, starting at the tick of the first received frame.
+    ///
+    std::vector<std::vector<uint16_t>> decode(const std::vector<uint8_t>& data);
+
+    size_t get_frames() const {
+        return frames;
+    }
+
+    size_t get_invalid_frames() const {
+        return invalid_frames;
+    }
+
+    size_t get_lost_samples() const {
+        return lost_samples;
+    }
+
+    // Frames dropped by the device because the transmission couldn't keep up.
+    uint32_t get_dropped_frames() const {
+        return dropped_frames;
+    }
+
+private:
+    size_t frames;
+    size_t invalid_frames;
+    size_t lost_samples;
+    uint32_t dropped_frames;
+};
+
+#endif // LAP_TIMER_TELEMETRY_CAPTURE_DECODER_H
@@ -0,0 +1,121 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "replay/lap_matcher.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+std::optional<std::vector<LapRecord>> parse_ground_truth(std::istream& input) {
+    std::vector<LapRecord> laps;
+    std::string line;
+    while (std::getline(input, line)) {
+        std::istringstream line_stream(line);
+        double timestamp_ms;
+        if (!(line_stream >> timestamp_ms)) {
+            line_stream.clear();
+            std::string token;
+            if (!(line_stream >> token) || token[0] == '#') {
+                continue;
+            }
+            return std::nullopt;
+        }
+
+        unsigned channel = 0;
+        if (!(line_stream >> channel)) {
+            channel = 0;
+        }
+        if (timestamp_ms < 0 || channel > UINT8_MAX) {
+            return std::nullopt;
+        }
+        laps.emplace_back(static_cast<uint64_t>(timestamp_ms * 1000 + 0.5), static_cast<uint8_t>(channel));
+    }
+    return laps;
+}
+
+LapMatcher::LapMatcher(uint32_t tolerance_ms) : tolerance_us(static_cast<uint64_t>(tolerance_ms) * 1000) {}
+
+void LapMatcher::match(const std::vector<LapRecord>& expected, const std::vector<LapRecord>& detected) {
+    matches.clear();
+    false_laps.clear();
+    std::vector<bool> used(detected.size(), false);
+
+    for (const LapRecord& expected_lap : expected) {
+        std::optional<size_t> best;
+        uint64_t best_distance = 0;
+        for (size_t i = 0; i < detected.size(); i++) {
+            if (used[i] || detected[i].get_channel() != expected_lap.get_channel()) {
+                continue;
+            }
+            uint64_t distance = std::max(detected[i].get_timestamp_us(), expected_lap.get_timestamp_us()) -
+                                std::min(detected[i].get_timestamp_us(), expected_lap.get_timestamp_us());
+            if (distance <= tolerance_us && (!best || distance < best_distance)) {
+                best = i;
+                best_distance = distance;
+            }
+        }
+
+        if (best) {
+            used[*best] = true;
+            matches.emplace_back(expected_lap, detected[*best]);
+        } else {
+            matches.emplace_back(expected_lap, std::nullopt);
+        }
+    }
+
+    for (size_t i = 0; i < detected.size(); i++) {
+        if (!used[i]) {
+            false_laps.push_back(detected[i]);
+        }
+    }
+}
+
+size_t LapMatcher::get_matched_count() const {
+    return std::count_if(matches.begin(), matches.end(), [](const Match& match) { return match.get_detected().has_value(); });
+}
+
+size_t LapMatcher::get_missed_count() const {
+    return matches.size() - get_matched_count();
+}
+
+int64_t LapMatcher::get_mean_abs_error_us() const {
+    size_t matched = get_matched_count();
+    if (matched == 0) {
+        return 0;
+    }
+    int64_t sum = 0;
+    for (const Match& match : matches) {
+        sum += std::llabs(match.get_error_us());
+    }
+    return sum / static_cast<int64_t>(matched);
+}
+
+int64_t LapMatcher::get_max_abs_error_us() const {
+    int64_t max_error = 0;
+    for (const Match& match : matches) {
+        max_error = std::max<int64_t>(max_error, std::llabs(match.get_error_us()));
+    }
+    return max_error;
+}
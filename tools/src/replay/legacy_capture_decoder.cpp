@@ -0,0 +1,84 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "replay/legacy_capture_decoder.h"
+
+LegacyCaptureDecoder::LegacyCaptureDecoder() : lost_samples(0), resyncs(0) {}
+
+uint8_t LegacyCaptureDecoder::get_sequence(const std::vector<uint8_t>& data, size_t offset) {
+    return data[offset] >> 6;
+}
+
+bool LegacyCaptureDecoder::is_synchronized(const std::vector<uint8_t>& data, size_t offset) {
+    if (offset + 2 * SYNC_LENGTH > data.size()) {
+        return false;
+    }
+    for (size_t i = 1; i < SYNC_LENGTH; i++) {
+        uint8_t previous = get_sequence(data, offset + 2 * (i - 1));
+        if (get_sequence(data, offset + 2 * i) != ((previous + 1) & 0x03)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint16_t> LegacyCaptureDecoder::decode(const std::vector<uint8_t>& data) {
+    std::vector<uint16_t> samples;
+    lost_samples = 0;
+    resyncs = 0;
+
+    size_t offset = 0;
+    while (offset + 2 * SYNC_LENGTH <= data.size() && !is_synchronized(data, offset)) {
+        offset++;
+    }
+    if (offset + 2 * SYNC_LENGTH > data.size()) {
+        return samples;
+    }
+
+    uint8_t expected_sequence = get_sequence(data, offset);
+    while (offset + 1 < data.size()) {
+        uint8_t sequence = get_sequence(data, offset);
+        // Lost byte shifts the alignment, lost sample only skips the sequence. A sample with the lost
+        // low byte still has the expected sequence, so the following one is checked as well.
+        bool next_follows = offset + 3 >= data.size() || get_sequence(data, offset + 2) == ((sequence + 1) & 0x03);
+        if ((sequence != expected_sequence || !next_follows) &&
+            !is_synchronized(data, offset) && is_synchronized(data, offset + 1)) {
+            offset++;
+            resyncs++;
+            continue;
+        }
+        if (sequence != expected_sequence) {
+            uint8_t gap = (sequence - expected_sequence) & 0x03;
+            uint16_t last_sample = samples.empty() ? 0 : samples.back();
+            samples.insert(samples.end(), gap, last_sample);
+            lost_samples += gap;
+        }
+
+        uint16_t sample = (static_cast<uint16_t>(data[offset] & 0x3F) << 8) | data[offset + 1];
+        // RssiReader normalizes 14 bits samples to 16 bits before passing them to the delegate.
+        samples.push_back(sample << 2);
+        expected_sequence = (sequence + 1) & 0x03;
+        offset += 2;
+    }
+    return samples;
+}
@@ -0,0 +1,96 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "replay/telemetry_capture_decoder.h"
+#include "telemetry/telemetry_frame.h"
+
+#include <algorithm>
+#include <optional>
+
+TelemetryCaptureDecoder::TelemetryCaptureDecoder() :
+    frames(0),
+    invalid_frames(0),
+    lost_samples(0),
+    dropped_frames(0) {}
+
+std::vector<std::vector<uint16_t>> TelemetryCaptureDecoder::decode(const std::vector<uint8_t>& data) {
+    std::vector<std::vector<uint16_t>> channels;
+    frames = 0;
+    invalid_frames = 0;
+    lost_samples = 0;
+    dropped_frames = 0;
+
+    std::optional<uint32_t> first_tick;
+    // First frame may be cut, start right after the first delimiter.
+    auto begin = std::find(data.begin(), data.end(), TelemetryFrame::DELIMITER);
+    if (begin != data.end()) {
+        begin++;
+    }
+
+    for (auto end = std::find(begin, data.end(), TelemetryFrame::DELIMITER); end != data.end();
+         begin = end + 1, end = std::find(begin, data.end(), TelemetryFrame::DELIMITER)) {
+        TelemetryFrame frame;
+        if (end == begin || !frame.decode(&*begin, end - begin)) {
+            invalid_frames++;
+            continue;
+        }
+        frames++;
+        dropped_frames = frame.get_dropped_frames();
+
+        if (frame.get_channel() >= RssiReaderInterface::MAX_CHANNELS_COUNT) {
+            invalid_frames++;
+            continue;
+        }
+        if (!first_tick) {
+            first_tick = frame.get_first_sample_tick();
+        }
+        if (channels.size() <= frame.get_channel()) {
+            channels.resize(frame.get_channel() + 1);
+        }
+
+        std::vector<uint16_t>& samples = channels[frame.get_channel()];
+        uint32_t offset = frame.get_first_sample_tick() - *first_tick;
+        if (offset < samples.size()) {
+            // Frame from the past, e.g. device was restarted.
+            invalid_frames++;
+            continue;
+        }
+        uint16_t last_sample = samples.empty() ? 0 : samples.back();
+        lost_samples += offset - samples.size();
+        samples.resize(offset, last_sample);
+        for (size_t i = 0; i < frame.get_samples_count(); i++) {
+            samples.insert(samples.end(), frame.get_tick_stride(), frame.get_samples()[i]);
+        }
+    }
+
+    // Trailing samples missing for some channels are treated as lost as well.
+    size_t length = 0;
+    for (const std::vector<uint16_t>& samples : channels) {
+        length = std::max(length, samples.size());
+    }
+    for (std::vector<uint16_t>& samples : channels) {
+        lost_samples += length - samples.size();
+        samples.resize(length, samples.empty() ? 0 : samples.back());
+    }
+    return channels;
+}
@@ -0,0 +1,285 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "events/mock_event_dispatcher.h"
+#include "replay/lap_matcher.h"
+#include "replay/legacy_capture_decoder.h"
+#include "replay/steady_cycle_counter.h"
+#include "replay/telemetry_capture_decoder.h"
+#include "rssi/buffered_rssi_reader_delegate.h"
+#include "rssi/matched_filter_rssi_reader_delegate.h"
+#include "rssi/mock_rssi_reader.h"
+#include "rssi/rssi_reader_delegate.h"
+#include "time/mock_real_time_clock.h"
+#include "trace/latency_tracer.h"
+
+// Samples passed to the delegate between processing of events.
+static constexpr size_t REPLAY_CHUNK_LENGTH = 1 << 16;
+
+static void print_usage(const char* name) {
+    std::printf(
+        "Usage: %s [options] <capture>\n"
+        "\n"
+        "Replays captured RSSI through RssiReaderDelegate and reports detected laps.\n"
+        "\n"
+        "Options:\n"
+        "  --format <legacy|telemetry>  Capture format (default: legacy)\n"
+        "  --detector <threshold|matched-filter>\n"
+        "                               Lap detection engine (default: threshold)\n"
+        "  --truth <file>               Ground truth laps: '<timestamp_ms> [channel]' per line\n"
+        "  --tolerance-ms <ms>          Max distance between detected and expected lap (default: 100)\n"
+        "  --sample-interval-us <us>    Interval between samples (default: 400)\n"
+        "  --block <samples>            Samples passed to the delegate at once (default: 32)\n"
+        "  --profile <floor>,<peak>     RSSI profile loaded before the replay\n"
+        "  --trace-latency              Queue samples like the firmware and report latency of laps\n"
+        "\n"
+        "Exit code is 1 if any lap is missed or falsely detected.\n",
+        name);
+}
+
+static bool read_file(const char* path, std::vector<uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static void collect_laps(MockEventDispatcher& dispatcher, std::vector<LapRecord>& laps) {
+    while (auto event = dispatcher.process_next_event()) {
+        if (auto lap = std::get_if<NewLap>(&*event)) {
+            laps.emplace_back(lap->get_timestamp_us(), lap->get_channel());
+        }
+    }
+}
+
+static void print_latency(const LatencyTracer& tracer) {
+    static const char* const stage_names[LatencyTracer::LATENCY_STAGES_COUNT] = {
+        "queue", "detection", "dispatch", "total"
+    };
+    std::printf("\nLap latency:\n");
+    for (uint8_t stage = 0; stage < LatencyTracer::LATENCY_STAGES_COUNT; stage++) {
+        const LatencyHistogram& histogram = tracer.get_histogram(static_cast<LatencyTracer::Stage>(stage));
+        if (histogram.get_count() == 0) {
+            continue;
+        }
+        std::printf("  %-10s  count %u  min %u us  p50 %u us  p99 %u us  max %u us\n", stage_names[stage],
+            histogram.get_count(), histogram.get_min_us(), histogram.get_percentile_us(50),
+            histogram.get_percentile_us(99), histogram.get_max_us());
+    }
+}
+
+static void print_lap_time(const char* label, uint64_t timestamp_us) {
+    std::printf("%s%llu.%03llu ms", label,
+        static_cast<unsigned long long>(timestamp_us / 1000),
+        static_cast<unsigned long long>(timestamp_us % 1000));
+}
+
+int main(int argc, char** argv) {
+    std::string format = "legacy";
+    std::string detector = "threshold";
+    const char* capture_path = nullptr;
+    const char* truth_path = nullptr;
+    uint32_t tolerance_ms = 100;
+    uint32_t sample_interval_us = 400;
+    size_t block_length = 32;
+    std::optional<RssiProfile> profile;
+    bool trace_latency = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--format") == 0 && has_value) {
+            format = argv[++i];
+        } else if (std::strcmp(argv[i], "--detector") == 0 && has_value) {
+            detector = argv[++i];
+        } else if (std::strcmp(argv[i], "--truth") == 0 && has_value) {
+            truth_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--tolerance-ms") == 0 && has_value) {
+            tolerance_ms = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--sample-interval-us") == 0 && has_value) {
+            sample_interval_us = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--block") == 0 && has_value) {
+            block_length = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--profile") == 0 && has_value) {
+            unsigned floor, peak;
+            if (std::sscanf(argv[++i], "%u,%u", &floor, &peak) != 2 || floor > UINT16_MAX || peak > UINT16_MAX) {
+                std::fprintf(stderr, "Invalid profile: %s\n", argv[i]);
+                return 2;
+            }
+            profile = RssiProfile(floor, peak);
+        } else if (std::strcmp(argv[i], "--trace-latency") == 0) {
+            trace_latency = true;
+        } else if (argv[i][0] != '-' && !capture_path) {
+            capture_path = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (!capture_path || sample_interval_us == 0 || block_length == 0 || (format != "legacy" && format != "telemetry") ||
+        (detector != "threshold" && detector != "matched-filter")) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> capture;
+    if (!read_file(capture_path, capture)) {
+        std::fprintf(stderr, "Can't read capture: %s\n", capture_path);
+        return 2;
+    }
+
+    std::optional<std::vector<LapRecord>> expected_laps;
+    if (truth_path) {
+        std::ifstream truth_file(truth_path);
+        if (truth_file) {
+            expected_laps = parse_ground_truth(truth_file);
+        }
+        if (!expected_laps) {
+            std::fprintf(stderr, "Can't read ground truth: %s\n", truth_path);
+            return 2;
+        }
+    }
+
+    std::vector<std::vector<uint16_t>> channels;
+    if (format == "legacy") {
+        LegacyCaptureDecoder decoder;
+        channels.push_back(decoder.decode(capture));
+        std::printf("Decoded %zu samples, %zu lost, %zu resyncs\n",
+            channels[0].size(), decoder.get_lost_samples(), decoder.get_resyncs());
+    } else {
+        TelemetryCaptureDecoder decoder;
+        channels = decoder.decode(capture);
+        std::printf("Decoded %zu frames of %zu channels, %zu invalid, %u dropped by device, %zu samples lost\n",
+            decoder.get_frames(), channels.size(), decoder.get_invalid_frames(),
+            decoder.get_dropped_frames(), decoder.get_lost_samples());
+    }
+    if (channels.empty() || channels.size() > RssiReaderInterface::MAX_CHANNELS_COUNT) {
+        std::fprintf(stderr, "No samples to replay\n");
+        return 2;
+    }
+
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(sample_interval_us, block_length, channels.size());
+    RssiReaderDelegate threshold_delegate(clock, dispatcher);
+    MatchedFilterRssiReaderDelegate matched_filter_delegate(clock, dispatcher);
+    RssiReaderInterface::Delegate& delegate = detector == "threshold" ?
+        static_cast<RssiReaderInterface::Delegate&>(threshold_delegate) : matched_filter_delegate;
+    SteadyCycleCounter cycle_counter;
+    LatencyTracer tracer(dispatcher, cycle_counter);
+    BufferedRssiReaderDelegate buffered_delegate(dispatcher, delegate);
+    size_t replay_chunk_length = REPLAY_CHUNK_LENGTH;
+    if (trace_latency) {
+        // Samples go through the same ring as in the firmware, a chunk has to fit in it.
+        size_t blocks_per_capture = (block_length + BufferedRssiReaderDelegate::MAX_BLOCK_LENGTH - 1) / BufferedRssiReaderDelegate::MAX_BLOCK_LENGTH;
+        size_t captures = BufferedRssiReaderDelegate::BLOCKS_COUNT / channels.size() / blocks_per_capture;
+        if (captures == 0) {
+            std::fprintf(stderr, "Block is too long to trace latency\n");
+            return 2;
+        }
+        replay_chunk_length = captures * block_length;
+        threshold_delegate.set_latency_tracer(&tracer);
+        matched_filter_delegate.set_latency_tracer(&tracer);
+        buffered_delegate.set_latency_tracer(&tracer);
+        reader.initialize(buffered_delegate);
+    } else {
+        reader.initialize(delegate);
+    }
+    if (profile) {
+        for (uint8_t channel = 0; channel < channels.size(); channel++) {
+            dispatcher.emit_event(RssiProfileLoaded(*profile, channel));
+        }
+    }
+
+    std::vector<LapRecord> detected_laps;
+    size_t length = channels[0].size();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < length; offset += replay_chunk_length) {
+        collect_laps(dispatcher, detected_laps);
+        size_t chunk_length = std::min(replay_chunk_length, length - offset);
+        std::vector<std::vector<uint16_t>> chunk;
+        for (const std::vector<uint16_t>& samples : channels) {
+            chunk.emplace_back(samples.begin() + offset, samples.begin() + offset + chunk_length);
+        }
+        reader.capture_channels(chunk);
+    }
+    collect_laps(dispatcher, detected_laps);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("\nDetected laps:\n");
+    for (size_t i = 0; i < detected_laps.size(); i++) {
+        std::printf("  %3zu  channel %u  ", i + 1, detected_laps[i].get_channel());
+        print_lap_time("", detected_laps[i].get_timestamp_us());
+        std::printf("\n");
+    }
+
+    double samples = static_cast<double>(length) * channels.size();
+    double signal_seconds = static_cast<double>(length) * sample_interval_us / 1e6;
+    std::printf("\nReplayed %.0f samples (%.1f s of signal) in %.3f s: %.0f samples/s, %.0fx real time\n",
+        samples, signal_seconds, elapsed.count(), samples / elapsed.count(), signal_seconds / elapsed.count());
+    if (trace_latency) {
+        print_latency(tracer);
+    }
+
+    if (!expected_laps) {
+        return 0;
+    }
+
+    LapMatcher matcher(tolerance_ms);
+    matcher.match(*expected_laps, detected_laps);
+
+    std::printf("\nGround truth:\n");
+    for (const LapMatcher::Match& match : matcher.get_matches()) {
+        std::printf("  channel %u  ", match.get_expected().get_channel());
+        print_lap_time("expected ", match.get_expected().get_timestamp_us());
+        if (match.get_detected()) {
+            std::printf("  error %+lld us\n", static_cast<long long>(match.get_error_us()));
+        } else {
+            std::printf("  MISSED\n");
+        }
+    }
+    for (const LapRecord& lap : matcher.get_false_laps()) {
+        std::printf("  channel %u  ", lap.get_channel());
+        print_lap_time("detected ", lap.get_timestamp_us());
+        std::printf("  FALSE\n");
+    }
+
+    std::printf("\nMatched %zu of %zu laps, %zu missed, %zu false, error mean %lld us, max %lld us\n",
+        matcher.get_matched_count(), matcher.get_matches().size(), matcher.get_missed_count(),
+        matcher.get_false_laps().size(),
+        static_cast<long long>(matcher.get_mean_abs_error_us()),
+        static_cast<long long>(matcher.get_max_abs_error_us()));
+
+    return matcher.get_missed_count() == 0 && matcher.get_false_laps().empty() ? 0 : 1;
+}
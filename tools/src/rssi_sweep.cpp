@@ -0,0 +1,415 @@
+// MIT License
+
+// Copyright (c) 2019 Polidea
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "events/mock_event_dispatcher.h"
+#include "replay/lap_matcher.h"
+#include "replay/legacy_capture_decoder.h"
+#include "replay/telemetry_capture_decoder.h"
+#include "rssi/mock_rssi_reader.h"
+#include "rssi/rssi_reader_delegate.h"
+#include "time/mock_real_time_clock.h"
+
+// Samples passed to the delegate between processing of events.
+static constexpr size_t REPLAY_CHUNK_LENGTH = 1 << 16;
+
+static void print_usage(const char* name) {
+    std::printf(
+        "Usage: %s [options] <capture> <truth> [<capture> <truth> ...]\n"
+        "\n"
+        "Replays captured RSSI through RssiReaderDelegate with many detection parameter sets\n"
+        "and ranks them by missed and false laps, then by lap time error.\n"
+        "\n"
+        "Options:\n"
+        "  --format <legacy|telemetry>  Capture format (default: legacy)\n"
+        "  --tolerance-ms <ms>          Max distance between detected and expected lap (default: 100)\n"
+        "  --sample-interval-us <us>    Interval between samples (default: 400)\n"
+        "  --block <samples>            Samples passed to the delegate at once (default: 32)\n"
+        "  --lockout-ms <ms>            Lap lockout set before the replay\n"
+        "  --enter <min>:<max>:<step>   Enter level in percent of the span\n"
+        "  --exit <min>:<max>:<step>    Exit level in percent of the span\n"
+        "  --pass-min-ms <min>:<max>:<step>\n"
+        "                               Shortest pass\n"
+        "  --rearm-ms <min>:<max>:<step>\n"
+        "                               Time below the exit threshold ending a pass\n"
+        "  --median <order>[,<order>...]\n"
+        "                               Median filter lengths, any of 3, 5, 7, 9 (default: 5)\n"
+        "  --random <count>             Sample this many parameter sets instead of the whole grid\n"
+        "  --seed <seed>                Seed of the random search (default: 1)\n"
+        "  --threads <count>            Worker threads (default: number of cores)\n"
+        "  --top <count>                Parameter sets printed (default: 10)\n"
+        "\n"
+        "Ranges default to the firmware tuning, a single value is given as <value>.\n",
+        name);
+}
+
+class Range {
+public:
+    Range(uint32_t value) : min(value), max(value), step(1) {}
+
+    bool parse(const char* text) {
+        unsigned parsed_min, parsed_max, parsed_step;
+        int fields = std::sscanf(text, "%u:%u:%u", &parsed_min, &parsed_max, &parsed_step);
+        if (fields == 1) {
+            parsed_max = parsed_min;
+            parsed_step = 1;
+        } else if (fields != 3 || parsed_step == 0 || parsed_max < parsed_min) {
+            return false;
+        }
+        min = parsed_min;
+        max = parsed_max;
+        step = parsed_step;
+        return true;
+    }
+
+    size_t get_count() const {
+        return (max - min) / step + 1;
+    }
+
+    uint32_t get_value(size_t index) const {
+        return min + index * step;
+    }
+
+private:
+    uint32_t min;
+    uint32_t max;
+    uint32_t step;
+};
+
+class Trace {
+public:
+    std::vector<std::vector<uint16_t>> channels;
+    std::vector<LapRecord> expected_laps;
+};
+
+class Candidate {
+public:
+    LapDetector::Parameters parameters;
+    uint8_t median_order = 5;
+    size_t missed_laps = 0;
+    size_t false_laps = 0;
+    size_t matched_laps = 0;
+    int64_t total_abs_error_us = 0;
+    int64_t max_abs_error_us = 0;
+
+    int64_t get_mean_abs_error_us() const {
+        return matched_laps ? total_abs_error_us / static_cast<int64_t>(matched_laps) : 0;
+    }
+
+    bool operator<(const Candidate& other) const {
+        size_t errors = missed_laps + false_laps;
+        size_t other_errors = other.missed_laps + other.false_laps;
+        if (errors != other_errors) {
+            return errors < other_errors;
+        }
+        if (get_mean_abs_error_us() != other.get_mean_abs_error_us()) {
+            return get_mean_abs_error_us() < other.get_mean_abs_error_us();
+        }
+        return max_abs_error_us < other.max_abs_error_us;
+    }
+};
+
+class SweepSettings {
+public:
+    uint32_t tolerance_ms = 100;
+    uint32_t sample_interval_us = 400;
+    size_t block_length = 32;
+    uint32_t lockout_ms = 0;
+};
+
+static bool read_file(const char* path, std::vector<uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool load_trace(const std::string& format, const char* capture_path, const char* truth_path, Trace& trace) {
+    std::vector<uint8_t> capture;
+    if (!read_file(capture_path, capture)) {
+        std::fprintf(stderr, "Can't read capture: %s\n", capture_path);
+        return false;
+    }
+    std::ifstream truth_file(truth_path);
+    std::optional<std::vector<LapRecord>> expected_laps;
+    if (truth_file) {
+        expected_laps = parse_ground_truth(truth_file);
+    }
+    if (!expected_laps) {
+        std::fprintf(stderr, "Can't read ground truth: %s\n", truth_path);
+        return false;
+    }
+    trace.expected_laps = *expected_laps;
+
+    if (format == "legacy") {
+        LegacyCaptureDecoder decoder;
+        trace.channels.push_back(decoder.decode(capture));
+    } else {
+        TelemetryCaptureDecoder decoder;
+        trace.channels = decoder.decode(capture);
+    }
+    if (trace.channels.empty() || trace.channels[0].empty() || trace.channels.size() > RssiReaderInterface::MAX_CHANNELS_COUNT) {
+        std::fprintf(stderr, "No samples to replay: %s\n", capture_path);
+        return false;
+    }
+    return true;
+}
+
+static void collect_laps(MockEventDispatcher& dispatcher, std::vector<LapRecord>& laps) {
+    while (auto event = dispatcher.process_next_event()) {
+        if (auto lap = std::get_if<NewLap>(&*event)) {
+            laps.emplace_back(lap->get_timestamp_us(), lap->get_channel());
+        }
+    }
+}
+
+// Everything is created per replay, so workers share only the read-only traces.
+template<typename Pipeline>
+static std::vector<LapRecord> replay(const Trace& trace, const Candidate& candidate, const SweepSettings& settings) {
+    MockRealTimeClock clock(0);
+    MockEventDispatcher dispatcher;
+    MockRssiReader reader(settings.sample_interval_us, settings.block_length, trace.channels.size());
+    BasicRssiReaderDelegate<Pipeline> delegate(clock, dispatcher);
+    delegate.set_detection_parameters(candidate.parameters);
+    reader.initialize(delegate);
+    if (settings.lockout_ms) {
+        dispatcher.emit_event(SetLapLockout(settings.lockout_ms));
+    }
+
+    std::vector<LapRecord> detected_laps;
+    size_t length = trace.channels[0].size();
+    for (size_t offset = 0; offset < length; offset += REPLAY_CHUNK_LENGTH) {
+        collect_laps(dispatcher, detected_laps);
+        size_t chunk_length = std::min(REPLAY_CHUNK_LENGTH, length - offset);
+        std::vector<std::vector<uint16_t>> chunk;
+        for (const std::vector<uint16_t>& samples : trace.channels) {
+            chunk.emplace_back(samples.begin() + offset, samples.begin() + offset + chunk_length);
+        }
+        reader.capture_channels(chunk);
+    }
+    collect_laps(dispatcher, detected_laps);
+    return detected_laps;
+}
+
+static void evaluate(const std::vector<Trace>& traces, const SweepSettings& settings, Candidate& candidate) {
+    for (const Trace& trace : traces) {
+        std::vector<LapRecord> detected_laps;
+        switch (candidate.median_order) {
+            case 3:
+                detected_laps = replay<RssiMedianPipeline<3>>(trace, candidate, settings);
+                break;
+            case 7:
+                detected_laps = replay<RssiMedianPipeline<7>>(trace, candidate, settings);
+                break;
+            case 9:
+                detected_laps = replay<RssiMedianPipeline<9>>(trace, candidate, settings);
+                break;
+            default:
+                detected_laps = replay<RssiReaderPipeline>(trace, candidate, settings);
+                break;
+        }
+
+        LapMatcher matcher(settings.tolerance_ms);
+        matcher.match(trace.expected_laps, detected_laps);
+        candidate.missed_laps += matcher.get_missed_count();
+        candidate.false_laps += matcher.get_false_laps().size();
+        candidate.matched_laps += matcher.get_matched_count();
+        candidate.total_abs_error_us += matcher.get_mean_abs_error_us() * static_cast<int64_t>(matcher.get_matched_count());
+        candidate.max_abs_error_us = std::max(candidate.max_abs_error_us, matcher.get_max_abs_error_us());
+    }
+}
+
+static bool parse_medians(const char* text, std::vector<uint8_t>& medians) {
+    medians.clear();
+    std::string list(text);
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        unsigned long order = std::strtoul(list.substr(start, end - start).c_str(), nullptr, 10);
+        if (order != 3 && order != 5 && order != 7 && order != 9) {
+            return false;
+        }
+        medians.push_back(order);
+        start = end + 1;
+    }
+    return !medians.empty();
+}
+
+int main(int argc, char** argv) {
+    std::string format = "legacy";
+    std::vector<const char*> paths;
+    SweepSettings settings;
+    Range enter_levels(AdaptiveThreshold::ENTER_LEVEL_PERCENT);
+    Range exit_levels(AdaptiveThreshold::EXIT_LEVEL_PERCENT);
+    Range pass_min_times(LapDetector::PASS_MIN_TIME_MS);
+    Range rearm_times(LapDetector::REARM_TIME_MS);
+    std::vector<uint8_t> medians = {5};
+    size_t random_count = 0;
+    uint32_t seed = 1;
+    size_t threads_count = std::max(1u, std::thread::hardware_concurrency());
+    size_t top_count = 10;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        bool valid = true;
+        if (std::strcmp(argv[i], "--format") == 0 && has_value) {
+            format = argv[++i];
+        } else if (std::strcmp(argv[i], "--tolerance-ms") == 0 && has_value) {
+            settings.tolerance_ms = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--sample-interval-us") == 0 && has_value) {
+            settings.sample_interval_us = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--block") == 0 && has_value) {
+            settings.block_length = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--lockout-ms") == 0 && has_value) {
+            settings.lockout_ms = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--enter") == 0 && has_value) {
+            valid = enter_levels.parse(argv[++i]);
+        } else if (std::strcmp(argv[i], "--exit") == 0 && has_value) {
+            valid = exit_levels.parse(argv[++i]);
+        } else if (std::strcmp(argv[i], "--pass-min-ms") == 0 && has_value) {
+            valid = pass_min_times.parse(argv[++i]);
+        } else if (std::strcmp(argv[i], "--rearm-ms") == 0 && has_value) {
+            valid = rearm_times.parse(argv[++i]);
+        } else if (std::strcmp(argv[i], "--median") == 0 && has_value) {
+            valid = parse_medians(argv[++i], medians);
+        } else if (std::strcmp(argv[i], "--random") == 0 && has_value) {
+            random_count = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            seed = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && has_value) {
+            threads_count = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--top") == 0 && has_value) {
+            top_count = std::strtoul(argv[++i], nullptr, 10);
+        } else if (argv[i][0] != '-') {
+            paths.push_back(argv[i]);
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (paths.empty() || paths.size() % 2 != 0 || settings.sample_interval_us == 0 || settings.block_length == 0 ||
+        threads_count == 0 || (format != "legacy" && format != "telemetry")) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Trace> traces(paths.size() / 2);
+    for (size_t i = 0; i < traces.size(); i++) {
+        if (!load_trace(format, paths[2 * i], paths[2 * i + 1], traces[i])) {
+            return 2;
+        }
+    }
+
+    const Range* ranges[] = {&enter_levels, &exit_levels, &pass_min_times, &rearm_times};
+    auto make_candidate = [&](const size_t (&indices)[4], size_t median_index) {
+        Candidate candidate;
+        candidate.parameters.enter_level_percent = enter_levels.get_value(indices[0]);
+        candidate.parameters.exit_level_percent = exit_levels.get_value(indices[1]);
+        candidate.parameters.pass_min_time_ms = pass_min_times.get_value(indices[2]);
+        candidate.parameters.rearm_time_ms = rearm_times.get_value(indices[3]);
+        candidate.median_order = medians[median_index];
+        return candidate;
+    };
+
+    std::vector<Candidate> candidates;
+    if (random_count) {
+        std::mt19937 generator(seed);
+        for (size_t i = 0; i < random_count; i++) {
+            size_t indices[4];
+            for (size_t range = 0; range < 4; range++) {
+                indices[range] = std::uniform_int_distribution<size_t>(0, ranges[range]->get_count() - 1)(generator);
+            }
+            candidates.push_back(make_candidate(indices, std::uniform_int_distribution<size_t>(0, medians.size() - 1)(generator)));
+        }
+    } else {
+        size_t grid_size = medians.size();
+        for (const Range* range : ranges) {
+            grid_size *= range->get_count();
+        }
+        for (size_t i = 0; i < grid_size; i++) {
+            size_t rest = i;
+            size_t indices[4];
+            for (size_t range = 0; range < 4; range++) {
+                indices[range] = rest % ranges[range]->get_count();
+                rest /= ranges[range]->get_count();
+            }
+            candidates.push_back(make_candidate(indices, rest));
+        }
+    }
+    // Exit above enter would be clamped to the same thresholds, skip the duplicates.
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const Candidate& candidate) {
+        return candidate.parameters.exit_level_percent > candidate.parameters.enter_level_percent;
+    }), candidates.end());
+
+    threads_count = std::min(threads_count, candidates.size());
+    std::printf("Sweeping %zu parameter sets over %zu traces on %zu threads\n",
+        candidates.size(), traces.size(), threads_count);
+
+    std::atomic<size_t> next_candidate(0);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads_count; i++) {
+        workers.emplace_back([&]() {
+            for (size_t index = next_candidate++; index < candidates.size(); index = next_candidate++) {
+                evaluate(traces, settings, candidates[index]);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end());
+
+    std::printf("\n  rank  enter  exit  pass min     rearm  median  missed  false  error mean  error max\n");
+    for (size_t i = 0; i < std::min(top_count, candidates.size()); i++) {
+        const Candidate& candidate = candidates[i];
+        std::printf("  %4zu  %4u%%  %3u%%  %5u ms  %5u ms  %6u  %6zu  %5zu  %7lld us  %6lld us\n", i + 1,
+            candidate.parameters.enter_level_percent, candidate.parameters.exit_level_percent,
+            candidate.parameters.pass_min_time_ms, candidate.parameters.rearm_time_ms, candidate.median_order,
+            candidate.missed_laps, candidate.false_laps,
+            static_cast<long long>(candidate.get_mean_abs_error_us()),
+            static_cast<long long>(candidate.max_abs_error_us));
+    }
+
+    return 0;
+}